@@ -0,0 +1,1130 @@
+/**
+*Offline asset cooker.
+*Turns source assets into the binary formats the game maps at load time. Each output carries
+*the stamp of its source, so an up to date output is skipped unless -f is given.
+*Meshes get a chain of simplified levels of detail sharing the full mesh's vertices.
+*Textures become block compressed DDS files with a full mip chain: BC5 for normal maps
+*(named *_norm or *_nrm), BC4 for masks (*_mask), BC3 when there is alpha, BC1 otherwise,
+*BC7 for colour with -b. Blocks compress in parallel on the worker threads.
+*An .atlas manifest packs the images it lists into one texture, plus a .map of where each went.
+*A .pipeline manifest packs the compiled shaders it lists into one .pack, vertex shaders' input
+*layouts read from their signatures and identical bytecode stored once; with -l the shaders'
+*constant buffers are also written out as C++ structs, read from the same bytecode.
+*Plain C++ apart from image decoding (WIC on Windows, libpng and libjpeg elsewhere), so it
+*builds and runs on Linux too.
+*
+*Usage: AssetCooker [-f] [-t] [-s] [-q] [-b] [-c quality] [-j threads] [-l header] [-p triangles] [-k particles] <files>
+*	-f	cook even if the output is current
+*	-t	time loading the source against loading the cooked output; for textures, time every
+*		quality on the top level, serial and threaded, with its PSNR
+*	-s	print vertex cache stats before and after optimisation, triangles and error per LOD,
+*		and packing error with -q; PSNR per mip for textures
+*	-q	write quantized PackedVertex2 vertices, only for meshes drawn with a packed vertex shader
+*	-b	BC7 instead of BC1/BC3 for colour textures
+*	-c	texture quality: fast, normal (the default) or high
+*	-j	worker threads for parsing and compression, defaults to the hardware thread count
+*	-l	with a .pipeline, also write the constant buffers and vertex inputs of its shaders as C++
+*		structs to this header (see WriteShaderLayouts)
+*	-p	benchmark the OBJ loader on a generated mesh of about this many triangles, no files needed
+*	-k	benchmark the CPU particle kernel (ParticleSoA::update) on pools of this many particles
+**/
+#include "ObjParser.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexCodec.h"
+#include "MappedFile.h"
+#include "AssetStamp.h"
+#include "ThreadPool.h"
+#include "TextureImage.h"
+#include "TextureFile.h"
+#include "AtlasFile.h"
+#include "AtlasPacker.h"
+#include "ShaderPackFile.h"
+#include "ParticleSoA.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+#define COOK_LOD_MAX_ERROR 0.1f // largest simplification error for any level, as a fraction of the bounding radius
+#define COOK_LOD_MIN_TRIANGLES 16 // no level goes below this
+#define COOK_LOD_MIN_REDUCTION 0.8f // a level has to get under this share of the one before to be kept
+#define BENCHMARK_RUNS 5 // each benchmark timing is the best of this many
+#define BENCHMARK_MAX_THREADS 16 // the parallel OBJ loader is timed with 1, 2, 4 ... up to this many
+#define BENCHMARK_PARTICLE_FRAMES 60 // frames of 60Hz updates in each particle benchmark run
+#define BENCHMARK_PARTICLE_EMITTERS 64 // emitters sharing each particle pool
+
+struct CookOptions{
+	bool force;
+	bool timing;
+	bool stats;
+	bool quantize;
+	bool bc7;
+	BlockQuality quality;
+	unsigned int threads;
+	const char* layouts; // header for the shader layouts of a .pipeline, or null
+	unsigned int benchmarkTriangles; // -p, 0 when not benchmarking
+	unsigned int benchmarkParticles; // -k, 0 when not benchmarking
+};
+
+//keeps the page touching loop from being optimised out
+static volatile unsigned int touchedBytes;
+
+static double SecondsSince(std::chrono::high_resolution_clock::time_point start){
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool HasExtension(const std::string& path, const char* extension){
+	size_t length = strlen(extension);
+	if (path.size() < length){
+		return false;
+	}
+	for (size_t i = 0; i < length; i++){
+		char c = path[path.size() - length + i];
+		if (c >= 'A' && c <= 'Z'){
+			c = c - 'A' + 'a';
+		}
+		if (c != extension[i]){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+*True if the cooked file exists, is readable and was built from the current source.
+*A quantized cook needs the packed layout; a plain one takes either, so cooking every mesh
+*after the quantized ones doesn't undo them.
+**/
+static bool IsCookedMeshCurrent(const std::string& source, const std::string& cooked, bool quantize){
+	MappedFile mapped;
+	MeshFileView view;
+	if (!mapped.open(cooked) || !ReadMeshFile(mapped.data(), mapped.size(), view)){
+		return false;
+	}
+	if (quantize && !IsPackedMeshFile(view)){
+		return false;
+	}
+	return IsCookedAssetCurrent(source, view.header->source, cooked, (const char*)&view.header->source - mapped.data());
+}
+
+/**
+*Times what startup pays for the mesh: parsing the OBJ against mapping and validating the
+*cooked file. The cooked load also reads every byte, as buffer creation would.
+**/
+static void TimeMesh(const std::string& source, const std::string& cooked, ThreadPool* pool){
+	std::vector<Vertex2> vertices;
+	std::vector<unsigned int> indices;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	LoadObjParallel(source, pool, vertices, indices);
+	double objTime = SecondsSince(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	MappedFile mapped;
+	MeshFileView view;
+	unsigned int checksum = 0;
+	if (mapped.open(cooked) && ReadMeshFile(mapped.data(), mapped.size(), view)){
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(mapped.data());
+		for (size_t i = 0; i < mapped.size(); i += 64){
+			checksum += bytes[i];
+		}
+	}
+	double cookedTime = SecondsSince(start);
+
+	touchedBytes = checksum;
+
+	printf("    obj %.3f ms, cooked %.3f ms (%.1fx)\n", objTime * 1000.0, cookedTime * 1000.0, cookedTime > 0.0 ? objTime / cookedTime : 0.0);
+}
+
+static MeshCacheStats GetCacheStats(const std::vector<Vertex2>& vertices, const std::vector<unsigned int>& indices){
+	return AnalyzeVertexCache(&indices[0], indices.size(), vertices.size(), MESH_CACHE_SIZE);
+}
+
+/**
+*The full mesh and up to MESH_MAX_LODS - 1 simplified levels, back to back in chain.
+*Every level is simplified from the full mesh, aiming at half the triangles of the level
+*before; the chain ends at the first level that can't get far enough within the error limit.
+**/
+static void BuildLodChain(const std::vector<Vertex2>& vertices, const std::vector<unsigned int>& indices, float radius, std::vector<unsigned int>& chain, std::vector<MeshLod>& lods){
+	chain = indices;
+	lods.resize(1);
+	lods[0].firstIndex = 0;
+	lods[0].indexCount = (uint32_t)indices.size();
+	lods[0].error = 0.0f;
+
+	std::vector<unsigned int> level;
+	while (lods.size() < MESH_MAX_LODS){
+		size_t previous = lods.back().indexCount;
+		size_t target = previous / 6 * 3;
+		if (target / 3 < COOK_LOD_MIN_TRIANGLES){
+			break;
+		}
+		float error = SimplifyMesh(vertices, indices, target, radius * COOK_LOD_MAX_ERROR, level);
+		if (level.empty() || level.size() > previous * COOK_LOD_MIN_REDUCTION){
+			break;
+		}
+		OptimizeVertexCache(&level[0], level.size(), vertices.size());
+
+		//the selector walks down while the error fits, so it must not shrink from level to level
+		MeshLod lod;
+		lod.firstIndex = (uint32_t)chain.size();
+		lod.indexCount = (uint32_t)level.size();
+		lod.error = error > lods.back().error ? error : lods.back().error;
+		chain.insert(chain.end(), level.begin(), level.end());
+		lods.push_back(lod);
+	}
+}
+
+static bool CookMesh(const std::string& source, const CookOptions& options, ThreadPool* pool){
+	std::string cooked = GetCookedMeshPath(source);
+	if (!options.force && IsCookedMeshCurrent(source, cooked, options.quantize)){
+		printf("%s: up to date\n", cooked.c_str());
+	}
+	else{
+		AssetStamp stamp;
+		std::vector<Vertex2> vertices;
+		std::vector<unsigned int> indices;
+		if (!StampAsset(source, stamp) || !LoadObjParallel(source, pool, vertices, indices) || indices.empty()){
+			printf("%s: can't read or parse\n", source.c_str());
+			return false;
+		}
+		MeshCacheStats before = GetCacheStats(vertices, indices);
+		OptimizeMesh(vertices, indices, true);
+		MeshCacheStats after = GetCacheStats(vertices, indices);
+
+		XMFLOAT3 center;
+		float radius;
+		ComputeMeshBounds(&vertices[0], sizeof(Vertex2), (uint32_t)vertices.size(), center, radius);
+
+		std::vector<unsigned int> chain;
+		std::vector<MeshLod> lods;
+		BuildLodChain(vertices, indices, radius, chain, lods);
+
+		uint32_t elementCount;
+		const MeshFileElement* layout = GetVertex2Layout(elementCount);
+		const void* vertexData = &vertices[0];
+		uint32_t stride = sizeof(Vertex2);
+
+		//checked against the reference codec, a mesh the formats can't hold isn't written
+		std::vector<PackedVertex2> packed;
+		VertexPackingError error = { 0.0f, 0.0f, 0.0f, 0.0f };
+		if (options.quantize){
+			packed.resize(vertices.size());
+			PackVertices(&vertices[0], vertices.size(), center, radius, &packed[0]);
+			error = MeasurePackingError(&vertices[0], &packed[0], vertices.size(), center, radius);
+			VertexPackingError bound = GetPackingErrorBound(radius);
+			if (error.position > bound.position || error.normal > bound.normal || error.tangent > bound.tangent || error.uv > bound.uv){
+				printf("%s: packing error over bound, position %g (%g), normal %g (%g), tangent %g (%g), uv %g (%g)\n", source.c_str(),
+					error.position, bound.position, error.normal, bound.normal, error.tangent, bound.tangent, error.uv, bound.uv);
+				return false;
+			}
+			layout = GetPackedVertex2Layout(elementCount);
+			vertexData = &packed[0];
+			stride = sizeof(PackedVertex2);
+		}
+
+		if (!WriteMeshFile(cooked, layout, elementCount, vertexData, stride, (uint32_t)vertices.size(), &chain[0], (uint32_t)chain.size(), &lods[0], (uint32_t)lods.size(), center, radius, stamp)){
+			printf("%s: can't write\n", cooked.c_str());
+			return false;
+		}
+		printf("%s: %u vertices, %u indices, %u LODs%s\n", cooked.c_str(), (unsigned int)vertices.size(), (unsigned int)indices.size(), (unsigned int)lods.size(), options.quantize ? ", quantized" : "");
+		if (options.stats){
+			printf("    ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", before.acmr, after.acmr, before.atvr, after.atvr);
+			for (size_t i = 0; i < lods.size(); i++){
+				printf("    LOD %u: %u triangles, error %g (%.2f%% of radius)\n", (unsigned int)i, lods[i].indexCount / 3, lods[i].error, radius > 0.0f ? 100.0f * lods[i].error / radius : 0.0f);
+			}
+			if (options.quantize){
+				printf("    packing error: position %g, normal %.4f deg, tangent %.4f deg, uv %g\n", error.position, error.normal, error.tangent, error.uv);
+			}
+		}
+	}
+
+	if (options.timing){
+		TimeMesh(source, cooked, pool);
+	}
+	return true;
+}
+
+/**
+*An OBJ of a rippled grid with about the given number of triangles, in memory so the disk
+*doesn't enter the timings. Every grid point has its own position, uv and normal line and the
+*triangles reference them as v/vt/vn the way exporters write smooth meshes, so each vertex is
+*shared by about six corners and the dedup has real work to do.
+**/
+static void GenerateBenchmarkObj(unsigned int triangles, std::string& text){
+	unsigned int side = (unsigned int)ceil(sqrt(triangles / 2.0)); // quads along each edge
+	if (side < 1){
+		side = 1;
+	}
+	unsigned int points = side + 1;
+	text.clear();
+	text.reserve((size_t)points * points * 96 + (size_t)side * side * 2 * 48);
+
+	char line[160];
+	for (unsigned int y = 0; y < points; y++){
+		for (unsigned int x = 0; x < points; x++){
+			float u = (float)x / side;
+			float v = (float)y / side;
+			float height = 0.5f * sinf(u * 25.0f) * cosf(v * 17.0f);
+			float slopeU = 12.5f * cosf(u * 25.0f) * cosf(v * 17.0f) / 100.0f;
+			float slopeV = -8.5f * sinf(u * 25.0f) * sinf(v * 17.0f) / 100.0f;
+			float length = sqrtf(slopeU * slopeU + 1.0f + slopeV * slopeV);
+			int written = sprintf(line, "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn %.6f %.6f %.6f\n",
+				u * 100.0f, height, v * 100.0f, u, v, -slopeU / length, 1.0f / length, -slopeV / length);
+			text.append(line, written);
+		}
+	}
+	for (unsigned int y = 0; y < side; y++){
+		for (unsigned int x = 0; x < side; x++){
+			unsigned int a = y * points + x + 1;
+			unsigned int b = a + 1;
+			unsigned int c = a + points;
+			unsigned int d = c + 1;
+			int written = sprintf(line, "f %u/%u/%u %u/%u/%u %u/%u/%u\nf %u/%u/%u %u/%u/%u %u/%u/%u\n",
+				a, a, a, c, c, c, b, b, b, b, b, b, c, c, c, d, d, d);
+			text.append(line, written);
+		}
+	}
+}
+
+/**
+*Loads a generated OBJ (see GenerateBenchmarkObj) from memory and reports the load time and how
+*far deduplication cut the vertex count below one vertex per corner. The tokenizing alone
+*(ParseObjChunk over the whole file) is timed too, as throughput on the one thread.
+*Then the parallel loader runs with 1 to BENCHMARK_MAX_THREADS threads, each output compared
+*with the serial one.
+**/
+static bool BenchmarkObj(unsigned int triangles){
+	std::string text;
+	GenerateBenchmarkObj(triangles, text);
+	double megabytes = text.size() / (1024.0 * 1024.0);
+
+	double bestParse = 0.0;
+	for (int run = 0; run < BENCHMARK_RUNS; run++){
+		ObjChunk chunk;
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		ParseObjChunk(text.data(), text.data() + text.size(), chunk);
+		double time = SecondsSince(start);
+		if (run == 0 || time < bestParse){
+			bestParse = time;
+		}
+	}
+
+	std::vector<Vertex2> vertices;
+	std::vector<unsigned int> indices;
+	double best = 0.0;
+	for (int run = 0; run < BENCHMARK_RUNS; run++){
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		if (!ParseObj(text.data(), text.size(), vertices, indices) || indices.empty()){
+			printf("benchmark: can't parse the generated OBJ\n");
+			return false;
+		}
+		double time = SecondsSince(start);
+		if (run == 0 || time < best){
+			best = time;
+		}
+	}
+
+	printf("benchmark: %u triangles, %.1f MB of OBJ\n", (unsigned int)(indices.size() / 3), megabytes);
+	printf("    parse %.1f ms (%.0f MB/s), load %.1f ms (%.0f MB/s)\n", bestParse * 1000.0, megabytes / bestParse, best * 1000.0, megabytes / best);
+	printf("    %u corners -> %u vertices (%.2fx fewer)\n",
+		(unsigned int)indices.size(), (unsigned int)vertices.size(), (double)indices.size() / vertices.size());
+
+	bool same = true;
+	double oneThread = 0.0;
+	for (unsigned int threads = 1; threads <= BENCHMARK_MAX_THREADS; threads *= 2){
+		//the calling thread parses a share too
+		ThreadPool* pool = threads > 1 ? new ThreadPool(threads - 1) : nullptr;
+		std::vector<Vertex2> parallelVertices;
+		std::vector<unsigned int> parallelIndices;
+		double bestParallel = 0.0;
+		for (int run = 0; run < BENCHMARK_RUNS; run++){
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			ParseObjParallel(text.data(), text.size(), pool, parallelVertices, parallelIndices);
+			double time = SecondsSince(start);
+			if (run == 0 || time < bestParallel){
+				bestParallel = time;
+			}
+		}
+		delete pool;
+
+		bool matches = parallelVertices.size() == vertices.size() && parallelIndices == indices &&
+			memcmp(&parallelVertices[0], &vertices[0], sizeof(Vertex2) * vertices.size()) == 0;
+		same = same && matches;
+		if (threads == 1){
+			oneThread = bestParallel;
+		}
+		printf("    %2u threads: load %.1f ms (%.2fx)%s\n", threads, bestParallel * 1000.0, oneThread / bestParallel, matches ? "" : ", DIFFERS from the serial load");
+	}
+	return same;
+}
+
+/**
+*One core's worth of the particle benchmark: a pool kept full by emitters whose particles live a
+*second, so about a sixtieth of it dies and is compacted out every frame, updated at 60Hz the way
+*CpuParticleSystem does. Returns the best run's particles updated per second.
+**/
+static double TimeParticleUpdates(unsigned int particles){
+	ParticleSoA soa(particles);
+	unsigned int perEmitter = particles / BENCHMARK_PARTICLE_EMITTERS > 0 ? particles / BENCHMARK_PARTICLE_EMITTERS : 1;
+	for (int e = 0; e < BENCHMARK_PARTICLE_EMITTERS; e++){
+		soa.addEmitter(XMFLOAT4(e * 0.5f, 0.0f, 1.0f, 1.0f), XMFLOAT2(0.3f, 1.0f), XMFLOAT2(0.0f, -0.5f), 1.0f, perEmitter);
+	}
+	//one lifetime in a single step fills the pool with ages spread across it
+	soa.update(1.0f);
+
+	const float dt = 1.0f / 60.0f;
+	double best = 0.0;
+	for (int run = 0; run < BENCHMARK_RUNS; run++){
+		double updated = 0.0;
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < BENCHMARK_PARTICLE_FRAMES; frame++){
+			updated += soa.getCount();
+			soa.update(dt);
+		}
+		double rate = updated / SecondsSince(start);
+		if (rate > best){
+			best = rate;
+		}
+	}
+	return best;
+}
+
+/**
+*Times ParticleSoA::update over pools of the given size, one pool per thread so the threads share
+*nothing, with 1, 2, 4 ... threads up to the hardware thread count. Reports particles per second
+*per core, which stays flat while the kernel is compute bound and drops once memory bandwidth
+*runs out.
+**/
+static bool BenchmarkParticles(unsigned int particles){
+#if defined(__AVX2__)
+	const char* kernel = "AVX2";
+#else
+	const char* kernel = "SSE2";
+#endif
+	unsigned int hardware = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	printf("benchmark: %u particles a thread, %s kernel, %u bytes a particle\n", particles, kernel, (unsigned int)(9 * sizeof(float)));
+
+	for (unsigned int threads = 1; threads <= hardware && threads <= BENCHMARK_MAX_THREADS; threads *= 2){
+		ThreadPool pool(threads);
+		std::vector<std::future<double>> rates;
+		for (unsigned int t = 0; t < threads; t++){
+			rates.push_back(pool.submit([particles](){ return TimeParticleUpdates(particles); }));
+		}
+		double total = 0.0;
+		for (size_t t = 0; t < rates.size(); t++){
+			total += rates[t].get();
+		}
+		printf("    %2u threads: %.0fM particles/s per core, %.0fM/s in all\n", threads, total / threads / 1e6, total / 1e6);
+	}
+	return true;
+}
+
+/**
+*True if the cooked file exists, is readable and was built from the current source.
+*A BC7 cook needs BC7 wherever BC7 would be chosen; a plain one takes either, like meshes and -q.
+**/
+static bool IsCookedTextureCurrent(const std::string& source, const std::string& cooked, bool bc7){
+	MappedFile mapped;
+	TextureFileView view;
+	AssetStamp stamp;
+	if (!mapped.open(cooked) || !ReadTextureFile(mapped.data(), mapped.size(), view) || !GetTextureFileStamp(view, stamp)){
+		return false;
+	}
+	if (bc7 && ChooseTextureFormat(source, false, true) == TEXTURE_FORMAT_BC7 && view.format != TEXTURE_FORMAT_BC7){
+		return false;
+	}
+	return IsCookedAssetCurrent(source, stamp, cooked, (const char*)view.header->stamp - mapped.data());
+}
+
+static const char* GetQualityName(BlockQuality quality){
+	return quality == BLOCK_QUALITY_FAST ? "fast" : (quality == BLOCK_QUALITY_NORMAL ? "normal" : "high");
+}
+
+/**
+*Compresses the top level at every quality, on the calling thread alone and then with the
+*pool, so the tiers' cost and what they buy can be compared.
+**/
+static void TimeTexture(const TextureImage& top, uint32_t format, unsigned int channels, ThreadPool* pool){
+	std::vector<uint8_t> blocks(GetCompressedSize(format, top.width, top.height));
+	double megapixels = (double)top.width * top.height / 1000000.0;
+	TextureImage decoded;
+	for (int quality = BLOCK_QUALITY_FAST; quality <= BLOCK_QUALITY_HIGH; quality++){
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		CompressImage(top, format, (BlockQuality)quality, &blocks[0]);
+		double serialTime = SecondsSince(start);
+		double parallelTime = serialTime;
+		if (pool){
+			start = std::chrono::high_resolution_clock::now();
+			CompressImage(top, format, (BlockQuality)quality, &blocks[0], pool);
+			parallelTime = SecondsSince(start);
+		}
+		DecompressImage(&blocks[0], format, top.width, top.height, decoded);
+		printf("    %-6s %8.1f ms %6.1f MP/s, %u threads %8.1f ms %6.1f MP/s, PSNR %.2f dB\n", GetQualityName((BlockQuality)quality),
+			serialTime * 1000.0, serialTime > 0.0 ? megapixels / serialTime : 0.0, pool ? pool->getThreadCount() + 1 : 1,
+			parallelTime * 1000.0, parallelTime > 0.0 ? megapixels / parallelTime : 0.0, ComputeImagePsnr(top, decoded, channels));
+	}
+}
+
+static bool CookTexture(const std::string& source, const CookOptions& options, ThreadPool* pool){
+	std::string cooked = GetCookedTexturePath(source);
+	if (!options.force && !options.timing && IsCookedTextureCurrent(source, cooked, options.bc7)){
+		printf("%s: up to date\n", cooked.c_str());
+		return true;
+	}
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	AssetStamp stamp;
+	TextureImage image;
+	if (!StampAsset(source, stamp) || !LoadTextureImage(source, image)){
+		printf("%s: can't read or decode\n", source.c_str());
+		return false;
+	}
+	double decodeTime = SecondsSince(start);
+
+	TextureEncoding encoding = ChooseTextureEncoding(source);
+	bool alpha = encoding == TEXTURE_SRGB && HasTextureAlpha(image);
+	uint32_t format = ChooseTextureFormat(source, alpha, options.bc7);
+
+	//D3D11 wants the top level of a block compressed texture in whole blocks
+	uint32_t width = (image.width + 3) & ~3u;
+	uint32_t height = (image.height + 3) & ~3u;
+
+	start = std::chrono::high_resolution_clock::now();
+	std::vector<TextureImage> mips;
+	BuildTextureMips(image, width, height, encoding, mips);
+	double mipTime = SecondsSince(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	CompressedTexture texture;
+	CompressMips(mips, format, options.quality, pool, texture);
+	double encodeTime = SecondsSince(start);
+
+	if (!WriteTextureFile(cooked, format, width, height, texture.mipCount, &texture.data[0], stamp)){
+		printf("%s: can't write\n", cooked.c_str());
+		return false;
+	}
+
+	//measured against what went into the encoder, over the channels the format keeps
+	unsigned int channels = format == TEXTURE_FORMAT_BC7 && !alpha ? 3 : GetFormatChannels(format);
+	size_t texels = 0;
+	for (size_t i = 0; i < mips.size(); i++){
+		texels += (size_t)mips[i].width * mips[i].height;
+	}
+	TextureImage decoded;
+	DecompressImage(&texture.data[0], format, width, height, decoded);
+	printf("%s: %ux%u %s %s, %u mips, %u KB (%.1f:1), PSNR %.2f dB, %.1f ms (decode %.1f, mips %.1f, encode %.1f at %.1f MP/s)\n", cooked.c_str(),
+		width, height, GetTextureFormatName(format), GetQualityName(options.quality), texture.mipCount, (unsigned int)(texture.data.size() / 1024),
+		(double)texels * 4.0 / texture.data.size(), ComputeImagePsnr(mips[0], decoded, channels), (decodeTime + mipTime + encodeTime) * 1000.0,
+		decodeTime * 1000.0, mipTime * 1000.0, encodeTime * 1000.0, encodeTime > 0.0 ? texels / encodeTime / 1000000.0 : 0.0);
+	if (options.stats){
+		size_t offset = 0;
+		for (size_t i = 0; i < mips.size(); i++){
+			DecompressImage(&texture.data[offset], format, mips[i].width, mips[i].height, decoded);
+			offset += GetCompressedSize(format, mips[i].width, mips[i].height);
+			printf("    mip %u: %ux%u, PSNR %.2f dB\n", (unsigned int)i, mips[i].width, mips[i].height, ComputeImagePsnr(mips[i], decoded, channels));
+		}
+	}
+	if (options.timing){
+		TimeTexture(mips[0], format, channels, pool);
+	}
+	return true;
+}
+
+/**
+*Packs the images a manifest lists into one texture and writes where each went.
+*Only the first ATLAS_MIP_COUNT levels are kept: past them the padding is gone and
+*neighbouring images would bleed into each other.
+**/
+static bool CookAtlas(const std::string& manifest, const CookOptions& options, ThreadPool* pool){
+	std::string cooked = GetCookedTexturePath(manifest);
+	std::string map = GetCookedAtlasPath(manifest);
+	MappedFile mapped;
+	AtlasFileView view;
+	if (!options.force && OpenCookedAtlas(manifest, mapped, view) && IsCookedTextureCurrent(manifest, cooked, options.bc7)){
+		printf("%s: up to date\n", map.c_str());
+		return true;
+	}
+	mapped.close();
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	AssetStamp stamp;
+	std::vector<std::string> names;
+	if (!StampAsset(manifest, stamp) || !ReadAssetManifest(manifest, names) || names.empty()){
+		printf("%s: can't read or lists nothing\n", manifest.c_str());
+		return false;
+	}
+	TextureEncoding encoding = ChooseTextureEncoding(manifest);
+	std::vector<TextureImage> images(names.size());
+	std::vector<AtlasRect> sizes(names.size());
+	std::vector<AtlasFileSprite> sprites(names.size());
+	bool alpha = false;
+	uint64_t texels = 0;
+	for (size_t i = 0; i < names.size(); i++){
+		std::string source = GetManifestSourcePath(manifest, names[i]);
+		memset(&sprites[i], 0, sizeof(AtlasFileSprite));
+		if (names[i].size() >= ATLAS_NAME_SIZE || !StampAsset(source, sprites[i].source) || !LoadTextureImage(source, images[i])){
+			printf("%s: can't read or decode %s\n", manifest.c_str(), source.c_str());
+			return false;
+		}
+		memcpy(sprites[i].name, names[i].c_str(), names[i].size());
+		alpha = alpha || (encoding == TEXTURE_SRGB && HasTextureAlpha(images[i]));
+		sizes[i] = GetPaddedAtlasSize(images[i].width, images[i].height);
+		texels += (uint64_t)images[i].width * images[i].height;
+	}
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<AtlasRect> placed;
+	if (!PackAtlas(sizes, ATLAS_MAX_SIZE, width, height, placed)){
+		printf("%s: doesn't fit in %ux%u\n", manifest.c_str(), ATLAS_MAX_SIZE, ATLAS_MAX_SIZE);
+		return false;
+	}
+	for (size_t i = 0; i < sprites.size(); i++){
+		AtlasRect content = GetAtlasContentRect(placed[i], images[i].width, images[i].height);
+		sprites[i].x = content.x;
+		sprites[i].y = content.y;
+		sprites[i].width = content.width;
+		sprites[i].height = content.height;
+		sprites[i].uvScale[0] = (float)content.width / width;
+		sprites[i].uvScale[1] = (float)content.height / height;
+		sprites[i].uvOffset[0] = (float)content.x / width;
+		sprites[i].uvOffset[1] = (float)content.y / height;
+	}
+	double packTime = SecondsSince(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	TextureImage atlas;
+	BuildAtlasImage(images, placed, width, height, atlas);
+	uint32_t format = ChooseTextureFormat(manifest, alpha, options.bc7);
+	std::vector<TextureImage> mips;
+	BuildTextureMips(atlas, width, height, encoding, mips);
+	if (mips.size() > ATLAS_MIP_COUNT){
+		mips.resize(ATLAS_MIP_COUNT);
+	}
+	CompressedTexture texture;
+	CompressMips(mips, format, options.quality, pool, texture);
+	double encodeTime = SecondsSince(start);
+
+	if (!WriteTextureFile(cooked, format, width, height, texture.mipCount, &texture.data[0], stamp) ||
+		!WriteAtlasFile(map, width, height, &sprites[0], (uint32_t)sprites.size(), stamp)){
+		printf("%s: can't write\n", map.c_str());
+		return false;
+	}
+
+	unsigned int count = (unsigned int)sprites.size();
+	printf("%s: %u images in %ux%u %s %s, %.1f%% covered, %u mips, %u KB, %.1f ms (pack %.1f, mips and encode %.1f)\n", cooked.c_str(),
+		count, width, height, GetTextureFormatName(format), GetQualityName(options.quality), 100.0 * texels / ((double)width * height),
+		texture.mipCount, (unsigned int)(texture.data.size() / 1024), (packTime + encodeTime) * 1000.0, packTime * 1000.0, encodeTime * 1000.0);
+	//draws that used to switch between these now keep one view bound, and SpriteBatch only
+	//flushes on a texture change
+	printf("    %u textures -> 1: up to %u texture binds and SpriteBatch flushes per pass over them -> 1\n", count, count);
+	if (options.stats){
+		for (size_t i = 0; i < sprites.size(); i++){
+			printf("    %s: %ux%u at %u,%u\n", sprites[i].name, sprites[i].width, sprites[i].height, sprites[i].x, sprites[i].y);
+		}
+	}
+	return true;
+}
+
+static bool ReadWholeFile(const std::string& path, std::vector<char>& bytes){
+	MappedFile mapped;
+	if (!mapped.open(path) || mapped.size() == 0){
+		return false;
+	}
+	bytes.assign(mapped.data(), mapped.data() + mapped.size());
+	return true;
+}
+
+/**
+*Times what startup pays for the shaders: reading every .cso on its own and reading its
+*signature, as the game does without a pack, against mapping and validating the pack. Both
+*touch every byte, as shader creation would.
+**/
+static void TimeShaderPack(const std::string& manifest, const std::vector<std::string>& names, const std::string& cooked){
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	unsigned int checksum = 0;
+	for (size_t i = 0; i < names.size(); i++){
+		std::vector<char> bytecode;
+		uint32_t stage;
+		std::vector<MeshFileElement> inputs;
+		if (ReadWholeFile(GetManifestSourcePath(manifest, names[i]), bytecode) && ReadShaderBytecode(&bytecode[0], bytecode.size(), stage, inputs)){
+			for (size_t j = 0; j < bytecode.size(); j += 64){
+				checksum += (unsigned char)bytecode[j];
+			}
+		}
+	}
+	double looseTime = SecondsSince(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	MappedFile mapped;
+	ShaderPackView view;
+	if (mapped.open(cooked) && ReadShaderPackFile(mapped.data(), mapped.size(), view)){
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(mapped.data());
+		for (size_t i = 0; i < mapped.size(); i += 64){
+			checksum += bytes[i];
+		}
+	}
+	double cookedTime = SecondsSince(start);
+
+	touchedBytes = checksum;
+
+	printf("    %u files %.3f ms, pack %.3f ms (%.1fx)\n", (unsigned int)names.size(), looseTime * 1000.0, cookedTime * 1000.0, cookedTime > 0.0 ? looseTime / cookedTime : 0.0);
+}
+
+/**
+*Packs the compiled shaders a .pipeline manifest lists into one file (see ShaderPackFile),
+*with each vertex shader's input layout read from its signature here instead of at startup.
+**/
+static bool CookShaderPack(const std::string& manifest, const CookOptions& options){
+	std::string cooked = GetCookedShaderPackPath(manifest);
+	std::vector<std::string> names;
+	MappedFile mapped;
+	ShaderPackView view;
+	if (!options.force && OpenCookedShaderPack(manifest, mapped, view)){
+		printf("%s: up to date\n", cooked.c_str());
+		if (options.timing && ReadAssetManifest(manifest, names)){
+			mapped.close();
+			TimeShaderPack(manifest, names, cooked);
+		}
+		return true;
+	}
+	mapped.close();
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	AssetStamp stamp;
+	if (!StampAsset(manifest, stamp) || !ReadAssetManifest(manifest, names) || names.empty()){
+		printf("%s: can't read or lists nothing\n", manifest.c_str());
+		return false;
+	}
+	std::vector<ShaderPackSource> shaders(names.size());
+	uint64_t bytes = 0;
+	unsigned int elements = 0;
+	for (size_t i = 0; i < names.size(); i++){
+		std::string source = GetManifestSourcePath(manifest, names[i]);
+		shaders[i].name = names[i];
+		uint32_t stage;
+		std::vector<MeshFileElement> inputs;
+		if (!StampAsset(source, shaders[i].source) || !ReadWholeFile(source, shaders[i].bytecode)){
+			printf("%s: can't read %s\n", manifest.c_str(), source.c_str());
+			return false;
+		}
+		if (names[i].size() >= SHADER_NAME_SIZE || !ReadShaderBytecode(&shaders[i].bytecode[0], shaders[i].bytecode.size(), stage, inputs)){
+			printf("%s: %s isn't compiled shader bytecode or its name is too long\n", manifest.c_str(), source.c_str());
+			return false;
+		}
+		bytes += shaders[i].bytecode.size();
+		elements += (unsigned int)inputs.size();
+	}
+
+	unsigned int unique = 0;
+	if (!WriteShaderPackFile(cooked, shaders, stamp, unique)){
+		printf("%s: can't write\n", cooked.c_str());
+		return false;
+	}
+	double cookTime = SecondsSince(start);
+
+	uint64_t packBytes = 0;
+	uint64_t packTime = 0;
+	StatAsset(cooked, packBytes, packTime);
+	printf("%s: %u shaders, %u distinct, %u layout elements, %u KB -> %u KB, %.1f ms\n", cooked.c_str(), (unsigned int)shaders.size(), unique,
+		elements, (unsigned int)(bytes / 1024), (unsigned int)(packBytes / 1024), cookTime * 1000.0);
+	if (options.stats){
+		for (size_t i = 0; i < shaders.size(); i++){
+			uint32_t stage;
+			std::vector<MeshFileElement> inputs;
+			ReadShaderBytecode(&shaders[i].bytecode[0], shaders[i].bytecode.size(), stage, inputs);
+			printf("    %s: %u bytes", shaders[i].name.c_str(), (unsigned int)shaders[i].bytecode.size());
+			for (size_t j = 0; j < inputs.size(); j++){
+				printf("%s %s%u", j == 0 ? ", inputs" : "", inputs[j].semantic, inputs[j].semanticIndex);
+			}
+			printf("\n");
+		}
+	}
+	if (options.timing){
+		TimeShaderPack(manifest, names, cooked);
+	}
+	return true;
+}
+
+//"perModel" -> "PerModelLayout", anything that can't be in an identifier dropped
+static std::string GetLayoutName(const std::string& name, const char* suffix){
+	std::string identifier;
+	for (size_t i = 0; i < name.size(); i++){
+		char c = name[i];
+		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9' && !identifier.empty()) || c == '_'){
+			identifier += identifier.empty() && c >= 'a' && c <= 'z' ? (char)(c - 'a' + 'A') : c;
+		}
+	}
+	return identifier + suffix;
+}
+
+static bool SameVariable(const ShaderVariable& a, const ShaderVariable& b){
+	return a.name == b.name && a.offset == b.offset && a.size == b.size && a.typeClass == b.typeClass && a.type == b.type &&
+		a.rows == b.rows && a.columns == b.columns && a.elements == b.elements;
+}
+
+//True if every variable of shorter is where longer has it, so one struct serves both
+static bool IsLayoutPrefix(const ShaderConstantBuffer& shorter, const ShaderConstantBuffer& longer){
+	if (shorter.size > longer.size || shorter.variables.size() > longer.variables.size()){
+		return false;
+	}
+	for (size_t i = 0; i < shorter.variables.size(); i++){
+		if (!SameVariable(shorter.variables[i], longer.variables[i])){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+*The C++ type that puts a variable at the same offsets the shader reads, count set for arrays.
+*False when none does, e.g. arrays of less than a register whose elements each start a new one;
+*those are written as raw words.
+**/
+static bool GetVariableType(const ShaderVariable& variable, std::string& type, unsigned int& count){
+	const char* scalar;
+	const char* vector;
+	if (variable.type == SHADER_VARIABLE_FLOAT){
+		scalar = "float";
+		vector = "DirectX::XMFLOAT";
+	}
+	else if (variable.type == SHADER_VARIABLE_INT){
+		scalar = "int32_t";
+		vector = "DirectX::XMINT";
+	}
+	else if (variable.type == SHADER_VARIABLE_UINT || variable.type == SHADER_VARIABLE_BOOL){
+		scalar = "uint32_t"; // HLSL bools are 32 bits
+		vector = "DirectX::XMUINT";
+	}
+	else{
+		return false;
+	}
+
+	unsigned int size;
+	if (variable.typeClass == SHADER_VARIABLE_SCALAR){
+		type = scalar;
+		size = 4;
+	}
+	else if (variable.typeClass == SHADER_VARIABLE_VECTOR && variable.columns >= 2 && variable.columns <= 4){
+		type = vector + std::to_string(variable.columns);
+		size = 4 * variable.columns;
+	}
+	else if ((variable.typeClass == SHADER_VARIABLE_MATRIX_ROWS || variable.typeClass == SHADER_VARIABLE_MATRIX_COLUMNS) &&
+		variable.type == SHADER_VARIABLE_FLOAT && variable.rows == 4 && variable.columns == 4){
+		type = "DirectX::XMFLOAT4X4";
+		size = 64;
+	}
+	else{
+		return false;
+	}
+	count = variable.elements;
+	if (count == 0){
+		return size == variable.size;
+	}
+	//array elements start a register each, packed C++ only matches whole register elements
+	return size % 16 == 0 && size * count == variable.size;
+}
+
+static void AppendConstantBuffer(const ShaderConstantBuffer& buffer, const std::vector<std::string>& users, std::string& out){
+	std::string name = GetLayoutName(buffer.name, "Layout");
+	out += "//cbuffer " + buffer.name + ", " + std::to_string(buffer.size) + " bytes:";
+	for (size_t i = 0; i < users.size(); i++){
+		out += " " + users[i];
+	}
+	out += "\nstruct " + name + "{\n";
+	std::string asserts;
+	uint32_t offset = 0;
+	unsigned int pads = 0;
+	for (size_t i = 0; i <= buffer.variables.size(); i++){
+		uint32_t next = i < buffer.variables.size() ? buffer.variables[i].offset : buffer.size;
+		if (next > offset){
+			//HLSL keeps a variable from straddling a register, C++ doesn't know to
+			out += "\tuint32_t pad" + std::to_string(pads++) + "[" + std::to_string((next - offset) / 4) + "];\n";
+		}
+		if (i == buffer.variables.size()){
+			break;
+		}
+		const ShaderVariable& variable = buffer.variables[i];
+		std::string type;
+		unsigned int count = 0;
+		if (GetVariableType(variable, type, count)){
+			out += "\t" + type + " " + variable.name + (count ? "[" + std::to_string(count) + "]" : "") + ";\n";
+		}
+		else{
+			out += "\tuint32_t " + variable.name + "[" + std::to_string((variable.size + 3) / 4) + "]; // no matching C++ type\n";
+		}
+		asserts += "static_assert(offsetof(" + name + ", " + variable.name + ") == " + std::to_string(variable.offset) + ", \"" + buffer.name + "." + variable.name + "\");\n";
+		offset = variable.offset + (variable.size + 3) / 4 * 4;
+	}
+	out += "};\n";
+	out += "static_assert(sizeof(" + name + ") == " + std::to_string(buffer.size) + ", \"cbuffer " + buffer.name + "\");\n";
+	out += asserts + "\n";
+}
+
+//A vertex shader's inputs as a vertex struct, laid out the way appended input elements are
+static bool AppendVertexInput(const std::string& shaderName, const std::vector<MeshFileElement>& inputs, std::string& out){
+	//DXGI_FORMAT_R32_*, R32G32_*, R32G32B32_*, R32G32B32A32_* by component count; float, uint then sint
+	static const uint32_t formats[3][4] = {
+		{ 41, 16, 6, 2 },
+		{ 42, 17, 7, 3 },
+		{ 43, 18, 8, 4 }
+	};
+	static const char* scalars[3] = { "float", "uint32_t", "int32_t" };
+	static const char* vectors[3] = { "DirectX::XMFLOAT", "DirectX::XMUINT", "DirectX::XMINT" };
+	std::string stem = shaderName.substr(0, shaderName.find_last_of('.'));
+	std::string name = GetLayoutName(stem, "Input");
+	std::string fields;
+	std::string asserts;
+	uint32_t offset = 0;
+	for (size_t i = 0; i < inputs.size(); i++){
+		std::string field;
+		for (const char* c = inputs[i].semantic; *c; c++){
+			field += *c >= 'A' && *c <= 'Z' ? (char)(*c - 'A' + 'a') : *c;
+		}
+		if (inputs[i].semanticIndex != 0){
+			field += std::to_string(inputs[i].semanticIndex);
+		}
+		unsigned int components = 0;
+		int kind = -1;
+		for (int k = 0; k < 3 && kind < 0; k++){
+			for (unsigned int c = 0; c < 4; c++){
+				if (formats[k][c] == inputs[i].format){
+					kind = k;
+					components = c + 1;
+				}
+			}
+		}
+		if (kind < 0){
+			return false;
+		}
+		fields += "\t" + (components == 1 ? std::string(scalars[kind]) : vectors[kind] + std::to_string(components)) + " " + field + ";\n";
+		asserts += "static_assert(offsetof(" + name + ", " + field + ") == " + std::to_string(offset) + ", \"" + stem + " " + inputs[i].semantic + std::to_string(inputs[i].semanticIndex) + "\");\n";
+		offset += 4 * components;
+	}
+	out += "//" + shaderName + " input signature\n";
+	out += "struct " + name + "{\n" + fields + "};\n";
+	out += "static_assert(sizeof(" + name + ") == " + std::to_string(offset) + ", \"" + stem + " inputs\");\n";
+	out += asserts + "\n";
+	return true;
+}
+
+/**
+*Writes the constant buffers and vertex inputs of the shaders a .pipeline manifest lists as a C++
+*header, so the structs the game fills can't drift from what the shaders read. A cbuffer more than
+*one shader declares becomes one struct; the shorter declarations have to be its prefix, anything
+*else is a mismatch and fails. The header is only rewritten when it changes.
+**/
+static bool WriteShaderLayouts(const std::string& manifest, const std::string& header){
+	std::vector<std::string> names;
+	if (!ReadAssetManifest(manifest, names) || names.empty()){
+		printf("%s: can't read or lists nothing\n", manifest.c_str());
+		return false;
+	}
+	std::vector<ShaderConstantBuffer> buffers; // merged, in the order first declared
+	std::vector<std::vector<std::string> > users;
+	std::vector<std::string> declaredBy; // the shader whose declaration buffers[i] is
+	std::string inputs;
+	for (size_t i = 0; i < names.size(); i++){
+		std::string source = GetManifestSourcePath(manifest, names[i]);
+		std::vector<char> bytecode;
+		uint32_t stage;
+		std::vector<MeshFileElement> elements;
+		std::vector<ShaderConstantBuffer> declared;
+		if (!ReadWholeFile(source, bytecode) || !ReadShaderBytecode(&bytecode[0], bytecode.size(), stage, elements) ||
+			!ReadShaderConstantBuffers(&bytecode[0], bytecode.size(), declared)){
+			printf("%s: can't read %s\n", manifest.c_str(), source.c_str());
+			return false;
+		}
+		if (!elements.empty() && !AppendVertexInput(names[i], elements, inputs)){
+			printf("%s: %s has an input no vertex struct can hold\n", manifest.c_str(), source.c_str());
+			return false;
+		}
+		for (size_t j = 0; j < declared.size(); j++){
+			size_t k = 0;
+			while (k < buffers.size() && buffers[k].name != declared[j].name){
+				k++;
+			}
+			if (k == buffers.size()){
+				buffers.push_back(declared[j]);
+				users.push_back(std::vector<std::string>());
+				declaredBy.push_back(names[i]);
+			}
+			else if (IsLayoutPrefix(buffers[k], declared[j])){
+				buffers[k] = declared[j];
+				declaredBy[k] = names[i];
+			}
+			else if (!IsLayoutPrefix(declared[j], buffers[k])){
+				printf("%s: cbuffer %s in %s doesn't match %s\n", manifest.c_str(), declared[j].name.c_str(), names[i].c_str(), declaredBy[k].c_str());
+				return false;
+			}
+			users[k].push_back(names[i]);
+		}
+	}
+
+	//ShaderLayouts.h -> _SHADERLAYOUTS_H
+	std::string guard = "_" + header.substr(header.find_last_of("/\\") + 1);
+	for (size_t i = 1; i < guard.size(); i++){
+		char c = guard[i];
+		guard[i] = c >= 'a' && c <= 'z' ? (char)(c - 'a' + 'A') : (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ? c : '_';
+	}
+	std::string manifestName = manifest.substr(manifest.find_last_of("/\\") + 1);
+	std::string out;
+	out += "/**\n";
+	out += "*Generated by AssetCooker -l from the shaders " + manifestName + " lists, don't edit: the game's\n";
+	out += "*build regenerates it from the compiled shaders before any C++ compiles.\n";
+	out += "*Constant buffers as the compiled shaders read them, HLSL's packing gaps written out as padding\n";
+	out += "*and every offset asserted. A cbuffer several shaders declare is the longest declaration.\n";
+	out += "*Vertex shader inputs as the vertex struct their signature asks for.\n";
+	out += "**/\n";
+	out += "#ifndef " + guard + "\n#define " + guard + "\n\n";
+	out += "#include <DirectXMath.h>\n#include <cstddef>\n#include <cstdint>\n\n";
+	for (size_t i = 0; i < buffers.size(); i++){
+		AppendConstantBuffer(buffers[i], users[i], out);
+	}
+	out += inputs;
+	out += "#endif\n";
+
+	std::vector<char> existing;
+	if (ReadWholeFile(header, existing) && std::string(existing.begin(), existing.end()) == out){
+		printf("%s: up to date\n", header.c_str());
+		return true;
+	}
+	FILE* file = fopen(header.c_str(), "wb");
+	if (!file){
+		printf("%s: can't write\n", header.c_str());
+		return false;
+	}
+	bool written = fwrite(out.c_str(), 1, out.size(), file) == out.size();
+	if (fclose(file) != 0 || !written){
+		printf("%s: can't write\n", header.c_str());
+		return false;
+	}
+	printf("%s: %u constant buffers, %u shaders\n", header.c_str(), (unsigned int)buffers.size(), (unsigned int)names.size());
+	return true;
+}
+
+static void PrintUsage(){
+	printf("Usage: AssetCooker [-f] [-t] [-s] [-q] [-b] [-c quality] [-j threads] [-l header] [-p triangles] [-k particles] <files>\n");
+	printf("   -f          cook even if the output is current\n");
+	printf("   -t          time loading the source against the cooked output, each\n");
+	printf("               texture quality serial and threaded\n");
+	printf("   -s          vertex cache stats, triangles and error per LOD, PSNR per mip\n");
+	printf("   -q          quantized vertices for the packed vertex shaders\n");
+	printf("   -b          BC7 for colour textures\n");
+	printf("   -c <level>  texture quality: fast, normal (default) or high\n");
+	printf("   -j <count>  worker threads\n");
+	printf("   -l <header> write a .pipeline's constant buffers and vertex inputs as C++\n");
+	printf("   -p <count>  benchmark the OBJ loader on a generated mesh of count triangles\n");
+	printf("   -k <count>  benchmark the CPU particle update on pools of count particles\n");
+	printf("Cooks .obj to .mesh, .png and .jpg to .dds, .atlas to .atlas.dds and .atlas.map,\n");
+	printf(".pipeline to .pipeline.pack\n");
+}
+
+int main(int argc, char* argv[]){
+	CookOptions options;
+	options.force = false;
+	options.timing = false;
+	options.stats = false;
+	options.quantize = false;
+	options.bc7 = false;
+	options.quality = BLOCK_QUALITY_NORMAL;
+	options.threads = ThreadPool::DefaultThreadCount();
+	options.layouts = nullptr;
+	options.benchmarkTriangles = 0;
+	options.benchmarkParticles = 0;
+
+	std::vector<std::string> files;
+	for (int i = 1; i < argc; i++){
+		if (strcmp(argv[i], "-f") == 0){
+			options.force = true;
+		}
+		else if (strcmp(argv[i], "-t") == 0){
+			options.timing = true;
+		}
+		else if (strcmp(argv[i], "-s") == 0){
+			options.stats = true;
+		}
+		else if (strcmp(argv[i], "-q") == 0){
+			options.quantize = true;
+		}
+		else if (strcmp(argv[i], "-b") == 0){
+			options.bc7 = true;
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc && strcmp(argv[i + 1], "fast") == 0){
+			options.quality = BLOCK_QUALITY_FAST;
+			i++;
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc && strcmp(argv[i + 1], "normal") == 0){
+			options.quality = BLOCK_QUALITY_NORMAL;
+			i++;
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc && strcmp(argv[i + 1], "high") == 0){
+			options.quality = BLOCK_QUALITY_HIGH;
+			i++;
+		}
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+			options.threads = (unsigned int)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc){
+			options.layouts = argv[++i];
+		}
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc){
+			options.benchmarkTriangles = (unsigned int)atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc){
+			options.benchmarkParticles = (unsigned int)atoi(argv[++i]);
+		}
+		else if (argv[i][0] == '-'){
+			PrintUsage();
+			return 1;
+		}
+		else{
+			files.push_back(argv[i]);
+		}
+	}
+	if (files.empty() && options.benchmarkTriangles == 0 && options.benchmarkParticles == 0){
+		PrintUsage();
+		return 1;
+	}
+
+	ThreadPool* pool = options.threads > 0 ? new ThreadPool(options.threads) : nullptr;
+	int failures = 0;
+	if (options.benchmarkTriangles > 0 && !BenchmarkObj(options.benchmarkTriangles)){
+		failures++;
+	}
+	if (options.benchmarkParticles > 0 && !BenchmarkParticles(options.benchmarkParticles)){
+		failures++;
+	}
+	for (size_t i = 0; i < files.size(); i++){
+		bool cooked = false;
+		if (HasExtension(files[i], ".obj")){
+			cooked = CookMesh(files[i], options, pool);
+		}
+		else if (HasExtension(files[i], ".png") || HasExtension(files[i], ".jpg") || HasExtension(files[i], ".jpeg")){
+			cooked = CookTexture(files[i], options, pool);
+		}
+		else if (HasExtension(files[i], ".atlas")){
+			cooked = CookAtlas(files[i], options, pool);
+		}
+		else if (HasExtension(files[i], ".pipeline")){
+			cooked = CookShaderPack(files[i], options);
+			if (cooked && options.layouts){
+				cooked = WriteShaderLayouts(files[i], options.layouts);
+			}
+		}
+		else{
+			printf("%s: unknown asset type\n", files[i].c_str());
+		}
+		if (!cooked){
+			failures++;
+		}
+	}
+	delete pool;
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,570 @@
+#include "AssetManager.h"
+#include "AssetStamp.h"
+#include "MappedFile.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "ObjParser.h"
+#include "TextureFile.h"
+#include "TextureImage.h"
+#include "AtlasFile.h"
+#include "WICTextureLoader.h"
+#include "DDSTextureLoader.h"
+#include "Global.h"
+#include <cstring>
+
+//True for a path to a DDS itself rather than a source image
+static bool IsDdsPath(const std::string& path){
+	const char* extension = TEXTURE_FILE_EXTENSION;
+	size_t length = strlen(extension);
+	if (path.size() < length){
+		return false;
+	}
+	for (size_t i = 0; i < length; i++){
+		char c = path[path.size() - length + i];
+		if ((c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c) != extension[i]){
+			return false;
+		}
+	}
+	return true;
+}
+
+//References held outside the cache, which owns exactly one
+template<typename TAsset>
+static unsigned int GetOutsideReferences(TAsset* asset){
+	asset->AddRef();
+	return asset->Release() - 1;
+}
+
+static size_t GetBitsPerPixel(DXGI_FORMAT format){
+	switch (format){
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		return 128;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT:
+	case DXGI_FORMAT_R16G16B16A16_UNORM:
+		return 64;
+	case DXGI_FORMAT_R8G8_UNORM:
+	case DXGI_FORMAT_R16_FLOAT:
+	case DXGI_FORMAT_R16_UNORM:
+	case DXGI_FORMAT_B5G6R5_UNORM:
+	case DXGI_FORMAT_B5G5R5A1_UNORM:
+		return 16;
+	case DXGI_FORMAT_R8_UNORM:
+	case DXGI_FORMAT_A8_UNORM:
+	case DXGI_FORMAT_BC2_UNORM:
+	case DXGI_FORMAT_BC2_UNORM_SRGB:
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC3_UNORM_SRGB:
+	case DXGI_FORMAT_BC5_UNORM:
+	case DXGI_FORMAT_BC5_SNORM:
+	case DXGI_FORMAT_BC6H_UF16:
+	case DXGI_FORMAT_BC6H_SF16:
+	case DXGI_FORMAT_BC7_UNORM:
+	case DXGI_FORMAT_BC7_UNORM_SRGB:
+		return 8;
+	case DXGI_FORMAT_BC1_UNORM:
+	case DXGI_FORMAT_BC1_UNORM_SRGB:
+	case DXGI_FORMAT_BC4_UNORM:
+	case DXGI_FORMAT_BC4_SNORM:
+		return 4;
+	default:
+		return 32;
+	}
+}
+
+//Every mip of every array slice, block compressed mips are rounded up to whole 4x4 blocks
+static size_t GetTextureBytes(ID3D11ShaderResourceView* view){
+	ID3D11Resource* resource = nullptr;
+	view->GetResource(&resource);
+	ID3D11Texture2D* texture = nullptr;
+	HRESULT hr = resource->QueryInterface(__uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&texture));
+	ReleaseMacro(resource);
+	if (FAILED(hr)){
+		return 0;
+	}
+
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+	ReleaseMacro(texture);
+
+	bool blockCompressed = (desc.Format >= DXGI_FORMAT_BC1_TYPELESS && desc.Format <= DXGI_FORMAT_BC5_SNORM) ||
+		(desc.Format >= DXGI_FORMAT_BC6H_TYPELESS && desc.Format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+	size_t bits = GetBitsPerPixel(desc.Format);
+	size_t bytes = 0;
+	UINT width = desc.Width;
+	UINT height = desc.Height;
+	for (UINT mip = 0; mip < desc.MipLevels; mip++){
+		size_t w = blockCompressed ? (width + 3) & ~3u : width;
+		size_t h = blockCompressed ? (height + 3) & ~3u : height;
+		bytes += w * h * bits / 8;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return bytes * desc.ArraySize;
+}
+
+//What a mesh load leaves for the upload, either a mapped cooked file or a parsed OBJ
+struct StreamedMesh{
+	MappedFile cooked;
+	MeshFileView view;
+	std::vector<Vertex2> vertices;
+	std::vector<UINT> indices;
+};
+
+//A mapped DDS, cooked or asked for by name, or a source image compressed on the load thread
+struct StreamedTexture{
+	MappedFile cooked;
+	TextureFileView view;
+	CompressedTexture compressed;
+};
+
+//Reads a byte from every page so the upload doesn't fault the mapping in on the main thread
+static void TouchPages(const char* data, size_t size){
+	volatile char sink = 0;
+	for (size_t i = 0; i < size; i += 4096){
+		sink += data[i];
+	}
+}
+
+static ID3D11ShaderResourceView* CreateMappedTexture(ID3D11Device* device, const TextureFileView& view){
+	std::vector<TextureFileLevel> levels;
+	GetTextureFileLevels(view, levels);
+	return CreateLevelTexture(device, view.format, &levels[0], (unsigned int)levels.size());
+}
+
+static ID3D11ShaderResourceView* CreateCompressedTexture(ID3D11Device* device, const CompressedTexture& compressed){
+	std::vector<TextureFileLevel> levels;
+	GetTextureLevels(compressed.format, compressed.width, compressed.height, compressed.mipCount, &compressed.data[0], levels);
+	return CreateLevelTexture(device, compressed.format, &levels[0], (unsigned int)levels.size());
+}
+
+AssetManager::AssetManager(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ThreadPool* loadThreads){
+	device = dev;
+	deviceContext = devCtx;
+	loader = new ObjectLoader(device);
+	streamer = new AssetStreamer(loadThreads, ASSET_UPLOAD_BUDGET);
+	textureMips = new TextureStreamer(device, ASSET_TEXTURE_MIP_BUDGET, ASSET_UPLOAD_BUDGET);
+	shaderCache = new ShaderCache(device);
+	meshBytes = 0;
+	textureBytes = 0;
+	loadCount = 0;
+}
+
+AssetManager::~AssetManager(void){
+	//cancels whatever is still loading, those loads only hold their own payload
+	if (streamer){
+		delete streamer;
+		streamer = nullptr;
+	}
+	if (textureMips){
+		delete textureMips;
+		textureMips = nullptr;
+	}
+	if (shaderCache){
+		delete shaderCache;
+		shaderCache = nullptr;
+	}
+	for (std::unordered_map<uint64_t, CachedMesh>::iterator it = meshes.begin(); it != meshes.end(); ++it){
+		ReleaseMacro(it->second.mesh);
+	}
+	for (std::unordered_map<uint64_t, CachedTexture>::iterator it = textures.begin(); it != textures.end(); ++it){
+		ReleaseMacro(it->second.view);
+	}
+	if (loader){
+		delete loader;
+		loader = nullptr;
+	}
+}
+
+Mesh* AssetManager::getMesh(const std::string& path){
+	std::string normalised = NormaliseAssetPath(path.c_str());
+	uint64_t key = HashAssetPath(normalised);
+
+	std::unordered_map<uint64_t, CachedMesh>::iterator found = meshes.find(key);
+	if (found != meshes.end() && found->second.path == normalised){
+		found->second.mesh->AddRef();
+		return found->second.mesh;
+	}
+
+	Mesh* mesh = loader->LoadModel(path);
+	if (!mesh){
+		return nullptr;
+	}
+	loadCount++;
+	//a different path with the same hash is loaded but not cached
+	if (found != meshes.end()){
+		return mesh;
+	}
+
+	cacheMesh(key, normalised, mesh);
+	mesh->AddRef();
+	return mesh;
+}
+
+ID3D11ShaderResourceView* AssetManager::getTexture(const wchar_t* path){
+	std::wstring normalised = NormaliseAssetPath(path);
+	uint64_t key = HashAssetPath(normalised);
+
+	std::unordered_map<uint64_t, CachedTexture>::iterator found = textures.find(key);
+	if (found != textures.end() && found->second.path == normalised){
+		found->second.view->AddRef();
+		return found->second.view;
+	}
+
+	//a current cooked DDS, or a block compressed one asked for by name, goes up from its mapping
+	ID3D11ShaderResourceView* view = nullptr;
+	std::string narrow = NarrowAssetPath(path);
+	bool dds = IsDdsPath(narrow);
+	MappedFile mapped;
+	TextureFileView mappedView;
+	if (dds ? OpenTextureFile(narrow, mapped, mappedView) : OpenCookedTexture(narrow, mapped, mappedView)){
+		view = CreateMappedTexture(device, mappedView);
+		mapped.close();
+	}
+	//DDS formats the mapped path doesn't read go through DirectXTK
+	if (!view && dds){
+		CreateDDSTextureFromFile(device, path, nullptr, &view);
+	}
+	if (!view && !dds){
+		CreateWICTextureFromFile(device, deviceContext, path, 0, &view, 0);
+	}
+	if (!view){
+		return nullptr;
+	}
+	loadCount++;
+	if (found != textures.end()){
+		return view;
+	}
+
+	cacheTexture(key, normalised, view);
+	view->AddRef();
+	return view;
+}
+
+StreamHandle AssetManager::streamMesh(const std::string& path){
+	std::string normalised = NormaliseAssetPath(path.c_str());
+	uint64_t key = HashAssetPath(normalised);
+	if (meshes.find(key) != meshes.end()){
+		return AssetStreamer::Completed();
+	}
+	std::unordered_map<uint64_t, StreamHandle>::iterator inFlight = meshStreams.find(key);
+	if (inFlight != meshStreams.end() && !inFlight->second->isFinished()){
+		return inFlight->second;
+	}
+
+	std::shared_ptr<StreamedMesh> payload = std::make_shared<StreamedMesh>();
+	StreamLoad load = [payload, path](size_t& uploadBytes) -> bool{
+		if (OpenCookedMesh(path, payload->cooked, payload->view)){
+			TouchPages(payload->cooked.data(), payload->cooked.size());
+			uploadBytes = (size_t)payload->view.header->vertexCount * payload->view.header->vertexStride + (size_t)payload->view.header->indexCount * payload->view.header->indexSize;
+			return true;
+		}
+		if (!LoadObj(path, payload->vertices, payload->indices) || payload->indices.empty()){
+			return false;
+		}
+		OptimizeMesh(payload->vertices, payload->indices, false);
+		uploadBytes = payload->vertices.size() * sizeof(Vertex2) + payload->indices.size() * sizeof(UINT);
+		return true;
+	};
+	StreamUpload upload = [this, payload, key, normalised]() -> bool{
+		meshStreams.erase(key);
+		if (meshes.find(key) != meshes.end()){
+			return true; // a get beat the stream to it
+		}
+		Mesh* mesh;
+		if (payload->cooked.isOpen()){
+			mesh = new Mesh(payload->view, device);
+		}
+		else{
+			mesh = new Mesh(&payload->vertices[0], payload->vertices.size(), &payload->indices[0], payload->indices.size(), device);
+		}
+		loadCount++;
+		cacheMesh(key, normalised, mesh);
+		return true;
+	};
+
+	StreamHandle handle = streamer->request(load, upload);
+	meshStreams[key] = handle;
+	return handle;
+}
+
+StreamHandle AssetManager::streamTexture(const wchar_t* path){
+	std::wstring normalised = NormaliseAssetPath(path);
+	uint64_t key = HashAssetPath(normalised);
+	if (textures.find(key) != textures.end() || regions.find(key) != regions.end()){
+		return AssetStreamer::Completed();
+	}
+	std::unordered_map<uint64_t, StreamHandle>::iterator inFlight = textureStreams.find(key);
+	if (inFlight != textureStreams.end() && !inFlight->second->isFinished()){
+		return inFlight->second;
+	}
+
+	std::shared_ptr<StreamedTexture> payload = std::make_shared<StreamedTexture>();
+	std::string file = NarrowAssetPath(path);
+	StreamLoad load = [payload, file](size_t& uploadBytes) -> bool{
+		if (IsDdsPath(file) ? OpenTextureFile(file, payload->cooked, payload->view) : OpenCookedTexture(file, payload->cooked, payload->view)){
+			TouchPages(payload->cooked.data(), payload->cooked.size());
+			uploadBytes = payload->view.dataSize;
+			return true;
+		}
+		//not cooked: the fast tier keeps this to tens of milliseconds for a 1024 texture, and the
+		//load already runs on a pool thread, so the blocks are compressed here serially
+		TextureImage image;
+		if (!LoadTextureImage(file, image)){
+			return false;
+		}
+		TextureEncoding encoding = ChooseTextureEncoding(file);
+		uint32_t format = ChooseTextureFormat(file, encoding == TEXTURE_SRGB && HasTextureAlpha(image), false);
+		CompressTexture(image, encoding, format, BLOCK_QUALITY_FAST, nullptr, payload->compressed);
+		uploadBytes = payload->compressed.data.size();
+		return true;
+	};
+	StreamUpload upload = [this, payload, key, normalised]() -> bool{
+		textureStreams.erase(key);
+		if (textures.find(key) != textures.end()){
+			return true;
+		}
+		ID3D11ShaderResourceView* view = nullptr;
+		if (payload->cooked.isOpen()){
+			view = CreateMappedTexture(device, payload->view);
+			payload->cooked.close();
+		}
+		else{
+			view = CreateCompressedTexture(device, payload->compressed);
+		}
+		if (!view){
+			return false;
+		}
+		loadCount++;
+		cacheTexture(key, normalised, view);
+		return true;
+	};
+
+	StreamHandle handle = streamer->request(load, upload);
+	textureStreams[key] = handle;
+	return handle;
+}
+
+bool AssetManager::cancelStream(const StreamHandle& handle){
+	std::unordered_map<uint64_t, StreamHandle>* inFlight[] = { &meshStreams, &textureStreams };
+	for (int i = 0; i < 2; i++){
+		for (std::unordered_map<uint64_t, StreamHandle>::iterator it = inFlight[i]->begin(); it != inFlight[i]->end(); ++it){
+			if (it->second == handle){
+				inFlight[i]->erase(it);
+				break;
+			}
+		}
+	}
+	return streamer->cancel(handle);
+}
+
+unsigned int AssetManager::pumpUploads(){
+	textureMips->update();
+	return streamer->pump();
+}
+
+void AssetManager::getStreamedTexture(const wchar_t* path, ID3D11ShaderResourceView** slot){
+	std::wstring normalised = NormaliseAssetPath(path);
+	if (!textureMips->track(NarrowAssetPath(normalised.c_str()), slot)){
+		ID3D11ShaderResourceView* view = getTexture(path);
+		ReleaseMacro((*slot));
+		*slot = view;
+	}
+}
+
+void AssetManager::releaseStreamedTexture(ID3D11ShaderResourceView** slot){
+	textureMips->untrack(slot);
+}
+
+void AssetManager::requestTextureMips(ID3D11ShaderResourceView* const* slot, float screenPixels){
+	textureMips->request(slot, screenPixels);
+}
+
+void AssetManager::setTextureMipBudget(size_t bytes){
+	textureMips->setBudget(bytes);
+}
+
+size_t AssetManager::getStreamedTextureBytes(){
+	return textureMips->getResidentBytes();
+}
+
+bool AssetManager::isStreaming(){
+	return streamer->getPendingCount() > 0;
+}
+
+void AssetManager::cacheMesh(uint64_t key, const std::string& normalised, Mesh* mesh){
+	CachedMesh cached;
+	cached.path = normalised;
+	cached.mesh = mesh;
+	cached.bytes = (size_t)mesh->m_vertexCount * mesh->sizeofvertex + (size_t)mesh->m_size * mesh->sizeofindex;
+	meshes[key] = cached;
+	meshBytes += cached.bytes;
+}
+
+bool AssetManager::loadAtlas(const wchar_t* manifestPath){
+	std::string manifest = NarrowAssetPath(manifestPath);
+	MappedFile mapped;
+	AtlasFileView view;
+	if (!OpenCookedAtlas(manifest, mapped, view)){
+		return false;
+	}
+	//not a source image, so this only finds the cooked DDS
+	ID3D11ShaderResourceView* atlas = getTexture(manifestPath);
+	if (!atlas){
+		return false;
+	}
+	uint64_t atlasKey = HashAssetPath(NormaliseAssetPath(manifestPath));
+
+	for (uint32_t i = 0; i < view.header->spriteCount; i++){
+		const AtlasFileSprite& sprite = view.sprites[i];
+		std::string path = GetManifestSourcePath(manifest, sprite.name);
+		AtlasRegion region;
+		region.path = NormaliseAssetPath(std::wstring(path.begin(), path.end()).c_str());
+		region.atlas = atlasKey;
+		region.uvTransform = XMFLOAT4(sprite.uvScale[0], sprite.uvScale[1], sprite.uvOffset[0], sprite.uvOffset[1]);
+		region.sourceRect.left = sprite.x;
+		region.sourceRect.top = sprite.y;
+		region.sourceRect.right = sprite.x + sprite.width;
+		region.sourceRect.bottom = sprite.y + sprite.height;
+		regions[HashAssetPath(region.path)] = region;
+	}
+	ReleaseMacro(atlas);
+	return true;
+}
+
+bool AssetManager::getTextureRegion(const wchar_t* path, TextureRegion& region){
+	std::wstring normalised = NormaliseAssetPath(path);
+	std::unordered_map<uint64_t, AtlasRegion>::iterator found = regions.find(HashAssetPath(normalised));
+	if (found == regions.end() || found->second.path != normalised){
+		return false;
+	}
+	//gone if the atlas was unloaded
+	std::unordered_map<uint64_t, CachedTexture>::iterator atlas = textures.find(found->second.atlas);
+	if (atlas == textures.end()){
+		regions.erase(found);
+		return false;
+	}
+	atlas->second.view->AddRef();
+	region.view = atlas->second.view;
+	region.uvTransform = found->second.uvTransform;
+	region.sourceRect = found->second.sourceRect;
+	return true;
+}
+
+void AssetManager::cacheTexture(uint64_t key, const std::wstring& normalised, ID3D11ShaderResourceView* view){
+	CachedTexture cached;
+	cached.path = normalised;
+	cached.view = view;
+	cached.bytes = GetTextureBytes(view);
+	textures[key] = cached;
+	textureBytes += cached.bytes;
+}
+
+bool AssetManager::loadShaderPack(const wchar_t* manifestPath){
+	return shaderCache->loadPack(NarrowAssetPath(manifestPath));
+}
+
+ShaderProgram* AssetManager::getShaderProgram(const wchar_t* vsPath, const wchar_t* psPath, const std::vector<ConstantBuffer*>& constantBufferList){
+	return shaderCache->getProgram(NarrowAssetPath(vsPath), NarrowAssetPath(psPath), constantBufferList);
+}
+
+ShaderProgram* AssetManager::getShaderProgram(const wchar_t* vsPath, const wchar_t* psPath, const std::vector<ConstantBuffer*>& constantBufferList, const MeshFileElement* layout, uint32_t layoutCount){
+	return shaderCache->getProgram(NarrowAssetPath(vsPath), NarrowAssetPath(psPath), constantBufferList, layout, layoutCount);
+}
+
+ShaderProgram* AssetManager::getShaderProgram(const wchar_t* vsPath, const wchar_t* psPath, const wchar_t* gsPath, const wchar_t* soPath, const std::vector<ConstantBuffer*>& constantBufferList){
+	return shaderCache->getProgram(NarrowAssetPath(vsPath), NarrowAssetPath(psPath), NarrowAssetPath(gsPath), NarrowAssetPath(soPath), constantBufferList);
+}
+
+ShaderProgram* AssetManager::getMeshShaderProgram(uint32_t features, const std::vector<ConstantBuffer*>& constantBufferList){
+	if (features & MESH_SHADER_PACKED){
+		uint32_t layoutCount;
+		const MeshFileElement* layout = GetPackedVertex2Layout(layoutCount);
+		return shaderCache->getProgram(GetMeshVertexShaderName(features), GetMeshPixelShaderName(features), constantBufferList, layout, layoutCount);
+	}
+	return shaderCache->getProgram(GetMeshVertexShaderName(features), GetMeshPixelShaderName(features), constantBufferList);
+}
+
+ShaderProgram* AssetManager::getPostProcessShaderProgram(PostProcessEffect effect, const std::vector<ConstantBuffer*>& constantBufferList){
+	return shaderCache->getProgram("PostProcessVertexShader.cso", GetPostProcessPixelShaderName(effect), constantBufferList);
+}
+
+bool AssetManager::unloadMesh(const std::string& path){
+	std::string normalised = NormaliseAssetPath(path.c_str());
+	std::unordered_map<uint64_t, CachedMesh>::iterator found = meshes.find(HashAssetPath(normalised));
+	if (found == meshes.end() || found->second.path != normalised){
+		return false;
+	}
+	meshBytes -= found->second.bytes;
+	ReleaseMacro(found->second.mesh);
+	meshes.erase(found);
+	return true;
+}
+
+bool AssetManager::unloadTexture(const wchar_t* path){
+	std::wstring normalised = NormaliseAssetPath(path);
+	std::unordered_map<uint64_t, CachedTexture>::iterator found = textures.find(HashAssetPath(normalised));
+	if (found == textures.end() || found->second.path != normalised){
+		return false;
+	}
+	textureBytes -= found->second.bytes;
+	ReleaseMacro(found->second.view);
+	textures.erase(found);
+	return true;
+}
+
+unsigned int AssetManager::unloadUnused(){
+	unsigned int unloaded = 0;
+	for (std::unordered_map<uint64_t, CachedMesh>::iterator it = meshes.begin(); it != meshes.end();){
+		if (GetOutsideReferences(it->second.mesh) == 0){
+			meshBytes -= it->second.bytes;
+			ReleaseMacro(it->second.mesh);
+			it = meshes.erase(it);
+			unloaded++;
+		}
+		else{
+			++it;
+		}
+	}
+	for (std::unordered_map<uint64_t, CachedTexture>::iterator it = textures.begin(); it != textures.end();){
+		if (GetOutsideReferences(it->second.view) == 0){
+			textureBytes -= it->second.bytes;
+			ReleaseMacro(it->second.view);
+			it = textures.erase(it);
+			unloaded++;
+		}
+		else{
+			++it;
+		}
+	}
+	return unloaded;
+}
+
+size_t AssetManager::getMeshBytes(){
+	return meshBytes;
+}
+
+size_t AssetManager::getTextureBytes(){
+	return textureBytes;
+}
+
+unsigned int AssetManager::getLoadCount(){
+	return loadCount;
+}
+
+void AssetManager::getUsage(std::vector<AssetUsage>& usage){
+	usage.clear();
+	for (std::unordered_map<uint64_t, CachedMesh>::iterator it = meshes.begin(); it != meshes.end(); ++it){
+		AssetUsage row;
+		row.path = std::wstring(it->second.path.begin(), it->second.path.end());
+		row.bytes = it->second.bytes;
+		row.references = GetOutsideReferences(it->second.mesh);
+		usage.push_back(row);
+	}
+	for (std::unordered_map<uint64_t, CachedTexture>::iterator it = textures.begin(); it != textures.end(); ++it){
+		AssetUsage row;
+		row.path = it->second.path;
+		row.bytes = it->second.bytes;
+		row.references = GetOutsideReferences(it->second.view);
+		usage.push_back(row);
+	}
+}
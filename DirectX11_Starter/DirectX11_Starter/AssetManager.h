@@ -0,0 +1,151 @@
+#ifndef _ASSETMANAGER_H
+#define _ASSETMANAGER_H
+
+#include <d3d11.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Mesh.h"
+#include "ObjectLoader.h"
+#include "AssetStreamer.h"
+#include "TextureStreamer.h"
+#include "ShaderCache.h"
+#include "ShaderPermutation.h"
+
+//Bytes of meshes and textures uploaded per pumpUploads call
+#define ASSET_UPLOAD_BUDGET (4 * 1024 * 1024)
+//GPU memory the levels of textures streamed by mip may take, their tails included
+#define ASSET_TEXTURE_MIP_BUDGET (16 * 1024 * 1024)
+
+//One row of AssetManager::getUsage
+struct AssetUsage{
+	std::wstring path;
+	size_t bytes; // GPU memory estimate
+	unsigned int references; // held outside the cache
+};
+
+//Where a texture packed into an atlas ended up
+struct TextureRegion{
+	ID3D11ShaderResourceView* view; // the whole atlas, a new reference like getTexture's
+	XMFLOAT4 uvTransform; // uv * xy + zw takes the texture's [0, 1] to its rectangle in the atlas
+	RECT sourceRect; // the same rectangle in texels, for SpriteBatch::Draw
+};
+
+/**
+*Loads each mesh and texture once and hands out shared references to it.
+*Assets are keyed by a hash of their normalised path. Every get returns a new reference that
+*the caller releases (ReleaseMacro), the cache keeps one of its own until the asset is unloaded.
+*stream* reads and decodes on the load threads instead and the asset is created on the main thread
+*by pumpUploads; once the handle is done the matching get is a cache hit.
+*getStreamedTexture is the other kind of streaming: a cooked texture starts with only its small
+*mips and gains finer ones as draws ask for them with requestTextureMips, within
+*ASSET_TEXTURE_MIP_BUDGET (see TextureResidency). Those aren't in the cache.
+*loadAtlas makes the textures a cooked atlas packs available as regions of it (see AtlasFile),
+*so draws that used to switch between them keep one view bound; the atlas itself is cached
+*under the manifest's name.
+*Shader programs come through a ShaderCache: loadShaderPack maps the cooked shader pack and
+*getShaderProgram builds programs over shader objects and input layouts shared by bytecode.
+*Unlike meshes and textures the manager owns those programs, they aren't released or deleted.
+**/
+class AssetManager{
+public:
+	AssetManager(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ThreadPool* loadThreads = nullptr);
+	~AssetManager(void);
+
+	Mesh* getMesh(const std::string& path);
+	ID3D11ShaderResourceView* getTexture(const wchar_t* path);
+
+	//Repeated requests for an asset that is cached or still in flight share one handle
+	StreamHandle streamMesh(const std::string& path);
+	StreamHandle streamTexture(const wchar_t* path);
+	bool cancelStream(const StreamHandle& handle);
+	//Call once a frame on the main thread, returns how many assets were created. Also moves
+	//streamed texture mips
+	unsigned int pumpUploads();
+	bool isStreaming();
+
+	//Puts a reference to path's texture in *slot (releasing what was there) like getTexture, but a
+	//cooked one comes with only its tail mips and *slot is swapped to finer or coarser levels as
+	//they come and go. *slot has to stay where it is until releaseStreamedTexture
+	void getStreamedTexture(const wchar_t* path, ID3D11ShaderResourceView** slot);
+	//Stops swapping *slot, which keeps its reference for the caller to release
+	void releaseStreamedTexture(ID3D11ShaderResourceView** slot);
+	//Pixels on screen a draw stretched the slot's whole texture over this frame
+	void requestTextureMips(ID3D11ShaderResourceView* const* slot, float screenPixels);
+	void setTextureMipBudget(size_t bytes);
+	size_t getStreamedTextureBytes();
+
+	//Maps the cooked atlas for a manifest and registers every texture in it, false unless the
+	//cooked files are current. Loaded atlases aren't streamed: streamTexture on their textures is done
+	bool loadAtlas(const wchar_t* manifestPath);
+	//False if path isn't in a loaded atlas, then getTexture is the way to it
+	bool getTextureRegion(const wchar_t* path, TextureRegion& region);
+
+	//Maps the cooked pack for a .pipeline manifest, false unless it is current; shaders it
+	//doesn't have are still read from their .cso files
+	bool loadShaderPack(const wchar_t* manifestPath);
+	ShaderProgram* getShaderProgram(const wchar_t* vsPath, const wchar_t* psPath, const std::vector<ConstantBuffer*>& constantBufferList);
+	//Input layout from a cooked vertex layout instead of the vertex shader's signature
+	ShaderProgram* getShaderProgram(const wchar_t* vsPath, const wchar_t* psPath, const std::vector<ConstantBuffer*>& constantBufferList, const MeshFileElement* layout, uint32_t layoutCount);
+	//Particles: gsPath draws, soPath is created with stream output
+	ShaderProgram* getShaderProgram(const wchar_t* vsPath, const wchar_t* psPath, const wchar_t* gsPath, const wchar_t* soPath, const std::vector<ConstantBuffer*>& constantBufferList);
+	//The mesh shader permutation for a mask of MeshShaderFeatures, with the packed layout if it has MESH_SHADER_PACKED
+	ShaderProgram* getMeshShaderProgram(uint32_t features, const std::vector<ConstantBuffer*>& constantBufferList);
+	//A fullscreen pass computing one effect
+	ShaderProgram* getPostProcessShaderProgram(PostProcessEffect effect, const std::vector<ConstantBuffer*>& constantBufferList);
+
+	//Drops the cache's reference, the asset is freed once its last user releases it
+	bool unloadMesh(const std::string& path);
+	bool unloadTexture(const wchar_t* path);
+	//Unloads every asset nothing outside the cache references, returns how many
+	unsigned int unloadUnused();
+
+	size_t getMeshBytes();
+	size_t getTextureBytes();
+	unsigned int getLoadCount(); // loads that actually went to disk
+	void getUsage(std::vector<AssetUsage>& usage);
+
+private:
+	struct CachedMesh{
+		std::string path;
+		Mesh* mesh;
+		size_t bytes;
+	};
+	struct CachedTexture{
+		std::wstring path;
+		ID3D11ShaderResourceView* view;
+		size_t bytes;
+	};
+
+	struct AtlasRegion{
+		std::wstring path;
+		uint64_t atlas; // the atlas' key in textures
+		XMFLOAT4 uvTransform;
+		RECT sourceRect;
+	};
+
+	void cacheMesh(uint64_t key, const std::string& normalised, Mesh* mesh);
+	void cacheTexture(uint64_t key, const std::wstring& normalised, ID3D11ShaderResourceView* view);
+
+	ID3D11Device* device;
+	ID3D11DeviceContext* deviceContext;
+	ObjectLoader* loader;
+	std::unordered_map<uint64_t, CachedMesh> meshes;
+	std::unordered_map<uint64_t, CachedTexture> textures;
+	std::unordered_map<uint64_t, AtlasRegion> regions; // by the key the texture would have on its own
+	AssetStreamer* streamer;
+	std::unordered_map<uint64_t, StreamHandle> meshStreams; // in flight
+	std::unordered_map<uint64_t, StreamHandle> textureStreams;
+	TextureStreamer* textureMips;
+	ShaderCache* shaderCache;
+	size_t meshBytes;
+	size_t textureBytes;
+	unsigned int loadCount;
+
+	// Prevent copying.
+	AssetManager(AssetManager const&);
+	AssetManager& operator= (AssetManager const&);
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "AssetStamp.h"
+#include "MappedFile.h"
+#include <cstdio>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+uint64_t HashAssetBytes(const void* data, size_t size){
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; i++){
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+std::string NarrowAssetPath(const wchar_t* path){
+	std::string narrow;
+	for (; *path; path++){
+		narrow += (char)*path;
+	}
+	return narrow;
+}
+
+#ifdef _WIN32
+bool StatAsset(const std::string& path, uint64_t& size, uint64_t& time){
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &attributes)){
+		return false;
+	}
+	size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	time = ((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	//rebased to 1970 so a stamp cooked on one platform still matches on the other
+	time -= ASSET_TIME_FILETIME_OFFSET;
+	return true;
+}
+#else
+bool StatAsset(const std::string& path, uint64_t& size, uint64_t& time){
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0){
+		return false;
+	}
+	size = (uint64_t)info.st_size;
+	time = (uint64_t)info.st_mtim.tv_sec * ASSET_TIME_TICKS_PER_SECOND + (uint64_t)info.st_mtim.tv_nsec / 100;
+	return true;
+}
+#endif
+
+bool StampAsset(const std::string& path, AssetStamp& stamp){
+	if (!StatAsset(path, stamp.size, stamp.time)){
+		return false;
+	}
+	MappedFile mapped;
+	if (!mapped.open(path)){
+		return false;
+	}
+	stamp.hash = HashAssetBytes(mapped.data(), mapped.size());
+	return true;
+}
+
+bool IsAssetCurrent(const std::string& sourcePath, const AssetStamp& cooked, AssetStamp& current){
+	//the hash only changes below if the source is read
+	current = cooked;
+	if (!StatAsset(sourcePath, current.size, current.time)){
+		current = cooked;
+		return true;
+	}
+	if (current.size != cooked.size){
+		return false;
+	}
+	if (current.time == cooked.time){
+		return true;
+	}
+
+	MappedFile mapped;
+	if (!mapped.open(sourcePath)){
+		return false;
+	}
+	current.hash = HashAssetBytes(mapped.data(), mapped.size());
+	return current.hash == cooked.hash;
+}
+
+bool RewriteAssetStamp(const std::string& cookedPath, size_t stampOffset, const AssetStamp& stamp){
+	FILE* file = fopen(cookedPath.c_str(), "r+b");
+	if (!file){
+		return false;
+	}
+	bool written = fseek(file, (long)stampOffset, SEEK_SET) == 0 && fwrite(&stamp, sizeof(stamp), 1, file) == 1;
+	return fclose(file) == 0 && written;
+}
+
+bool IsCookedAssetCurrent(const std::string& sourcePath, const AssetStamp& cooked, const std::string& cookedPath, size_t stampOffset){
+	AssetStamp current;
+	if (!IsAssetCurrent(sourcePath, cooked, current)){
+		return false;
+	}
+	if (current.time != cooked.time){
+		RewriteAssetStamp(cookedPath, stampOffset, current);
+	}
+	return true;
+}
+
+bool ReadAssetManifest(const std::string& path, std::vector<std::string>& sources){
+	sources.clear();
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file){
+		return false;
+	}
+	char line[512];
+	while (fgets(line, sizeof(line), file)){
+		std::string name(line);
+		size_t first = name.find_first_not_of(" \t\r\n");
+		if (first == std::string::npos || name[first] == '#'){
+			continue;
+		}
+		size_t last = name.find_last_not_of(" \t\r\n");
+		sources.push_back(name.substr(first, last - first + 1));
+	}
+	fclose(file);
+	return true;
+}
+
+std::string GetManifestSourcePath(const std::string& manifestPath, const std::string& name){
+	size_t slash = manifestPath.find_last_of("/\\");
+	if (slash == std::string::npos){
+		return name;
+	}
+	return manifestPath.substr(0, slash + 1) + name;
+}
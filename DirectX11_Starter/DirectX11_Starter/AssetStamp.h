@@ -0,0 +1,83 @@
+#ifndef _ASSETSTAMP_H
+#define _ASSETSTAMP_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+//What a cooked asset remembers about the source file it was built from
+struct AssetStamp{
+	uint64_t size;
+	uint64_t time; // last write time, 100ns ticks since 1970 UTC on every platform
+	uint64_t hash; // HashAssetBytes of the whole source
+};
+
+//64-bit FNV-1a
+uint64_t HashAssetBytes(const void* data, size_t size);
+
+//Case and separator insensitive, so "Foo/bar.png" and "foo\BAR.PNG" share an entry
+template<typename TChar>
+std::basic_string<TChar> NormaliseAssetPath(const TChar* path){
+	std::basic_string<TChar> normalised(path);
+	for (size_t i = 0; i < normalised.size(); i++){
+		if (normalised[i] >= 'A' && normalised[i] <= 'Z'){
+			normalised[i] = normalised[i] - 'A' + 'a';
+		}
+		else if (normalised[i] == '/'){
+			normalised[i] = '\\';
+		}
+	}
+	return normalised;
+}
+
+//Key for a normalised path
+template<typename TChar>
+uint64_t HashAssetPath(const std::basic_string<TChar>& normalised){
+	return HashAssetBytes(normalised.data(), normalised.size() * sizeof(TChar));
+}
+
+//Asset names are plain ASCII, the file helpers take narrow paths
+std::string NarrowAssetPath(const wchar_t* path);
+
+#define ASSET_TIME_TICKS_PER_SECOND 10000000ULL
+#define ASSET_TIME_FILETIME_OFFSET 116444736000000000ULL // FILETIME ticks from 1601 to 1970
+
+//Size and last write time only; false if the file doesn't exist
+bool StatAsset(const std::string& path, uint64_t& size, uint64_t& time);
+
+//Size, time and content hash of a source file
+bool StampAsset(const std::string& path, AssetStamp& stamp);
+
+/**
+*True if a cooked asset built from this stamp can still be used.
+*Matching size and time is enough. If only the time moved the source is hashed, so a touched
+*but unchanged file doesn't force a recook. A missing source counts as current, which lets a
+*build ship cooked files alone.
+*current gets the stamp the source has now, cooked's own when the source is missing. When it is
+*current but its time differs from cooked's, the stamp in the cooked file is stale and every
+*check hashes the source again until it is rewritten.
+**/
+bool IsAssetCurrent(const std::string& sourcePath, const AssetStamp& cooked, AssetStamp& current);
+
+//Overwrites the stamp stampOffset bytes into a cooked file, false if it can't be written
+bool RewriteAssetStamp(const std::string& cookedPath, size_t stampOffset, const AssetStamp& stamp);
+
+/**
+*IsAssetCurrent for a stamp read from cookedPath, stampOffset bytes in. A stale stamp is
+*rewritten in place so the next check is a stat again; failing to write it doesn't make the
+*asset any less current.
+**/
+bool IsCookedAssetCurrent(const std::string& sourcePath, const AssetStamp& cooked, const std::string& cookedPath, size_t stampOffset);
+
+/**
+*A manifest is a text file naming one source per line, relative to the manifest's folder;
+*blank lines and lines starting with # are skipped. Returns the lines trimmed, false if the
+*file can't be read
+**/
+bool ReadAssetManifest(const std::string& path, std::vector<std::string>& sources);
+
+//name relative to the folder the manifest is in
+std::string GetManifestSourcePath(const std::string& manifestPath, const std::string& name);
+
+#endif
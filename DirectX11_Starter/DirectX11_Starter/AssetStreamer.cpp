@@ -0,0 +1,136 @@
+#include "AssetStreamer.h"
+
+StreamState StreamRequest::getState(){
+	return (StreamState)state.load();
+}
+
+bool StreamRequest::isFinished(){
+	int current = state.load();
+	return current == STREAM_DONE || current == STREAM_FAILED || current == STREAM_CANCELLED;
+}
+
+size_t StreamRequest::getUploadBytes(){
+	return uploadBytes;
+}
+
+AssetStreamer::AssetStreamer(ThreadPool* pool, size_t uploadBudget){
+	threads = pool;
+	budget = uploadBudget;
+	lastPumpBytes = 0;
+}
+
+AssetStreamer::~AssetStreamer(void){
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < pending.size(); i++){
+		int expected = pending[i]->state.load();
+		while (expected != STREAM_DONE && expected != STREAM_FAILED && expected != STREAM_CANCELLED &&
+			!pending[i]->state.compare_exchange_weak(expected, STREAM_CANCELLED)){
+		}
+		pending[i]->upload = nullptr;
+	}
+	pending.clear();
+}
+
+//The worker only ever moves QUEUED -> LOADING -> LOADED/FAILED, so a cancel in between wins
+void AssetStreamer::Load(StreamHandle request){
+	int expected = STREAM_QUEUED;
+	if (!request->state.compare_exchange_strong(expected, STREAM_LOADING)){
+		return;
+	}
+
+	size_t bytes = 0;
+	bool loaded = request->load(bytes);
+	request->load = nullptr;
+	request->uploadBytes = bytes;
+
+	expected = STREAM_LOADING;
+	request->state.compare_exchange_strong(expected, loaded ? STREAM_LOADED : STREAM_FAILED);
+}
+
+StreamHandle AssetStreamer::request(StreamLoad load, StreamUpload upload){
+	StreamHandle handle = std::make_shared<StreamRequest>();
+	handle->state = STREAM_QUEUED;
+	handle->uploadBytes = 0;
+	handle->load = load;
+	handle->upload = upload;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.push_back(handle);
+	}
+
+	if (threads){
+		threads->submit([handle](){ Load(handle); });
+	}
+	else{
+		Load(handle);
+	}
+	return handle;
+}
+
+bool AssetStreamer::cancel(const StreamHandle& handle){
+	int expected = handle->state.load();
+	while (expected == STREAM_QUEUED || expected == STREAM_LOADING || expected == STREAM_LOADED){
+		if (handle->state.compare_exchange_weak(expected, STREAM_CANCELLED)){
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned int AssetStreamer::pump(){
+	unsigned int uploaded = 0;
+	size_t spent = 0;
+	while (true){
+		StreamHandle front;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			//finished requests leave the queue whatever their position, so they can't hold it up
+			while (!pending.empty() && pending.front()->isFinished()){
+				pending.front()->upload = nullptr;
+				pending.pop_front();
+			}
+			if (pending.empty() || pending.front()->state.load() != STREAM_LOADED){
+				break;
+			}
+			if (uploaded > 0 && spent + pending.front()->uploadBytes > budget){
+				break;
+			}
+			front = pending.front();
+			pending.pop_front();
+		}
+
+		bool ok = front->upload();
+		front->upload = nullptr;
+		front->state = ok ? STREAM_DONE : STREAM_FAILED;
+		spent += front->uploadBytes;
+		uploaded++;
+	}
+	lastPumpBytes = spent;
+	return uploaded;
+}
+
+size_t AssetStreamer::getPendingCount(){
+	std::lock_guard<std::mutex> lock(mutex);
+	size_t count = 0;
+	for (size_t i = 0; i < pending.size(); i++){
+		if (!pending[i]->isFinished()){
+			count++;
+		}
+	}
+	return count;
+}
+
+size_t AssetStreamer::getLastPumpBytes(){
+	return lastPumpBytes;
+}
+
+void AssetStreamer::setUploadBudget(size_t bytes){
+	budget = bytes;
+}
+
+StreamHandle AssetStreamer::Completed(){
+	StreamHandle handle = std::make_shared<StreamRequest>();
+	handle->state = STREAM_DONE;
+	handle->uploadBytes = 0;
+	return handle;
+}
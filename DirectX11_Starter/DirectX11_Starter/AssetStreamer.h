@@ -0,0 +1,80 @@
+#ifndef _ASSETSTREAMER_H
+#define _ASSETSTREAMER_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <cstddef>
+#include "ThreadPool.h"
+
+enum StreamState{
+	STREAM_QUEUED,
+	STREAM_LOADING,
+	STREAM_LOADED, // waiting for its turn to upload
+	STREAM_DONE,
+	STREAM_FAILED,
+	STREAM_CANCELLED
+};
+
+//Load runs on a worker and reports how many bytes the upload will cost; upload runs on the main thread
+typedef std::function<bool(size_t& uploadBytes)> StreamLoad;
+typedef std::function<bool()> StreamUpload;
+
+//One request, shared by the caller's handle, the worker loading it and the upload queue
+class StreamRequest{
+public:
+	StreamState getState();
+	bool isFinished(); // done, failed or cancelled
+	size_t getUploadBytes();
+private:
+	friend class AssetStreamer;
+	std::atomic<int> state;
+	size_t uploadBytes;
+	StreamLoad load;
+	StreamUpload upload;
+};
+
+typedef std::shared_ptr<StreamRequest> StreamHandle;
+
+/**
+*Loads on a thread pool, uploads on the main thread.
+*Loads run in any order, but pump() uploads strictly in request order so a later asset never
+*shows up before an earlier one, and it stops once the frame's byte budget is spent (at least one
+*upload always goes through, so an asset bigger than the budget can't stall the queue).
+*request, cancel and pump are main thread calls. Loads must not touch the device context.
+**/
+class AssetStreamer{
+public:
+	AssetStreamer(ThreadPool* pool, size_t uploadBudget);
+	~AssetStreamer(void); // cancels everything still queued
+
+	StreamHandle request(StreamLoad load, StreamUpload upload);
+	//False if the request already finished. A load that is running completes but is thrown away
+	bool cancel(const StreamHandle& handle);
+	//Uploads what it can within the budget, returns how many requests finished uploading
+	unsigned int pump();
+
+	size_t getPendingCount(); // requests not uploaded, failed or cancelled yet
+	size_t getLastPumpBytes();
+	void setUploadBudget(size_t bytes);
+
+	//A handle that is already done, for assets that needed no loading
+	static StreamHandle Completed();
+
+private:
+	static void Load(StreamHandle request);
+
+	ThreadPool* threads;
+	size_t budget;
+	size_t lastPumpBytes;
+	std::deque<StreamHandle> pending;
+	std::mutex mutex;
+
+	// Prevent copying.
+	AssetStreamer(AssetStreamer const&);
+	AssetStreamer& operator= (AssetStreamer const&);
+};
+
+#endif
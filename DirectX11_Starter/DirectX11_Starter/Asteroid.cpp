@@ -2,7 +2,7 @@
 #include "Game.h"
 
 //Constructor for Asteroid object
-Asteroid::Asteroid(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed){
+Asteroid::Asteroid(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed){
 
 	//set up the lighting parameters
 	lighting.ambientColor = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
@@ -14,8 +14,10 @@ Asteroid::Asteroid(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<Consta
 	device = dev;
 	deviceContext = devCtx;
 	sampler = samplerState;
-	shaderProgram = new ShaderProgram(L"NewNormalVertexShader.cso", L"NewNormalPixelShader.cso", device, constantBufferList);
-	asteroidMaterial = new Material(device, deviceContext, sampler, L"asteroid.jpg", L"asteroid_norm.jpg", shaderProgram);
+	shaderProgram = assets->getMeshShaderProgram(MESH_SHADER_LIT | MESH_SHADER_NORMAL_MAP | (meshReference->quantized ? MESH_SHADER_PACKED : 0), constantBufferList);
+	//asteroids go from specks to filling the screen, so their textures stream by mip
+	asteroidMaterial = new Material(assets, sampler, L"asteroid.jpg", L"asteroid_norm.jpg", shaderProgram, true);
+	screenPixels = 0.0f;
 	player = playerReference;
 	mesh = meshReference;
 
@@ -41,15 +43,13 @@ Asteroid::~Asteroid(){
 		delete asteroidMaterial;
 		asteroidMaterial = nullptr;
 	}
-	if (shaderProgram){
-		delete shaderProgram;
-		shaderProgram = nullptr;
-	}
 }
 
 
 //Update asteroid positions each frame
 void Asteroid::update(float dt, StateManager *stateManager){
+	//the texture wraps all the way round, so it spans about twice the width seen from the front
+	asteroidMaterial->requestMips(screenPixels * 2.0f);
 
 	//make bounding boxes
 	BoundingBox *playerbb = new BoundingBox(XMFLOAT3(player->player->getPosition()._41, player->player->getPosition()._42, player->player->getPosition()._43),
@@ -126,22 +126,55 @@ void Asteroid::update(float dt, StateManager *stateManager){
 
 
 //draw asteroids
-void Asteroid::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos){
+void Asteroid::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context){
 	UINT offset = 0;
 	UINT stride = sizeof(Vertex);
 
+	//only submit what the camera can see
+	culler.setCamera(viewMatrix, projectionMatrix);
+	culler.clear();
 	for (unsigned int i = 0; i < asteroids.size(); i++){
+		XMFLOAT3 center;
+		float radius;
+		asteroids[i]->getBoundingSphere(center, radius);
+		culler.add(center, radius);
+	}
+	culler.cull();
+
+	//pick a level for each visible asteroid from its size on screen, then draw them grouped by level
+	D3D11_VIEWPORT viewport;
+	UINT viewportCount = 1;
+	context->RSGetViewports(&viewportCount, &viewport);
+	lodSelector.setCamera(viewMatrix, projectionMatrix, viewportCount > 0 ? viewport.Height : 0.0f);
+	lodSelector.clear();
+	float widest = 0.0f;
+	for (unsigned int v = 0; v < culler.getVisibleCount(); v++){
+		unsigned int i = culler.getVisible(v);
+		XMFLOAT3 center;
+		float radius;
+		asteroids[i]->getBoundingSphere(center, radius);
+		lodSelector.add(i, asteroids[i]->g_mesh, center, radius);
+		float size = lodSelector.getScreenSize(center, radius);
+		widest = size > widest ? size : widest;
+	}
+	screenPixels = widest;
+	lodSelector.group();
+
+	for (unsigned int v = 0; v < lodSelector.getCount(); v++){
+		unsigned int i = lodSelector.getEntity(v);
+		const MeshLod& level = asteroids[i]->g_mesh->lods[lodSelector.getLod(v)];
 		//UINT offset = 0;
 		stride = asteroids[i]->g_mesh->sizeofvertex;
 		// Set up the input assembler
-		deviceContext->IASetInputLayout(asteroids[i]->g_mat->shaderProgram->vsInputLayout);
-		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context->IASetInputLayout(asteroids[i]->g_mat->shaderProgram->vsInputLayout);
+		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 		//set values that get passed to matrix constant buffer
 
-		asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = asteroids[i]->getWorld();
+		asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = asteroids[i]->getDrawWorld();
 		asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
 		asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+		asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = asteroids[i]->g_mat->uvTransform;
 
 		//set values that get passed to lighting constant buffer
 		asteroids[i]->g_mat->shaderProgram->ConstantBuffers[1]->dataToSendToLightBuffer.ambientColor = lighting.ambientColor;
@@ -156,7 +189,7 @@ void Asteroid::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3
 
 
 		//matrix constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer,
 			0,
 			NULL,
@@ -165,7 +198,7 @@ void Asteroid::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3
 			0);
 
 		//camera constant buffer 
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			asteroids[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer,
 			0,
 			NULL,
@@ -173,7 +206,7 @@ void Asteroid::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3
 			0,
 			0);
 		//light constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			asteroids[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer,
 			0,
 			NULL,
@@ -181,26 +214,30 @@ void Asteroid::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3
 			0,
 			0);
 
-		deviceContext->IASetVertexBuffers(0, 1, &asteroids[i]->g_mesh->v_buffer, &stride, &offset);
-		deviceContext->IASetIndexBuffer(asteroids[i]->g_mesh->i_buffer, DXGI_FORMAT_R32_UINT, 0);
+		context->IASetVertexBuffers(0, 1, &asteroids[i]->g_mesh->v_buffer, &stride, &offset);
+		context->IASetIndexBuffer(asteroids[i]->g_mesh->i_buffer, asteroids[i]->g_mesh->indexFormat, 0);
 
-		deviceContext->PSSetSamplers(0, 1, &asteroids[i]->g_mat->samplerState);
-		deviceContext->PSSetShaderResources(0, 1, &asteroids[i]->g_mat->resourceView);
-		deviceContext->PSSetShaderResources(1, 1, &asteroids[1]->g_mat->resourceView2);
+		context->PSSetSamplers(0, 1, &asteroids[i]->g_mat->samplerState);
+		context->PSSetShaderResources(0, 1, &asteroids[i]->g_mat->resourceView);
+		context->PSSetShaderResources(1, 1, &asteroids[1]->g_mat->resourceView2);
 
 
 
 		// Set the current vertex and pixel shaders, as well the constant buffer for the vert shader
-		deviceContext->VSSetShader(asteroids[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
-		deviceContext->VSSetConstantBuffers(0, 1, &asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
-		deviceContext->VSSetConstantBuffers(1, 1, &asteroids[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
-		deviceContext->PSSetShader(asteroids[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
-		deviceContext->PSSetConstantBuffers(0, 1, &asteroids[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
+		context->VSSetShader(asteroids[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
+		context->VSSetConstantBuffers(0, 1, &asteroids[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
+		context->VSSetConstantBuffers(1, 1, &asteroids[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
+		context->PSSetShader(asteroids[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
+		context->PSSetConstantBuffers(0, 1, &asteroids[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
 
 		// Finally do the actual drawing
-		deviceContext->DrawIndexed(
-			asteroids.at(i)->g_mesh->m_size,	// The number of indices we're using in this draw
-			0,
+		context->DrawIndexed(
+			level.indexCount,	// The number of indices we're using in this draw
+			level.firstIndex,
 			0);
 	}
 }
+
+CullStats Asteroid::getCullStats(){
+	return culler.getStats();
+}
@@ -8,6 +8,7 @@
 #include "Mesh.h"
 #include "GameEntity.h"
 #include "Material.h"
+#include "AssetManager.h"
 #include "ShaderProgram.h"
 #include "SamplerState.h"
 #include "Global.h"
@@ -15,6 +16,8 @@
 #include "StateManager.h"
 #include "FW1FontWrapper.h"
 #include "Player.h"
+#include "FrustumCuller.h"
+#include "LodSelector.h"
 #include "StateManager.h"
 #include "SimpleMath.h"
 
@@ -24,19 +27,23 @@ using namespace DirectX;
 
 class Asteroid{
 public:
-	Asteroid(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed);
+	Asteroid(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed);
 	~Asteroid(void);
 	void update(float dt, StateManager *stateManager);
-	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos);
+	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context);
+	CullStats getCullStats(); // visible/culled counts from the last draw
 	GameEntity* getAsteroid();
 
 	// list of asteroids present in the game
 	std::vector<GameEntity*> asteroids;
 private:
+	FrustumCuller culler;
+	LodSelector lodSelector;
 	Player* player;
 	Mesh* mesh;
 	ShaderProgram* shaderProgram;
 	Material* asteroidMaterial;
+	float screenPixels; // widest asteroid on screen in the last draw, which may be recorded off the main thread
 	ID3D11SamplerState* sampler;
 	ID3D11Device* device;
 	ID3D11DeviceContext* deviceContext;
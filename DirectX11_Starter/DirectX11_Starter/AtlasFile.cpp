@@ -0,0 +1,77 @@
+#include "AtlasFile.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static_assert(sizeof(AtlasFileHeader) == 48, "AtlasFileHeader is read in place");
+static_assert(sizeof(AtlasFileSprite) == 120, "AtlasFileSprite is read in place");
+
+bool WriteAtlasFile(const std::string& path, uint32_t width, uint32_t height, const AtlasFileSprite* sprites, uint32_t spriteCount, const AssetStamp& source){
+	AtlasFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = ATLAS_FILE_MAGIC;
+	header.version = ATLAS_FILE_VERSION;
+	header.width = width;
+	header.height = height;
+	header.spriteCount = spriteCount;
+	header.source = source;
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file){
+		return false;
+	}
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	if (written && spriteCount){
+		written = fwrite(sprites, sizeof(AtlasFileSprite), spriteCount, file) == spriteCount;
+	}
+	return fclose(file) == 0 && written;
+}
+
+bool ReadAtlasFile(const char* data, size_t size, AtlasFileView& view){
+	if (!data || size < sizeof(AtlasFileHeader)){
+		return false;
+	}
+	const AtlasFileHeader* header = reinterpret_cast<const AtlasFileHeader*>(data);
+	if (header->magic != ATLAS_FILE_MAGIC || header->version != ATLAS_FILE_VERSION){
+		return false;
+	}
+	if (sizeof(AtlasFileHeader) + (uint64_t)header->spriteCount * sizeof(AtlasFileSprite) > size){
+		return false;
+	}
+	const AtlasFileSprite* sprites = reinterpret_cast<const AtlasFileSprite*>(data + sizeof(AtlasFileHeader));
+	for (uint32_t i = 0; i < header->spriteCount; i++){
+		if (memchr(sprites[i].name, 0, ATLAS_NAME_SIZE) == nullptr ||
+			(uint64_t)sprites[i].x + sprites[i].width > header->width || (uint64_t)sprites[i].y + sprites[i].height > header->height){
+			return false;
+		}
+	}
+
+	view.header = header;
+	view.sprites = sprites;
+	return true;
+}
+
+std::string GetCookedAtlasPath(const std::string& manifestPath){
+	return manifestPath + ATLAS_FILE_EXTENSION;
+}
+
+bool OpenCookedAtlas(const std::string& manifestPath, MappedFile& mapped, AtlasFileView& view){
+	std::string cookedPath = GetCookedAtlasPath(manifestPath);
+	if (!mapped.open(cookedPath)){
+		return false;
+	}
+	if (!ReadAtlasFile(mapped.data(), mapped.size(), view) ||
+		!IsCookedAssetCurrent(manifestPath, view.header->source, cookedPath, (const char*)&view.header->source - mapped.data())){
+		mapped.close();
+		return false;
+	}
+	for (uint32_t i = 0; i < view.header->spriteCount; i++){
+		const AssetStamp& source = view.sprites[i].source;
+		if (!IsCookedAssetCurrent(GetManifestSourcePath(manifestPath, view.sprites[i].name), source, cookedPath, (const char*)&source - mapped.data())){
+			mapped.close();
+			return false;
+		}
+	}
+	return true;
+}
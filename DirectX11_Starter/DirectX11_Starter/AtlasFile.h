@@ -0,0 +1,65 @@
+#ifndef _ATLASFILE_H
+#define _ATLASFILE_H
+
+#include "AssetStamp.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile;
+
+/**
+*A texture atlas starts as a manifest naming one source image per line (ReadAssetManifest).
+*The cooker turns sprites.atlas into two files:
+*	sprites.atlas.dds	the packed texture, an ordinary cooked DDS stamped with the manifest
+*	sprites.atlas.map	where each image went:
+*		AtlasFileHeader
+*		AtlasFileSprite[spriteCount]
+*Everything is little endian and read in place from a mapping.
+**/
+#define ATLAS_FILE_MAGIC 0x534C5441 // "ATLS"
+#define ATLAS_FILE_VERSION 1
+#define ATLAS_FILE_EXTENSION ".map"
+#define ATLAS_NAME_SIZE 64
+
+struct AtlasFileHeader{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t spriteCount;
+	uint32_t reserved;
+	AssetStamp source; // the manifest
+};
+
+struct AtlasFileSprite{
+	char name[ATLAS_NAME_SIZE]; // as the manifest spells it, zero terminated
+	uint32_t x; // the image's own texels, padding excluded
+	uint32_t y;
+	uint32_t width;
+	uint32_t height;
+	float uvScale[2]; // uv * uvScale + uvOffset maps the image's [0, 1] onto its texels in the atlas
+	float uvOffset[2];
+	AssetStamp source; // the image
+};
+
+//Pointers into a validated file image
+struct AtlasFileView{
+	const AtlasFileHeader* header;
+	const AtlasFileSprite* sprites;
+};
+
+bool WriteAtlasFile(const std::string& path, uint32_t width, uint32_t height, const AtlasFileSprite* sprites, uint32_t spriteCount, const AssetStamp& source);
+
+//Checks the header, that the sprites fit in the file and each lies inside the atlas
+bool ReadAtlasFile(const char* data, size_t size, AtlasFileView& view);
+
+//sprites.atlas -> sprites.atlas.map; the texture is GetCookedTexturePath(manifestPath)
+std::string GetCookedAtlasPath(const std::string& manifestPath);
+
+//Maps the cooked map for manifestPath, false unless it exists, is valid and neither the manifest
+//nor any image in it changed since. The view points into mapped, which has to stay open while it is used
+bool OpenCookedAtlas(const std::string& manifestPath, MappedFile& mapped, AtlasFileView& view);
+
+#endif
@@ -0,0 +1,174 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <cstring>
+
+static bool Contains(const AtlasRect& outer, const AtlasRect& inner){
+	return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+}
+
+static bool Overlaps(const AtlasRect& a, const AtlasRect& b){
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+static AtlasRect MakeRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height){
+	AtlasRect rect;
+	rect.x = x;
+	rect.y = y;
+	rect.width = width;
+	rect.height = height;
+	return rect;
+}
+
+//Replaces every free rectangle used overlaps with the up to four maximal ones left around it
+static void SplitFreeRects(std::vector<AtlasRect>& freeRects, const AtlasRect& used){
+	size_t count = freeRects.size();
+	for (size_t i = 0; i < count;){
+		AtlasRect free = freeRects[i];
+		if (!Overlaps(free, used)){
+			i++;
+			continue;
+		}
+		if (used.x > free.x){
+			freeRects.push_back(MakeRect(free.x, free.y, used.x - free.x, free.height));
+		}
+		if (used.x + used.width < free.x + free.width){
+			freeRects.push_back(MakeRect(used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height));
+		}
+		if (used.y > free.y){
+			freeRects.push_back(MakeRect(free.x, free.y, free.width, used.y - free.y));
+		}
+		if (used.y + used.height < free.y + free.height){
+			freeRects.push_back(MakeRect(free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height));
+		}
+		//the last old one takes its place, new ones past count are checked by the prune
+		freeRects[i] = freeRects[count - 1];
+		freeRects.erase(freeRects.begin() + count - 1);
+		count--;
+	}
+}
+
+//Drops free rectangles inside another, they can never hold anything the bigger one can't
+static void PruneFreeRects(std::vector<AtlasRect>& freeRects){
+	for (size_t i = 0; i < freeRects.size(); i++){
+		for (size_t j = i + 1; j < freeRects.size();){
+			if (Contains(freeRects[i], freeRects[j])){
+				freeRects.erase(freeRects.begin() + j);
+				continue;
+			}
+			if (Contains(freeRects[j], freeRects[i])){
+				freeRects.erase(freeRects.begin() + i);
+				j = i + 1;
+				if (i >= freeRects.size()){
+					break;
+				}
+				continue;
+			}
+			j++;
+		}
+	}
+}
+
+static bool PackInto(const std::vector<AtlasRect>& sizes, const std::vector<unsigned int>& order, uint32_t width, uint32_t height, std::vector<AtlasRect>& placed){
+	std::vector<AtlasRect> freeRects(1, MakeRect(0, 0, width, height));
+	placed = sizes;
+	for (size_t n = 0; n < order.size(); n++){
+		AtlasRect& rect = placed[order[n]];
+		size_t best = freeRects.size();
+		uint32_t bestShort = 0;
+		uint32_t bestLong = 0;
+		for (size_t i = 0; i < freeRects.size(); i++){
+			const AtlasRect& free = freeRects[i];
+			if (free.width < rect.width || free.height < rect.height){
+				continue;
+			}
+			uint32_t leftoverX = free.width - rect.width;
+			uint32_t leftoverY = free.height - rect.height;
+			uint32_t shortSide = std::min(leftoverX, leftoverY);
+			uint32_t longSide = std::max(leftoverX, leftoverY);
+			if (best == freeRects.size() || shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)){
+				best = i;
+				bestShort = shortSide;
+				bestLong = longSide;
+			}
+		}
+		if (best == freeRects.size()){
+			return false;
+		}
+		rect.x = freeRects[best].x;
+		rect.y = freeRects[best].y;
+		SplitFreeRects(freeRects, rect);
+		PruneFreeRects(freeRects);
+	}
+	return true;
+}
+
+static uint32_t RoundUp(uint32_t value, uint32_t step){
+	return (value + step - 1) / step * step;
+}
+
+bool PackAtlas(const std::vector<AtlasRect>& sizes, uint32_t maxSize, uint32_t& width, uint32_t& height, std::vector<AtlasRect>& placed){
+	uint64_t area = 0;
+	uint32_t widest = ATLAS_SIZE_STEP;
+	uint32_t tallest = ATLAS_SIZE_STEP;
+	std::vector<unsigned int> order(sizes.size());
+	for (size_t i = 0; i < sizes.size(); i++){
+		area += (uint64_t)sizes[i].width * sizes[i].height;
+		widest = std::max(widest, sizes[i].width);
+		tallest = std::max(tallest, sizes[i].height);
+		order[i] = (unsigned int)i;
+	}
+	//largest first, the small ones fill the gaps they leave
+	std::stable_sort(order.begin(), order.end(), [&sizes](unsigned int a, unsigned int b){
+		return (uint64_t)sizes[a].width * sizes[a].height > (uint64_t)sizes[b].width * sizes[b].height;
+	});
+
+	//every height, with the narrowest width that packs at it
+	uint64_t bestArea = 0;
+	std::vector<AtlasRect> attempt;
+	for (uint32_t h = RoundUp(tallest, ATLAS_SIZE_STEP); h <= maxSize; h += ATLAS_SIZE_STEP){
+		uint32_t w = RoundUp(std::max(widest, (uint32_t)((area + h - 1) / h)), ATLAS_SIZE_STEP);
+		for (; w <= maxSize; w += ATLAS_SIZE_STEP){
+			uint64_t candidate = (uint64_t)w * h;
+			//squarer wins a tie, mips of a long thin atlas run out of one side early
+			if (bestArea != 0 && (candidate > bestArea || (candidate == bestArea && std::max(w, h) >= std::max(width, height)))){
+				break;
+			}
+			if (PackInto(sizes, order, w, h, attempt)){
+				bestArea = candidate;
+				width = w;
+				height = h;
+				placed.swap(attempt);
+				break;
+			}
+		}
+	}
+	return bestArea != 0;
+}
+
+AtlasRect GetPaddedAtlasSize(uint32_t width, uint32_t height){
+	return MakeRect(0, 0, RoundUp(width + 2 * ATLAS_PADDING, ATLAS_ALIGNMENT), RoundUp(height + 2 * ATLAS_PADDING, ATLAS_ALIGNMENT));
+}
+
+AtlasRect GetAtlasContentRect(const AtlasRect& placed, uint32_t width, uint32_t height){
+	return MakeRect(placed.x + ATLAS_PADDING, placed.y + ATLAS_PADDING, width, height);
+}
+
+void BuildAtlasImage(const std::vector<TextureImage>& images, const std::vector<AtlasRect>& placed, uint32_t width, uint32_t height, TextureImage& atlas){
+	atlas.width = width;
+	atlas.height = height;
+	atlas.pixels.assign((size_t)width * height * 4, 0);
+	for (size_t i = 0; i < images.size(); i++){
+		const TextureImage& image = images[i];
+		AtlasRect content = GetAtlasContentRect(placed[i], image.width, image.height);
+		for (uint32_t y = placed[i].y; y < placed[i].y + placed[i].height; y++){
+			//clamped, so the padding repeats the nearest border texel
+			uint32_t sourceY = y < content.y ? 0 : std::min(y - content.y, image.height - 1);
+			const uint8_t* sourceRow = &image.pixels[(size_t)sourceY * image.width * 4];
+			uint8_t* row = &atlas.pixels[((size_t)y * width + placed[i].x) * 4];
+			for (uint32_t x = placed[i].x; x < placed[i].x + placed[i].width; x++, row += 4){
+				uint32_t sourceX = x < content.x ? 0 : std::min(x - content.x, image.width - 1);
+				memcpy(row, sourceRow + (size_t)sourceX * 4, 4);
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef _ATLASPACKER_H
+#define _ATLASPACKER_H
+
+#include "TextureImage.h"
+#include <vector>
+#include <cstdint>
+
+/**
+*Packs small images into one texture so draws using any of them share a single view.
+*Rectangles go in largest first, each into the free space that fits it most tightly along its
+*shorter side (MaxRects, best short side fit, after Jylanki). Free space is kept as maximal
+*rectangles, which may overlap, so no placement is lost to an early choice of split.
+*Every image gets an edge of ATLAS_PADDING texels repeating its border and starts on an
+*ATLAS_ALIGNMENT boundary, which keeps bilinear filtering and the first ATLAS_MIP_COUNT levels
+*of box filtered mips from mixing neighbours. Plain C++, the cooker does the packing.
+**/
+#define ATLAS_PADDING 8 // texels of repeated border around each image
+#define ATLAS_ALIGNMENT 8 // images and their padding start on multiples of this
+#define ATLAS_SIZE_STEP 64 // atlas sides are multiples of this, so every level of the chain halves exactly
+#define ATLAS_MIP_COUNT 4 // levels down to where the padding shrinks to one texel
+#define ATLAS_MAX_SIZE 4096
+
+struct AtlasRect{
+	uint32_t x;
+	uint32_t y;
+	uint32_t width;
+	uint32_t height;
+};
+
+/**
+*Finds the smallest atlas, by area, that sizes fit in without overlapping, no side over maxSize.
+*sizes only needs width and height; placed gets the same rectangles with x and y filled in.
+*False if they don't fit even at maxSize x maxSize
+**/
+bool PackAtlas(const std::vector<AtlasRect>& sizes, uint32_t maxSize, uint32_t& width, uint32_t& height, std::vector<AtlasRect>& placed);
+
+//What to pack for an image of width x height: the image with its padding, aligned
+AtlasRect GetPaddedAtlasSize(uint32_t width, uint32_t height);
+//Where the image's own texels land inside the padded rectangle PackAtlas placed for it
+AtlasRect GetAtlasContentRect(const AtlasRect& placed, uint32_t width, uint32_t height);
+
+//Copies every image into its placed rectangle with the border repeated out to the rectangle's
+//edge; the space between rectangles is transparent black
+void BuildAtlasImage(const std::vector<TextureImage>& images, const std::vector<AtlasRect>& placed, uint32_t width, uint32_t height, TextureImage& atlas);
+
+#endif
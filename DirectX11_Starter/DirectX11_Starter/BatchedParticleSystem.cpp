@@ -0,0 +1,343 @@
+#include "BatchedParticleSystem.h"
+#include "ParticleSimulation.h"
+#include <d3dcompiler.h>
+#include <sstream>
+
+/**
+*Batched particle system constructor
+*constantBufferList: the game's constant buffers, [0] (world/view/projection) is used for drawing
+*mat: texture and sampler the particles are drawn with
+*particles_per_emitter: slots reserved in the pool for each emitter
+**/
+BatchedParticleSystem::BatchedParticleSystem(ID3D11Device* dev, ID3D11DeviceContext* devCtx, std::vector<ConstantBuffer*> constantBufferList, Material* mat, int particles_per_emitter)
+{
+	device = dev;
+	deviceContext = devCtx;
+	material = mat;
+	ConstantBuffers = constantBufferList;
+	particlesPerEmitter = particles_per_emitter;
+	particleCount = 0;
+	time = 0;
+	frame = 0;
+	verifyMismatches = 0;
+
+	emitterBuffer = nullptr;
+	emitterView = nullptr;
+	particleBuffer = nullptr;
+	particleView = nullptr;
+	particleUAV = nullptr;
+	stagingBuffer = nullptr;
+
+	ParticleUpdateConstantBufferLayout updateData;
+	updateBuffer = new ConstantBuffer(updateData, device);
+
+	loadShaders();
+
+	D3D11_BLEND_DESC blendDesc;
+	ZeroMemory(&blendDesc, sizeof(blendDesc));
+	blendDesc.RenderTarget[0].BlendEnable = TRUE;
+	blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+	blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+	blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ZERO;
+	blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+	blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+	stateCache = PipelineStateCache::ForDevice(device);
+	blendState = stateCache->getBlendState(blendDesc);
+}
+
+BatchedParticleSystem::~BatchedParticleSystem(void)
+{
+	ReleaseMacro(emitterView);
+	ReleaseMacro(emitterBuffer);
+	ReleaseMacro(particleUAV);
+	ReleaseMacro(particleView);
+	ReleaseMacro(particleBuffer);
+	ReleaseMacro(stagingBuffer);
+	ReleaseMacro(updateShader);
+	ReleaseMacro(vertexShader);
+	ReleaseMacro(geometryShader);
+	ReleaseMacro(pixelShader);
+	if (updateBuffer){
+		ReleaseMacro(updateBuffer->constantBuffer);
+		delete updateBuffer;
+		updateBuffer = nullptr;
+	}
+}
+
+//Compute shaders and structured buffers both need feature level 11
+bool BatchedParticleSystem::isSupported(ID3D11Device* dev)
+{
+	return dev->GetFeatureLevel() >= D3D_FEATURE_LEVEL_11_0;
+}
+
+void BatchedParticleSystem::loadShaders()
+{
+	updateShader = nullptr;
+	vertexShader = nullptr;
+	geometryShader = nullptr;
+	pixelShader = nullptr;
+
+	ID3DBlob* blob = nullptr;
+	if (SUCCEEDED(D3DReadFileToBlob(L"ParticleUpdateComputeShader.cso", &blob))){
+		device->CreateComputeShader(blob->GetBufferPointer(), blob->GetBufferSize(), NULL, &updateShader);
+		ReleaseMacro(blob);
+	}
+	if (SUCCEEDED(D3DReadFileToBlob(L"ParticleVertexShader.cso", &blob))){
+		device->CreateVertexShader(blob->GetBufferPointer(), blob->GetBufferSize(), NULL, &vertexShader);
+		ReleaseMacro(blob);
+	}
+	if (SUCCEEDED(D3DReadFileToBlob(L"ParticleGeometryShader.cso", &blob))){
+		device->CreateGeometryShader(blob->GetBufferPointer(), blob->GetBufferSize(), NULL, &geometryShader);
+		ReleaseMacro(blob);
+	}
+	if (SUCCEEDED(D3DReadFileToBlob(L"GeometryPixelShader.cso", &blob))){
+		device->CreatePixelShader(blob->GetBufferPointer(), blob->GetBufferSize(), NULL, &pixelShader);
+		ReleaseMacro(blob);
+	}
+}
+
+/**
+*Add an emitter to the batch, returns its index
+*lifetime: seconds each particle lives, the emitter spawns particles_per_emitter particles per lifetime
+**/
+int BatchedParticleSystem::addEmitter(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime)
+{
+	if (particleBuffer){
+		return -1;
+	}
+
+	ParticleEmitter emitter;
+	emitter.position = position;
+	emitter.velocity = velocity;
+	emitter.acceleration = acceleration;
+	emitter.lifetime = lifetime;
+	emitter.emitInterval = lifetime / particlesPerEmitter;
+	emitter.firstParticle = emitters.size() * particlesPerEmitter;
+	emitter.phase = 0;
+	emitter.previousPhase = 0;
+	emitter.padding[0] = 0;
+	emitter.padding[1] = 0;
+	emitters.push_back(emitter);
+
+	return emitters.size() - 1;
+}
+
+void BatchedParticleSystem::createBuffers()
+{
+	particleCount = emitters.size() * particlesPerEmitter;
+	if (particleCount == 0){
+		return;
+	}
+
+	//emitter parameters, rewritten every update for the phases
+	D3D11_BUFFER_DESC ebd;
+	ebd.Usage = D3D11_USAGE_DYNAMIC;
+	ebd.ByteWidth = sizeof(ParticleEmitter) * emitters.size();
+	ebd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	ebd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	ebd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	ebd.StructureByteStride = sizeof(ParticleEmitter);
+	D3D11_SUBRESOURCE_DATA emitterData;
+	emitterData.pSysMem = &emitters[0];
+	emitterData.SysMemPitch = 0;
+	emitterData.SysMemSlicePitch = 0;
+	device->CreateBuffer(&ebd, &emitterData, &emitterBuffer);
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
+	ZeroMemory(&srvDesc, sizeof(srvDesc));
+	srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+	srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	srvDesc.Buffer.FirstElement = 0;
+	srvDesc.Buffer.NumElements = emitters.size();
+	device->CreateShaderResourceView(emitterBuffer, &srvDesc, &emitterView);
+
+	//particle pool, every slot starts dead
+	std::vector<PooledParticle> pool(particleCount);
+	InitializeParticlePool(&pool[0], emitters.size(), particlesPerEmitter);
+
+	D3D11_BUFFER_DESC pbd;
+	pbd.Usage = D3D11_USAGE_DEFAULT;
+	pbd.ByteWidth = sizeof(PooledParticle) * particleCount;
+	pbd.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+	pbd.CPUAccessFlags = 0;
+	pbd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	pbd.StructureByteStride = sizeof(PooledParticle);
+	D3D11_SUBRESOURCE_DATA particleData;
+	particleData.pSysMem = &pool[0];
+	particleData.SysMemPitch = 0;
+	particleData.SysMemSlicePitch = 0;
+	device->CreateBuffer(&pbd, &particleData, &particleBuffer);
+
+	srvDesc.Buffer.NumElements = particleCount;
+	device->CreateShaderResourceView(particleBuffer, &srvDesc, &particleView);
+
+	D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc;
+	ZeroMemory(&uavDesc, sizeof(uavDesc));
+	uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+	uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+	uavDesc.Buffer.FirstElement = 0;
+	uavDesc.Buffer.NumElements = particleCount;
+	uavDesc.Buffer.Flags = 0;
+	device->CreateUnorderedAccessView(particleBuffer, &uavDesc, &particleUAV);
+}
+
+//Single dispatch that ages, kills, integrates and emits for every emitter
+void BatchedParticleSystem::update(float dt)
+{
+	if (!particleBuffer){
+		createBuffers();
+	}
+	if (particleCount == 0 || !updateShader){
+		return;
+	}
+
+	time += dt;
+	SetEmitterPhases(&emitters[0], emitters.size(), time);
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	if (SUCCEEDED(deviceContext->Map(emitterBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))){
+		memcpy(mapped.pData, &emitters[0], sizeof(ParticleEmitter) * emitters.size());
+		deviceContext->Unmap(emitterBuffer, 0);
+	}
+
+#if defined(DEBUG) || defined(_DEBUG)
+	//the CPU reference steps the same starting pool the kernel is about to
+	std::vector<PooledParticle> expected;
+	bool verify = (frame++ % PARTICLE_VERIFY_INTERVAL) == 0 && readPool(expected);
+	if (verify){
+		SimulateParticles(&emitters[0], &expected[0], emitters.size(), particlesPerEmitter, dt);
+	}
+#endif
+
+	updateBuffer->dataToSendToParticleUpdateBuffer.deltaTime = dt;
+	updateBuffer->dataToSendToParticleUpdateBuffer.particlesPerEmitter = particlesPerEmitter;
+	updateBuffer->dataToSendToParticleUpdateBuffer.particleCount = particleCount;
+	deviceContext->UpdateSubresource(
+		updateBuffer->constantBuffer,
+		0,
+		NULL,
+		&updateBuffer->dataToSendToParticleUpdateBuffer,
+		0,
+		0);
+
+	deviceContext->CSSetShader(updateShader, NULL, 0);
+	deviceContext->CSSetConstantBuffers(0, 1, &updateBuffer->constantBuffer);
+	deviceContext->CSSetShaderResources(0, 1, &emitterView);
+	deviceContext->CSSetUnorderedAccessViews(0, 1, &particleUAV, NULL);
+
+	deviceContext->Dispatch((particleCount + 63) / 64, 1, 1);
+
+	//unbind the pool so the vertex shader can read it
+	ID3D11UnorderedAccessView* nullUAV[1] = { 0 };
+	ID3D11ShaderResourceView* nullSRV[1] = { 0 };
+	deviceContext->CSSetUnorderedAccessViews(0, 1, nullUAV, NULL);
+	deviceContext->CSSetShaderResources(0, 1, nullSRV);
+	deviceContext->CSSetShader(NULL, NULL, 0);
+
+#if defined(DEBUG) || defined(_DEBUG)
+	std::vector<PooledParticle> actual;
+	if (verify && readPool(actual)){
+		UINT mismatches = CompareParticlePools(&expected[0], &actual[0], particleCount, PARTICLE_VERIFY_TOLERANCE);
+		if (mismatches > 0){
+			verifyMismatches += mismatches;
+			std::ostringstream message;
+			message << "BatchedParticleSystem: " << mismatches << " of " << particleCount << " particles differ from the CPU reference\n";
+			OutputDebugStringA(message.str().c_str());
+		}
+	}
+#endif
+}
+
+//Copies the pool into system memory, stalling until the GPU has written it
+bool BatchedParticleSystem::readPool(std::vector<PooledParticle>& pool)
+{
+	if (!stagingBuffer){
+		D3D11_BUFFER_DESC sbd;
+		sbd.Usage = D3D11_USAGE_STAGING;
+		sbd.ByteWidth = sizeof(PooledParticle) * particleCount;
+		sbd.BindFlags = 0;
+		sbd.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+		sbd.MiscFlags = 0;
+		sbd.StructureByteStride = 0;
+		if (FAILED(device->CreateBuffer(&sbd, NULL, &stagingBuffer))){
+			return false;
+		}
+	}
+	deviceContext->CopyResource(stagingBuffer, particleBuffer);
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	if (FAILED(deviceContext->Map(stagingBuffer, 0, D3D11_MAP_READ, 0, &mapped))){
+		return false;
+	}
+	pool.resize(particleCount);
+	memcpy(&pool[0], mapped.pData, sizeof(PooledParticle) * particleCount);
+	deviceContext->Unmap(stagingBuffer, 0);
+	return true;
+}
+
+//Single draw for all emitters, one point per pool slot
+void BatchedParticleSystem::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix)
+{
+	if (!particleBuffer || particleCount == 0){
+		return;
+	}
+
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixIdentity());
+	ConstantBuffers[0]->dataToSendToConstantBuffer.world = world;
+	ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
+	ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+	ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = material->uvTransform;
+
+	//matrix constant buffer
+	deviceContext->UpdateSubresource(
+		ConstantBuffers[0]->constantBuffer,
+		0,
+		NULL,
+		&ConstantBuffers[0]->dataToSendToConstantBuffer,
+		0,
+		0);
+
+	//no vertex buffer, the vertex shader fetches from the pool by SV_VertexID
+	ID3D11Buffer* nullBuffer[1] = { 0 };
+	UINT stride = 0;
+	UINT offset = 0;
+	deviceContext->IASetInputLayout(NULL);
+	deviceContext->IASetVertexBuffers(0, 1, nullBuffer, &stride, &offset);
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+
+	deviceContext->VSSetShader(vertexShader, NULL, 0);
+	deviceContext->VSSetShaderResources(0, 1, &particleView);
+
+	deviceContext->GSSetShader(geometryShader, NULL, 0);
+	deviceContext->GSSetConstantBuffers(0, 1, &ConstantBuffers[0]->constantBuffer);
+
+	deviceContext->PSSetShader(pixelShader, NULL, 0);
+	deviceContext->PSSetSamplers(0, 1, &material->samplerState);
+	deviceContext->PSSetShaderResources(0, 1, &material->resourceView);
+
+	stateCache->setBlendState(deviceContext, blendState);
+
+	deviceContext->Draw(particleCount, 0);
+
+	//unbind geometry shader and the pool so the next update can write it
+	ID3D11ShaderResourceView* nullSRV[1] = { 0 };
+	deviceContext->VSSetShaderResources(0, 1, nullSRV);
+	deviceContext->GSSetShader(NULL, NULL, 0);
+}
+
+UINT BatchedParticleSystem::getParticleCount()
+{
+	return particleCount;
+}
+
+UINT BatchedParticleSystem::getEmitterCount()
+{
+	return emitters.size();
+}
+
+UINT BatchedParticleSystem::getVerifyMismatches()
+{
+	return verifyMismatches;
+}
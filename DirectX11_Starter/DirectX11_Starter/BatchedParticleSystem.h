@@ -0,0 +1,72 @@
+#ifndef _BATCHEDPARTICLESYSTEM_H
+#define _BATCHEDPARTICLESYSTEM_H
+
+#include "Global.h"
+#include "Material.h"
+#include "ConstantBuffer.h"
+#include "PipelineStateCache.h"
+#include <Windows.h>
+#include <d3d11.h>
+#include <vector>
+#include <memory>
+
+#define PARTICLE_VERIFY_INTERVAL 300 // frames between debug build checks of the kernel against ParticleSimulation
+#define PARTICLE_VERIFY_TOLERANCE 0.001f // relative, the compiler may fuse multiply-adds the CPU rounds separately
+
+//Runs every emitter out of one pooled particle buffer.
+//Emitter parameters live in a structured buffer, a compute shader updates the whole pool
+//in one dispatch and a single point list draw expands the live particles in the geometry shader.
+//Needs feature level 11 for cs_5_0 and structured buffers.
+//Debug builds read the pool back every PARTICLE_VERIFY_INTERVAL frames, run ParticleSimulation on
+//it and compare with what the dispatch wrote, reporting slots that differ to the debugger output.
+class BatchedParticleSystem{
+public:
+	BatchedParticleSystem(ID3D11Device* dev, ID3D11DeviceContext* devCtx, std::vector<ConstantBuffer*> constantBufferList, Material* mat, int particles_per_emitter = 20);
+	~BatchedParticleSystem(void);
+
+	//Emitters can be added until the first update, the pool is sized from them
+	int addEmitter(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime);
+	void update(float dt);
+	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix);
+
+	UINT getParticleCount();
+	UINT getEmitterCount();
+	//Slots the debug build check has found differing from the CPU reference so far, always 0 in release
+	UINT getVerifyMismatches();
+
+	static bool isSupported(ID3D11Device* dev);
+
+private:
+	void createBuffers();
+	void loadShaders();
+	bool readPool(std::vector<PooledParticle>& pool);
+
+	ID3D11Device* device;
+	ID3D11DeviceContext* deviceContext;
+	Material* material;
+	std::vector<ConstantBuffer*> ConstantBuffers;
+	ConstantBuffer* updateBuffer;
+
+	std::vector<ParticleEmitter> emitters;
+	UINT particlesPerEmitter;
+	UINT particleCount;
+	double time; // the emitters get it wrapped to their lifetime as phase
+
+	ID3D11Buffer* emitterBuffer;
+	ID3D11ShaderResourceView* emitterView;
+	ID3D11Buffer* particleBuffer;
+	ID3D11ShaderResourceView* particleView;
+	ID3D11UnorderedAccessView* particleUAV;
+	ID3D11Buffer* stagingBuffer; // debug build readback of the pool
+	UINT frame;
+	UINT verifyMismatches;
+
+	ID3D11ComputeShader* updateShader;
+	ID3D11VertexShader* vertexShader;
+	ID3D11GeometryShader* geometryShader;
+	ID3D11PixelShader* pixelShader;
+
+	std::shared_ptr<PipelineStateCache> stateCache;
+	BlendStateHandle blendState;
+};
+#endif
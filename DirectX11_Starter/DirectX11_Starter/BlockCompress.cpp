@@ -0,0 +1,881 @@
+#include "BlockCompress.h"
+#include "ThreadPool.h"
+#include <emmintrin.h>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+#define BLOCK_AXIS_ITERATIONS 8 // power iterations for a block's principal axis
+#define BLOCK_SEARCH_PASSES 4 // most rounds of the neighbouring endpoint search
+#define BLOCK_TASK_MIN_BLOCKS 1024 // below this a run of block rows isn't worth a task
+#define BLOCK_TASKS_PER_THREAD 4
+
+//BC7 4-bit index weights, out of 64
+static const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+//What each quality tier spends on a block
+struct BlockSettings{
+	bool principalAxis; // otherwise the bounding box diagonal
+	int refineIterations; // least squares passes over the endpoints
+	bool searchEndpoints; // try stepping each quantised endpoint component by one
+};
+
+static BlockSettings GetBlockSettings(BlockQuality quality){
+	BlockSettings settings;
+	settings.principalAxis = quality != BLOCK_QUALITY_FAST;
+	settings.refineIterations = quality == BLOCK_QUALITY_FAST ? 0 : (quality == BLOCK_QUALITY_NORMAL ? 2 : 4);
+	settings.searchEndpoints = quality == BLOCK_QUALITY_HIGH;
+	return settings;
+}
+
+//A block a channel at a time, so each SSE operation covers four texels
+struct BlockTexels{
+	float channel[4][16];
+};
+
+static void LoadTexels(const uint8_t rgba[64], BlockTexels& texels){
+	for (int i = 0; i < 16; i++){
+		for (int c = 0; c < 4; c++){
+			texels.channel[c][i] = rgba[i * 4 + c];
+		}
+	}
+}
+
+/**
+*Closest palette entry for every texel over channels [first, first + channels), and the
+*summed squared error. The palette's columns line up with those channels.
+**/
+static float FindNearestEntries(const BlockTexels& texels, int first, int channels, const float palette[][4], int entries, uint8_t indices[16]){
+	__m128 total = _mm_setzero_ps();
+	for (int group = 0; group < 16; group += 4){
+		__m128 values[4];
+		for (int c = 0; c < channels; c++){
+			values[c] = _mm_loadu_ps(&texels.channel[first + c][group]);
+		}
+		__m128 best = _mm_set1_ps(FLT_MAX);
+		__m128i bestIndex = _mm_setzero_si128();
+		for (int p = 0; p < entries; p++){
+			__m128 error = _mm_setzero_ps();
+			for (int c = 0; c < channels; c++){
+				__m128 difference = _mm_sub_ps(values[c], _mm_set1_ps(palette[p][c]));
+				error = _mm_add_ps(error, _mm_mul_ps(difference, difference));
+			}
+			__m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, best));
+			best = _mm_min_ps(error, best);
+			bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32(p)), _mm_andnot_si128(closer, bestIndex));
+		}
+		total = _mm_add_ps(total, best);
+		int32_t lanes[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), bestIndex);
+		for (int i = 0; i < 4; i++){
+			indices[group + i] = (uint8_t)lanes[i];
+		}
+	}
+	float sums[4];
+	_mm_storeu_ps(sums, total);
+	return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+static void GetChannelStats(const BlockTexels& texels, int channels, float mean[4], float minimum[4], float maximum[4], float covariance[4][4]){
+	for (int c = 0; c < 4; c++){
+		mean[c] = 0.0f;
+		minimum[c] = 255.0f;
+		maximum[c] = 0.0f;
+	}
+	for (int c = 0; c < channels; c++){
+		for (int i = 0; i < 16; i++){
+			float value = texels.channel[c][i];
+			mean[c] += value * (1.0f / 16.0f);
+			minimum[c] = value < minimum[c] ? value : minimum[c];
+			maximum[c] = value > maximum[c] ? value : maximum[c];
+		}
+	}
+	memset(covariance, 0, sizeof(float) * 16);
+	for (int a = 0; a < channels; a++){
+		for (int b = a; b < channels; b++){
+			float sum = 0.0f;
+			for (int i = 0; i < 16; i++){
+				sum += (texels.channel[a][i] - mean[a]) * (texels.channel[b][i] - mean[b]);
+			}
+			covariance[a][b] = sum;
+			covariance[b][a] = sum;
+		}
+	}
+}
+
+/**
+*Line through the first channels of the texels, low and high are the extremes of the texels
+*projected onto it. With principalAxis the line follows the covariance's main eigenvector,
+*found by power iteration; otherwise it is the bounding box diagonal, each channel flipped to
+*agree in sign with the widest one. A flat block gets its mean for both.
+**/
+static void FitLine(const BlockTexels& texels, int channels, bool principalAxis, float low[4], float high[4]){
+	float mean[4];
+	float minimum[4];
+	float maximum[4];
+	float covariance[4][4];
+	GetChannelStats(texels, channels, mean, minimum, maximum, covariance);
+
+	if (!principalAxis){
+		int widest = 0;
+		for (int c = 1; c < channels; c++){
+			widest = maximum[c] - minimum[c] > maximum[widest] - minimum[widest] ? c : widest;
+		}
+		for (int c = 0; c < 4; c++){
+			bool flip = c < channels && covariance[widest][c] < 0.0f;
+			low[c] = c < channels ? (flip ? maximum[c] : minimum[c]) : mean[c];
+			high[c] = c < channels ? (flip ? minimum[c] : maximum[c]) : mean[c];
+		}
+		return;
+	}
+
+	//the box diagonal is usually close already
+	float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int c = 0; c < channels; c++){
+		axis[c] = maximum[c] - minimum[c];
+	}
+	for (int iteration = 0; iteration < BLOCK_AXIS_ITERATIONS; iteration++){
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float largest = 0.0f;
+		for (int a = 0; a < channels; a++){
+			for (int b = 0; b < channels; b++){
+				next[a] += covariance[a][b] * axis[b];
+			}
+			largest = fabsf(next[a]) > largest ? fabsf(next[a]) : largest;
+		}
+		if (largest <= 0.0f){
+			break;
+		}
+		for (int c = 0; c < channels; c++){
+			axis[c] = next[c] / largest;
+		}
+	}
+
+	float length = 0.0f;
+	for (int c = 0; c < channels; c++){
+		length += axis[c] * axis[c];
+	}
+	if (length <= 1e-12f){
+		for (int c = 0; c < 4; c++){
+			low[c] = mean[c];
+			high[c] = mean[c];
+		}
+		return;
+	}
+	length = sqrtf(length);
+	for (int c = 0; c < channels; c++){
+		axis[c] /= length;
+	}
+
+	float lowest = 0.0f;
+	float highest = 0.0f;
+	for (int i = 0; i < 16; i++){
+		float t = 0.0f;
+		for (int c = 0; c < channels; c++){
+			t += (texels.channel[c][i] - mean[c]) * axis[c];
+		}
+		lowest = t < lowest ? t : lowest;
+		highest = t > highest ? t : highest;
+	}
+	for (int c = 0; c < 4; c++){
+		low[c] = c < channels ? mean[c] + axis[c] * lowest : mean[c];
+		high[c] = c < channels ? mean[c] + axis[c] * highest : mean[c];
+	}
+}
+
+//Least squares endpoints for texels that sit weights[i] of the way from low to high. False if the weights don't pin them down
+static bool SolveLine(const BlockTexels& texels, int channels, const float weights[16], float low[4], float high[4]){
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ax[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float bx[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 16; i++){
+		float b = weights[i];
+		float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < channels; c++){
+			ax[c] += a * texels.channel[c][i];
+			bx[c] += b * texels.channel[c][i];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if (fabsf(determinant) < 1e-6f){
+		return false;
+	}
+	for (int c = 0; c < channels; c++){
+		float l = (ax[c] * bb - bx[c] * ab) / determinant;
+		float h = (bx[c] * aa - ax[c] * ab) / determinant;
+		low[c] = l < 0.0f ? 0.0f : (l > 255.0f ? 255.0f : l);
+		high[c] = h < 0.0f ? 0.0f : (h > 255.0f ? 255.0f : h);
+	}
+	return true;
+}
+
+static void WriteBits(uint8_t* block, uint32_t& offset, uint32_t value, uint32_t count){
+	for (uint32_t i = 0; i < count; i++, offset++){
+		if ((value >> i) & 1){
+			block[offset >> 3] |= (uint8_t)(1 << (offset & 7));
+		}
+	}
+}
+
+static uint32_t ReadBits(const uint8_t* block, uint32_t& offset, uint32_t count){
+	uint32_t value = 0;
+	for (uint32_t i = 0; i < count; i++, offset++){
+		value |= (uint32_t)((block[offset >> 3] >> (offset & 7)) & 1) << i;
+	}
+	return value;
+}
+
+//BC1 colour
+
+static uint16_t PackColor565(const float color[4]){
+	int r = (int)(color[0] * (31.0f / 255.0f) + 0.5f);
+	int g = (int)(color[1] * (63.0f / 255.0f) + 0.5f);
+	int b = (int)(color[2] * (31.0f / 255.0f) + 0.5f);
+	r = r < 0 ? 0 : (r > 31 ? 31 : r);
+	g = g < 0 ? 0 : (g > 63 ? 63 : g);
+	b = b < 0 ? 0 : (b > 31 ? 31 : b);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void UnpackColor565(uint16_t color, int rgb[3]){
+	int r = color >> 11;
+	int g = (color >> 5) & 63;
+	int b = color & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+//Four colours when c0 > c1 (always in BC3), otherwise three and transparent black
+static void GetColorPalette(uint16_t c0, uint16_t c1, bool alwaysFour, int palette[4][4]){
+	int a[3];
+	int b[3];
+	UnpackColor565(c0, a);
+	UnpackColor565(c1, b);
+	bool four = alwaysFour || c0 > c1;
+	for (int c = 0; c < 3; c++){
+		palette[0][c] = a[c];
+		palette[1][c] = b[c];
+		palette[2][c] = four ? (2 * a[c] + b[c] + 1) / 3 : (a[c] + b[c] + 1) / 2;
+		palette[3][c] = four ? (a[c] + 2 * b[c] + 1) / 3 : 0;
+	}
+	palette[0][3] = 255;
+	palette[1][3] = 255;
+	palette[2][3] = 255;
+	palette[3][3] = four ? 255 : 0;
+}
+
+//Indices and squared RGB error of the texels against a four colour palette; swaps the endpoints into four colour order
+static float EvaluateColorEndpoints(const BlockTexels& texels, uint16_t& c0, uint16_t& c1, uint8_t indices[16]){
+	if (c0 < c1){
+		uint16_t swap = c0;
+		c0 = c1;
+		c1 = swap;
+	}
+	int palette[4][4];
+	GetColorPalette(c0, c1, true, palette);
+	float entries[4][4];
+	for (int p = 0; p < 4; p++){
+		for (int c = 0; c < 4; c++){
+			entries[p][c] = (float)palette[p][c];
+		}
+	}
+	//equal endpoints decode as three colour in BC1, index 0 is the only one both modes agree on
+	return FindNearestEntries(texels, 0, 3, entries, c0 == c1 ? 1 : 4, indices);
+}
+
+//Greedy walk over the 565 endpoints one component step at a time while the error drops
+static float SearchColorEndpoints(const BlockTexels& texels, uint16_t& c0, uint16_t& c1, uint8_t indices[16], float bestError){
+	static const int shifts[3] = { 11, 5, 0 };
+	static const int limits[3] = { 31, 63, 31 };
+	for (int pass = 0; pass < BLOCK_SEARCH_PASSES && bestError > 0.0f; pass++){
+		bool improved = false;
+		for (int e = 0; e < 2; e++){
+			for (int f = 0; f < 3; f++){
+				for (int step = -1; step <= 1; step += 2){
+					uint16_t candidate[2] = { c0, c1 };
+					int value = ((candidate[e] >> shifts[f]) & limits[f]) + step;
+					if (value < 0 || value > limits[f]){
+						continue;
+					}
+					candidate[e] = (uint16_t)((candidate[e] & ~(limits[f] << shifts[f])) | (value << shifts[f]));
+					uint8_t trial[16];
+					float error = EvaluateColorEndpoints(texels, candidate[0], candidate[1], trial);
+					if (error < bestError){
+						bestError = error;
+						c0 = candidate[0];
+						c1 = candidate[1];
+						memcpy(indices, trial, 16);
+						improved = true;
+					}
+				}
+			}
+		}
+		if (!improved){
+			break;
+		}
+	}
+	return bestError;
+}
+
+static void EncodeColorBlock(const BlockTexels& texels, const BlockSettings& settings, uint8_t* block){
+	static const float colorWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+	float low[4];
+	float high[4];
+	FitLine(texels, 3, settings.principalAxis, low, high);
+
+	uint16_t c0 = PackColor565(high);
+	uint16_t c1 = PackColor565(low);
+	uint8_t indices[16];
+	float bestError = EvaluateColorEndpoints(texels, c0, c1, indices);
+
+	for (int iteration = 0; iteration < settings.refineIterations && bestError > 0.0f; iteration++){
+		float weights[16];
+		for (int i = 0; i < 16; i++){
+			weights[i] = colorWeights[indices[i]];
+		}
+		if (!SolveLine(texels, 3, weights, low, high)){
+			break;
+		}
+		uint16_t r0 = PackColor565(low);
+		uint16_t r1 = PackColor565(high);
+		uint8_t refined[16];
+		float error = EvaluateColorEndpoints(texels, r0, r1, refined);
+		if (error >= bestError){
+			break;
+		}
+		bestError = error;
+		c0 = r0;
+		c1 = r1;
+		memcpy(indices, refined, sizeof(indices));
+	}
+	if (settings.searchEndpoints){
+		SearchColorEndpoints(texels, c0, c1, indices, bestError);
+	}
+
+	block[0] = (uint8_t)(c0 & 0xFF);
+	block[1] = (uint8_t)(c0 >> 8);
+	block[2] = (uint8_t)(c1 & 0xFF);
+	block[3] = (uint8_t)(c1 >> 8);
+	uint32_t bits = 0;
+	for (int i = 0; i < 16; i++){
+		bits |= (uint32_t)indices[i] << (i * 2);
+	}
+	memcpy(block + 4, &bits, 4);
+}
+
+static void DecodeColorBlock(const uint8_t* block, bool alwaysFour, uint8_t rgba[64]){
+	uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+	uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+	int palette[4][4];
+	GetColorPalette(c0, c1, alwaysFour, palette);
+	uint32_t bits;
+	memcpy(&bits, block + 4, 4);
+	for (int i = 0; i < 16; i++){
+		int index = (bits >> (i * 2)) & 3;
+		for (int c = 0; c < 4; c++){
+			rgba[i * 4 + c] = (uint8_t)palette[index][c];
+		}
+	}
+}
+
+//BC4 single channel
+
+//Eight interpolated values when a0 > a1, otherwise six plus 0 and 255
+static void GetChannelPalette(int a0, int a1, int palette[8]){
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1){
+		for (int i = 1; i < 7; i++){
+			palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+		}
+	}
+	else{
+		for (int i = 1; i < 5; i++){
+			palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+static float EvaluateChannelEndpoints(const BlockTexels& texels, int channel, int a0, int a1, uint8_t indices[16]){
+	int palette[8];
+	GetChannelPalette(a0, a1, palette);
+	float entries[8][4];
+	for (int p = 0; p < 8; p++){
+		entries[p][0] = (float)palette[p];
+	}
+	return FindNearestEntries(texels, channel, 1, entries, 8, indices);
+}
+
+//Tries the endpoints within radius of (a0, a1) that stay in the same mode, keeps the best
+static float SearchChannelEndpoints(const BlockTexels& texels, int channel, int radius, int& a0, int& a1, uint8_t indices[16], float bestError){
+	int centre0 = a0;
+	int centre1 = a1;
+	bool eight = a0 > a1;
+	for (int d0 = -radius; d0 <= radius; d0++){
+		for (int d1 = -radius; d1 <= radius; d1++){
+			int e0 = centre0 + d0;
+			int e1 = centre1 + d1;
+			if (e0 < 0 || e0 > 255 || e1 < 0 || e1 > 255 || (e0 > e1) != eight){
+				continue;
+			}
+			uint8_t trial[16];
+			float error = EvaluateChannelEndpoints(texels, channel, e0, e1, trial);
+			if (error < bestError){
+				bestError = error;
+				a0 = e0;
+				a1 = e1;
+				memcpy(indices, trial, 16);
+			}
+		}
+	}
+	return bestError;
+}
+
+//The span of the values in eight steps, or in six when 0 and 255 can take the extremes instead
+static void EncodeChannelBlock(const BlockTexels& texels, int channel, const BlockSettings& settings, uint8_t* block){
+	int minimum = 255;
+	int maximum = 0;
+	int innerMinimum = 255;
+	int innerMaximum = 0;
+	for (int i = 0; i < 16; i++){
+		int value = (int)texels.channel[channel][i];
+		minimum = value < minimum ? value : minimum;
+		maximum = value > maximum ? value : maximum;
+		if (value != 0 && value != 255){
+			innerMinimum = value < innerMinimum ? value : innerMinimum;
+			innerMaximum = value > innerMaximum ? value : innerMaximum;
+		}
+	}
+
+	int a0 = maximum;
+	int a1 = minimum;
+	uint8_t indices[16];
+	float bestError = EvaluateChannelEndpoints(texels, channel, a0, a1, indices);
+	if (settings.searchEndpoints && bestError > 0.0f){
+		bestError = SearchChannelEndpoints(texels, channel, 2, a0, a1, indices, bestError);
+	}
+	if (settings.refineIterations > 0 && bestError > 0.0f && (minimum == 0 || maximum == 255)){
+		if (innerMinimum > innerMaximum){
+			innerMinimum = innerMaximum = minimum == 0 ? 0 : 255;
+		}
+		int s0 = innerMinimum;
+		int s1 = innerMaximum;
+		uint8_t sixIndices[16];
+		float error = EvaluateChannelEndpoints(texels, channel, s0, s1, sixIndices);
+		if (settings.searchEndpoints && error > 0.0f){
+			error = SearchChannelEndpoints(texels, channel, 2, s0, s1, sixIndices, error);
+		}
+		if (error < bestError){
+			bestError = error;
+			a0 = s0;
+			a1 = s1;
+			memcpy(indices, sixIndices, sizeof(indices));
+		}
+	}
+
+	block[0] = (uint8_t)a0;
+	block[1] = (uint8_t)a1;
+	uint64_t bits = 0;
+	for (int i = 0; i < 16; i++){
+		bits |= (uint64_t)indices[i] << (i * 3);
+	}
+	for (int i = 0; i < 6; i++){
+		block[2 + i] = (uint8_t)(bits >> (i * 8));
+	}
+}
+
+static void DecodeChannelBlock(const uint8_t* block, uint8_t* values, int stride){
+	int palette[8];
+	GetChannelPalette(block[0], block[1], palette);
+	uint64_t bits = 0;
+	for (int i = 0; i < 6; i++){
+		bits |= (uint64_t)block[2 + i] << (i * 8);
+	}
+	for (int i = 0; i < 16; i++){
+		values[i * stride] = (uint8_t)palette[(bits >> (i * 3)) & 7];
+	}
+}
+
+//BC7 mode 6
+
+struct Mode6Endpoints{
+	int quantized[2][4]; // 7 bits per channel
+	int pBits[2];
+};
+
+static float QuantizeMode6Endpoint(const float endpoint[4], int pBit, int quantized[4]){
+	float error = 0.0f;
+	for (int c = 0; c < 4; c++){
+		int q = (int)((endpoint[c] - pBit) * 0.5f + 0.5f);
+		quantized[c] = q < 0 ? 0 : (q > 127 ? 127 : q);
+		float difference = endpoint[c] - ((quantized[c] << 1) | pBit);
+		error += difference * difference;
+	}
+	return error;
+}
+
+static float EvaluateMode6Endpoints(const BlockTexels& texels, const Mode6Endpoints& endpoints, uint8_t indices[16]){
+	float palette[16][4];
+	for (int i = 0; i < 16; i++){
+		for (int c = 0; c < 4; c++){
+			int e0 = (endpoints.quantized[0][c] << 1) | endpoints.pBits[0];
+			int e1 = (endpoints.quantized[1][c] << 1) | endpoints.pBits[1];
+			palette[i][c] = (float)(((64 - bc7Weights[i]) * e0 + bc7Weights[i] * e1 + 32) >> 6);
+		}
+	}
+	return FindNearestEntries(texels, 0, 4, palette, 16, indices);
+}
+
+//Quantises both endpoints; each takes the p-bit closest to it, or with searchEndpoints every pairing is tried against the block
+static float FitMode6Endpoints(const BlockTexels& texels, const float low[4], const float high[4], bool tryAllPBits, Mode6Endpoints& endpoints, uint8_t indices[16]){
+	if (!tryAllPBits){
+		for (int e = 0; e < 2; e++){
+			const float* endpoint = e == 0 ? low : high;
+			int other[4];
+			float zero = QuantizeMode6Endpoint(endpoint, 0, endpoints.quantized[e]);
+			float one = QuantizeMode6Endpoint(endpoint, 1, other);
+			endpoints.pBits[e] = one < zero ? 1 : 0;
+			if (one < zero){
+				memcpy(endpoints.quantized[e], other, sizeof(other));
+			}
+		}
+		return EvaluateMode6Endpoints(texels, endpoints, indices);
+	}
+
+	float bestError = FLT_MAX;
+	for (int pairing = 0; pairing < 4; pairing++){
+		Mode6Endpoints candidate;
+		candidate.pBits[0] = pairing & 1;
+		candidate.pBits[1] = pairing >> 1;
+		QuantizeMode6Endpoint(low, candidate.pBits[0], candidate.quantized[0]);
+		QuantizeMode6Endpoint(high, candidate.pBits[1], candidate.quantized[1]);
+		uint8_t trial[16];
+		float error = EvaluateMode6Endpoints(texels, candidate, trial);
+		if (error < bestError){
+			bestError = error;
+			endpoints = candidate;
+			memcpy(indices, trial, 16);
+		}
+	}
+	return bestError;
+}
+
+static float SearchMode6Endpoints(const BlockTexels& texels, Mode6Endpoints& endpoints, uint8_t indices[16], float bestError){
+	for (int pass = 0; pass < BLOCK_SEARCH_PASSES && bestError > 0.0f; pass++){
+		bool improved = false;
+		for (int e = 0; e < 2; e++){
+			for (int c = 0; c < 4; c++){
+				for (int step = -1; step <= 1; step += 2){
+					Mode6Endpoints candidate = endpoints;
+					candidate.quantized[e][c] += step;
+					if (candidate.quantized[e][c] < 0 || candidate.quantized[e][c] > 127){
+						continue;
+					}
+					uint8_t trial[16];
+					float error = EvaluateMode6Endpoints(texels, candidate, trial);
+					if (error < bestError){
+						bestError = error;
+						endpoints = candidate;
+						memcpy(indices, trial, 16);
+						improved = true;
+					}
+				}
+			}
+		}
+		if (!improved){
+			break;
+		}
+	}
+	return bestError;
+}
+
+static void EncodeMode6Block(const BlockTexels& texels, const BlockSettings& settings, uint8_t* block){
+	float low[4];
+	float high[4];
+	FitLine(texels, 4, settings.principalAxis, low, high);
+	Mode6Endpoints endpoints;
+	uint8_t indices[16];
+	float bestError = FitMode6Endpoints(texels, low, high, settings.searchEndpoints, endpoints, indices);
+
+	for (int iteration = 0; iteration < settings.refineIterations && bestError > 0.0f; iteration++){
+		float weights[16];
+		for (int i = 0; i < 16; i++){
+			weights[i] = bc7Weights[indices[i]] / 64.0f;
+		}
+		if (!SolveLine(texels, 4, weights, low, high)){
+			break;
+		}
+		Mode6Endpoints refined;
+		uint8_t refinedIndices[16];
+		float error = FitMode6Endpoints(texels, low, high, settings.searchEndpoints, refined, refinedIndices);
+		if (error >= bestError){
+			break;
+		}
+		bestError = error;
+		endpoints = refined;
+		memcpy(indices, refinedIndices, sizeof(indices));
+	}
+	if (settings.searchEndpoints){
+		SearchMode6Endpoints(texels, endpoints, indices, bestError);
+	}
+
+	//the first index is stored without its top bit, so it has to be under 8
+	int first = 0;
+	if (indices[0] >= 8){
+		first = 1;
+		for (int i = 0; i < 16; i++){
+			indices[i] = (uint8_t)(15 - indices[i]);
+		}
+	}
+	int second = 1 - first;
+
+	memset(block, 0, 16);
+	uint32_t offset = 0;
+	WriteBits(block, offset, 1 << 6, 7);
+	for (int c = 0; c < 4; c++){
+		WriteBits(block, offset, endpoints.quantized[first][c], 7);
+		WriteBits(block, offset, endpoints.quantized[second][c], 7);
+	}
+	WriteBits(block, offset, endpoints.pBits[first], 1);
+	WriteBits(block, offset, endpoints.pBits[second], 1);
+	WriteBits(block, offset, indices[0], 3);
+	for (int i = 1; i < 16; i++){
+		WriteBits(block, offset, indices[i], 4);
+	}
+}
+
+//Blocks in any other mode decode as transparent black, as reserved modes do on hardware
+static void DecodeMode6Block(const uint8_t* block, uint8_t rgba[64]){
+	if ((block[0] & 0x7F) != 0x40){
+		memset(rgba, 0, 64);
+		return;
+	}
+	uint32_t offset = 7;
+	int e0[4];
+	int e1[4];
+	for (int c = 0; c < 4; c++){
+		e0[c] = (int)ReadBits(block, offset, 7) << 1;
+		e1[c] = (int)ReadBits(block, offset, 7) << 1;
+	}
+	int p0 = (int)ReadBits(block, offset, 1);
+	int p1 = (int)ReadBits(block, offset, 1);
+	for (int c = 0; c < 4; c++){
+		e0[c] |= p0;
+		e1[c] |= p1;
+	}
+	for (int i = 0; i < 16; i++){
+		int index = (int)ReadBits(block, offset, i == 0 ? 3 : 4);
+		for (int c = 0; c < 4; c++){
+			rgba[i * 4 + c] = (uint8_t)(((64 - bc7Weights[index]) * e0[c] + bc7Weights[index] * e1[c] + 32) >> 6);
+		}
+	}
+}
+
+size_t GetBlockBytes(uint32_t format){
+	switch (format){
+	case TEXTURE_FORMAT_BC1:
+	case TEXTURE_FORMAT_BC4:
+		return 8;
+	case TEXTURE_FORMAT_BC3:
+	case TEXTURE_FORMAT_BC5:
+	case TEXTURE_FORMAT_BC7:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+const char* GetTextureFormatName(uint32_t format){
+	switch (format){
+	case TEXTURE_FORMAT_BC1:
+		return "BC1";
+	case TEXTURE_FORMAT_BC3:
+		return "BC3";
+	case TEXTURE_FORMAT_BC4:
+		return "BC4";
+	case TEXTURE_FORMAT_BC5:
+		return "BC5";
+	case TEXTURE_FORMAT_BC7:
+		return "BC7";
+	default:
+		return "unknown";
+	}
+}
+
+unsigned int GetFormatChannels(uint32_t format){
+	switch (format){
+	case TEXTURE_FORMAT_BC1:
+		return 3;
+	case TEXTURE_FORMAT_BC4:
+		return 1;
+	case TEXTURE_FORMAT_BC5:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+size_t GetCompressedSize(uint32_t format, uint32_t width, uint32_t height){
+	return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(format);
+}
+
+void EncodeBlock(uint32_t format, const uint8_t rgba[64], uint8_t* block, BlockQuality quality){
+	BlockSettings settings = GetBlockSettings(quality);
+	BlockTexels texels;
+	LoadTexels(rgba, texels);
+	switch (format){
+	case TEXTURE_FORMAT_BC1:
+		EncodeColorBlock(texels, settings, block);
+		break;
+	case TEXTURE_FORMAT_BC3:
+		EncodeChannelBlock(texels, 3, settings, block);
+		EncodeColorBlock(texels, settings, block + 8);
+		break;
+	case TEXTURE_FORMAT_BC4:
+		EncodeChannelBlock(texels, 0, settings, block);
+		break;
+	case TEXTURE_FORMAT_BC5:
+		EncodeChannelBlock(texels, 0, settings, block);
+		EncodeChannelBlock(texels, 1, settings, block + 8);
+		break;
+	case TEXTURE_FORMAT_BC7:
+		EncodeMode6Block(texels, settings, block);
+		break;
+	}
+}
+
+void DecodeBlock(uint32_t format, const uint8_t* block, uint8_t rgba[64]){
+	switch (format){
+	case TEXTURE_FORMAT_BC1:
+		DecodeColorBlock(block, false, rgba);
+		break;
+	case TEXTURE_FORMAT_BC3:
+		DecodeColorBlock(block + 8, true, rgba);
+		DecodeChannelBlock(block, rgba + 3, 4);
+		break;
+	case TEXTURE_FORMAT_BC4:
+		DecodeChannelBlock(block, rgba, 4);
+		for (int i = 0; i < 16; i++){
+			rgba[i * 4 + 1] = 0;
+			rgba[i * 4 + 2] = 0;
+			rgba[i * 4 + 3] = 255;
+		}
+		break;
+	case TEXTURE_FORMAT_BC5:
+		DecodeChannelBlock(block, rgba, 4);
+		DecodeChannelBlock(block + 8, rgba + 1, 4);
+		for (int i = 0; i < 16; i++){
+			rgba[i * 4 + 2] = 0;
+			rgba[i * 4 + 3] = 255;
+		}
+		break;
+	case TEXTURE_FORMAT_BC7:
+		DecodeMode6Block(block, rgba);
+		break;
+	default:
+		memset(rgba, 0, 64);
+		break;
+	}
+}
+
+//Block rows [firstRow, endRow) of the image
+static void CompressBlockRows(const TextureImage& image, uint32_t format, BlockQuality quality, uint8_t* blocks, uint32_t firstRow, uint32_t endRow){
+	size_t blockBytes = GetBlockBytes(format);
+	blocks += (size_t)firstRow * ((image.width + 3) / 4) * blockBytes;
+	uint8_t rgba[64];
+	for (uint32_t by = firstRow * 4; by < endRow * 4 && by < image.height; by += 4){
+		for (uint32_t bx = 0; bx < image.width; bx += 4){
+			for (uint32_t y = 0; y < 4; y++){
+				uint32_t sy = by + y < image.height ? by + y : image.height - 1;
+				for (uint32_t x = 0; x < 4; x++){
+					uint32_t sx = bx + x < image.width ? bx + x : image.width - 1;
+					memcpy(&rgba[(y * 4 + x) * 4], &image.pixels[((size_t)sy * image.width + sx) * 4], 4);
+				}
+			}
+			EncodeBlock(format, rgba, blocks, quality);
+			blocks += blockBytes;
+		}
+	}
+}
+
+/**
+*Blocks don't depend on each other, so runs of block rows go out as tasks; a few per thread
+*so one busy stretch of the image doesn't hold the rest up. Every task writes its own range
+*of the output.
+**/
+void CompressImage(const TextureImage& image, uint32_t format, BlockQuality quality, uint8_t* blocks, ThreadPool* pool){
+	uint32_t rows = (image.height + 3) / 4;
+	size_t blockCount = (size_t)rows * ((image.width + 3) / 4);
+	size_t taskCount = pool ? (pool->getThreadCount() + 1) * BLOCK_TASKS_PER_THREAD : 1;
+	if (blockCount / BLOCK_TASK_MIN_BLOCKS < taskCount){
+		taskCount = blockCount / BLOCK_TASK_MIN_BLOCKS;
+	}
+	if (taskCount > rows){
+		taskCount = rows;
+	}
+	if (taskCount < 2 || !pool){
+		CompressBlockRows(image, format, quality, blocks, 0, rows);
+		return;
+	}
+
+	std::vector<std::future<void>> compressed;
+	for (size_t t = 1; t < taskCount; t++){
+		uint32_t first = (uint32_t)(rows * t / taskCount);
+		uint32_t end = (uint32_t)(rows * (t + 1) / taskCount);
+		compressed.push_back(pool->submit([&image, format, quality, blocks, first, end](){ CompressBlockRows(image, format, quality, blocks, first, end); }));
+	}
+	CompressBlockRows(image, format, quality, blocks, 0, (uint32_t)(rows / taskCount));
+	for (size_t i = 0; i < compressed.size(); i++){
+		compressed[i].get();
+	}
+}
+
+void DecompressImage(const uint8_t* blocks, uint32_t format, uint32_t width, uint32_t height, TextureImage& image){
+	size_t blockBytes = GetBlockBytes(format);
+	image.width = width;
+	image.height = height;
+	image.pixels.resize((size_t)width * height * 4);
+	uint8_t rgba[64];
+	for (uint32_t by = 0; by < height; by += 4){
+		for (uint32_t bx = 0; bx < width; bx += 4){
+			DecodeBlock(format, blocks, rgba);
+			blocks += blockBytes;
+			for (uint32_t y = 0; y < 4 && by + y < height; y++){
+				for (uint32_t x = 0; x < 4 && bx + x < width; x++){
+					memcpy(&image.pixels[((size_t)(by + y) * width + bx + x) * 4], &rgba[(y * 4 + x) * 4], 4);
+				}
+			}
+		}
+	}
+}
+
+void CompressMips(const std::vector<TextureImage>& mips, uint32_t format, BlockQuality quality, ThreadPool* pool, CompressedTexture& texture){
+	texture.format = format;
+	texture.width = mips.empty() ? 0 : mips[0].width;
+	texture.height = mips.empty() ? 0 : mips[0].height;
+	texture.mipCount = (uint32_t)mips.size();
+	size_t size = 0;
+	for (size_t i = 0; i < mips.size(); i++){
+		size += GetCompressedSize(format, mips[i].width, mips[i].height);
+	}
+	texture.data.resize(size);
+	size_t offset = 0;
+	for (size_t i = 0; i < mips.size(); i++){
+		CompressImage(mips[i], format, quality, &texture.data[offset], pool);
+		offset += GetCompressedSize(format, mips[i].width, mips[i].height);
+	}
+}
+
+void CompressTexture(const TextureImage& image, TextureEncoding encoding, uint32_t format, BlockQuality quality, ThreadPool* pool, CompressedTexture& texture){
+	std::vector<TextureImage> mips;
+	BuildTextureMips(image, (image.width + 3) & ~3u, (image.height + 3) & ~3u, encoding, mips);
+	CompressMips(mips, format, quality, pool, texture);
+}
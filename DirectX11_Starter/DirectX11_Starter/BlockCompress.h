@@ -0,0 +1,74 @@
+#ifndef _BLOCKCOMPRESS_H
+#define _BLOCKCOMPRESS_H
+
+#include "TextureImage.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+/**
+*Block compression encoders and decoders, plain C++ and SSE2 so textures compress anywhere,
+*offline in the cooker or at load time for images that were never cooked.
+*Every format stores 4x4 texel blocks; an image that isn't a multiple of 4 repeats its
+*last row and column into the partial blocks.
+*	BC1	RGB, two 565 endpoints and 2-bit indices along the block's principal axis
+*	BC3	BC1 colour plus alpha as a BC4 block
+*	BC4	one channel, two 8-bit endpoints and 3-bit indices, for masks
+*	BC5	red and green as two BC4 blocks, for tangent space normal maps
+*	BC7	mode 6 only: one RGBA line with 7-bit endpoints, a p-bit each, and 4-bit indices
+*The palette searches run four texels per SSE operation. Images are split into runs of block
+*rows that compress in parallel on a ThreadPool.
+*The decoders follow the D3D rules for the blocks the encoders write, so quality can be
+*measured without a GPU.
+**/
+
+//Formats, same values as the DXGI_FORMAT they describe
+#define TEXTURE_FORMAT_BC1 71 // DXGI_FORMAT_BC1_UNORM
+#define TEXTURE_FORMAT_BC3 77 // DXGI_FORMAT_BC3_UNORM
+#define TEXTURE_FORMAT_BC4 80 // DXGI_FORMAT_BC4_UNORM
+#define TEXTURE_FORMAT_BC5 83 // DXGI_FORMAT_BC5_UNORM
+#define TEXTURE_FORMAT_BC7 98 // DXGI_FORMAT_BC7_UNORM
+
+enum BlockQuality{
+	BLOCK_QUALITY_FAST, // endpoints from the block's bounding box, no refinement; for load time
+	BLOCK_QUALITY_NORMAL, // principal axis endpoints refined by least squares
+	BLOCK_QUALITY_HIGH // more refinement, then a search over neighbouring quantised endpoints
+};
+
+//A whole mip chain, levels back to back, largest first
+struct CompressedTexture{
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t mipCount;
+	std::vector<uint8_t> data;
+};
+
+//Bytes per 4x4 block, 0 for formats this doesn't know
+size_t GetBlockBytes(uint32_t format);
+const char* GetTextureFormatName(uint32_t format);
+//How many leading channels of a decoded texel the format stores: 4 for BC7 and BC3, 3 for BC1, 2 for BC5, 1 for BC4
+unsigned int GetFormatChannels(uint32_t format);
+
+//Bytes of one level, width and height rounded up to whole blocks
+size_t GetCompressedSize(uint32_t format, uint32_t width, uint32_t height);
+
+//rgba is 16 texels in rows of 4
+void EncodeBlock(uint32_t format, const uint8_t rgba[64], uint8_t* block, BlockQuality quality);
+void DecodeBlock(uint32_t format, const uint8_t* block, uint8_t rgba[64]);
+
+//blocks must hold GetCompressedSize bytes. With a pool the calling thread takes a share too,
+//so it mustn't be called from one of the pool's own tasks
+void CompressImage(const TextureImage& image, uint32_t format, BlockQuality quality, uint8_t* blocks, ThreadPool* pool = nullptr);
+//Channels a format doesn't store decode as 0, alpha as 255
+void DecompressImage(const uint8_t* blocks, uint32_t format, uint32_t width, uint32_t height, TextureImage& image);
+
+//Compresses every level of a chain from BuildTextureMips
+void CompressMips(const std::vector<TextureImage>& mips, uint32_t format, BlockQuality quality, ThreadPool* pool, CompressedTexture& texture);
+
+//Mips and compression in one go, the top level grown to whole blocks as D3D11 requires
+void CompressTexture(const TextureImage& image, TextureEncoding encoding, uint32_t format, BlockQuality quality, ThreadPool* pool, CompressedTexture& texture);
+
+#endif
@@ -0,0 +1,111 @@
+#include "CaptureWriter.h"
+#include "TextureFile.h"
+#include <cstdio>
+#include <cstring>
+
+CaptureWriter::CaptureWriter(ThreadPool* pool, const std::string& pathPrefix, CaptureFormat format, unsigned int maxPending){
+	workers = pool;
+	prefix = pathPrefix;
+	fileFormat = format;
+	maxQueued = maxPending > 0 ? maxPending : 1;
+	pending = 0;
+	written = 0;
+	failed = 0;
+}
+
+CaptureWriter::~CaptureWriter(void){
+	finish();
+	for (size_t i = 0; i < freeImages.size(); i++){
+		delete freeImages[i];
+	}
+	freeImages.clear();
+}
+
+bool CaptureWriter::submit(const uint8_t* rows, uint32_t rowPitch, uint32_t width, uint32_t height, unsigned int frame, bool bgra, std::atomic<bool>* copied){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (pending >= maxQueued){
+			return false;
+		}
+		pending++;
+	}
+	workers->submit([=](){ write(rows, rowPitch, width, height, frame, bgra, copied); });
+	return true;
+}
+
+//Runs on a worker
+void CaptureWriter::write(const uint8_t* rows, uint32_t rowPitch, uint32_t width, uint32_t height, unsigned int frame, bool bgra, std::atomic<bool>* copied){
+	TextureImage* image = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!freeImages.empty()){
+			image = freeImages.back();
+			freeImages.pop_back();
+		}
+	}
+	if (!image){
+		image = new TextureImage();
+	}
+	image->width = width;
+	image->height = height;
+	//same size as last time keeps the pages already touched
+	image->pixels.resize((size_t)width * height * 4);
+	size_t rowBytes = (size_t)width * 4;
+	for (uint32_t y = 0; y < height; y++){
+		memcpy(&image->pixels[y * rowBytes], rows + (size_t)y * rowPitch, rowBytes);
+	}
+	if (copied){
+		copied->store(true);
+	}
+
+	std::vector<uint8_t>& pixels = image->pixels;
+	for (size_t i = 0; i < pixels.size(); i += 4){
+		if (bgra){
+			uint8_t blue = pixels[i];
+			pixels[i] = pixels[i + 2];
+			pixels[i + 2] = blue;
+		}
+		pixels[i + 3] = 0xFF;
+	}
+
+	std::string path = GetFramePath(prefix, frame, fileFormat);
+	bool saved = fileFormat == CAPTURE_PNG ? SaveTextureImage(path, *image) : WriteImageTextureFile(path, width, height, &pixels[0]);
+
+	//notified under the lock, finish() may return and the writer go the moment it can take it
+	std::lock_guard<std::mutex> lock(mutex);
+	freeImages.push_back(image);
+	if (saved){
+		written++;
+	}
+	else{
+		failed++;
+	}
+	pending--;
+	idle.notify_all();
+}
+
+void CaptureWriter::finish(){
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this](){ return pending == 0; });
+}
+
+unsigned int CaptureWriter::getWrittenCount(){
+	std::lock_guard<std::mutex> lock(mutex);
+	return written;
+}
+
+unsigned int CaptureWriter::getFailedCount(){
+	std::lock_guard<std::mutex> lock(mutex);
+	return failed;
+}
+
+unsigned int CaptureWriter::getPendingCount(){
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending;
+}
+
+std::string CaptureWriter::GetFramePath(const std::string& pathPrefix, unsigned int frame, CaptureFormat format){
+	char number[16];
+	sprintf(number, "%05u", frame);
+	return pathPrefix + number + (format == CAPTURE_PNG ? ".png" : TEXTURE_FILE_EXTENSION);
+}
@@ -0,0 +1,74 @@
+#ifndef _CAPTUREWRITER_H
+#define _CAPTUREWRITER_H
+
+#include "TextureImage.h"
+#include "ThreadPool.h"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+//What each captured frame is saved as
+enum CaptureFormat{
+	CAPTURE_PNG, // small, costs a worker around 20ms a 720p frame
+	CAPTURE_DDS // uncompressed RGBA8, next to free to write but four bytes a pixel on disk
+};
+
+#define CAPTURE_MAX_PENDING 8 // frames waiting for or being written before new ones are dropped
+
+/**
+*Encoding and writing half of a frame capture. No D3D in here.
+*submit() only queues a frame: a ThreadPool worker copies its rows into a buffer from the
+*free list, sets the caller's flag so the rows can be let go of, fixes up the pixels, encodes
+*them and writes <prefix><frame>.png or .dds. The calling thread never touches the pixels,
+*so the rows can be a mapped staging texture, and a steady capture stops allocating after
+*the first few frames. Once maxPending frames are queued submit() refuses new ones and the
+*caller drops them instead of stalling on the disk.
+*Frames are the back buffer, whose alpha the display ignores, so every pixel is written opaque.
+**/
+class CaptureWriter{
+public:
+	CaptureWriter(ThreadPool* pool, const std::string& pathPrefix, CaptureFormat format, unsigned int maxPending);
+	//Waits for every queued frame
+	~CaptureWriter(void);
+
+	/**
+	*Queues a width x height frame of 8-bit RGBA rows, rowPitch bytes apart, to be written as
+	*frame number frame; bgra swaps red and blue first. rows has to stay valid until *copied
+	*is set, or until finish() returns if copied is nullptr.
+	*False, with nothing queued, if maxPending frames already are
+	**/
+	bool submit(const uint8_t* rows, uint32_t rowPitch, uint32_t width, uint32_t height, unsigned int frame, bool bgra, std::atomic<bool>* copied);
+
+	//Blocks until every submitted frame is written
+	void finish();
+
+	unsigned int getWrittenCount();
+	unsigned int getFailedCount();
+	unsigned int getPendingCount();
+
+	//<prefix>00042.png
+	static std::string GetFramePath(const std::string& pathPrefix, unsigned int frame, CaptureFormat format);
+
+private:
+	void write(const uint8_t* rows, uint32_t rowPitch, uint32_t width, uint32_t height, unsigned int frame, bool bgra, std::atomic<bool>* copied);
+
+	ThreadPool* workers;
+	std::string prefix;
+	CaptureFormat fileFormat;
+	unsigned int maxQueued;
+
+	std::mutex mutex;
+	std::condition_variable idle;
+	std::vector<TextureImage*> freeImages;
+	unsigned int pending; // submitted and not yet written
+	unsigned int written;
+	unsigned int failed;
+
+	// Prevent copying.
+	CaptureWriter(CaptureWriter const&);
+	CaptureWriter& operator= (CaptureWriter const&);
+};
+
+#endif
@@ -2,7 +2,7 @@
 #include "Game.h"
 
 //Constructor for Collectable object
-Collectable::Collectable(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed){
+Collectable::Collectable(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed){
 
 	// set up the lighting parameters
 	lighting.ambientColor = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
@@ -14,8 +14,8 @@ Collectable::Collectable(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<
 	device = dev;
 	deviceContext = devCtx;
 	sampler = samplerState;
-	shaderProgram = new ShaderProgram(L"NormalVertexShader.cso", L"NormalPixelShader.cso", device, constantBufferList);
-	collectableMaterial = new Material(device, deviceContext, sampler, L"star.png", shaderProgram);
+	shaderProgram = assets->getMeshShaderProgram(MESH_SHADER_LIT, constantBufferList);
+	collectableMaterial = new Material(assets, sampler, L"star.png", shaderProgram);
 	player = playerReference;
 	mesh = meshReference;
 
@@ -41,10 +41,6 @@ Collectable::~Collectable(){
 		delete collectableMaterial;
 		collectableMaterial = nullptr;
 	}
-	if (shaderProgram){
-		delete shaderProgram;
-		shaderProgram = nullptr;
-	}
 }
 
 
@@ -93,22 +89,35 @@ void Collectable::update(float dt){
 
 
 //draw collectables
-void Collectable::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos){
+void Collectable::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context){
 	UINT offset = 0;
 	UINT stride = sizeof(Vertex);
 
+	//only submit what the camera can see
+	culler.setCamera(viewMatrix, projectionMatrix);
+	culler.clear();
 	for (unsigned int i = 0; i < collectables.size(); i++){
+		XMFLOAT3 center;
+		float radius;
+		collectables[i]->getBoundingSphere(center, radius);
+		culler.add(center, radius);
+	}
+	culler.cull();
+
+	for (unsigned int v = 0; v < culler.getVisibleCount(); v++){
+		unsigned int i = culler.getVisible(v);
 		//UINT offset = 0;
 		stride = collectables[i]->g_mesh->sizeofvertex;
 		// Set up the input assembler
-		deviceContext->IASetInputLayout(collectables[i]->g_mat->shaderProgram->vsInputLayout);
-		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context->IASetInputLayout(collectables[i]->g_mat->shaderProgram->vsInputLayout);
+		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 		//set values that get passed to matrix constant buffer
 
 		collectables[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = collectables[i]->getWorld();
 		collectables[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
 		collectables[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+		collectables[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = collectables[i]->g_mat->uvTransform;
 
 		//set values that get passed to lighting constant buffer
 		collectables[i]->g_mat->shaderProgram->ConstantBuffers[1]->dataToSendToLightBuffer.ambientColor = lighting.ambientColor;
@@ -123,7 +132,7 @@ void Collectable::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLO
 
 
 		//matrix constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			collectables[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer,
 			0,
 			NULL,
@@ -132,7 +141,7 @@ void Collectable::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLO
 			0);
 
 		//camera constant buffer 
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			collectables[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer,
 			0,
 			NULL,
@@ -140,7 +149,7 @@ void Collectable::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLO
 			0,
 			0);
 		//light constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			collectables[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer,
 			0,
 			NULL,
@@ -148,25 +157,29 @@ void Collectable::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLO
 			0,
 			0);
 
-		deviceContext->IASetVertexBuffers(0, 1, &collectables[i]->g_mesh->v_buffer, &stride, &offset);
-		deviceContext->IASetIndexBuffer(collectables[i]->g_mesh->i_buffer, DXGI_FORMAT_R32_UINT, 0);
+		context->IASetVertexBuffers(0, 1, &collectables[i]->g_mesh->v_buffer, &stride, &offset);
+		context->IASetIndexBuffer(collectables[i]->g_mesh->i_buffer, collectables[i]->g_mesh->indexFormat, 0);
 
-		deviceContext->PSSetSamplers(0, 1, &collectables[i]->g_mat->samplerState);
-		deviceContext->PSSetShaderResources(0, 1, &collectables[i]->g_mat->resourceView);
+		context->PSSetSamplers(0, 1, &collectables[i]->g_mat->samplerState);
+		context->PSSetShaderResources(0, 1, &collectables[i]->g_mat->resourceView);
 
 
 
 		// Set the current vertex and pixel shaders, as well the constant buffer for the vert shader
-		deviceContext->VSSetShader(collectables[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
-		deviceContext->VSSetConstantBuffers(0, 1, &collectables[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
-		deviceContext->VSSetConstantBuffers(1, 1, &collectables[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
-		deviceContext->PSSetShader(collectables[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
-		deviceContext->PSSetConstantBuffers(0, 1, &collectables[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
+		context->VSSetShader(collectables[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
+		context->VSSetConstantBuffers(0, 1, &collectables[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
+		context->VSSetConstantBuffers(1, 1, &collectables[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
+		context->PSSetShader(collectables[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
+		context->PSSetConstantBuffers(0, 1, &collectables[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
 
 		// Finally do the actual drawing
-		deviceContext->DrawIndexed(
+		context->DrawIndexed(
 			collectables.at(i)->g_mesh->m_size,	// The number of indices we're using in this draw
 			0,
 			0);
 	}
 }
+
+CullStats Collectable::getCullStats(){
+	return culler.getStats();
+}
@@ -8,6 +8,7 @@
 #include "Mesh.h"
 #include "GameEntity.h"
 #include "Material.h"
+#include "AssetManager.h"
 #include "ShaderProgram.h"
 #include "SamplerState.h"
 #include "Global.h"
@@ -15,6 +16,7 @@
 #include "StateManager.h"
 #include "FW1FontWrapper.h"
 #include "Player.h"
+#include "FrustumCuller.h"
 #include "StateManager.h"
 #include "SimpleMath.h"
 
@@ -24,15 +26,17 @@ using namespace DirectX;
 
 class Collectable{
 public:
-	Collectable(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed);
+	Collectable(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed);
 	~Collectable(void);
 	void update(float dt);
-	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos);
+	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context);
+	CullStats getCullStats(); // visible/culled counts from the last draw
 	GameEntity* getCollectable();
 
 	// list of Collectables present in the game
 	std::vector<GameEntity*> collectables;
 private:
+	FrustumCuller culler;
 	Player* player;
 	Mesh* mesh;
 	ShaderProgram* shaderProgram;
@@ -0,0 +1,32 @@
+#ifndef _COMMANDBACKEND_H
+#define _COMMANDBACKEND_H
+
+/**
+*What ParallelRenderQueue needs from a graphics API.
+*TContext is whatever the render jobs draw with (ID3D11DeviceContext for the game).
+*Call order for one flush, with N = getWorkerCount():
+*	beginFlush()                                  submitting thread
+*	beginRecording(k) ... endRecording(k)         worker k's thread, k < N
+*	executeRecording(0) ... executeRecording(N-1) submitting thread, in order
+*	endFlush()                                    submitting thread
+*With N == 0 jobs are run directly on getImmediateContext() and none of the above is called.
+**/
+template<typename TContext>
+class CommandBackend{
+public:
+	virtual ~CommandBackend(void){}
+
+	virtual unsigned int getWorkerCount() = 0;
+	virtual TContext* getImmediateContext() = 0;
+
+	//Snapshot whatever the recordings inherit (render targets, viewport, fixed function state)
+	virtual void beginFlush() = 0;
+	//Returns the context worker k records into, with the snapshot applied
+	virtual TContext* beginRecording(unsigned int worker) = 0;
+	virtual void endRecording(unsigned int worker) = 0;
+	//Plays worker k's recording on the immediate context
+	virtual void executeRecording(unsigned int worker) = 0;
+	virtual void endFlush() = 0;
+};
+
+#endif
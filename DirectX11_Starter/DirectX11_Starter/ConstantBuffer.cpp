@@ -3,6 +3,7 @@
 ConstantBuffer::ConstantBuffer(ConstantBufferLayout c_buffer_data, ID3D11Device* dev)
 {
 	c_byteWidth = sizeof(ConstantBufferLayout);
+	dataToSendToConstantBuffer.uvTransform = XMFLOAT4(1.0f, 1.0f, 0.0f, 0.0f);
 	setUpConstantBuffer(dev);
 }
 
@@ -23,7 +24,14 @@ ConstantBuffer::ConstantBuffer(CameraBufferType c_buffer_data, ID3D11Device* dev
 ConstantBuffer::ConstantBuffer(ParticleVertexShaderConstantBufferLayout c_buffer_data, ID3D11Device* dev)
 {
 
-	c_byteWidth = 16;
+	c_byteWidth = sizeof(ParticleVertexShaderConstantBufferLayout);
+	setUpConstantBuffer(dev);
+}
+
+ConstantBuffer::ConstantBuffer(ParticleUpdateConstantBufferLayout c_buffer_data, ID3D11Device* dev)
+{
+
+	c_byteWidth = sizeof(ParticleUpdateConstantBufferLayout);
 	setUpConstantBuffer(dev);
 }
 
@@ -5,8 +5,25 @@
 #include <unordered_map>
 #include <string>
 #include "Global.h"
+#include "ShaderLayouts.h" // generated into $(IntDir) from the compiled shaders before anything compiles
 
 using namespace DirectX;
+
+//Constant buffer layouts, generated from the compiled shaders so they can't drift.
+//perModel's uvTransform is the Material::uvTransform of the draw
+typedef PerModelLayout ConstantBufferLayout;
+typedef GeoBufferLayout ParticleVertexShaderConstantBufferLayout;
+typedef CameraBufferLayout CameraBufferType;
+typedef LightBufferLayout LightBufferType;
+
+//The mesh shaders read Vertex2 or the front of it
+static_assert(sizeof(Vertex2) == sizeof(MeshVertexShader_LNInput) && offsetof(Vertex2, Normal) == offsetof(MeshVertexShader_LNInput, normal) &&
+	offsetof(Vertex2, UVs) == offsetof(MeshVertexShader_LNInput, texcoord1) && offsetof(Vertex2, Tangent) == offsetof(MeshVertexShader_LNInput, tangent), "Vertex2 doesn't match MeshVertexShader_LN");
+static_assert(sizeof(MeshVertexShader_LInput) <= sizeof(Vertex2) && offsetof(Vertex2, UVs) == offsetof(MeshVertexShader_LInput, texcoord1) &&
+	offsetof(Vertex2, UVs) == offsetof(MeshVertexShaderInput, texcoord1), "Vertex2 doesn't start with what MeshVertexShader and MeshVertexShader_L read");
+static_assert(sizeof(Particle) == sizeof(GeometryVertexShaderInput) && offsetof(Particle, velocity) == offsetof(GeometryVertexShaderInput, texcoord) &&
+	offsetof(Particle, acceleration) == offsetof(GeometryVertexShaderInput, texcoord1), "Particle doesn't match GeometryVertexShader");
+
 class ConstantBuffer{
 public:
 	int c_byteWidth;
@@ -14,11 +31,13 @@ public:
 	ParticleVertexShaderConstantBufferLayout dataToSendToGSBuffer;
 	LightBufferType dataToSendToLightBuffer;
 	CameraBufferType dataToSendToCameraBuffer;
+	ParticleUpdateConstantBufferLayout dataToSendToParticleUpdateBuffer;
 	ID3D11Buffer* constantBuffer;
 	ConstantBuffer(ConstantBufferLayout c_buffer_data, ID3D11Device* dev);
 	ConstantBuffer(ParticleVertexShaderConstantBufferLayout c_buffer_data, ID3D11Device* dev);
 	ConstantBuffer(LightBufferType c_buffer_data, ID3D11Device* dev);
 	ConstantBuffer(CameraBufferType c_buffer_data, ID3D11Device* dev);
+	ConstantBuffer(ParticleUpdateConstantBufferLayout c_buffer_data, ID3D11Device* dev);
 	~ConstantBuffer(void);
 private:
 	void setUpConstantBuffer(ID3D11Device* dev);
@@ -0,0 +1,130 @@
+#include "CpuParticleSystem.h"
+
+/**
+*CPU particle system constructor
+*mat: particle texture and the geometry shader program it is drawn with
+*max_particles: size of the pool and of the dynamic vertex buffer
+**/
+CpuParticleSystem::CpuParticleSystem(ID3D11Device* dev, ID3D11DeviceContext* devCtx, Material* mat, unsigned int max_particles)
+	: particles(max_particles)
+{
+	device = dev;
+	deviceContext = devCtx;
+	material = mat;
+	vertexCount = 0;
+	vertexBuffer = nullptr;
+	vertices.resize(max_particles);
+
+	D3D11_BUFFER_DESC vbd;
+	vbd.Usage = D3D11_USAGE_DYNAMIC;
+	vbd.ByteWidth = sizeof(Particle) * max_particles;
+	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vbd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	vbd.MiscFlags = 0;
+	vbd.StructureByteStride = 0;
+	device->CreateBuffer(&vbd, NULL, &vertexBuffer);
+
+	D3D11_BLEND_DESC blendDesc;
+	ZeroMemory(&blendDesc, sizeof(blendDesc));
+	blendDesc.RenderTarget[0].BlendEnable = TRUE;
+	blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+	blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+	blendDesc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ZERO;
+	blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+	blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+	blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+	stateCache = PipelineStateCache::ForDevice(device);
+	blendState = stateCache->getBlendState(blendDesc);
+}
+
+CpuParticleSystem::~CpuParticleSystem(void)
+{
+	ReleaseMacro(vertexBuffer);
+}
+
+int CpuParticleSystem::addEmitter(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime, unsigned int particles_per_lifetime)
+{
+	return particles.addEmitter(position, velocity, acceleration, lifetime, particles_per_lifetime);
+}
+
+//Simulate, then write the live particles into the dynamic vertex buffer
+void CpuParticleSystem::update(float dt)
+{
+	particles.update(dt);
+	vertexCount = particles.writeVertices(&vertices[0], vertices.size());
+
+	if (!vertexBuffer || vertexCount == 0){
+		return;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mapped;
+	if (SUCCEEDED(deviceContext->Map(vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))){
+		memcpy(mapped.pData, &vertices[0], sizeof(Particle) * vertexCount);
+		deviceContext->Unmap(vertexBuffer, 0);
+	}
+}
+
+void CpuParticleSystem::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix)
+{
+	if (!vertexBuffer || vertexCount == 0){
+		return;
+	}
+
+	ShaderProgram* program = material->shaderProgram;
+	UINT offset = 0;
+	UINT stride = sizeof(Particle);
+
+	deviceContext->IASetInputLayout(program->vsInputLayout);
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+	deviceContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+
+	XMFLOAT4X4 world;
+	XMStoreFloat4x4(&world, XMMatrixIdentity());
+	program->ConstantBuffers[0]->dataToSendToConstantBuffer.world = world;
+	program->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
+	program->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+	program->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = material->uvTransform;
+	//positions are already integrated, so the vertex shader must not advance them again
+	program->ConstantBuffers[3]->dataToSendToGSBuffer.age = 0.0f;
+
+	//matrix constant buffer
+	deviceContext->UpdateSubresource(
+		program->ConstantBuffers[0]->constantBuffer,
+		0,
+		NULL,
+		&program->ConstantBuffers[0]->dataToSendToConstantBuffer,
+		0,
+		0);
+
+	deviceContext->UpdateSubresource(
+		program->ConstantBuffers[3]->constantBuffer,
+		0,
+		NULL,
+		&program->ConstantBuffers[3]->dataToSendToGSBuffer,
+		0,
+		0);
+
+	deviceContext->VSSetShader(program->vertexShader, NULL, 0);
+	deviceContext->VSSetConstantBuffers(0, 1, &program->ConstantBuffers[3]->constantBuffer);
+
+	deviceContext->GSSetShader(program->geometryShader, NULL, 0);
+	deviceContext->GSSetConstantBuffers(0, 1, &program->ConstantBuffers[0]->constantBuffer);
+
+	deviceContext->PSSetShader(program->pixelShader, NULL, 0);
+	deviceContext->PSSetSamplers(0, 1, &material->samplerState);
+	deviceContext->PSSetShaderResources(0, 1, &material->resourceView);
+
+	stateCache->setBlendState(deviceContext, blendState);
+
+	deviceContext->Draw(vertexCount, 0);
+
+	//unbind geometry shader
+	deviceContext->GSSetShader(NULL, NULL, 0);
+}
+
+unsigned int CpuParticleSystem::getParticleCount()
+{
+	return particles.getCount();
+}
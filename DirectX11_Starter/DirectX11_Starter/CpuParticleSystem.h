@@ -0,0 +1,41 @@
+#ifndef _CPUPARTICLESYSTEM_H
+#define _CPUPARTICLESYSTEM_H
+
+#include "Global.h"
+#include "Material.h"
+#include "ConstantBuffer.h"
+#include "ParticleSoA.h"
+#include "PipelineStateCache.h"
+#include <Windows.h>
+#include <d3d11.h>
+#include <vector>
+#include <memory>
+
+//Particle system simulated on the CPU by ParticleSoA and uploaded every frame into a dynamic
+//vertex buffer. Draws with the material's geometry shader program (GeometryVertexShader,
+//GeometryShader) so it works on devices without compute shader support.
+class CpuParticleSystem{
+public:
+	CpuParticleSystem(ID3D11Device* dev, ID3D11DeviceContext* devCtx, Material* mat, unsigned int max_particles);
+	~CpuParticleSystem(void);
+
+	int addEmitter(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime, unsigned int particles_per_lifetime = 20);
+	void update(float dt);
+	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix);
+
+	unsigned int getParticleCount();
+
+private:
+	ID3D11Device* device;
+	ID3D11DeviceContext* deviceContext;
+	Material* material;
+
+	ParticleSoA particles;
+	std::vector<Particle> vertices;
+	ID3D11Buffer* vertexBuffer;
+	unsigned int vertexCount;
+
+	std::shared_ptr<PipelineStateCache> stateCache;
+	BlendStateHandle blendState;
+};
+#endif
@@ -0,0 +1,95 @@
+#include "D3D11CommandBackend.h"
+#include "Global.h"
+
+/**
+*workers: number of deferred contexts; if one can't be created the backend runs with fewer
+**/
+D3D11CommandBackend::D3D11CommandBackend(ID3D11Device* dev, ID3D11DeviceContext* immediateContext, unsigned int workers){
+	immediate = immediateContext;
+	renderTarget = nullptr;
+	depthStencil = nullptr;
+	viewportCount = 0;
+	blendState = nullptr;
+	sampleMask = 0xffffffff;
+	depthStencilState = nullptr;
+	stencilRef = 0;
+	rasterizerState = nullptr;
+
+	for (unsigned int i = 0; i < workers; i++){
+		ID3D11DeviceContext* deferred = nullptr;
+		if (FAILED(dev->CreateDeferredContext(0, &deferred))){
+			break;
+		}
+		deferredContexts.push_back(deferred);
+		commandLists.push_back(nullptr);
+	}
+}
+
+D3D11CommandBackend::~D3D11CommandBackend(void){
+	releaseSnapshot();
+	for (size_t i = 0; i < deferredContexts.size(); i++){
+		ReleaseMacro(commandLists[i]);
+		ReleaseMacro(deferredContexts[i]);
+	}
+}
+
+bool D3D11CommandBackend::SupportsCommandLists(ID3D11Device* dev){
+	D3D11_FEATURE_DATA_THREADING threading;
+	if (FAILED(dev->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading)))){
+		return false;
+	}
+	return threading.DriverCommandLists != FALSE;
+}
+
+unsigned int D3D11CommandBackend::getWorkerCount(){
+	return deferredContexts.size();
+}
+
+ID3D11DeviceContext* D3D11CommandBackend::getImmediateContext(){
+	return immediate;
+}
+
+//The Get calls add references, released in endFlush
+void D3D11CommandBackend::beginFlush(){
+	releaseSnapshot();
+	immediate->OMGetRenderTargets(1, &renderTarget, &depthStencil);
+	viewportCount = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+	immediate->RSGetViewports(&viewportCount, viewports);
+	immediate->OMGetBlendState(&blendState, blendFactor, &sampleMask);
+	immediate->OMGetDepthStencilState(&depthStencilState, &stencilRef);
+	immediate->RSGetState(&rasterizerState);
+}
+
+ID3D11DeviceContext* D3D11CommandBackend::beginRecording(unsigned int worker){
+	ID3D11DeviceContext* context = deferredContexts[worker];
+	context->OMSetRenderTargets(1, &renderTarget, depthStencil);
+	context->RSSetViewports(viewportCount, viewports);
+	context->OMSetBlendState(blendState, blendFactor, sampleMask);
+	context->OMSetDepthStencilState(depthStencilState, stencilRef);
+	context->RSSetState(rasterizerState);
+	return context;
+}
+
+void D3D11CommandBackend::endRecording(unsigned int worker){
+	ReleaseMacro(commandLists[worker]);
+	deferredContexts[worker]->FinishCommandList(FALSE, &commandLists[worker]);
+}
+
+void D3D11CommandBackend::executeRecording(unsigned int worker){
+	if (commandLists[worker]){
+		immediate->ExecuteCommandList(commandLists[worker], TRUE);
+		ReleaseMacro(commandLists[worker]);
+	}
+}
+
+void D3D11CommandBackend::endFlush(){
+	releaseSnapshot();
+}
+
+void D3D11CommandBackend::releaseSnapshot(){
+	ReleaseMacro(renderTarget);
+	ReleaseMacro(depthStencil);
+	ReleaseMacro(blendState);
+	ReleaseMacro(depthStencilState);
+	ReleaseMacro(rasterizerState);
+}
@@ -0,0 +1,50 @@
+#ifndef _D3D11COMMANDBACKEND_H
+#define _D3D11COMMANDBACKEND_H
+
+#include "CommandBackend.h"
+#include <Windows.h>
+#include <d3d11.h>
+#include <vector>
+
+//CommandBackend over D3D11 deferred contexts, one per worker.
+//Each recording starts from the immediate context's render targets, viewport and
+//blend/depth/rasterizer state as they were at beginFlush, and command lists are executed with
+//RestoreContextState so the immediate context is left as it was.
+class D3D11CommandBackend : public CommandBackend<ID3D11DeviceContext>{
+public:
+	D3D11CommandBackend(ID3D11Device* dev, ID3D11DeviceContext* immediateContext, unsigned int workers);
+	~D3D11CommandBackend(void);
+
+	unsigned int getWorkerCount();
+	ID3D11DeviceContext* getImmediateContext();
+	void beginFlush();
+	ID3D11DeviceContext* beginRecording(unsigned int worker);
+	void endRecording(unsigned int worker);
+	void executeRecording(unsigned int worker);
+	void endFlush();
+
+	//True when the driver builds command lists itself; otherwise the runtime emulates them
+	//and recording on other threads gains nothing
+	static bool SupportsCommandLists(ID3D11Device* dev);
+
+private:
+	void releaseSnapshot();
+
+	ID3D11DeviceContext* immediate;
+	std::vector<ID3D11DeviceContext*> deferredContexts;
+	std::vector<ID3D11CommandList*> commandLists;
+
+	//state inherited by every recording
+	ID3D11RenderTargetView* renderTarget;
+	ID3D11DepthStencilView* depthStencil;
+	D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
+	UINT viewportCount;
+	ID3D11BlendState* blendState;
+	FLOAT blendFactor[4];
+	UINT sampleMask;
+	ID3D11DepthStencilState* depthStencilState;
+	UINT stencilRef;
+	ID3D11RasterizerState* rasterizerState;
+};
+
+#endif
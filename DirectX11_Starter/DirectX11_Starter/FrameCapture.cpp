@@ -0,0 +1,211 @@
+#include "FrameCapture.h"
+#include "Global.h"
+#include <chrono>
+#include <cstring>
+
+FrameCapture::FrameCapture(ID3D11Device* dev, CaptureWriter* captureWriter, unsigned int ringSize){
+	device = dev;
+	writer = captureWriter;
+	ringCount = ringSize > 0 ? ringSize : 1;
+	ring = new StagingFrame[ringCount];
+	for (unsigned int i = 0; i < ringCount; i++){
+		ring[i].texture = nullptr;
+		ring[i].state = STAGING_FREE;
+		ring[i].frame = 0;
+		ring[i].copied = false;
+	}
+	oldest = 0;
+	inFlight = 0;
+	resolved = nullptr;
+	memset(&desc, 0, sizeof(desc));
+	bgra = false;
+	captured = 0;
+	dropped = 0;
+	calls = 0;
+	totalMilliseconds = 0.0;
+	maxMilliseconds = 0.0;
+}
+
+FrameCapture::~FrameCapture(void){
+	//workers may still be reading mapped rows
+	writer->finish();
+	releaseRing();
+	delete[] ring;
+}
+
+void FrameCapture::releaseRing(){
+	for (unsigned int i = 0; i < ringCount; i++){
+		ReleaseMacro(ring[i].texture);
+		ring[i].state = STAGING_FREE;
+	}
+	ReleaseMacro(resolved);
+	oldest = 0;
+	inFlight = 0;
+	memset(&desc, 0, sizeof(desc));
+}
+
+bool FrameCapture::createRing(const D3D11_TEXTURE2D_DESC& sourceDesc){
+	releaseRing();
+	switch (sourceDesc.Format){
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		bgra = false;
+		break;
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+		bgra = true;
+		break;
+	default:
+		return false;
+	}
+
+	D3D11_TEXTURE2D_DESC stagingDesc;
+	stagingDesc.Width = sourceDesc.Width;
+	stagingDesc.Height = sourceDesc.Height;
+	stagingDesc.MipLevels = 1;
+	stagingDesc.ArraySize = 1;
+	stagingDesc.Format = sourceDesc.Format;
+	stagingDesc.SampleDesc.Count = 1;
+	stagingDesc.SampleDesc.Quality = 0;
+	stagingDesc.Usage = D3D11_USAGE_STAGING;
+	stagingDesc.BindFlags = 0;
+	stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	stagingDesc.MiscFlags = 0;
+	for (unsigned int i = 0; i < ringCount; i++){
+		if (FAILED(device->CreateTexture2D(&stagingDesc, nullptr, &ring[i].texture))){
+			releaseRing();
+			return false;
+		}
+	}
+
+	//staging textures can't be multisampled, the frame is resolved into this first
+	if (sourceDesc.SampleDesc.Count > 1){
+		D3D11_TEXTURE2D_DESC resolveDesc = stagingDesc;
+		resolveDesc.Usage = D3D11_USAGE_DEFAULT;
+		resolveDesc.CPUAccessFlags = 0;
+		if (FAILED(device->CreateTexture2D(&resolveDesc, nullptr, &resolved))){
+			releaseRing();
+			return false;
+		}
+	}
+	desc = sourceDesc;
+	return true;
+}
+
+void FrameCapture::advance(ID3D11DeviceContext* context, bool wait){
+	for (unsigned int n = 0; n < inFlight; n++){
+		StagingFrame& staging = ring[(oldest + n) % ringCount];
+		if (staging.state == STAGING_MAPPED && staging.copied.load()){
+			context->Unmap(staging.texture, 0);
+			staging.state = STAGING_FREE;
+		}
+		else if (staging.state == STAGING_COPYING){
+			//copies finish in order, once one isn't done none after it are
+			D3D11_MAPPED_SUBRESOURCE mapped;
+			HRESULT hr = context->Map(staging.texture, 0, D3D11_MAP_READ, wait ? 0 : D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+			if (hr == DXGI_ERROR_WAS_STILL_DRAWING){
+				break;
+			}
+			if (FAILED(hr)){
+				staging.state = STAGING_FREE;
+				dropped++;
+				continue;
+			}
+			staging.copied = false;
+			bool queued = writer->submit(static_cast<const uint8_t*>(mapped.pData), mapped.RowPitch, desc.Width, desc.Height, staging.frame, bgra, &staging.copied);
+			if (!queued && wait){
+				writer->finish();
+				queued = writer->submit(static_cast<const uint8_t*>(mapped.pData), mapped.RowPitch, desc.Width, desc.Height, staging.frame, bgra, &staging.copied);
+			}
+			if (queued){
+				staging.state = STAGING_MAPPED;
+				captured++;
+			}
+			else{
+				context->Unmap(staging.texture, 0);
+				staging.state = STAGING_FREE;
+				dropped++;
+			}
+		}
+	}
+	//slots are reused in order, so only the free ones at the front go back
+	while (inFlight > 0 && ring[oldest].state == STAGING_FREE){
+		oldest = (oldest + 1) % ringCount;
+		inFlight--;
+	}
+}
+
+void FrameCapture::capture(ID3D11DeviceContext* context, ID3D11Texture2D* source, unsigned int frame){
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	D3D11_TEXTURE2D_DESC sourceDesc;
+	source->GetDesc(&sourceDesc);
+	//a resize or a new format needs a new ring, what the old one holds is finished first
+	if (sourceDesc.Width != desc.Width || sourceDesc.Height != desc.Height || sourceDesc.Format != desc.Format || sourceDesc.SampleDesc.Count != desc.SampleDesc.Count){
+		flush(context);
+		createRing(sourceDesc);
+	}
+
+	if (desc.Width == 0){
+		dropped++;
+	}
+	else{
+		advance(context, false);
+		if (inFlight == ringCount){
+			dropped++;
+		}
+		else{
+			StagingFrame& staging = ring[(oldest + inFlight) % ringCount];
+			if (resolved){
+				context->ResolveSubresource(resolved, 0, source, 0, desc.Format);
+				context->CopyResource(staging.texture, resolved);
+			}
+			else{
+				context->CopyResource(staging.texture, source);
+			}
+			staging.state = STAGING_COPYING;
+			staging.frame = frame;
+			inFlight++;
+		}
+	}
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	calls++;
+	totalMilliseconds += milliseconds;
+	if (milliseconds > maxMilliseconds){
+		maxMilliseconds = milliseconds;
+	}
+}
+
+void FrameCapture::collect(ID3D11DeviceContext* context){
+	advance(context, false);
+}
+
+void FrameCapture::flush(ID3D11DeviceContext* context){
+	advance(context, true);
+	if (inFlight > 0){
+		//every copy is mapped and queued now, once the writer is idle they can all go
+		writer->finish();
+		advance(context, true);
+	}
+}
+
+unsigned int FrameCapture::getInFlightCount(){
+	return inFlight;
+}
+
+unsigned int FrameCapture::getCapturedCount(){
+	return captured;
+}
+
+unsigned int FrameCapture::getDroppedCount(){
+	return dropped;
+}
+
+float FrameCapture::getAverageMilliseconds(){
+	return calls > 0 ? (float)(totalMilliseconds / calls) : 0.0f;
+}
+
+float FrameCapture::getMaxMilliseconds(){
+	return (float)maxMilliseconds;
+}
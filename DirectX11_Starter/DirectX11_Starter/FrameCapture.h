@@ -0,0 +1,82 @@
+#ifndef _FRAMECAPTURE_H
+#define _FRAMECAPTURE_H
+
+#include <d3d11.h>
+#include <atomic>
+#include "CaptureWriter.h"
+
+#define CAPTURE_RING_SIZE 4 // frames the GPU and the copying worker can be behind before one is dropped
+
+/**
+*Reads frames back from the GPU without waiting for them.
+*capture() copies the frame into the next of a ring of staging textures and moves on. Later
+*frames map the copies with D3D11_MAP_FLAG_DO_NOT_WAIT once the GPU has got to them and hand
+*the mapped rows to a CaptureWriter, whose worker copies them out, encodes and writes; the
+*texture is unmapped and reused a frame or so after that. The render thread only issues the
+*copy, the maps and the unmaps, it never touches a pixel.
+*A frame is dropped, never waited for, when every staging texture is still in use or the
+*writer is maxPending frames behind. Map and Unmap are immediate context calls, so main thread only.
+**/
+class FrameCapture{
+public:
+	FrameCapture(ID3D11Device* dev, CaptureWriter* captureWriter, unsigned int ringSize);
+	//Waits for the writer to finish with any mapped copy; copies still on the GPU are lost, flush() first to keep them
+	~FrameCapture(void);
+
+	//Once a frame, before Present: moves the earlier copies along and queues one of source,
+	//an 8-bit RGBA or BGRA texture such as the back buffer. frame names the file it ends up in
+	void capture(ID3D11DeviceContext* context, ID3D11Texture2D* source, unsigned int frame);
+	//Moves the earlier copies along without queuing another, each frame after capture() stops
+	//until getInFlightCount() is 0
+	void collect(ID3D11DeviceContext* context);
+	//Waits for every copy still in flight and hands it to the writer; when capturing stops
+	void flush(ID3D11DeviceContext* context);
+
+	unsigned int getInFlightCount();
+	unsigned int getCapturedCount();
+	unsigned int getDroppedCount();
+	//Render thread time spent in capture(), per call and the worst single call
+	float getAverageMilliseconds();
+	float getMaxMilliseconds();
+
+private:
+	enum StagingState{
+		STAGING_FREE,
+		STAGING_COPYING, // CopyResource queued, the GPU may not have got to it
+		STAGING_MAPPED // a worker is copying the rows out
+	};
+
+	struct StagingFrame{
+		ID3D11Texture2D* texture;
+		StagingState state;
+		unsigned int frame;
+		std::atomic<bool> copied; // set by the worker once the mapping can go
+	};
+
+	bool createRing(const D3D11_TEXTURE2D_DESC& sourceDesc);
+	void releaseRing();
+	//Maps or unmaps whatever is ready, oldest first; wait blocks on the GPU and the writer instead
+	void advance(ID3D11DeviceContext* context, bool wait);
+
+	ID3D11Device* device;
+	CaptureWriter* writer;
+	StagingFrame* ring;
+	unsigned int ringCount;
+	unsigned int oldest; // index of the oldest slot in use
+	unsigned int inFlight; // slots in use, from oldest on
+	ID3D11Texture2D* resolved; // single sampled copy of a multisampled source
+	D3D11_TEXTURE2D_DESC desc; // of the source the ring was made for, zero width before the first capture
+	bool bgra;
+
+	unsigned int captured;
+	unsigned int dropped;
+	unsigned int calls;
+	double totalMilliseconds;
+	double maxMilliseconds;
+
+	// Prevent copying.
+	FrameCapture(FrameCapture const&);
+	FrameCapture& operator= (FrameCapture const&);
+};
+
+#endif
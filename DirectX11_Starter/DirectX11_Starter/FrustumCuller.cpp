@@ -0,0 +1,164 @@
+#include "FrustumCuller.h"
+#include <emmintrin.h>
+#include <cmath>
+
+FrustumCuller::FrustumCuller(void)
+{
+	count = 0;
+	stats.visible = 0;
+	stats.culled = 0;
+
+	//until a camera is set nothing is culled
+	for (int i = 0; i < 6; i++){
+		planes[i] = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+/**
+*Plane extraction (Gribb/Hartmann) for row vectors, clip = p * view * projection.
+*The matrices arrive transposed, so view * projection is built directly from them
+*and column j of the product is clip coordinate j.
+*D3D clip space keeps 0 <= z <= w, so the near plane is column 2 on its own.
+**/
+void FrustumCuller::setCamera(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix)
+{
+	float m[4][4];
+	for (int i = 0; i < 4; i++){
+		for (int j = 0; j < 4; j++){
+			m[i][j] = 0.0f;
+			for (int k = 0; k < 4; k++){
+				m[i][j] += viewMatrix.m[k][i] * projectionMatrix.m[j][k];
+			}
+		}
+	}
+
+	for (int i = 0; i < 4; i++){
+		float x = m[i][0];
+		float y = m[i][1];
+		float z = m[i][2];
+		float w = m[i][3];
+		(&planes[0].x)[i] = w + x; //left
+		(&planes[1].x)[i] = w - x; //right
+		(&planes[2].x)[i] = w + y; //bottom
+		(&planes[3].x)[i] = w - y; //top
+		(&planes[4].x)[i] = z;     //near
+		(&planes[5].x)[i] = w - z; //far
+	}
+
+	//normalize so the plane distance is in world units and can be compared with a radius
+	for (int p = 0; p < 6; p++){
+		float length = sqrtf(planes[p].x * planes[p].x + planes[p].y * planes[p].y + planes[p].z * planes[p].z);
+		if (length > 0.0f){
+			planes[p].x /= length;
+			planes[p].y /= length;
+			planes[p].z /= length;
+			planes[p].w /= length;
+		}
+	}
+}
+
+void FrustumCuller::clear()
+{
+	count = 0;
+	visible.clear();
+}
+
+unsigned int FrustumCuller::add(XMFLOAT3 center, float radius)
+{
+	//keep the arrays a multiple of 4 long so the batch loop never reads past the end
+	if (count + 4 > centerX.size()){
+		size_t size = centerX.size() < 16 ? 16 : centerX.size() * 2;
+		centerX.resize(size, 0.0f);
+		centerY.resize(size, 0.0f);
+		centerZ.resize(size, 0.0f);
+		radii.resize(size, 0.0f);
+	}
+
+	centerX[count] = center.x;
+	centerY[count] = center.y;
+	centerZ[count] = center.z;
+	radii[count] = radius;
+	return count++;
+}
+
+/**
+*Four spheres per iteration, each plane broadcast across the lanes.
+*A sphere is culled as soon as it lies entirely behind one plane: dot(n, c) + d < -r.
+**/
+void FrustumCuller::cull()
+{
+	visible.clear();
+
+	for (unsigned int i = 0; i < count; i += 4){
+		__m128 cx = _mm_loadu_ps(&centerX[i]);
+		__m128 cy = _mm_loadu_ps(&centerY[i]);
+		__m128 cz = _mm_loadu_ps(&centerZ[i]);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&radii[i]));
+
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; p++){
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(planes[p].x)), _mm_mul_ps(cy, _mm_set1_ps(planes[p].y))),
+				_mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(planes[p].z)), _mm_set1_ps(planes[p].w)));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+		}
+
+		int inside = ~_mm_movemask_ps(outside) & 0xF;
+		unsigned int lanes = count - i < 4 ? count - i : 4;
+		for (unsigned int lane = 0; lane < lanes; lane++){
+			if (inside & (1 << lane)){
+				visible.push_back(i + lane);
+			}
+		}
+	}
+
+	stats.visible = visible.size();
+	stats.culled = count - stats.visible;
+}
+
+unsigned int FrustumCuller::getVisibleCount()
+{
+	return visible.size();
+}
+
+unsigned int FrustumCuller::getVisible(unsigned int i)
+{
+	return visible[i];
+}
+
+CullStats FrustumCuller::getStats()
+{
+	return stats;
+}
+
+bool FrustumCuller::isVisible(XMFLOAT3 center, float radius)
+{
+	for (int p = 0; p < 6; p++){
+		float distance = center.x * planes[p].x + center.y * planes[p].y + center.z * planes[p].z + planes[p].w;
+		if (distance < -radius){
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+*worldMatrix is transposed, so row i of the real world matrix is column i here.
+*The three basis rows give the scale; the longest one bounds the sphere for non uniform scale.
+**/
+void FrustumCuller::TransformBoundingSphere(const XMFLOAT4X4& worldMatrix, XMFLOAT3 center, float radius, XMFLOAT3& worldCenter, float& worldRadius)
+{
+	const float (*w)[4] = worldMatrix.m;
+	worldCenter.x = center.x * w[0][0] + center.y * w[0][1] + center.z * w[0][2] + w[0][3];
+	worldCenter.y = center.x * w[1][0] + center.y * w[1][1] + center.z * w[1][2] + w[1][3];
+	worldCenter.z = center.x * w[2][0] + center.y * w[2][1] + center.z * w[2][2] + w[2][3];
+
+	float maxScale = 0.0f;
+	for (int i = 0; i < 3; i++){
+		float scale = w[0][i] * w[0][i] + w[1][i] * w[1][i] + w[2][i] * w[2][i];
+		if (scale > maxScale){
+			maxScale = scale;
+		}
+	}
+	worldRadius = radius * sqrtf(maxScale);
+}
@@ -0,0 +1,57 @@
+#ifndef _FRUSTUMCULLER_H
+#define _FRUSTUMCULLER_H
+
+#include "Global.h"
+#include <vector>
+
+//Number of bounds tested and how many of them survived the last cull
+struct CullStats{
+	unsigned int visible;
+	unsigned int culled;
+};
+
+/**
+*Culls bounding spheres against the camera frustum before draw submission.
+*Bounds are collected into structure of arrays (add) and tested 4 at a time with SSE
+*(cull); the indices of the visible spheres, in the order they were added, are then
+*read back with getVisibleCount/getVisible. No D3D in here.
+*All matrices are the transposed ones the game sends to the shaders.
+**/
+class FrustumCuller{
+public:
+	FrustumCuller(void);
+
+	//Extracts the six frustum planes from view * projection
+	void setCamera(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix);
+
+	void clear();
+	//Queues a world space sphere, returns its index
+	unsigned int add(XMFLOAT3 center, float radius);
+	//Tests every queued sphere and fills the visible list
+	void cull();
+
+	unsigned int getVisibleCount();
+	unsigned int getVisible(unsigned int i);
+	CullStats getStats();
+
+	//Single sphere test, same result as the batch path
+	bool isVisible(XMFLOAT3 center, float radius);
+
+	//Moves a local space bounding sphere into world space (radius grows with the largest axis scale)
+	static void TransformBoundingSphere(const XMFLOAT4X4& worldMatrix, XMFLOAT3 center, float radius, XMFLOAT3& worldCenter, float& worldRadius);
+
+private:
+	//plane i is planes[i] = (nx, ny, nz, d), inside when dot(n, p) + d >= 0
+	XMFLOAT4 planes[6];
+
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radii;
+	unsigned int count;
+
+	std::vector<unsigned int> visible;
+	CullStats stats;
+};
+
+#endif
@@ -7,16 +7,66 @@
 std::unique_ptr<DirectX::SpriteBatch> spriteBatch;
 std::unique_ptr<DirectX::SpriteFont> spriteFont;
 
-Game::Game(ID3D11Device* dev, ID3D11DeviceContext* devCxt){
+Game::Game(ID3D11Device* dev, ID3D11DeviceContext* devCxt, AssetManager* assetManager){
 	device = dev;
 	deviceContext = devCxt;
+	assets = assetManager;
+	asteroid = nullptr;
+	playerm = nullptr;
+	bulletm = nullptr;
+	HPm = nullptr;
+	Collm = nullptr;
+	starField = nullptr;
+	cpuStarField = nullptr;
+	renderThreads = nullptr;
+	commandBackend = nullptr;
+	renderQueue = nullptr;
 }
 
 Game::~Game(void){
+	if (starField){
+		delete starField;
+		starField = nullptr;
+	}
+	if (cpuStarField){
+		delete cpuStarField;
+		cpuStarField = nullptr;
+	}
+	if (renderQueue){
+		delete renderQueue;
+		renderQueue = nullptr;
+	}
+	if (commandBackend){
+		delete commandBackend;
+		commandBackend = nullptr;
+	}
+	if (renderThreads){
+		delete renderThreads;
+		renderThreads = nullptr;
+	}
+	// the managers only borrow these, the references are Game's
+	ReleaseMacro(asteroid);
+	ReleaseMacro(playerm);
+	ReleaseMacro(bulletm);
+	ReleaseMacro(HPm);
+	ReleaseMacro(Collm);
 	ReleaseMacro(device);
 	ReleaseMacro(deviceContext);
 }
 
+void Game::streamAssets(){
+	const char* meshes[] = { "asteroid.obj", "ship.obj", "bullet.obj", "energy.obj", "star.obj" };
+	//the asteroid textures aren't here, they stream by mip once the asteroids are drawn
+	const wchar_t* textures[] = { L"spaceShipTexture.jpg", L"night.jpg", L"alpha_map.png",
+		L"star.png", L"energy.png", L"background.jpg", L"bullet.jpg", L"bullet.png", L"particle.png" };
+	for (int i = 0; i < sizeof(meshes) / sizeof(meshes[0]); i++){
+		assets->streamMesh(meshes[i]);
+	}
+	for (int i = 0; i < sizeof(textures) / sizeof(textures[0]); i++){
+		assets->streamTexture(textures[i]);
+	}
+}
+
 void Game::initGame(SamplerState *samplerStates){
 	p_time = 0;
 	//sound effect engine
@@ -33,58 +83,74 @@ void Game::initGame(SamplerState *samplerStates){
 	hullIntegrity = 100;
 	shootingScore = 0;
 
-	constantBufferList.push_back(new ConstantBuffer(dataToSendToVSConstantBuffer, device)); //create matrix constant buffer
-	constantBufferList.push_back(new ConstantBuffer(dataToSendToLightConstantBuffer, device));//create light constant buffer
-	constantBufferList.push_back(new ConstantBuffer(dataToSendToCameraConstantBuffer, device)); //create camera constant buffer
-	constantBufferList.push_back(new ConstantBuffer(dataToSendToGSConstantBuffer, device)); //create geometry constant buffer
+	constantBufferList = createConstantBuffers();
 
 
 	//create shader program-Params(vertex shader, pixel shader, device, constant buffers)
-	shaderProgram = new ShaderProgram(L"FlatVertexShader.cso", L"FlatPixelShader.cso", device, constantBufferList);
-	ShaderProgram* geoShader = new ShaderProgram(L"GeometryVertexShader.cso", L"GeometryPixelShader.cso", L"GeometryShader.cso", L"GeometryShaderStreamOutput.cso", device, constantBufferList);
-	ObjectLoader *asteroidObject = new ObjectLoader(device);
-	ObjectLoader *collObject = new ObjectLoader(device);
-	ObjectLoader *HPObject = new ObjectLoader(device);
-	ObjectLoader *playerObject = new ObjectLoader(device);
-	ObjectLoader *bulletObject = new ObjectLoader(device);
-	asteroid = asteroidObject->LoadModel("asteroid.obj");
-	playerm = playerObject->LoadModel("ship.obj");
-	bulletm = bulletObject->LoadModel("bullet.obj");
-	HPm = HPObject->LoadModel("energy.obj");
-	Collm = collObject->LoadModel("star.obj");
+	shaderProgram = assets->getMeshShaderProgram(0, constantBufferList);
+	ShaderProgram* geoShader = assets->getShaderProgram(L"GeometryVertexShader.cso", L"GeometryPixelShader.cso", L"GeometryShader.cso", L"GeometryShaderStreamOutput.cso", constantBufferList);
+	// Meshes and textures come from the shared cache, so anything the menu already loaded is reused
+	asteroid = assets->getMesh("asteroid.obj");
+	playerm = assets->getMesh("ship.obj");
+	bulletm = assets->getMesh("bullet.obj");
+	HPm = assets->getMesh("energy.obj");
+	Collm = assets->getMesh("star.obj");
 	ID3D11SamplerState* sample = nullptr;
 
-	// Set up the object loader and load the main menu
-	ObjectLoader *bgObject = new ObjectLoader(device);
-	Mesh *bg = bgObject->LoadModel("Menu.obj");
+	// Load the main menu
+	Mesh *bg = assets->getMesh("Menu.obj");
 
 
 
 	//Create the matierials used by the myriad game entities
-	materials.push_back(new Material(device, deviceContext, samplerStates->sampler, L"spaceShipTexture.jpg", shaderProgram));
-	materials.push_back(new Material(device, deviceContext, samplerStates->sampler, L"asteroid.jpg", shaderProgram));
-	materials.push_back(new Material(device, deviceContext, samplerStates->sampler, L"star.png", shaderProgram));
-	materials.push_back(new Material(device, deviceContext, samplerStates->sampler, L"energy.png", shaderProgram));
-	materials.push_back(new Material(device, deviceContext, samplerStates->sampler, L"background.jpg", shaderProgram));
-	materials.push_back(new Material(device, deviceContext, samplerStates->sampler, L"bullet.jpg", shaderProgram));
-	materials.push_back(new Material(device, deviceContext, samplerStates->sampler, L"particle.png", geoShader));
-
-	for (float i = 0; i < 50; i++){
-		stars.push_back(new ParticleSystem(XMFLOAT4((i - 50.0f) / 10, -1.5f, 0, 0), XMFLOAT2(0.1f, 0.0f), XMFLOAT2(0.1f, 0.1f), device, deviceContext, materials[6], 20));
+	materials.push_back(new Material(assets, samplerStates->sampler, L"spaceShipTexture.jpg", shaderProgram));
+	materials.push_back(new Material(assets, samplerStates->sampler, L"asteroid.jpg", shaderProgram, true));
+	materials.push_back(new Material(assets, samplerStates->sampler, L"star.png", shaderProgram));
+	materials.push_back(new Material(assets, samplerStates->sampler, L"energy.png", shaderProgram));
+	materials.push_back(new Material(assets, samplerStates->sampler, L"background.jpg", shaderProgram));
+	materials.push_back(new Material(assets, samplerStates->sampler, L"bullet.jpg", shaderProgram));
+	materials.push_back(new Material(assets, samplerStates->sampler, L"particle.png", geoShader));
+
+	//One compute dispatch and one draw for every emitter where supported, simulated on the CPU otherwise
+	if (BatchedParticleSystem::isSupported(device)){
+		starField = new BatchedParticleSystem(device, deviceContext, constantBufferList, materials[6], 20);
+		for (float i = 0; i < 50; i++){
+			starField->addEmitter(XMFLOAT4((i - 50.0f) / 10, -1.5f, 0, 0), XMFLOAT2(0.1f, 0.0f), XMFLOAT2(0.1f, 0.1f), 1.2f);
+		}
 	}
-	player = new Player(device, deviceContext, constantBufferList, samplerStates->sampler, playerm);
+	else{
+		cpuStarField = new CpuParticleSystem(device, deviceContext, materials[6], 50 * 20);
+		for (float i = 0; i < 50; i++){
+			cpuStarField->addEmitter(XMFLOAT4((i - 50.0f) / 10, -1.5f, 0, 0), XMFLOAT2(0.1f, 0.0f), XMFLOAT2(0.1f, 0.1f), 1.2f, 20);
+		}
+	}
+	player = new Player(device, deviceContext, assets, createConstantBuffers(), samplerStates->sampler, playerm);
 
 	//Set up the two backgrounds
 	gameEntities.push_back(new GameEntity(bg, materials[2]));
 	gameEntities[0]->setPosition(XMFLOAT3(2.5f, 0.0f, 6.0f));
 	gameEntities.push_back(new GameEntity(bg, materials[2]));
 	gameEntities[1]->setPosition(XMFLOAT3(15.0f, 0.0f, 6.0f));
-
-	// Create the managers
-	projectileManager = new Projectile(device, deviceContext, constantBufferList, samplerStates->sampler, bulletm, player);
-	asteroidManager = new Asteroid(device, deviceContext, constantBufferList, samplerStates->sampler, asteroid, player, this);
-	HPManager = new healthPickup(device, deviceContext, constantBufferList, samplerStates->sampler, HPm, player, this);
-	collManager = new Collectable(device, deviceContext, constantBufferList, samplerStates->sampler, Collm, player, this);
+	ReleaseMacro(bg);
+
+	// Create the managers, each with its own constant buffers so their draws can be recorded at the same time
+	projectileManager = new Projectile(device, deviceContext, assets, createConstantBuffers(), samplerStates->sampler, bulletm, player);
+	asteroidManager = new Asteroid(device, deviceContext, assets, createConstantBuffers(), samplerStates->sampler, asteroid, player, this);
+	HPManager = new healthPickup(device, deviceContext, assets, createConstantBuffers(), samplerStates->sampler, HPm, player, this);
+	collManager = new Collectable(device, deviceContext, assets, createConstantBuffers(), samplerStates->sampler, Collm, player, this);
+
+	// Record on worker threads only when the driver supports command lists, otherwise draw straight to the immediate context
+	unsigned int recordingThreads = 0;
+	if (D3D11CommandBackend::SupportsCommandLists(device)){
+		//the calling thread records slice 0 itself, so the pool only needs a thread for each of the others
+		recordingThreads = ThreadPool::DefaultThreadCount() + 1;
+		if (recordingThreads > 4){
+			recordingThreads = 4;
+		}
+		renderThreads = new ThreadPool(recordingThreads - 1);
+	}
+	commandBackend = new D3D11CommandBackend(device, deviceContext, recordingThreads);
+	renderQueue = new ParallelRenderQueue<ID3D11DeviceContext>(commandBackend, renderThreads);
 
 	spriteBatch.reset(new DirectX::SpriteBatch(deviceContext));
 	spriteFont.reset(new DirectX::SpriteFont(device, L"Font.spritesheet"));
@@ -98,6 +164,12 @@ void Game::updateGame(float dt, StateManager *stateManager)
 	player->update(dt);
 	projectileManager->update(dt);
 	asteroidManager->update(dt, stateManager);
+	if (starField){
+		starField->update(dt);
+	}
+	if (cpuStarField){
+		cpuStarField->update(dt);
+	}
 	HPManager->update(dt);
 	collManager->update(dt);
 
@@ -216,6 +288,33 @@ void Game::pickUp()
 
 }
 
+std::vector<ConstantBuffer*> Game::createConstantBuffers()
+{
+	std::vector<ConstantBuffer*> buffers;
+	buffers.push_back(new ConstantBuffer(dataToSendToVSConstantBuffer, device)); //create matrix constant buffer
+	buffers.push_back(new ConstantBuffer(dataToSendToLightConstantBuffer, device));//create light constant buffer
+	buffers.push_back(new ConstantBuffer(dataToSendToCameraConstantBuffer, device)); //create camera constant buffer
+	buffers.push_back(new ConstantBuffer(dataToSendToGSConstantBuffer, device)); //create geometry constant buffer
+	return buffers;
+}
+
+CullStats Game::getCullStats()
+{
+	CullStats managers[] = {
+		projectileManager->getCullStats(),
+		asteroidManager->getCullStats(),
+		HPManager->getCullStats(),
+		collManager->getCullStats()
+	};
+
+	CullStats total = { 0, 0 };
+	for (int i = 0; i < 4; i++){
+		total.visible += managers[i].visible;
+		total.culled += managers[i].culled;
+	}
+	return total;
+}
+
 
 // Method where all the actual drawing occurs
 void Game::drawGame(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, float time, wchar_t* state)
@@ -228,18 +327,23 @@ void Game::drawGame(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3
 	{
 		p_time = time;
 	}
-	projectileManager->draw(viewMatrix, projectionMatrix, camPos);
+	projectileManager->draw(viewMatrix, projectionMatrix, camPos, deviceContext);
 
-	for (int i = 0; i < stars.size(); i++){
-		stars[i]->drawParticleSystem(viewMatrix, projectionMatrix, age);
+	if (starField){
+		starField->draw(viewMatrix, projectionMatrix);
+	}
+	if (cpuStarField){
+		cpuStarField->draw(viewMatrix, projectionMatrix);
 	}
 
-	// Call the corresponding draw methods for the different entity managers
-	projectileManager->draw(viewMatrix, projectionMatrix, camPos);
-	player->draw(viewMatrix, projectionMatrix, camPos);
-	asteroidManager->draw(viewMatrix, projectionMatrix, camPos);
-	collManager->draw(viewMatrix, projectionMatrix, camPos);
-	HPManager->draw(viewMatrix, projectionMatrix, camPos);
+	// Queue the draw methods for the different entity managers, the flush keeps this order on the GPU
+	renderQueue->submit([=](ID3D11DeviceContext* context){ projectileManager->draw(viewMatrix, projectionMatrix, camPos, context); });
+	renderQueue->submit([=](ID3D11DeviceContext* context){ player->draw(viewMatrix, projectionMatrix, camPos, context); });
+	renderQueue->submit([=](ID3D11DeviceContext* context){ asteroidManager->draw(viewMatrix, projectionMatrix, camPos, context); });
+	renderQueue->submit([=](ID3D11DeviceContext* context){ collManager->draw(viewMatrix, projectionMatrix, camPos, context); });
+	renderQueue->submit([=](ID3D11DeviceContext* context){ HPManager->draw(viewMatrix, projectionMatrix, camPos, context); });
+	renderQueue->flush();
+
 	DrawUI(time, state);
 }
 
@@ -4,7 +4,7 @@
 #include <DirectXMath.h>
 #include <vector>
 #include "ConstantBuffer.h"
-#include "ObjectLoader.h"
+#include "AssetManager.h"
 #include "Mesh.h"
 #include "GameEntity.h"
 #include "Material.h"
@@ -23,6 +23,11 @@
 #include "Asteroid.h"
 #include "Collectable.h"
 #include "ParticleSystem.h"
+#include "BatchedParticleSystem.h"
+#include "CpuParticleSystem.h"
+#include "D3D11CommandBackend.h"
+#include "ParallelRenderQueue.h"
+#include "ThreadPool.h"
 #include "healthPickup.h"
 
 using namespace DirectX;
@@ -31,8 +36,9 @@ using namespace DirectX;
 
 class Game{
 public:
-	Game(ID3D11Device* dev, ID3D11DeviceContext* devCxt);
+	Game(ID3D11Device* dev, ID3D11DeviceContext* devCxt, AssetManager* assetManager);
 	~Game(void);
+	void streamAssets(); // starts loading the meshes and textures initGame uses, so it finds them cached
 	void initGame(SamplerState *samplerStates); // sets up the default parameters for the game
 	void updateGame(float dt, StateManager *stateManager); // main update method for the game
 	void drawGame(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 gamePos, float time, wchar_t* state); // Main drawing method for the game
@@ -42,6 +48,7 @@ public:
 	void handleCollision(StateManager *stateManager); // handles collisions between the player and an asteroid
 	void getHealth(); //for health pickups
 	void pickUp(); // for star pickups
+	CullStats getCullStats(); // visible/culled entity totals across the managers for the last frame
 	int hullIntegrity; // the current hull integrity (out of 100)
 private:
 	LightBufferType lighting;
@@ -53,6 +60,7 @@ private:
 	ID3D11Device* device;
 	ID3D11DeviceContext* deviceContext;
 	ShaderProgram* shaderProgram;
+	AssetManager* assets; // owned by MyDemoGame, shared with the menu states
 	std::vector<GameEntity*> gameEntities; // Game entities that are not covered by the player, projectile, and asteroid managers
 	std::vector<SamplerState*>samplerStates;
 	std::vector<Material*> materials; // The list of materials utilized by game entities
@@ -70,8 +78,15 @@ private:
 	CameraBufferType dataToSendToCameraConstantBuffer;
 
 	std::vector<ConstantBuffer*> constantBufferList;
+	std::vector<ConstantBuffer*> createConstantBuffers(); // matrix, light, camera and geometry buffers, in constantBufferList order
+
+	// Manager draws are recorded on worker threads into deferred contexts
+	ThreadPool* renderThreads;
+	D3D11CommandBackend* commandBackend;
+	ParallelRenderQueue<ID3D11DeviceContext>* renderQueue;
 	ParticleSystem *particle;
-	std::vector<ParticleSystem*>stars;
+	BatchedParticleSystem* starField; // all star emitters in one buffer, null below feature level 11
+	CpuParticleSystem* cpuStarField; // CPU simulated fallback when starField is null
 
 	// The list of managers
 	Projectile* projectileManager;
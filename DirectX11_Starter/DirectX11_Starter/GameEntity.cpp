@@ -1,18 +1,19 @@
 #include "GameEntity.h"
 #include "Global.h"
+#include "FrustumCuller.h"
 
 GameEntity::GameEntity(Mesh* mesh, Material* mat){
 	g_mesh = mesh;
+	if (g_mesh){
+		g_mesh->AddRef();
+	}
 	clearTransforms();
 	worldMatrix = getWorld();
 	g_mat = mat;
 }
 
 GameEntity::~GameEntity(void){
-	if (g_mesh){
-		delete g_mesh;
-		g_mesh = nullptr;
-	}
+	ReleaseMacro(g_mesh);
 	if (g_mat){
 		delete g_mat;
 		g_mat = nullptr;
@@ -62,6 +63,19 @@ XMFLOAT4X4 GameEntity::getWorld(void){
 	return worldMatrix;
 }
 
+/**
+*World matrix for the vertex shader, with the mesh's position decode in front of it
+**/
+XMFLOAT4X4 GameEntity::getDrawWorld(void){
+	XMMATRIX decode = XMLoadFloat4x4(&g_mesh->decodeMatrix);
+	XMMATRIX pos = XMLoadFloat4x4(&positionMatrix);
+	XMMATRIX rot = XMLoadFloat4x4(&rotationMatrix);
+	XMMATRIX sca = XMLoadFloat4x4(&scaleMatrix);
+	XMFLOAT4X4 drawWorld;
+	XMStoreFloat4x4(&drawWorld, XMMatrixTranspose(decode * pos * rot * sca));
+	return drawWorld;
+}
+
 /**
 *Apply a scale transform to game object
 **/
@@ -128,4 +142,11 @@ void GameEntity::setPosition(XMFLOAT3 pos){
 	};
 
 	XMStoreFloat4x4(&positionMatrix, position);
+}
+
+/**
+*World space bounding sphere of the mesh under the current transforms
+**/
+void GameEntity::getBoundingSphere(XMFLOAT3& center, float& radius){
+	FrustumCuller::TransformBoundingSphere(getWorld(), g_mesh->boundsCenter, g_mesh->boundsRadius, center, radius);
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ public:
 	~GameEntity(void);
 	void clearTransforms(void);
 	XMFLOAT4X4 getWorld(void);
+	XMFLOAT4X4 getDrawWorld(void); // getWorld plus the mesh's position decode
 	XMFLOAT4X4 getRotation(void);
 	XMFLOAT4X4 getPosition(void);
     XMFLOAT4X4 getScale(void);
@@ -28,5 +29,6 @@ public:
 	void translate(XMFLOAT3 translate);
 	void rotate(XMFLOAT3 rotate);
 	void setPosition(XMFLOAT3 pos);
+	void getBoundingSphere(XMFLOAT3& center, float& radius);
 };
 #endif
\ No newline at end of file
@@ -16,6 +16,7 @@ cbuffer perModel		: register(b0)
 	matrix world;
 	matrix view;
 	matrix projection;
+	float4 uvTransform; // xy scale, zw offset of the texture in an atlas
 };
 
 [maxvertexcount(4)]
@@ -45,7 +46,7 @@ void main(
 	for (uint i = 0; i < 4; i++)
 	{
 		element.position = mul(v[i], worldViewProj);
-		element.uv = quadUVs[i];
+		element.uv = quadUVs[i] * uvTransform.xy + uvTransform.zw;
 		output.Append(element);
 	}
 	output.RestartStrip();
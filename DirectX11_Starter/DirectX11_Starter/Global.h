@@ -19,7 +19,7 @@ struct Vertex2{
 	XMFLOAT3 Position;
 	XMFLOAT3 Normal;
 	XMFLOAT2 UVs;
-	XMFLOAT3 Tangent;
+	XMFLOAT4 Tangent; // w is the handedness, bitangent = cross(normal, tangent) * w
 };
 
 struct Triangle{
@@ -42,36 +42,39 @@ struct Vector
 	float z;
 };
 
-struct ConstantBufferLayout
-{
-	XMFLOAT4X4 world;
-	XMFLOAT4X4 view;
-	XMFLOAT4X4 projection;
-};
-
-struct ParticleVertexShaderConstantBufferLayout
-{
-	float age;
+struct Particle{
+	XMFLOAT4 Position;
+	XMFLOAT2 velocity;
+	XMFLOAT2 acceleration;
 };
 
-//Camera Constant Buffer Data Layout
-struct CameraBufferType{
-	XMFLOAT3 cameraPosition;
-	float padding;
+//Particle update Constant Buffer Data Layout
+struct ParticleUpdateConstantBufferLayout{
+	float deltaTime;
+	unsigned int particlesPerEmitter;
+	unsigned int particleCount;
+	unsigned int padding;
 };
 
-//Light Constant Buffer Data Layout
-struct LightBufferType{
-	XMFLOAT4 ambientColor;
-	XMFLOAT4 diffuseColor;
-	XMFLOAT3 lightDirection;
-	float specularPower;
-	XMFLOAT4 specularColor;
+//Emitter parameters, matches the Emitter struct in ParticleUpdateComputeShader.hlsl (64 bytes)
+struct ParticleEmitter{
+	XMFLOAT4 position;
+	XMFLOAT2 velocity;
+	XMFLOAT2 acceleration;
+	float lifetime;
+	float emitInterval;
+	unsigned int firstParticle;
+	float phase; // seconds into the emitter's current lifetime at the end of this frame, see SetEmitterPhases
+	float previousPhase; // and at the end of the last one
+	unsigned int padding[2];
 };
 
-struct Particle{
-	XMFLOAT4 Position;
+//One slot of the pooled particle buffer, matches the PooledParticle struct in the particle shaders (32 bytes)
+struct PooledParticle{
+	XMFLOAT3 position;
+	float age;
 	XMFLOAT2 velocity;
-	XMFLOAT2 acceleration;
+	unsigned int emitter;
+	unsigned int alive;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "LodSelector.h"
+
+LodSelector::LodSelector(void)
+{
+	depthRow = XMFLOAT4(0.0f, 0.0f, 1.0f, 0.0f);
+	pixelsPerUnit = 0.0f;
+	viewportPixels = 0.0f;
+	clear();
+}
+
+void LodSelector::setCamera(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, float viewportHeight)
+{
+	//transposed view, its third row is the depth column of the real one
+	depthRow = XMFLOAT4(viewMatrix.m[2][0], viewMatrix.m[2][1], viewMatrix.m[2][2], viewMatrix.m[2][3]);
+	//y scale of the projection takes view space to [-1, 1], half the viewport covers 1
+	pixelsPerUnit = projectionMatrix.m[1][1] * viewportHeight * 0.5f;
+	viewportPixels = viewportHeight;
+}
+
+float LodSelector::getScreenSize(XMFLOAT3 center, float radius)
+{
+	float depth = depthRow.x * center.x + depthRow.y * center.y + depthRow.z * center.z + depthRow.w;
+	if (depth <= radius){
+		return viewportPixels;
+	}
+	float size = 2.0f * radius * pixelsPerUnit / depth;
+	return size < viewportPixels ? size : viewportPixels;
+}
+
+int LodSelector::select(const Mesh* mesh, XMFLOAT3 center, float radius)
+{
+	return select(mesh->lods, mesh->lodCount, mesh->boundsRadius, center, radius);
+}
+
+int LodSelector::select(const MeshLod* lods, int lodCount, float boundsRadius, XMFLOAT3 center, float radius)
+{
+	if (lodCount < 2 || boundsRadius <= 0.0f || pixelsPerUnit <= 0.0f){
+		return 0;
+	}
+	float depth = depthRow.x * center.x + depthRow.y * center.y + depthRow.z * center.z + depthRow.w;
+	//the camera is inside or right against the bounds
+	if (depth <= radius){
+		return 0;
+	}
+
+	//errors are in model units, the world radius over the model radius is the entity's scale
+	float pixelsPerModelUnit = pixelsPerUnit * (radius / boundsRadius) / depth;
+	int lod = 0;
+	while (lod + 1 < lodCount && lods[lod + 1].error * pixelsPerModelUnit <= LOD_PIXEL_ERROR){
+		lod++;
+	}
+	return lod;
+}
+
+void LodSelector::clear()
+{
+	entities.clear();
+	levels.clear();
+	order.clear();
+	for (int i = 0; i < MESH_MAX_LODS; i++){
+		lodCounts[i] = 0;
+	}
+}
+
+void LodSelector::add(unsigned int entity, const Mesh* mesh, XMFLOAT3 center, float radius)
+{
+	add(entity, mesh->lods, mesh->lodCount, mesh->boundsRadius, center, radius);
+}
+
+void LodSelector::add(unsigned int entity, const MeshLod* lods, int lodCount, float boundsRadius, XMFLOAT3 center, float radius)
+{
+	int lod = select(lods, lodCount, boundsRadius, center, radius);
+	entities.push_back(entity);
+	levels.push_back(lod);
+	lodCounts[lod]++;
+}
+
+//counting sort on the level
+void LodSelector::group()
+{
+	unsigned int start[MESH_MAX_LODS];
+	unsigned int next = 0;
+	for (int i = 0; i < MESH_MAX_LODS; i++){
+		start[i] = next;
+		next += lodCounts[i];
+	}
+	order.resize(entities.size());
+	for (unsigned int i = 0; i < entities.size(); i++){
+		order[start[levels[i]]++] = i;
+	}
+}
+
+unsigned int LodSelector::getCount()
+{
+	return order.size();
+}
+
+unsigned int LodSelector::getEntity(unsigned int i)
+{
+	return entities[order[i]];
+}
+
+int LodSelector::getLod(unsigned int i)
+{
+	return levels[order[i]];
+}
+
+unsigned int LodSelector::getLodCount(int lod)
+{
+	return lodCounts[lod];
+}
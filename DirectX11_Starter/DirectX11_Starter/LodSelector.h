@@ -0,0 +1,58 @@
+#ifndef _LODSELECTOR_H
+#define _LODSELECTOR_H
+
+#include "Global.h"
+#include "Mesh.h"
+#include <vector>
+
+#define LOD_PIXEL_ERROR 1.0f // most a level's simplification error may cover on screen, in pixels
+
+/**
+*Picks a mesh level of detail per entity from how many pixels its simplification error would
+*cover at the entity's distance.
+*Used like FrustumCuller: setCamera, clear, add every visible entity, then group, which orders
+*them by level so each level's draws go out back to back (the batches an instanced draw would
+*take), and read them back with getCount/getEntity/getLod.
+*All matrices are the transposed ones the game sends to the shaders. No D3D in here, a Mesh is
+*only read for its levels and bounds, which can also be passed on their own.
+**/
+class LodSelector{
+public:
+	LodSelector(void);
+
+	void setCamera(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, float viewportHeight);
+
+	//Pixels the diameter of a world space bounding sphere covers on screen, the whole viewport
+	//height when the camera is inside it
+	float getScreenSize(XMFLOAT3 center, float radius);
+
+	//Coarsest level of mesh whose error stays under LOD_PIXEL_ERROR for an entity with this world space bounding sphere
+	int select(const Mesh* mesh, XMFLOAT3 center, float radius);
+	//The same for a chain of lodCount levels of a model whose bounding radius is boundsRadius
+	int select(const MeshLod* lods, int lodCount, float boundsRadius, XMFLOAT3 center, float radius);
+
+	void clear();
+	//Queues an entity with the level select picks for it
+	void add(unsigned int entity, const Mesh* mesh, XMFLOAT3 center, float radius);
+	void add(unsigned int entity, const MeshLod* lods, int lodCount, float boundsRadius, XMFLOAT3 center, float radius);
+	//Orders the queued entities by level, keeping the order they were added within a level
+	void group();
+
+	unsigned int getCount();
+	unsigned int getEntity(unsigned int i);
+	int getLod(unsigned int i);
+	//How many of the grouped entities draw at this level
+	unsigned int getLodCount(int lod);
+
+private:
+	XMFLOAT4 depthRow; // dot with (p, 1) gives view space depth
+	float pixelsPerUnit; // screen pixels one world unit covers at depth 1
+	float viewportPixels;
+
+	std::vector<unsigned int> entities;
+	std::vector<int> levels;
+	std::vector<unsigned int> order; // indices into entities, grouped by level
+	unsigned int lodCounts[MESH_MAX_LODS];
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(void){
+	view = nullptr;
+	length = 0;
+	opened = false;
+#ifdef _WIN32
+	file = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+#else
+	descriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile(void){
+	close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& path){
+	close();
+
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE){
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)){
+		close();
+		return false;
+	}
+	length = (size_t)fileSize.QuadPart;
+	opened = true;
+	if (length == 0){
+		return true;
+	}
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mapping){
+		close();
+		return false;
+	}
+	view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!view){
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close(){
+	if (view){
+		UnmapViewOfFile(view);
+		view = nullptr;
+	}
+	if (mapping){
+		CloseHandle(mapping);
+		mapping = NULL;
+	}
+	if (file != INVALID_HANDLE_VALUE){
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+	length = 0;
+	opened = false;
+}
+#else
+bool MappedFile::open(const std::string& path){
+	close();
+
+	descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0){
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(descriptor, &info) != 0){
+		close();
+		return false;
+	}
+	length = (size_t)info.st_size;
+	opened = true;
+	if (length == 0){
+		return true;
+	}
+
+	void* mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (mapped == MAP_FAILED){
+		close();
+		return false;
+	}
+	view = static_cast<const char*>(mapped);
+	return true;
+}
+
+void MappedFile::close(){
+	if (view){
+		munmap(const_cast<char*>(view), length);
+		view = nullptr;
+	}
+	if (descriptor >= 0){
+		::close(descriptor);
+		descriptor = -1;
+	}
+	length = 0;
+	opened = false;
+}
+#endif
+
+const char* MappedFile::data(){
+	return view;
+}
+
+size_t MappedFile::size(){
+	return length;
+}
+
+bool MappedFile::isOpen(){
+	return opened;
+}
@@ -0,0 +1,38 @@
+#ifndef _MAPPEDFILE_H
+#define _MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+//Read only memory mapping of a whole file.
+//The view stays valid until the object is destroyed; an empty file maps to a null view.
+//Others may open the file for writing meanwhile, so a cooked file's stamp can be rewritten in place.
+class MappedFile{
+public:
+	MappedFile(void);
+	~MappedFile(void);
+
+	bool open(const std::string& path);
+	void close();
+
+	const char* data();
+	size_t size();
+	bool isOpen();
+
+private:
+	const char* view;
+	size_t length;
+	bool opened;
+#ifdef _WIN32
+	void* file;
+	void* mapping;
+#else
+	int descriptor;
+#endif
+
+	// Prevent copying.
+	MappedFile(MappedFile const&);
+	MappedFile& operator= (MappedFile const&);
+};
+
+#endif
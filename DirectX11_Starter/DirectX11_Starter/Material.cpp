@@ -1,5 +1,5 @@
 #include "Material.h"
-#include "WICTextureLoader.h"
+#include "AssetManager.h"
 #include "Global.h"
 /**
 *Material Constructor for materials read/created
@@ -11,48 +11,104 @@ Material::Material(ID3D11ShaderResourceView* rv, ID3D11SamplerState* sample, Sha
 	samplerState = sample;
 	shaderProgram = s_program;
 	resourceView = rv;
+	resourceView2 = nullptr;
+	resourceView3 = nullptr;
+	vsConstantBuffer = nullptr;
+	psConstantBuffer = nullptr;
+	mipAssets = nullptr;
+	uvTransform = XMFLOAT4(1.0f, 1.0f, 0.0f, 0.0f);
 }
 
 /**
-*Material Contructor that creates a texture from an image file
-*dev: Device object
-*devCtx: deviceContext object
+*Material Contructor that takes its textures from the asset cache, so an image shared by
+*several materials is only decoded once, and comes from the cooked DDS when that is current
+*assets: asset cache the textures are loaded through
 *sampler: sampler state object
 *filepath: address of image file
+*streamMips: start cooked textures with their small mips only and load finer ones as
+*requestMips asks for them, for materials whose size on screen varies
+*A single texture that was packed into a loaded atlas comes as the atlas, with uvTransform
+*picking out its rectangle; materials with more textures can't share one transform, so they
+*always get the textures on their own.
 **/
-Material::Material(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sampler, wchar_t* filepath, ShaderProgram* s_program){
+Material::Material(AssetManager* assets, ID3D11SamplerState* sampler, wchar_t* filepath, ShaderProgram* s_program, bool streamMips){
 	samplerState = sampler;
 	shaderProgram = s_program;
-	CreateWICTextureFromFile(dev, devCtx, filepath, 0, &resourceView, 0);
+	mipAssets = streamMips ? assets : nullptr;
+	resourceView = nullptr;
 	resourceView2 = nullptr;
 	resourceView3 = nullptr;
+	uvTransform = XMFLOAT4(1.0f, 1.0f, 0.0f, 0.0f);
+	TextureRegion region;
+	if (!streamMips && assets->getTextureRegion(filepath, region)){
+		resourceView = region.view;
+		uvTransform = region.uvTransform;
+	}
+	else{
+		loadTexture(assets, filepath, &resourceView);
+	}
+	vsConstantBuffer = nullptr;
+	psConstantBuffer = nullptr;
 }
 
-Material::Material(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, ShaderProgram* s_program){
+Material::Material(AssetManager* assets, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, ShaderProgram* s_program, bool streamMips){
 	samplerState = sampler;
 	shaderProgram = s_program;
-	CreateWICTextureFromFile(dev, devCtx, filepath, 0, &resourceView, 0);
-	CreateWICTextureFromFile(dev, devCtx, filepath2, 0, &resourceView2, 0);
+	mipAssets = streamMips ? assets : nullptr;
+	resourceView = nullptr;
+	resourceView2 = nullptr;
 	resourceView3 = nullptr;
+	uvTransform = XMFLOAT4(1.0f, 1.0f, 0.0f, 0.0f);
+	loadTexture(assets, filepath, &resourceView);
+	loadTexture(assets, filepath2, &resourceView2);
+	vsConstantBuffer = nullptr;
+	psConstantBuffer = nullptr;
 }
 
-Material::Material(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, wchar_t* filepath3, ShaderProgram* s_program){
+Material::Material(AssetManager* assets, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, wchar_t* filepath3, ShaderProgram* s_program, bool streamMips){
 	samplerState = sampler;
 	shaderProgram = s_program;
-	CreateWICTextureFromFile(dev, devCtx, filepath, 0, &resourceView, 0);
-	CreateWICTextureFromFile(dev, devCtx, filepath2, 0, &resourceView2, 0);
-	CreateWICTextureFromFile(dev, devCtx, filepath3, 0, &resourceView3, 0);
+	mipAssets = streamMips ? assets : nullptr;
+	resourceView = nullptr;
+	resourceView2 = nullptr;
+	resourceView3 = nullptr;
+	uvTransform = XMFLOAT4(1.0f, 1.0f, 0.0f, 0.0f);
+	loadTexture(assets, filepath, &resourceView);
+	loadTexture(assets, filepath2, &resourceView2);
+	loadTexture(assets, filepath3, &resourceView3);
+	vsConstantBuffer = nullptr;
+	psConstantBuffer = nullptr;
+}
+
+void Material::loadTexture(AssetManager* assets, wchar_t* filepath, ID3D11ShaderResourceView** slot){
+	if (mipAssets){
+		mipAssets->getStreamedTexture(filepath, slot);
+	}
+	else{
+		*slot = assets->getTexture(filepath);
+	}
+}
+
+void Material::requestMips(float screenPixels){
+	if (!mipAssets){
+		return;
+	}
+	mipAssets->requestTextureMips(&resourceView, screenPixels);
+	mipAssets->requestTextureMips(&resourceView2, screenPixels);
+	mipAssets->requestTextureMips(&resourceView3, screenPixels);
 }
 
 Material::~Material(void){
+	//the streamer stops swapping the views, the references left in them are the material's
+	if (mipAssets){
+		mipAssets->releaseStreamedTexture(&resourceView);
+		mipAssets->releaseStreamedTexture(&resourceView2);
+		mipAssets->releaseStreamedTexture(&resourceView3);
+	}
 	ReleaseMacro(samplerState);
 	ReleaseMacro(resourceView);
 	ReleaseMacro(resourceView2);
 	ReleaseMacro(resourceView3);
 	ReleaseMacro(vsConstantBuffer);
 	ReleaseMacro(psConstantBuffer);
-	if (shaderProgram){
-		delete shaderProgram;
-		shaderProgram = nullptr;
-	}
 }
@@ -11,6 +11,8 @@
 #include "dxerr.h"
 #include "ShaderProgram.h"
 
+class AssetManager;
+
 using namespace DirectX;
 
 class Material{
@@ -20,17 +22,28 @@ public:
 	ID3D11ShaderResourceView* resourceView3;
 	ID3D11SamplerState* samplerState;
 
-	// Our basic shaders for this example
+	// Our basic shaders for this example, owned by the AssetManager that made them
 	ShaderProgram* shaderProgram;
 
 	ID3D11Buffer* vsConstantBuffer;
 	ID3D11Buffer* psConstantBuffer;
 
+	//uv * xy + zw is where the texture's [0, 1] is in resourceView, identity unless it is an atlas
+	XMFLOAT4 uvTransform;
+
 	Material(ID3D11ShaderResourceView* rv, ID3D11SamplerState* sample, ShaderProgram* s_program);
-	Material(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sampler, wchar_t* filepath, ShaderProgram* s_program);
-	Material(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, ShaderProgram* s_program);
-	Material(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, wchar_t* filepath3, ShaderProgram* s_program);
+	Material(AssetManager* assets, ID3D11SamplerState* sampler, wchar_t* filepath, ShaderProgram* s_program, bool streamMips = false);
+	Material(AssetManager* assets, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, ShaderProgram* s_program, bool streamMips = false);
+	Material(AssetManager* assets, ID3D11SamplerState* sampler, wchar_t* filepath, wchar_t* filepath2, wchar_t* filepath3, ShaderProgram* s_program, bool streamMips = false);
 	~Material(void);
+
+	//How many pixels on screen the textures were stretched over by this frame's draws, for streamed mips
+	void requestMips(float screenPixels);
+
+private:
+	void loadTexture(AssetManager* assets, wchar_t* filepath, ID3D11ShaderResourceView** slot);
+
+	AssetManager* mipAssets; // set when the textures stream their mips
 };
 
 #endif
\ No newline at end of file
@@ -1,15 +1,27 @@
 #include "Mesh.h"
 #include <d3dcompiler.h>
 #include "Global.h"
+#include "MeshFile.h"
 #include <typeinfo>
+#include <vector>
 
 Mesh::Mesh(Vertex* vertices, UINT* indices, int size, ID3D11Device* device){
 	m_size = size;
+	m_vertexCount = size;
 	m_vertices = vertices;
 	m_indices = indices;
 	m_device = device;
+	refCount = 1;
+	so_buffer = nullptr;
+	init_buffer = nullptr;
+	indexFormat = DXGI_FORMAT_R32_UINT;
+	sizeofindex = sizeof(UINT);
+	quantized = false;
+	XMStoreFloat4x4(&decodeMatrix, XMMatrixIdentity());
+	resetLods();
 
 	sizeofvertex = sizeof(Vertex);
+	computeBounds();
 
 	createVertexBuffer();
 	createIndexBuffer();
@@ -18,23 +30,112 @@ Mesh::Mesh(Vertex* vertices, UINT* indices, int size, ID3D11Device* device){
 //model mesh constructor
 Mesh::Mesh(Vertex2* vertices, UINT* indices, int size, ID3D11Device* device){
 	m_size = size;
+	m_vertexCount = size;
 	m_vertices = vertices;
 	m_indices = indices;
 	m_device = device;
+	refCount = 1;
+	so_buffer = nullptr;
+	init_buffer = nullptr;
+	indexFormat = DXGI_FORMAT_R32_UINT;
+	sizeofindex = sizeof(UINT);
+	quantized = false;
+	XMStoreFloat4x4(&decodeMatrix, XMMatrixIdentity());
+	resetLods();
 
 	sizeofvertex = sizeof(Vertex2);
+	computeBounds();
 
 	createVertexBuffer();
 	createIndexBuffer();
 }
 
+//indexed model mesh constructor, for vertex buffers that are shared between faces
+Mesh::Mesh(Vertex2* vertices, int vertexCount, UINT* indices, int indexCount, ID3D11Device* device){
+	m_size = indexCount;
+	m_vertexCount = vertexCount;
+	m_vertices = vertices;
+	m_indices = indices;
+	m_device = device;
+	refCount = 1;
+	so_buffer = nullptr;
+	init_buffer = nullptr;
+	indexFormat = DXGI_FORMAT_R32_UINT;
+	sizeofindex = sizeof(UINT);
+	quantized = false;
+	XMStoreFloat4x4(&decodeMatrix, XMMatrixIdentity());
+	resetLods();
+
+	sizeofvertex = sizeof(Vertex2);
+	computeBounds();
+
+	createVertexBuffer();
+	createIndexBuffer();
+}
+
+//cooked mesh constructor, the buffers are created straight from the mapped blobs and no CPU copy is kept
+Mesh::Mesh(const MeshFileView& view, ID3D11Device* device){
+	m_size = view.header->indexCount;
+	m_vertexCount = view.header->vertexCount;
+	m_vertices = const_cast<void*>(view.vertices);
+	m_indices = const_cast<void*>(view.indices);
+	m_device = device;
+	refCount = 1;
+	so_buffer = nullptr;
+	init_buffer = nullptr;
+	indexFormat = DXGI_FORMAT_R32_UINT;
+	sizeofindex = sizeof(UINT);
+	quantized = false;
+	XMStoreFloat4x4(&decodeMatrix, XMMatrixIdentity());
+	resetLods();
+
+	sizeofvertex = view.header->vertexStride;
+	if (view.header->indexSize == sizeof(unsigned short)){
+		indexFormat = DXGI_FORMAT_R16_UINT;
+		sizeofindex = sizeof(unsigned short);
+	}
+	boundsCenter = XMFLOAT3(view.header->boundsCenter[0], view.header->boundsCenter[1], view.header->boundsCenter[2]);
+	boundsRadius = view.header->boundsRadius;
+	if (IsPackedMeshFile(view)){
+		//unorm positions span the bounding cube, 0..1 -> center - radius..center + radius
+		quantized = true;
+		XMMATRIX decode = XMMatrixScaling(2.0f * boundsRadius, 2.0f * boundsRadius, 2.0f * boundsRadius) *
+			XMMatrixTranslation(boundsCenter.x - boundsRadius, boundsCenter.y - boundsRadius, boundsCenter.z - boundsRadius);
+		XMStoreFloat4x4(&decodeMatrix, decode);
+	}
+
+	createVertexBuffer();
+	createIndexBuffer();
+
+	//the index buffer holds every level, draws default to the full mesh
+	lodCount = view.header->lodCount;
+	for (int i = 0; i < lodCount; i++){
+		lods[i] = view.lods[i];
+	}
+	m_size = lods[0].indexCount;
+
+	//the mapping goes away after loading
+	m_vertices = nullptr;
+	m_indices = nullptr;
+}
+
 Mesh::Mesh(Phong* vertices, UINT* indices, int size, ID3D11Device* device){
 	m_size = size;
+	m_vertexCount = size;
 	m_vertices = vertices;
 	m_indices = indices;
 	m_device = device;
+	refCount = 1;
+	so_buffer = nullptr;
+	init_buffer = nullptr;
+	indexFormat = DXGI_FORMAT_R32_UINT;
+	sizeofindex = sizeof(UINT);
+	quantized = false;
+	XMStoreFloat4x4(&decodeMatrix, XMMatrixIdentity());
+	resetLods();
 
 	sizeofvertex = sizeof(Phong);
+	computeBounds();
 
 	createVertexBuffer();
 	createIndexBuffer();
@@ -42,11 +143,21 @@ Mesh::Mesh(Phong* vertices, UINT* indices, int size, ID3D11Device* device){
 
 Mesh::Mesh(Particle* vertices, UINT* indices, int size, ID3D11Device* device){
 	m_size = size;
+	m_vertexCount = size;
 	m_vertices = vertices;
 	m_indices = indices;
 	m_device = device;
+	refCount = 1;
+	so_buffer = nullptr;
+	init_buffer = nullptr;
+	indexFormat = DXGI_FORMAT_R32_UINT;
+	sizeofindex = sizeof(UINT);
+	quantized = false;
+	XMStoreFloat4x4(&decodeMatrix, XMMatrixIdentity());
+	resetLods();
 
 	sizeofvertex = sizeof(Particle);
+	computeBounds();
 
 	D3D11_BUFFER_DESC sobd;
 	sobd.Usage = D3D11_USAGE_DEFAULT;
@@ -72,21 +183,24 @@ Mesh::~Mesh(void){
 	ReleaseMacro(i_buffer);
 	ReleaseMacro(init_buffer);
 	ReleaseMacro(so_buffer);
-	ReleaseMacro(m_device);
-	if (m_indices){
-		delete m_indices;
-		m_indices = nullptr;
-	}
-	if (m_vertices){
-		delete m_vertices;
-		m_vertices = nullptr;
+}
+
+ULONG Mesh::AddRef(){
+	return ++refCount;
+}
+
+ULONG Mesh::Release(){
+	ULONG remaining = --refCount;
+	if (remaining == 0){
+		delete this;
 	}
+	return remaining;
 }
 
 void Mesh::createVertexBuffer(){
 	D3D11_BUFFER_DESC vbd;
 	vbd.Usage = D3D11_USAGE_IMMUTABLE;
-	vbd.ByteWidth = sizeofvertex * m_size;
+	vbd.ByteWidth = sizeofvertex * m_vertexCount;
 	// Number of vertices in the "model" you want to draw
 	vbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	vbd.CPUAccessFlags = 0;
@@ -101,7 +215,7 @@ void Mesh::createVertexBuffer(){
 void Mesh::createInitBuffer(){
 	D3D11_BUFFER_DESC initbd;
 	initbd.Usage = D3D11_USAGE_IMMUTABLE;
-	initbd.ByteWidth = sizeofvertex * m_size;
+	initbd.ByteWidth = sizeofvertex * m_vertexCount;
 	// Number of vertices in the "model" you want to draw
 	initbd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 	initbd.CPUAccessFlags = 0;
@@ -112,10 +226,34 @@ void Mesh::createInitBuffer(){
 	m_device->CreateBuffer(&initbd, &initialVertexData, &init_buffer);
 }
 
+void Mesh::resetLods(){
+	lodCount = 1;
+	lods[0].firstIndex = 0;
+	lods[0].indexCount = m_size > 0 ? m_size : 0;
+	lods[0].error = 0.0f;
+}
+
+void Mesh::computeBounds(){
+	ComputeMeshBounds(m_vertices, sizeofvertex, m_vertexCount > 0 ? m_vertexCount : 0, boundsCenter, boundsRadius);
+}
+
 void Mesh::createIndexBuffer(){
+	//32-bit arrays are packed down when they can be, halving index fetch
+	std::vector<unsigned short> packed;
+	if (m_indices && indexFormat == DXGI_FORMAT_R32_UINT && m_vertexCount > 0 && m_vertexCount <= 0xFFFF && m_size > 0){
+		packed.resize(m_size);
+		const UINT* wide = static_cast<const UINT*>(m_indices);
+		for (int i = 0; i < m_size; i++){
+			packed[i] = (unsigned short)wide[i];
+		}
+		m_indices = &packed[0];
+		indexFormat = DXGI_FORMAT_R16_UINT;
+		sizeofindex = sizeof(unsigned short);
+	}
+
 	D3D11_BUFFER_DESC ibd;
 	ibd.Usage = D3D11_USAGE_IMMUTABLE;
-	ibd.ByteWidth = sizeof(UINT) * m_size; // Number of indices in the "model" you want to draw
+	ibd.ByteWidth = sizeofindex * m_size; // Number of indices in the "model" you want to draw
 	ibd.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	ibd.CPUAccessFlags = 0;
 	ibd.MiscFlags = 0;
@@ -123,5 +261,8 @@ void Mesh::createIndexBuffer(){
 	D3D11_SUBRESOURCE_DATA initialIndexData;
 	initialIndexData.pSysMem = m_indices;
 	m_device->CreateBuffer(&ibd, &initialIndexData, &i_buffer);
+	if (!packed.empty()){
+		m_indices = nullptr;
+	}
 }
 
@@ -2,30 +2,51 @@
 #define _MESH_H
 
 #include "Global.h"
+#include "MeshFile.h"
 #include <Windows.h>
 #include <d3d11.h>
 
 
 class Mesh{
 public:
-	int m_size;
-	void* m_vertices;
-	UINT* m_indices;
+	int m_size; // index count, what draws use
+	int m_vertexCount;
+	void* m_vertices; // the caller's arrays, only read while the buffers are created
+	void* m_indices;
 	ID3D11Device* m_device;
 	ID3D11Buffer* v_buffer;
 	ID3D11Buffer* so_buffer;
 	ID3D11Buffer* i_buffer;
 	ID3D11Buffer* init_buffer;
+	DXGI_FORMAT indexFormat; // R16_UINT whenever every vertex fits in 16 bits
+	int sizeofindex;
 	int sizeofvertex;
+	XMFLOAT3 boundsCenter; // local space bounding sphere, used for culling
+	float boundsRadius;
+	bool quantized; // PackedVertex2s, drawn with the packed vertex shaders
+	XMFLOAT4X4 decodeMatrix; // takes packed positions to model space, identity for float meshes
+	MeshLod lods[MESH_MAX_LODS]; // runs of i_buffer from full detail down, only cooked meshes have more than one
+	int lodCount;
 	Mesh(Vertex* vertices, UINT* indices, int size, ID3D11Device* device);
 	Mesh(Vertex2* vertices, UINT* indices, int size, ID3D11Device* device);
+	Mesh(Vertex2* vertices, int vertexCount, UINT* indices, int indexCount, ID3D11Device* device);
+	Mesh(const MeshFileView& view, ID3D11Device* device); // view must stay mapped until this returns
 	Mesh(Phong* vertices, UINT* indices, int size, ID3D11Device* device);
 	Mesh(Particle* vertices, UINT* indices, int size, ID3D11Device* device);
 	~Mesh(void);
 	void createVertexBuffer();
 	void createIndexBuffer();
 	void createInitBuffer();
+	void computeBounds();
+	void resetLods(); // a single level covering the whole index buffer
 	void drawMesh(ID3D11DeviceContext* deviceContext);
+
+	//Meshes are shared between entities and the asset cache, so they are reference counted the way
+	//COM objects are: the creator holds the first reference and ReleaseMacro works on them
+	ULONG AddRef();
+	ULONG Release();
+private:
+	ULONG refCount;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "MeshFile.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <cmath>
+#include <vector>
+
+static const MeshFileElement vertex2Layout[] = {
+	{ "POSITION", 0, MESH_FORMAT_FLOAT3, offsetof(Vertex2, Position) },
+	{ "NORMAL", 0, MESH_FORMAT_FLOAT3, offsetof(Vertex2, Normal) },
+	{ "TEXCOORD", 0, MESH_FORMAT_FLOAT2, offsetof(Vertex2, UVs) },
+	{ "TANGENT", 0, MESH_FORMAT_FLOAT4, offsetof(Vertex2, Tangent) },
+};
+
+static const MeshFileElement packedVertex2Layout[] = {
+	{ "POSITION", 0, MESH_FORMAT_UNORM16X4, offsetof(PackedVertex2, position) },
+	{ "NORMAL", 0, MESH_FORMAT_SNORM16X2, offsetof(PackedVertex2, normal) },
+	{ "TEXCOORD", 0, MESH_FORMAT_HALF2, offsetof(PackedVertex2, uv) },
+	{ "TANGENT", 0, MESH_FORMAT_SNORM16X2, offsetof(PackedVertex2, tangent) },
+};
+
+const MeshFileElement* GetVertex2Layout(uint32_t& elementCount){
+	elementCount = sizeof(vertex2Layout) / sizeof(vertex2Layout[0]);
+	return vertex2Layout;
+}
+
+const MeshFileElement* GetPackedVertex2Layout(uint32_t& elementCount){
+	elementCount = sizeof(packedVertex2Layout) / sizeof(packedVertex2Layout[0]);
+	return packedVertex2Layout;
+}
+
+void ComputeMeshBounds(const void* vertices, uint32_t stride, uint32_t vertexCount, XMFLOAT3& center, float& radius){
+	center = XMFLOAT3(0.0f, 0.0f, 0.0f);
+	radius = 0.0f;
+	if (!vertices || vertexCount == 0){
+		return;
+	}
+
+	const char* bytes = static_cast<const char*>(vertices);
+	XMFLOAT3 minimum = *reinterpret_cast<const XMFLOAT3*>(bytes);
+	XMFLOAT3 maximum = minimum;
+	for (uint32_t i = 1; i < vertexCount; i++){
+		const XMFLOAT3& p = *reinterpret_cast<const XMFLOAT3*>(bytes + (size_t)i * stride);
+		if (p.x < minimum.x) minimum.x = p.x;
+		if (p.y < minimum.y) minimum.y = p.y;
+		if (p.z < minimum.z) minimum.z = p.z;
+		if (p.x > maximum.x) maximum.x = p.x;
+		if (p.y > maximum.y) maximum.y = p.y;
+		if (p.z > maximum.z) maximum.z = p.z;
+	}
+	center = XMFLOAT3((minimum.x + maximum.x) * 0.5f, (minimum.y + maximum.y) * 0.5f, (minimum.z + maximum.z) * 0.5f);
+
+	float radiusSq = 0.0f;
+	for (uint32_t i = 0; i < vertexCount; i++){
+		const XMFLOAT3& p = *reinterpret_cast<const XMFLOAT3*>(bytes + (size_t)i * stride);
+		float dx = p.x - center.x;
+		float dy = p.y - center.y;
+		float dz = p.z - center.z;
+		float distanceSq = dx * dx + dy * dy + dz * dz;
+		if (distanceSq > radiusSq){
+			radiusSq = distanceSq;
+		}
+	}
+	radius = sqrtf(radiusSq);
+}
+
+static uint32_t AlignMeshOffset(uint32_t offset){
+	return (offset + MESH_FILE_ALIGNMENT - 1) & ~(uint32_t)(MESH_FILE_ALIGNMENT - 1);
+}
+
+bool WriteMeshFile(const std::string& path, const MeshFileElement* elements, uint32_t elementCount, const void* vertices, uint32_t stride, uint32_t vertexCount, const unsigned int* indices, uint32_t indexCount, const MeshLod* lods, uint32_t lodCount, const XMFLOAT3& boundsCenter, float boundsRadius, const AssetStamp& source){
+	MeshLod full;
+	full.firstIndex = 0;
+	full.indexCount = indexCount;
+	full.error = 0.0f;
+	if (lodCount == 0){
+		lods = &full;
+		lodCount = 1;
+	}
+
+	MeshFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = MESH_FILE_MAGIC;
+	header.version = MESH_FILE_VERSION;
+	header.vertexStride = stride;
+	header.vertexCount = vertexCount;
+	header.indexCount = indexCount;
+	header.indexSize = vertexCount <= 0xFFFF ? sizeof(uint16_t) : sizeof(uint32_t);
+	header.elementCount = elementCount;
+	header.elementOffset = sizeof(MeshFileHeader);
+	header.lodCount = lodCount;
+	header.lodOffset = header.elementOffset + elementCount * sizeof(MeshFileElement);
+	header.vertexOffset = AlignMeshOffset(header.lodOffset + lodCount * sizeof(MeshLod));
+	header.indexOffset = AlignMeshOffset(header.vertexOffset + vertexCount * stride);
+	header.source = source;
+
+	header.boundsCenter[0] = boundsCenter.x;
+	header.boundsCenter[1] = boundsCenter.y;
+	header.boundsCenter[2] = boundsCenter.z;
+	header.boundsRadius = boundsRadius;
+
+	uint32_t fileSize = header.indexOffset + indexCount * header.indexSize;
+	std::vector<char> image(fileSize, 0);
+	memcpy(&image[0], &header, sizeof(header));
+	memcpy(&image[header.elementOffset], elements, elementCount * sizeof(MeshFileElement));
+	memcpy(&image[header.lodOffset], lods, lodCount * sizeof(MeshLod));
+	if (vertexCount){
+		memcpy(&image[header.vertexOffset], vertices, (size_t)vertexCount * stride);
+	}
+	if (indexCount && header.indexSize == sizeof(uint16_t)){
+		uint16_t* packed = reinterpret_cast<uint16_t*>(&image[header.indexOffset]);
+		for (uint32_t i = 0; i < indexCount; i++){
+			packed[i] = (uint16_t)indices[i];
+		}
+	}
+	else if (indexCount){
+		memcpy(&image[header.indexOffset], indices, (size_t)indexCount * header.indexSize);
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file){
+		return false;
+	}
+	bool written = fwrite(&image[0], 1, image.size(), file) == image.size();
+	return fclose(file) == 0 && written;
+}
+
+//offset + count * stride must fit without wrapping
+static bool MeshSectionFits(uint32_t offset, uint32_t count, uint32_t stride, uint32_t alignment, size_t size){
+	if (offset % alignment != 0){
+		return false;
+	}
+	uint64_t end = (uint64_t)offset + (uint64_t)count * stride;
+	return end <= size;
+}
+
+bool ReadMeshFile(const char* data, size_t size, MeshFileView& view){
+	if (!data || size < sizeof(MeshFileHeader)){
+		return false;
+	}
+	const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>(data);
+	if (header->magic != MESH_FILE_MAGIC || header->version != MESH_FILE_VERSION){
+		return false;
+	}
+	if (header->indexSize != 2 && header->indexSize != 4){
+		return false;
+	}
+	if (header->lodCount == 0 || header->lodCount > MESH_MAX_LODS){
+		return false;
+	}
+	if (!MeshSectionFits(header->elementOffset, header->elementCount, sizeof(MeshFileElement), sizeof(uint32_t), size) ||
+		!MeshSectionFits(header->lodOffset, header->lodCount, sizeof(MeshLod), sizeof(uint32_t), size) ||
+		!MeshSectionFits(header->vertexOffset, header->vertexCount, header->vertexStride, MESH_FILE_ALIGNMENT, size) ||
+		!MeshSectionFits(header->indexOffset, header->indexCount, header->indexSize, MESH_FILE_ALIGNMENT, size)){
+		return false;
+	}
+
+	const MeshLod* lods = reinterpret_cast<const MeshLod*>(data + header->lodOffset);
+	for (uint32_t i = 0; i < header->lodCount; i++){
+		if ((uint64_t)lods[i].firstIndex + lods[i].indexCount > header->indexCount){
+			return false;
+		}
+	}
+
+	view.header = header;
+	view.elements = reinterpret_cast<const MeshFileElement*>(data + header->elementOffset);
+	view.lods = lods;
+	view.vertices = data + header->vertexOffset;
+	view.indices = data + header->indexOffset;
+	return true;
+}
+
+bool MeshFileHasLayout(const MeshFileView& view, const MeshFileElement* elements, uint32_t elementCount, uint32_t stride){
+	if (view.header->vertexStride != stride || view.header->elementCount != elementCount){
+		return false;
+	}
+	for (uint32_t i = 0; i < elementCount; i++){
+		const MeshFileElement& a = view.elements[i];
+		const MeshFileElement& b = elements[i];
+		if (strncmp(a.semantic, b.semantic, sizeof(a.semantic)) != 0 || a.semanticIndex != b.semanticIndex || a.format != b.format || a.offset != b.offset){
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string GetCookedMeshPath(const std::string& sourcePath){
+	size_t dot = sourcePath.find_last_of('.');
+	size_t slash = sourcePath.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)){
+		return sourcePath + MESH_FILE_EXTENSION;
+	}
+	return sourcePath.substr(0, dot) + MESH_FILE_EXTENSION;
+}
+
+bool IsPackedMeshFile(const MeshFileView& view){
+	uint32_t elementCount;
+	const MeshFileElement* layout = GetPackedVertex2Layout(elementCount);
+	return MeshFileHasLayout(view, layout, elementCount, sizeof(PackedVertex2));
+}
+
+bool OpenCookedMesh(const std::string& sourcePath, MappedFile& mapped, MeshFileView& view){
+	std::string cookedPath = GetCookedMeshPath(sourcePath);
+	if (!mapped.open(cookedPath)){
+		return false;
+	}
+
+	uint32_t elementCount;
+	const MeshFileElement* layout = GetVertex2Layout(elementCount);
+	if (!ReadMeshFile(mapped.data(), mapped.size(), view) || view.lods[0].indexCount == 0 ||
+		!(MeshFileHasLayout(view, layout, elementCount, sizeof(Vertex2)) || IsPackedMeshFile(view)) ||
+		!IsCookedAssetCurrent(sourcePath, view.header->source, cookedPath, (const char*)&view.header->source - mapped.data())){
+		mapped.close();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,107 @@
+#ifndef _MESHFILE_H
+#define _MESHFILE_H
+
+#include "Global.h"
+#include "AssetStamp.h"
+#include "VertexCodec.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile;
+
+/**
+*Cooked mesh layout:
+*	MeshFileHeader
+*	MeshFileElement[elementCount]	the vertex layout
+*	MeshLod[lodCount]				index ranges of the levels of detail, 0 is the full mesh
+*	vertex blob						vertexCount * vertexStride bytes, 16 byte aligned, shared by every LOD
+*	index blob						indexCount * indexSize bytes, 16 byte aligned, 16-bit when the vertices allow
+*Everything is little endian and read in place from a mapping, so the blobs go straight
+*into buffer creation.
+**/
+#define MESH_FILE_MAGIC 0x4853454D // "MESH"
+#define MESH_FILE_VERSION 4
+#define MESH_FILE_ALIGNMENT 16
+#define MESH_FILE_EXTENSION ".mesh"
+#define MESH_MAX_LODS 4
+
+//Element formats, same values as the DXGI_FORMAT they describe
+#define MESH_FORMAT_FLOAT2 16 // DXGI_FORMAT_R32G32_FLOAT
+#define MESH_FORMAT_FLOAT3 6 // DXGI_FORMAT_R32G32B32_FLOAT
+#define MESH_FORMAT_FLOAT4 2 // DXGI_FORMAT_R32G32B32A32_FLOAT
+#define MESH_FORMAT_UNORM16X4 11 // DXGI_FORMAT_R16G16B16A16_UNORM
+#define MESH_FORMAT_HALF2 34 // DXGI_FORMAT_R16G16_FLOAT
+#define MESH_FORMAT_SNORM16X2 37 // DXGI_FORMAT_R16G16_SNORM
+
+struct MeshFileHeader{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vertexStride;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t indexSize; // bytes per index
+	uint32_t elementCount;
+	uint32_t elementOffset;
+	uint32_t lodCount;
+	uint32_t lodOffset;
+	uint32_t vertexOffset;
+	uint32_t indexOffset;
+	float boundsCenter[3]; // local space bounding sphere
+	float boundsRadius;
+	AssetStamp source;
+};
+
+struct MeshFileElement{
+	char semantic[16];
+	uint32_t semanticIndex;
+	uint32_t format;
+	uint32_t offset;
+};
+
+//One level of detail, a run of the index buffer; the file stores these and Mesh keeps them
+struct MeshLod{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	float error; // simplification error in model units, 0 for the full mesh
+};
+
+//Pointers into a validated file image
+struct MeshFileView{
+	const MeshFileHeader* header;
+	const MeshFileElement* elements;
+	const MeshLod* lods;
+	const void* vertices;
+	const void* indices;
+};
+
+//The layout that matches Vertex2
+const MeshFileElement* GetVertex2Layout(uint32_t& elementCount);
+//The layout that matches PackedVertex2, positions decode against the header's bounding sphere
+const MeshFileElement* GetPackedVertex2Layout(uint32_t& elementCount);
+
+//Bounding sphere around the box of the positions; every vertex type starts with its position
+void ComputeMeshBounds(const void* vertices, uint32_t stride, uint32_t vertexCount, XMFLOAT3& center, float& radius);
+
+//Writes a cooked mesh, indices are stored 16-bit when every vertex can be addressed that way.
+//indices holds every LOD back to back as lods describes; with no lods it is one full level.
+//The bounds are passed in since packed positions can't be measured
+bool WriteMeshFile(const std::string& path, const MeshFileElement* elements, uint32_t elementCount, const void* vertices, uint32_t stride, uint32_t vertexCount, const unsigned int* indices, uint32_t indexCount, const MeshLod* lods, uint32_t lodCount, const XMFLOAT3& boundsCenter, float boundsRadius, const AssetStamp& source);
+
+//Checks the header, that every section lies inside [data, data + size) and every LOD inside the indices
+bool ReadMeshFile(const char* data, size_t size, MeshFileView& view);
+
+//True if the file was cooked with exactly this vertex layout
+bool MeshFileHasLayout(const MeshFileView& view, const MeshFileElement* elements, uint32_t elementCount, uint32_t stride);
+
+//asteroid.obj -> asteroid.mesh
+std::string GetCookedMeshPath(const std::string& sourcePath);
+
+//True if the file holds PackedVertex2s
+bool IsPackedMeshFile(const MeshFileView& view);
+
+//Maps the cooked Vertex2 or PackedVertex2 mesh for sourcePath, false unless it exists, is valid and still current.
+//The view points into mapped, which has to stay open while it is used
+bool OpenCookedMesh(const std::string& sourcePath, MappedFile& mapped, MeshFileView& view);
+
+#endif
@@ -0,0 +1,329 @@
+#include "MeshOptimizer.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+//LRU size Forsyth's scoring is tuned for, it only has to be near the hardware's
+#define FORSYTH_CACHE_SIZE 32
+
+static const size_t noTriangle = (size_t)-1;
+
+static float ForsythVertexScore(int cachePosition, unsigned int remainingTriangles){
+	if (remainingTriangles == 0){
+		return -1.0f;
+	}
+	float score = 0.0f;
+	if (cachePosition >= 0){
+		//the last triangle's vertices score the same, so the next one isn't forced to reuse its edge
+		if (cachePosition < 3){
+			score = 0.75f;
+		}
+		else{
+			score = powf(1.0f - (float)(cachePosition - 3) / (FORSYTH_CACHE_SIZE - 3), 1.5f);
+		}
+	}
+	//vertices with few triangles left get finished off before they fall out of the cache
+	return score + 2.0f / sqrtf((float)remainingTriangles);
+}
+
+MeshCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize){
+	MeshCacheStats stats;
+	stats.acmr = 0.0f;
+	stats.atvr = 0.0f;
+	if (indexCount < 3 || vertexCount == 0){
+		return stats;
+	}
+
+	//a vertex is in the FIFO if fewer than cacheSize misses happened since it was loaded
+	std::vector<unsigned int> loadedAt(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+	unsigned int misses = 0;
+	for (size_t i = 0; i < indexCount; i++){
+		unsigned int v = indices[i];
+		if (time - loadedAt[v] > cacheSize){
+			loadedAt[v] = time++;
+			misses++;
+		}
+	}
+
+	size_t used = 0;
+	for (size_t v = 0; v < vertexCount; v++){
+		if (loadedAt[v] != 0){
+			used++;
+		}
+	}
+	stats.acmr = (float)misses / (float)(indexCount / 3);
+	stats.atvr = used > 0 ? (float)misses / (float)used : 0.0f;
+	return stats;
+}
+
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount){
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount < 2 || vertexCount == 0){
+		return;
+	}
+
+	//triangles around each vertex; live ones are kept at the front of each list
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++){
+		remaining[indices[i]]++;
+	}
+	std::vector<unsigned int> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++){
+		offsets[v + 1] = offsets[v] + remaining[v];
+	}
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++){
+		for (int k = 0; k < 3; k++){
+			adjacency[cursor[indices[t * 3 + k]]++] = (unsigned int)t;
+		}
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++){
+		vertexScore[v] = ForsythVertexScore(-1, remaining[v]);
+	}
+	std::vector<float> triangleScore(triangleCount);
+	size_t best = 0;
+	for (size_t t = 0; t < triangleCount; t++){
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		if (triangleScore[t] > triangleScore[best]){
+			best = t;
+		}
+	}
+
+	std::vector<char> emitted(triangleCount, 0);
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	unsigned int cache[FORSYTH_CACHE_SIZE + 3];
+	unsigned int cacheCount = 0;
+	size_t inputCursor = 0;
+
+	while (best != noTriangle){
+		emitted[best] = 1;
+		const unsigned int* triangle = &indices[best * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+
+		//the triangle's vertices go to the front, the rest shift back and up to three fall out
+		unsigned int newCache[FORSYTH_CACHE_SIZE + 3];
+		unsigned int newCount = 0;
+		for (int k = 0; k < 3; k++){
+			newCache[newCount++] = triangle[k];
+		}
+		for (unsigned int i = 0; i < cacheCount; i++){
+			unsigned int v = cache[i];
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2]){
+				newCache[newCount++] = v;
+			}
+		}
+
+		for (int k = 0; k < 3; k++){
+			unsigned int v = triangle[k];
+			unsigned int* list = &adjacency[offsets[v]];
+			for (unsigned int i = 0; i < remaining[v]; i++){
+				if (list[i] == best){
+					list[i] = list[remaining[v] - 1];
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		for (unsigned int i = 0; i < newCount; i++){
+			unsigned int v = newCache[i];
+			cachePosition[v] = i < FORSYTH_CACHE_SIZE ? (int)i : -1;
+			vertexScore[v] = ForsythVertexScore(cachePosition[v], remaining[v]);
+		}
+		cacheCount = newCount < FORSYTH_CACHE_SIZE ? newCount : FORSYTH_CACHE_SIZE;
+		memcpy(cache, newCache, cacheCount * sizeof(unsigned int));
+
+		//only triangles touching the old or new cache changed score
+		best = noTriangle;
+		float bestScore = -1.0f;
+		for (unsigned int i = 0; i < newCount; i++){
+			unsigned int v = newCache[i];
+			const unsigned int* list = &adjacency[offsets[v]];
+			for (unsigned int j = 0; j < remaining[v]; j++){
+				unsigned int t = list[j];
+				const unsigned int* corners = &indices[t * 3];
+				triangleScore[t] = vertexScore[corners[0]] + vertexScore[corners[1]] + vertexScore[corners[2]];
+				if (triangleScore[t] > bestScore){
+					bestScore = triangleScore[t];
+					best = t;
+				}
+			}
+		}
+
+		//dead end, restart from the first triangle not drawn yet
+		if (best == noTriangle){
+			while (inputCursor < triangleCount && emitted[inputCursor]){
+				inputCursor++;
+			}
+			if (inputCursor < triangleCount){
+				best = inputCursor;
+			}
+		}
+	}
+
+	memcpy(indices, &output[0], output.size() * sizeof(unsigned int));
+}
+
+struct OverdrawCluster{
+	size_t start;
+	size_t count; // triangles
+	float sortKey;
+};
+
+static const XMFLOAT3& GetVertexPosition(const void* vertices, size_t stride, unsigned int index){
+	return *reinterpret_cast<const XMFLOAT3*>(static_cast<const char*>(vertices) + index * stride);
+}
+
+/**
+*Sander, Nehab and Barczak's approach: the cache ordered list is cut into clusters where the
+*cache starts over anyway, then clusters facing away from the middle of the mesh go first since
+*they are the ones most likely to cover the rest.
+**/
+bool OptimizeOverdraw(unsigned int* indices, size_t indexCount, const void* vertices, size_t stride, size_t vertexCount, float threshold){
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount < 2 || vertexCount == 0){
+		return false;
+	}
+	MeshCacheStats before = AnalyzeVertexCache(indices, indexCount, vertexCount, MESH_CACHE_SIZE);
+
+	//hard boundaries where a triangle misses on all three vertices, soft ones where it misses on
+	//two and the cluster so far already beats the target
+	std::vector<OverdrawCluster> clusters;
+	std::vector<unsigned int> loadedAt(vertexCount, 0);
+	unsigned int time = MESH_CACHE_SIZE + 1;
+	unsigned int clusterMisses = 0;
+	for (size_t t = 0; t < triangleCount; t++){
+		unsigned int misses = 0;
+		for (int k = 0; k < 3; k++){
+			unsigned int v = indices[t * 3 + k];
+			if (time - loadedAt[v] > MESH_CACHE_SIZE){
+				loadedAt[v] = time++;
+				misses++;
+			}
+		}
+		bool split = clusters.empty() || misses == 3;
+		if (!split && misses >= 2){
+			split = (float)clusterMisses / (float)clusters.back().count <= before.acmr * threshold;
+		}
+		if (split){
+			OverdrawCluster cluster;
+			cluster.start = t;
+			cluster.count = 0;
+			cluster.sortKey = 0.0f;
+			clusters.push_back(cluster);
+			clusterMisses = 0;
+		}
+		clusters.back().count++;
+		clusterMisses += misses;
+	}
+	if (clusters.size() < 2){
+		return false;
+	}
+
+	//area weighted centroids and normals
+	std::vector<XMFLOAT3> centroids(clusters.size());
+	std::vector<XMFLOAT3> normals(clusters.size());
+	std::vector<float> areas(clusters.size());
+	XMFLOAT3 meshCentroid(0.0f, 0.0f, 0.0f);
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusters.size(); c++){
+		XMFLOAT3 centroid(0.0f, 0.0f, 0.0f);
+		XMFLOAT3 normal(0.0f, 0.0f, 0.0f);
+		float area = 0.0f;
+		for (size_t t = clusters[c].start; t < clusters[c].start + clusters[c].count; t++){
+			const XMFLOAT3& a = GetVertexPosition(vertices, stride, indices[t * 3]);
+			const XMFLOAT3& b = GetVertexPosition(vertices, stride, indices[t * 3 + 1]);
+			const XMFLOAT3& p = GetVertexPosition(vertices, stride, indices[t * 3 + 2]);
+			XMFLOAT3 ab(b.x - a.x, b.y - a.y, b.z - a.z);
+			XMFLOAT3 ac(p.x - a.x, p.y - a.y, p.z - a.z);
+			XMFLOAT3 cross(ab.y * ac.z - ab.z * ac.y, ab.z * ac.x - ab.x * ac.z, ab.x * ac.y - ab.y * ac.x);
+			float triangleArea = sqrtf(cross.x * cross.x + cross.y * cross.y + cross.z * cross.z) * 0.5f;
+			centroid.x += (a.x + b.x + p.x) / 3.0f * triangleArea;
+			centroid.y += (a.y + b.y + p.y) / 3.0f * triangleArea;
+			centroid.z += (a.z + b.z + p.z) / 3.0f * triangleArea;
+			normal.x += cross.x;
+			normal.y += cross.y;
+			normal.z += cross.z;
+			area += triangleArea;
+		}
+		meshCentroid.x += centroid.x;
+		meshCentroid.y += centroid.y;
+		meshCentroid.z += centroid.z;
+		meshArea += area;
+		if (area > 0.0f){
+			centroid.x /= area;
+			centroid.y /= area;
+			centroid.z /= area;
+		}
+		centroids[c] = centroid;
+		normals[c] = normal;
+		areas[c] = area;
+	}
+	if (meshArea > 0.0f){
+		meshCentroid.x /= meshArea;
+		meshCentroid.y /= meshArea;
+		meshCentroid.z /= meshArea;
+	}
+
+	for (size_t c = 0; c < clusters.size(); c++){
+		const XMFLOAT3& n = normals[c];
+		float length = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+		if (length > 0.0f && areas[c] > 0.0f){
+			clusters[c].sortKey = ((centroids[c].x - meshCentroid.x) * n.x + (centroids[c].y - meshCentroid.y) * n.y + (centroids[c].z - meshCentroid.z) * n.z) / length;
+		}
+	}
+	std::stable_sort(clusters.begin(), clusters.end(), [](const OverdrawCluster& a, const OverdrawCluster& b){
+		return a.sortKey > b.sortKey;
+	});
+
+	std::vector<unsigned int> sorted;
+	sorted.reserve(triangleCount * 3);
+	for (size_t c = 0; c < clusters.size(); c++){
+		sorted.insert(sorted.end(), indices + clusters[c].start * 3, indices + (clusters[c].start + clusters[c].count) * 3);
+	}
+	MeshCacheStats after = AnalyzeVertexCache(&sorted[0], sorted.size(), vertexCount, MESH_CACHE_SIZE);
+	if (after.acmr > before.acmr * threshold){
+		return false;
+	}
+	memcpy(indices, &sorted[0], sorted.size() * sizeof(unsigned int));
+	return true;
+}
+
+size_t OptimizeVertexFetch(void* vertices, size_t stride, size_t vertexCount, unsigned int* indices, size_t indexCount){
+	const unsigned int unused = ~0u;
+	std::vector<unsigned int> remap(vertexCount, unused);
+	unsigned int next = 0;
+	for (size_t i = 0; i < indexCount; i++){
+		unsigned int v = indices[i];
+		if (remap[v] == unused){
+			remap[v] = next++;
+		}
+		indices[i] = remap[v];
+	}
+
+	char* bytes = static_cast<char*>(vertices);
+	std::vector<char> original(bytes, bytes + vertexCount * stride);
+	for (size_t v = 0; v < vertexCount; v++){
+		if (remap[v] != unused){
+			memcpy(bytes + remap[v] * stride, &original[v * stride], stride);
+		}
+	}
+	return next;
+}
+
+void OptimizeMesh(std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices, bool overdraw){
+	if (indices.empty() || vertices.empty()){
+		return;
+	}
+	OptimizeVertexCache(&indices[0], indices.size(), vertices.size());
+	if (overdraw){
+		OptimizeOverdraw(&indices[0], indices.size(), &vertices[0], sizeof(Vertex2), vertices.size(), MESH_OVERDRAW_THRESHOLD);
+	}
+	vertices.resize(OptimizeVertexFetch(&vertices[0], sizeof(Vertex2), vertices.size(), &indices[0], indices.size()));
+}
@@ -0,0 +1,36 @@
+#ifndef _MESHOPTIMIZER_H
+#define _MESHOPTIMIZER_H
+
+#include "Global.h"
+#include <vector>
+#include <cstddef>
+
+/**
+*Reorders indexed triangle lists for the GPU.
+*	OptimizeVertexCache		Forsyth's linear speed vertex cache ordering
+*	OptimizeOverdraw		sorts cache friendly clusters so outward facing ones draw first
+*	OptimizeVertexFetch		renumbers vertices in first use order so fetches walk the buffer
+*Positions are read from the first 12 bytes of each vertex, like every vertex type here has them.
+**/
+#define MESH_CACHE_SIZE 16 // post transform FIFO the stats simulate
+#define MESH_OVERDRAW_THRESHOLD 1.05f // how much ACMR the overdraw pass may give back
+
+struct MeshCacheStats{
+	float acmr; // transformed vertices per triangle, 0.5 is the best a regular grid gets
+	float atvr; // transformed vertices per vertex, 1 is perfect
+};
+
+MeshCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize);
+
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+//Expects cache optimised input, keeps the new order only if ACMR stays within threshold of it
+bool OptimizeOverdraw(unsigned int* indices, size_t indexCount, const void* vertices, size_t stride, size_t vertexCount, float threshold);
+
+//Rewrites the vertices in place and drops unreferenced ones, returns the new vertex count
+size_t OptimizeVertexFetch(void* vertices, size_t stride, size_t vertexCount, unsigned int* indices, size_t indexCount);
+
+//The whole pass for parsed meshes; overdraw ordering costs a few sorts and is worth it offline
+void OptimizeMesh(std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices, bool overdraw);
+
+#endif
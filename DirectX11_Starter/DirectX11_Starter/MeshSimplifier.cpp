@@ -0,0 +1,434 @@
+#include "MeshSimplifier.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+//Sum of weighted squared plane distances, the symmetric 4x4 kept as its upper triangle
+struct Quadric{
+	double a00, a01, a02, a03;
+	double a11, a12, a13;
+	double a22, a23;
+	double a33;
+	double weight;
+};
+
+static void AddPlane(Quadric& q, double nx, double ny, double nz, double d, double weight){
+	q.a00 += weight * nx * nx;
+	q.a01 += weight * nx * ny;
+	q.a02 += weight * nx * nz;
+	q.a03 += weight * nx * d;
+	q.a11 += weight * ny * ny;
+	q.a12 += weight * ny * nz;
+	q.a13 += weight * ny * d;
+	q.a22 += weight * nz * nz;
+	q.a23 += weight * nz * d;
+	q.a33 += weight * d * d;
+	q.weight += weight;
+}
+
+static void AddQuadric(Quadric& q, const Quadric& other){
+	q.a00 += other.a00;
+	q.a01 += other.a01;
+	q.a02 += other.a02;
+	q.a03 += other.a03;
+	q.a11 += other.a11;
+	q.a12 += other.a12;
+	q.a13 += other.a13;
+	q.a22 += other.a22;
+	q.a23 += other.a23;
+	q.a33 += other.a33;
+	q.weight += other.weight;
+}
+
+//Mean squared distance of p to the quadric's planes
+static double EvaluateQuadric(const Quadric& q, const XMFLOAT3& p){
+	if (q.weight <= 0.0){
+		return 0.0;
+	}
+	double x = p.x;
+	double y = p.y;
+	double z = p.z;
+	double value = q.a00 * x * x + 2.0 * q.a01 * x * y + 2.0 * q.a02 * x * z + 2.0 * q.a03 * x +
+		q.a11 * y * y + 2.0 * q.a12 * y * z + 2.0 * q.a13 * y +
+		q.a22 * z * z + 2.0 * q.a23 * z +
+		q.a33;
+	value /= q.weight;
+	return value > 0.0 ? value : 0.0;
+}
+
+static XMFLOAT3 Subtract(const XMFLOAT3& a, const XMFLOAT3& b){
+	return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b){
+	return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+static float Dot(const XMFLOAT3& a, const XMFLOAT3& b){
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static unsigned long long EdgeKey(unsigned int a, unsigned int b){
+	return ((unsigned long long)a << 32) | b;
+}
+
+struct PositionKey{
+	float x, y, z;
+};
+
+struct PositionKeyHash{
+	size_t operator()(const PositionKey& key) const{
+		unsigned int bits[3];
+		memcpy(bits, &key, sizeof(bits));
+		return (size_t)(bits[0] * 73856093u ^ bits[1] * 19349663u ^ bits[2] * 83492791u);
+	}
+};
+
+struct PositionKeyEqual{
+	bool operator()(const PositionKey& a, const PositionKey& b) const{
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+};
+
+struct Collapse{
+	unsigned int from; // position ids
+	unsigned int to;
+	double cost;
+};
+
+static bool CollapseCheaper(const Collapse& a, const Collapse& b){
+	return a.cost < b.cost;
+}
+
+//Triangles around every position, rebuilt each pass from the current indices
+struct PositionTriangles{
+	std::vector<unsigned int> offsets;
+	std::vector<unsigned int> triangles;
+};
+
+static void BuildPositionTriangles(const std::vector<unsigned int>& indices, const std::vector<unsigned int>& positionOf, size_t positionCount, PositionTriangles& adjacency){
+	adjacency.offsets.assign(positionCount + 1, 0);
+	for (size_t i = 0; i < indices.size(); i++){
+		adjacency.offsets[positionOf[indices[i]] + 1]++;
+	}
+	for (size_t p = 0; p < positionCount; p++){
+		adjacency.offsets[p + 1] += adjacency.offsets[p];
+	}
+	adjacency.triangles.resize(indices.size());
+	std::vector<unsigned int> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+	for (size_t i = 0; i < indices.size(); i++){
+		adjacency.triangles[fill[positionOf[indices[i]]]++] = (unsigned int)(i / 3);
+	}
+}
+
+//Directed position edges of the current triangles
+typedef std::unordered_map<unsigned long long, unsigned int> EdgeSet;
+
+static void BuildEdgeSet(const std::vector<unsigned int>& indices, const std::vector<unsigned int>& positionOf, EdgeSet& edges){
+	edges.clear();
+	edges.reserve(indices.size());
+	for (size_t i = 0; i < indices.size(); i++){
+		unsigned int a = positionOf[indices[i]];
+		unsigned int b = positionOf[indices[i - i % 3 + (i + 1) % 3]];
+		edges[EdgeKey(a, b)]++;
+	}
+}
+
+//An edge only one triangle uses, the other side is open
+static bool IsOpenEdge(const EdgeSet& edges, unsigned int a, unsigned int b){
+	return edges.count(EdgeKey(a, b)) && !edges.count(EdgeKey(b, a));
+}
+
+//Link condition: from and to may only share the neighbours of the triangles the collapse
+//removes, anything more would pinch the surface
+static bool KeepsManifold(const std::vector<unsigned int>& indices, const PositionTriangles& adjacency, const std::vector<unsigned int>& positionOf, unsigned int from, unsigned int to, size_t shared, std::vector<unsigned int>& neighbours){
+	neighbours.clear();
+	for (unsigned int t = adjacency.offsets[from]; t < adjacency.offsets[from + 1]; t++){
+		const unsigned int* triangle = &indices[adjacency.triangles[t] * 3];
+		for (int k = 0; k < 3; k++){
+			unsigned int p = positionOf[triangle[k]];
+			if (p != from && p != to){
+				neighbours.push_back(p);
+			}
+		}
+	}
+	std::sort(neighbours.begin(), neighbours.end());
+	neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+	size_t common = 0;
+	for (size_t n = 0; n < neighbours.size(); n++){
+		bool found = false;
+		for (unsigned int t = adjacency.offsets[to]; t < adjacency.offsets[to + 1] && !found; t++){
+			const unsigned int* triangle = &indices[adjacency.triangles[t] * 3];
+			found = positionOf[triangle[0]] == neighbours[n] || positionOf[triangle[1]] == neighbours[n] || positionOf[triangle[2]] == neighbours[n];
+		}
+		if (found){
+			common++;
+		}
+	}
+	return common <= shared;
+}
+
+//Distance between a corner's attributes and a candidate vertex's, for corners with no edge to follow
+static float AttributeDistance(const Vertex2& a, const Vertex2& b){
+	float du = a.UVs.x - b.UVs.x;
+	float dv = a.UVs.y - b.UVs.y;
+	return (1.0f - Dot(a.Normal, b.Normal)) + du * du + dv * dv;
+}
+
+float SimplifyMesh(const std::vector<Vertex2>& vertices, const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError, std::vector<unsigned int>& result){
+	result = indices;
+	size_t vertexCount = vertices.size();
+	if (vertexCount == 0 || indices.size() <= targetIndexCount){
+		return 0.0f;
+	}
+
+	//weld by position, wedges[wedgeOffsets[p]..] lists the vertices at position p
+	std::vector<unsigned int> positionOf(vertexCount);
+	std::vector<unsigned int> positionVertex;
+	std::unordered_map<PositionKey, unsigned int, PositionKeyHash, PositionKeyEqual> lookup;
+	lookup.reserve(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++){
+		PositionKey key = { vertices[v].Position.x, vertices[v].Position.y, vertices[v].Position.z };
+		auto found = lookup.find(key);
+		if (found == lookup.end()){
+			found = lookup.insert(std::make_pair(key, (unsigned int)positionVertex.size())).first;
+			positionVertex.push_back((unsigned int)v);
+		}
+		positionOf[v] = found->second;
+	}
+	size_t positionCount = positionVertex.size();
+	std::vector<unsigned int> wedgeOffsets(positionCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++){
+		wedgeOffsets[positionOf[v] + 1]++;
+	}
+	for (size_t p = 0; p < positionCount; p++){
+		wedgeOffsets[p + 1] += wedgeOffsets[p];
+	}
+	std::vector<unsigned int> wedges(vertexCount);
+	std::vector<unsigned int> wedgeFill(wedgeOffsets.begin(), wedgeOffsets.end() - 1);
+	for (size_t v = 0; v < vertexCount; v++){
+		wedges[wedgeFill[positionOf[v]]++] = (unsigned int)v;
+	}
+
+	//drop triangles that are already degenerate by position
+	std::vector<unsigned int> current;
+	current.reserve(indices.size());
+	for (size_t i = 0; i + 2 < indices.size(); i += 3){
+		unsigned int p0 = positionOf[indices[i]];
+		unsigned int p1 = positionOf[indices[i + 1]];
+		unsigned int p2 = positionOf[indices[i + 2]];
+		if (p0 != p1 && p1 != p2 && p0 != p2){
+			current.push_back(indices[i]);
+			current.push_back(indices[i + 1]);
+			current.push_back(indices[i + 2]);
+		}
+	}
+
+	EdgeSet edges;
+	BuildEdgeSet(current, positionOf, edges);
+	std::vector<unsigned char> border(positionCount, 0);
+
+	Quadric zero;
+	memset(&zero, 0, sizeof(zero));
+	std::vector<Quadric> quadrics(positionCount, zero);
+	for (size_t i = 0; i < current.size(); i += 3){
+		const XMFLOAT3& p0 = vertices[current[i]].Position;
+		const XMFLOAT3& p1 = vertices[current[i + 1]].Position;
+		const XMFLOAT3& p2 = vertices[current[i + 2]].Position;
+		XMFLOAT3 normal = Cross(Subtract(p1, p0), Subtract(p2, p0));
+		float length = sqrtf(Dot(normal, normal));
+		if (length <= 0.0f){
+			continue;
+		}
+		normal = XMFLOAT3(normal.x / length, normal.y / length, normal.z / length);
+		double d = -Dot(normal, p0);
+		double area = 0.5 * length;
+		for (int k = 0; k < 3; k++){
+			AddPlane(quadrics[positionOf[current[i + k]]], normal.x, normal.y, normal.z, d, area);
+		}
+
+		for (int k = 0; k < 3; k++){
+			unsigned int a = positionOf[current[i + k]];
+			unsigned int b = positionOf[current[i + (k + 1) % 3]];
+			if (!IsOpenEdge(edges, a, b)){
+				continue;
+			}
+			//plane through the edge, perpendicular to the triangle
+			const XMFLOAT3& pa = vertices[current[i + k]].Position;
+			XMFLOAT3 edge = Subtract(vertices[current[i + (k + 1) % 3]].Position, pa);
+			XMFLOAT3 side = Cross(edge, normal);
+			float sideLength = sqrtf(Dot(side, side));
+			if (sideLength <= 0.0f){
+				continue;
+			}
+			side = XMFLOAT3(side.x / sideLength, side.y / sideLength, side.z / sideLength);
+			double weight = Dot(edge, edge) * MESH_SIMPLIFY_BORDER_WEIGHT;
+			AddPlane(quadrics[a], side.x, side.y, side.z, -Dot(side, pa), weight);
+			AddPlane(quadrics[b], side.x, side.y, side.z, -Dot(side, pa), weight);
+			border[a] = 1;
+			border[b] = 1;
+		}
+	}
+
+	double maxCost = (double)maxError * maxError;
+	float resultError = 0.0f;
+	PositionTriangles adjacency;
+	std::vector<Collapse> collapses;
+	std::vector<unsigned int> collapseTo(positionCount);
+	std::vector<unsigned char> locked(positionCount);
+	std::vector<unsigned int> remap(vertexCount);
+
+	std::vector<unsigned int> neighbours;
+
+	while (current.size() > targetIndexCount){
+		BuildPositionTriangles(current, positionOf, positionCount, adjacency);
+		BuildEdgeSet(current, positionOf, edges);
+
+		collapses.clear();
+		for (size_t i = 0; i < current.size(); i++){
+			unsigned int a = positionOf[current[i]];
+			unsigned int b = positionOf[current[i - i % 3 + (i + 1) % 3]];
+			for (int direction = 0; direction < 2; direction++){
+				unsigned int from = direction ? b : a;
+				unsigned int to = direction ? a : b;
+				//a border vertex may only slide along its border
+				if (border[from] && !IsOpenEdge(edges, from, to) && !IsOpenEdge(edges, to, from)){
+					continue;
+				}
+				Collapse collapse;
+				collapse.from = from;
+				collapse.to = to;
+				collapse.cost = EvaluateQuadric(quadrics[from], vertices[positionVertex[to]].Position);
+				collapses.push_back(collapse);
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), CollapseCheaper);
+
+		for (size_t p = 0; p < positionCount; p++){
+			collapseTo[p] = (unsigned int)p;
+			locked[p] = 0;
+		}
+
+		//one collapse per neighbourhood each pass, so the flip test sees the final positions
+		size_t triangleGoal = (current.size() - targetIndexCount) / 3;
+		size_t trianglesRemoved = 0;
+		size_t collapseCount = 0;
+		for (size_t c = 0; c < collapses.size() && trianglesRemoved < triangleGoal; c++){
+			const Collapse& collapse = collapses[c];
+			if (collapse.cost > maxCost){
+				break;
+			}
+			if (locked[collapse.from] || locked[collapse.to]){
+				continue;
+			}
+
+			const XMFLOAT3& target = vertices[positionVertex[collapse.to]].Position;
+			bool flips = false;
+			size_t shared = 0;
+			for (unsigned int t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1] && !flips; t++){
+				const unsigned int* triangle = &current[adjacency.triangles[t] * 3];
+				XMFLOAT3 before[3];
+				XMFLOAT3 after[3];
+				bool hasTarget = false;
+				for (int k = 0; k < 3; k++){
+					unsigned int p = positionOf[triangle[k]];
+					before[k] = vertices[triangle[k]].Position;
+					after[k] = p == collapse.from ? target : before[k];
+					hasTarget = hasTarget || p == collapse.to;
+				}
+				if (hasTarget){
+					shared++;
+					continue;
+				}
+				XMFLOAT3 oldNormal = Cross(Subtract(before[1], before[0]), Subtract(before[2], before[0]));
+				XMFLOAT3 newNormal = Cross(Subtract(after[1], after[0]), Subtract(after[2], after[0]));
+				float turn = Dot(oldNormal, newNormal);
+				flips = turn <= 0.0f || turn * turn < MESH_SIMPLIFY_MIN_TURN_COSINE * MESH_SIMPLIFY_MIN_TURN_COSINE * Dot(oldNormal, oldNormal) * Dot(newNormal, newNormal);
+			}
+			if (flips || !KeepsManifold(current, adjacency, positionOf, collapse.from, collapse.to, shared, neighbours)){
+				continue;
+			}
+
+			collapseTo[collapse.from] = collapse.to;
+			for (unsigned int t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1]; t++){
+				const unsigned int* triangle = &current[adjacency.triangles[t] * 3];
+				for (int k = 0; k < 3; k++){
+					locked[positionOf[triangle[k]]] = 1;
+				}
+			}
+			locked[collapse.to] = 1;
+			trianglesRemoved += shared;
+			collapseCount++;
+			float error = (float)sqrt(collapse.cost);
+			if (error > resultError){
+				resultError = error;
+			}
+		}
+		if (collapseCount == 0){
+			break;
+		}
+
+		//move every corner at a collapsed position onto a vertex at its target
+		for (size_t v = 0; v < vertexCount; v++){
+			remap[v] = (unsigned int)v;
+		}
+		for (size_t p = 0; p < positionCount; p++){
+			unsigned int to = collapseTo[p];
+			if (to == p){
+				continue;
+			}
+			AddQuadric(quadrics[to], quadrics[p]);
+			for (unsigned int w = wedgeOffsets[p]; w < wedgeOffsets[p + 1]; w++){
+				unsigned int v = wedges[w];
+				unsigned int best = wedges[wedgeOffsets[to]];
+				bool followed = false;
+				//a triangle with this corner and a corner at the target gives the matching vertex
+				for (unsigned int t = adjacency.offsets[p]; t < adjacency.offsets[p + 1] && !followed; t++){
+					const unsigned int* triangle = &current[adjacency.triangles[t] * 3];
+					if (triangle[0] != v && triangle[1] != v && triangle[2] != v){
+						continue;
+					}
+					for (int k = 0; k < 3; k++){
+						if (positionOf[triangle[k]] == to){
+							best = triangle[k];
+							followed = true;
+						}
+					}
+				}
+				if (!followed){
+					float bestDistance = AttributeDistance(vertices[v], vertices[best]);
+					for (unsigned int x = wedgeOffsets[to] + 1; x < wedgeOffsets[to + 1]; x++){
+						float distance = AttributeDistance(vertices[v], vertices[wedges[x]]);
+						if (distance < bestDistance){
+							bestDistance = distance;
+							best = wedges[x];
+						}
+					}
+				}
+				remap[v] = best;
+			}
+		}
+
+		size_t kept = 0;
+		for (size_t i = 0; i + 2 < current.size(); i += 3){
+			unsigned int v0 = remap[current[i]];
+			unsigned int v1 = remap[current[i + 1]];
+			unsigned int v2 = remap[current[i + 2]];
+			unsigned int p0 = positionOf[v0];
+			unsigned int p1 = positionOf[v1];
+			unsigned int p2 = positionOf[v2];
+			if (p0 == p1 || p1 == p2 || p0 == p2){
+				continue;
+			}
+			current[kept++] = v0;
+			current[kept++] = v1;
+			current[kept++] = v2;
+		}
+		current.resize(kept);
+	}
+
+	result.swap(current);
+	return resultError;
+}
@@ -0,0 +1,27 @@
+#ifndef _MESHSIMPLIFIER_H
+#define _MESHSIMPLIFIER_H
+
+#include "Global.h"
+#include <vector>
+#include <cstddef>
+
+/**
+*Quadric error metric simplification (Garland and Heckbert) by half edge collapses.
+*A vertex only ever moves onto a neighbouring vertex, so every simplified index list still
+*indexes the original vertex buffer and a whole LOD chain can share it.
+*	Vertices at the same position collapse together; each corner moves to the vertex at the
+*	target it shares an edge with, or the one with the closest normal and uv, so uv seams and
+*	hard edges survive where they can.
+*	Open edges get perpendicular constraint planes and only slide along themselves.
+*	Collapses that would flip a triangle over, or turn it far enough to leave a sliver standing
+*	on its edge for a later collapse to flip, are refused.
+*Error is the area weighted RMS distance to the planes a vertex has absorbed, in model units.
+**/
+#define MESH_SIMPLIFY_BORDER_WEIGHT 10.0f // how hard open edges hold their shape
+#define MESH_SIMPLIFY_MIN_TURN_COSINE 0.25f // a collapse may turn a triangle's normal by up to about 75 degrees
+
+//Writes indices simplified toward targetIndexCount, stopping early rather than going over
+//maxError. Returns the largest error of the collapses made
+float SimplifyMesh(const std::vector<Vertex2>& vertices, const std::vector<unsigned int>& indices, size_t targetIndexCount, float maxError, std::vector<unsigned int>& result);
+
+#endif
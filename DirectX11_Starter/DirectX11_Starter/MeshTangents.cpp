@@ -0,0 +1,83 @@
+#include "MeshTangents.h"
+#include <vector>
+#include <cmath>
+
+//What a vertex collects from the triangles around it
+struct TangentSums{
+	XMFLOAT3 tangent; // dP/du
+	XMFLOAT3 bitangent; // dP/dv
+};
+
+//Any unit vector perpendicular to n, for vertices the uvs say nothing about
+static XMVECTOR AnyPerpendicular(FXMVECTOR n){
+	XMVECTOR axis = fabsf(XMVectorGetX(n)) < 0.9f ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+	return XMVector3Normalize(XMVectorSubtract(axis, XMVectorMultiply(n, XMVector3Dot(n, axis))));
+}
+
+void GenerateTangents(Vertex2* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount){
+	TangentSums zero = { XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f) };
+	std::vector<TangentSums> sums(vertexCount, zero);
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3){
+		unsigned int corner[3] = { indices[i], indices[i + 1], indices[i + 2] };
+		if (corner[0] >= vertexCount || corner[1] >= vertexCount || corner[2] >= vertexCount){
+			continue;
+		}
+		const Vertex2& v0 = vertices[corner[0]];
+		const Vertex2& v1 = vertices[corner[1]];
+		const Vertex2& v2 = vertices[corner[2]];
+
+		XMVECTOR p0 = XMLoadFloat3(&v0.Position);
+		XMVECTOR e1 = XMVectorSubtract(XMLoadFloat3(&v1.Position), p0);
+		XMVECTOR e2 = XMVectorSubtract(XMLoadFloat3(&v2.Position), p0);
+		float s1 = v1.UVs.x - v0.UVs.x;
+		float t1 = v1.UVs.y - v0.UVs.y;
+		float s2 = v2.UVs.x - v0.UVs.x;
+		float t2 = v2.UVs.y - v0.UVs.y;
+
+		//dP/du and dP/dv scaled by |det| rather than divided by det: each triangle is weighted
+		//by its uv area, and one with no uv area adds nothing instead of a huge vector
+		float sign = s1 * t2 - s2 * t1 < 0.0f ? -1.0f : 1.0f;
+		XMVECTOR sdir = XMVectorScale(XMVectorSubtract(XMVectorScale(e1, t2), XMVectorScale(e2, t1)), sign);
+		XMVECTOR tdir = XMVectorScale(XMVectorSubtract(XMVectorScale(e2, s1), XMVectorScale(e1, s2)), sign);
+
+		for (int k = 0; k < 3; k++){
+			TangentSums& sum = sums[corner[k]];
+			XMStoreFloat3(&sum.tangent, XMVectorAdd(XMLoadFloat3(&sum.tangent), sdir));
+			XMStoreFloat3(&sum.bitangent, XMVectorAdd(XMLoadFloat3(&sum.bitangent), tdir));
+		}
+	}
+
+	for (size_t i = 0; i < vertexCount; i++){
+		Vertex2& v = vertices[i];
+		XMVECTOR n = XMLoadFloat3(&v.Normal);
+		XMVECTOR t = XMLoadFloat3(&sums[i].tangent);
+		XMVECTOR b = XMLoadFloat3(&sums[i].bitangent);
+
+		float normalLength = XMVectorGetX(XMVector3Length(n));
+		float sumLength = XMVectorGetX(XMVector3Length(t));
+		if (normalLength > 0.0f){
+			n = XMVectorScale(n, 1.0f / normalLength);
+			//Gram-Schmidt, drop the part of t along n
+			t = XMVectorSubtract(t, XMVectorMultiply(n, XMVector3Dot(n, t)));
+		}
+		else{
+			n = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+		}
+
+		//a tangent that was (nearly) all normal has no direction left worth keeping
+		float tangentLength = XMVectorGetX(XMVector3Length(t));
+		if (tangentLength > 0.0f && tangentLength > sumLength * 1e-4f){
+			t = XMVectorScale(t, 1.0f / tangentLength);
+		}
+		else{
+			t = AnyPerpendicular(n);
+		}
+
+		float handedness = XMVectorGetX(XMVector3Dot(XMVector3Cross(n, t), b)) < 0.0f ? -1.0f : 1.0f;
+
+		XMFLOAT3 tangent;
+		XMStoreFloat3(&tangent, t);
+		v.Tangent = XMFLOAT4(tangent.x, tangent.y, tangent.z, handedness);
+	}
+}
@@ -0,0 +1,18 @@
+#ifndef _MESHTANGENTS_H
+#define _MESHTANGENTS_H
+
+#include "Global.h"
+#include <cstddef>
+
+/**
+*Per vertex tangent frames for indexed triangle lists (Lengyel's method).
+*One pass over the triangles accumulates the uv derivative directions into every corner's
+*vertex, then each tangent is made orthonormal to the vertex normal (Gram-Schmidt).
+*Tangent.w is the handedness, the bitangent is cross(normal, tangent.xyz) * w, so mirrored
+*uvs get a correct frame.
+*Vertices whose triangles have no usable uv mapping still get a unit tangent perpendicular
+*to the normal.
+**/
+void GenerateTangents(Vertex2* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+
+#endif
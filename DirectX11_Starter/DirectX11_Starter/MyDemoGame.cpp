@@ -29,6 +29,7 @@
 #include <d3dcompiler.h>
 #include "MyDemoGame.h"
 #include "WICTextureLoader.h"
+#include <sstream>
 
 #pragma region Win32 Entry Point (WinMain)
 
@@ -64,6 +65,16 @@ MyDemoGame::MyDemoGame(HINSTANCE hInstance) : DirectXGame(hInstance)
 	windowCaption = L"Graphics Programming Project";
 	windowWidth = 800;
 	windowHeight = 600;
+	assets = nullptr;
+	loadThreads = nullptr;
+	gameReady = false;
+	captureWriter = nullptr;
+	frameCapture = nullptr;
+	pauseChain = nullptr;
+	capturing = false;
+	recordKeyDown = false;
+	screenshotKeyDown = false;
+	frameNumber = 0;
 }
 
 MyDemoGame::~MyDemoGame()
@@ -101,6 +112,28 @@ MyDemoGame::~MyDemoGame()
 		delete game;
 		game = nullptr;
 	}
+	if (pauseChain){
+		delete pauseChain;
+		pauseChain = nullptr;
+	}
+	//frames still on the GPU or queued are saved before the workers go
+	if (frameCapture){
+		frameCapture->flush(deviceContext);
+		delete frameCapture;
+		frameCapture = nullptr;
+	}
+	if (captureWriter){
+		delete captureWriter;
+		captureWriter = nullptr;
+	}
+	if (assets){
+		delete assets;
+		assets = nullptr;
+	}
+	if (loadThreads){
+		delete loadThreads;
+		loadThreads = nullptr;
+	}
 	
 }
 
@@ -119,9 +152,16 @@ bool MyDemoGame::Init()
 		return false;
 
 	stateManager = new StateManager();
-	ObjectLoader* objLoader = new ObjectLoader(device);
-	Mesh* menuMesh = objLoader->LoadModel("Menu.obj");
-	game = new Game(device, deviceContext);
+	loadThreads = new ThreadPool(ThreadPool::DefaultThreadCount());
+	assets = new AssetManager(device, deviceContext, loadThreads);
+	//before any material, so the sprites and screens it packs come from it; without a current
+	//cooked atlas they load on their own as before
+	assets->loadAtlas(L"sprites.atlas");
+	//one mapping for every shader program below, the .cso files are read instead when it isn't current
+	assets->loadShaderPack(L"shaders.pipeline");
+	Mesh* menuMesh = assets->getMesh("Menu.obj");
+	game = new Game(device, deviceContext, assets);
+	game->streamAssets();
 	ID3D11SamplerState* sample = nullptr;
 	samplerState = new SamplerState(sample);
 	samplerState->createSamplerState(device);
@@ -130,19 +170,18 @@ bool MyDemoGame::Init()
 	CamCB = new ConstantBuffer(dataToSendToCameraConstantBuffer, device);
 	vector<ConstantBuffer*> cb;
 	cb.push_back(MatrixCB);
-	shaderProgram = new ShaderProgram(L"FlatVertexShader.cso", L"FlatPixelShader.cso", device, cb);
-	gameStates.push_back(new State(device, deviceContext, sample, L"StartScreen.png", menuMesh, shaderProgram));
-	gameStates.push_back(new State(device, deviceContext, sample, L"InstructionsScreen.png", menuMesh, shaderProgram));
-	gameStates.push_back(new State(device, deviceContext, sample, L"gameOverScreen.png", menuMesh, shaderProgram));
-	game->initGame(samplerState);
-
-	//initialize our render Target
-	renderTarget.Initialize(device, windowWidth, windowHeight);
-	ObjectLoader* postProcessQuad = new ObjectLoader(device);
-	Mesh* postProcessQuadMesh = postProcessQuad->LoadModel("fullscreenQuad.obj");
-	postProcessShaderProgram = new ShaderProgram(L"PostProcessVertexShader.cso", L"PostProcessPixelShader.cso", device, cb);
-	Material* postProcessMaterial = new Material(renderTarget.GetShaderResourceView(), samplerState->getSamplerState(), postProcessShaderProgram);
-	postProcessEntities.push_back(new GameEntity(postProcessQuadMesh, postProcessMaterial));
+	shaderProgram = assets->getMeshShaderProgram(0, cb);
+	gameStates.push_back(new State(device, deviceContext, assets, sample, L"StartScreen.png", menuMesh, shaderProgram));
+	gameStates.push_back(new State(device, deviceContext, assets, sample, L"InstructionsScreen.png", menuMesh, shaderProgram));
+	gameStates.push_back(new State(device, deviceContext, assets, sample, L"gameOverScreen.png", menuMesh, shaderProgram));
+	ReleaseMacro(menuMesh);
+
+	//scene -> sepia on the back buffer, both at full resolution like the render target it replaces
+	pauseChain = new PostProcessChain(device, assets);
+	uint32_t scene = pauseChain->addTarget(POST_PROCESS_FORMAT_R11G11B10, 1);
+	pauseChain->addScenePass(scene);
+	pauseChain->addEffectPass(POST_PROCESS_SEPIA, POST_PROCESS_BACK_BUFFER, scene);
+	pauseChain->resize(windowWidth, windowHeight);
 
 	// Set up view matrix (camera)
 	// In an actual game, update this when the camera moves (every frame)
@@ -190,6 +229,9 @@ void MyDemoGame::OnResize()
 {
 	// Handle base-level DX resize stuff
 	DirectXGame::OnResize();
+	if (pauseChain){
+		pauseChain->resize(windowWidth, windowHeight);
+	}
 
 	// Update our projection matrix since the window size changed
 	XMMATRIX P = XMMatrixPerspectiveFovLH(
@@ -208,7 +250,20 @@ void MyDemoGame::OnResize()
 void MyDemoGame::UpdateScene(float dt)
 {
 	UpdateCamera();
+
+	//the menu is up while the game's assets stream in, initGame then finds them all cached
+	if (!gameReady){
+		assets->pumpUploads();
+		if (!assets->isStreaming()){
+			game->initGame(samplerState);
+			gameReady = true;
+		}
+	}
+
 	state = stateManager->changeState();
+	if (!gameReady && state == L"Game"){
+		state = stateManager->getStateFromIndex(0); // keep showing the menu until loading finishes
+	}
 	if (state == L"Game")
 	{
 		timer->Start();
@@ -346,8 +401,7 @@ void MyDemoGame::DrawScene()
 	//Set render target only if we are paused, otherwise render game normally
 	if (state == L"Pause")
 	{
-		renderTarget.SetRenderTarget(deviceContext, depthStencilView);
-		renderTarget.ClearRenderTarget(deviceContext, depthStencilView, 0.0, 0.0, 0.0, 0.0);
+		pauseChain->beginScene(deviceContext, depthStencilView);
 	}
 
 	if (state == L"Game")
@@ -375,8 +429,47 @@ void MyDemoGame::DrawScene()
 
 	}
 
+	CaptureFrame();
+
 	// Present the buffer
 	HR(swapChain->Present(0, 0));
+	frameNumber++;
+}
+
+//F9 starts and stops saving every frame, F8 saves just this one. The back buffer is only
+//copied here, the copy is read back frames later and written out on the load threads
+void MyDemoGame::CaptureFrame()
+{
+	bool recordKey = (GetAsyncKeyState(VK_F9) & 0x8000) != 0;
+	bool screenshotKey = (GetAsyncKeyState(VK_F8) & 0x8000) != 0;
+	bool record = recordKey && !recordKeyDown;
+	bool screenshot = screenshotKey && !screenshotKeyDown;
+	recordKeyDown = recordKey;
+	screenshotKeyDown = screenshotKey;
+
+	if (record){
+		capturing = !capturing;
+		if (!capturing && frameCapture){
+			std::wostringstream outs;
+			outs << L"Capture: " << frameCapture->getCapturedCount() << L" frames, " << frameCapture->getDroppedCount() << L" dropped, "
+				<< frameCapture->getAverageMilliseconds() << L" ms a frame on the render thread (worst " << frameCapture->getMaxMilliseconds() << L" ms)\n";
+			OutputDebugString(outs.str().c_str());
+		}
+	}
+	if ((capturing || screenshot) && !frameCapture){
+		captureWriter = new CaptureWriter(loadThreads, "capture_", CAPTURE_PNG, CAPTURE_MAX_PENDING);
+		frameCapture = new FrameCapture(device, captureWriter, CAPTURE_RING_SIZE);
+	}
+
+	if (capturing || screenshot){
+		ID3D11Texture2D* backBuffer;
+		HR(swapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&backBuffer)));
+		frameCapture->capture(deviceContext, backBuffer, frameNumber);
+		ReleaseMacro(backBuffer);
+	}
+	else if (frameCapture){
+		frameCapture->collect(deviceContext);
+	}
 }
 
 #pragma endregion
@@ -422,40 +515,11 @@ void MyDemoGame::HandleUIClick(int x, int y)
 	}
 }
 
+//Runs the pause chain over the game drawn into it, ending on the screen
 void MyDemoGame::PostProcessDraw()
 {
-	// Reset render target so that from here on out you're rendering to the screen!
 	// The variable "renderTargetView" is the render target that maps to the screen
-	deviceContext->OMSetRenderTargets(1, &renderTargetView, depthStencilView);
-
-	UINT offset = 0;
-	UINT stride = sizeof(Vertex2);
-	for (int i = 0; i < postProcessEntities.size(); i++)
-	{
-		stride = postProcessEntities[i]->g_mesh->sizeofvertex;
-
-		// Set up the input assembler
-		deviceContext->IASetInputLayout(postProcessEntities[i]->g_mat->shaderProgram->vsInputLayout);
-		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-		deviceContext->IASetVertexBuffers(0, 1, &postProcessEntities[i]->g_mesh->v_buffer, &stride, &offset);
-		deviceContext->IASetIndexBuffer(postProcessEntities[i]->g_mesh->i_buffer, DXGI_FORMAT_R32_UINT, 0);
-
-		deviceContext->PSSetSamplers(0, 1, &postProcessEntities[i]->g_mat->samplerState);
-		deviceContext->PSSetShaderResources(0, 1, &postProcessEntities[i]->g_mat->resourceView);
-
-		// Set the current vertex and pixel shaders, as well the constant buffer for the vert shader
-		deviceContext->VSSetShader(postProcessEntities[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
-		deviceContext->PSSetShader(postProcessEntities[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
-
-		// Finally do the actual drawing
-		deviceContext->DrawIndexed(
-			postProcessEntities.at(i)->g_mesh->m_size,	// The number of indices we're using in this draw
-			0,
-			0);
-	}
-
-
+	pauseChain->execute(deviceContext, renderTargetView, depthStencilView);
 }
 
 #pragma endregion
@@ -23,7 +23,8 @@
 #include "Game.h"
 #include "State.h"
 #include "GameTimer.h"
-#include "RenderTextureClass.h"
+#include "PostProcessChain.h"
+#include "FrameCapture.h"
 //#include "include/irrKlang.h"
 
 // Include run-time memory checking in debug builds
@@ -75,6 +76,7 @@ public:
 	void DrawScene();
 	void PostProcessDraw();
 	void UpdateCamera();
+	void CaptureFrame();
 
 	// For handing mouse input
 	void OnMouseDown(WPARAM btnState, int x, int y);
@@ -100,15 +102,22 @@ private:
 
 private:
 	Game* game;
+	AssetManager* assets; // every mesh and texture, shared by the menu states and the game
+	ThreadPool* loadThreads; // reads and decodes the streamed assets
+	bool gameReady; // initGame runs once the game's assets have streamed in
+	CaptureWriter* captureWriter; // saves captured frames on loadThreads
+	FrameCapture* frameCapture; // reads the back buffer back without stalling
+	bool capturing; // F9 starts and stops saving every frame
+	bool recordKeyDown;
+	bool screenshotKeyDown;
+	unsigned int frameNumber;
 	StateManager* stateManager;
 	wchar_t* state;
 
 	ShaderProgram* shaderProgram;
-	ShaderProgram* postProcessShaderProgram;
 
-	//Render target
-	RenderTextureClass renderTarget;
-	std::vector<GameEntity*> postProcessEntities;
+	//The paused game is drawn into this and shown in sepia
+	PostProcessChain* pauseChain;
 
 	GameTimer *timer;
 
@@ -0,0 +1,445 @@
+#include "ObjParser.h"
+#include "MeshTangents.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <unordered_map>
+#include <cstdlib>
+#include <future>
+
+//Powers of ten for the float parser; negative powers are multiplied rather than divided by,
+//the rounding error stays far below float precision
+static const double PowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const double NegativePowersOfTen[] = {
+	1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10,
+	1e-11, 1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18, 1e-19, 1e-20, 1e-21, 1e-22
+};
+
+static inline bool IsDigit(char c){
+	return c >= '0' && c <= '9';
+}
+
+static inline bool IsSpace(char c){
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline void SkipSpaces(const char*& p, const char* end){
+	while (p < end && IsSpace(*p)){
+		p++;
+	}
+}
+
+static inline const char* NextLine(const char* p, const char* end){
+	while (p < end && *p != '\n'){
+		p++;
+	}
+	return p < end ? p + 1 : end;
+}
+
+//Slow path for numbers with more digits than fit in 64 bits
+static float ParseLongFloat(const char* start, const char*& p, const char* end){
+	char buffer[128];
+	size_t length = 0;
+	const char* q = start;
+	while (q < end && length + 1 < sizeof(buffer) && !IsSpace(*q) && *q != '\n' && *q != '/'){
+		buffer[length++] = *q++;
+	}
+	buffer[length] = 0;
+	char* stop = buffer;
+	double value = strtod(buffer, &stop);
+	p = start + (stop - buffer);
+	return (float)value;
+}
+
+/**
+*Digits are accumulated exactly in an integer and scaled once by a power of ten in double
+*precision, which is well inside float precision for OBJ data. More than 19 digits goes
+*through strtod. Anything that isn't a number reads as 0 and the pointer is left on the
+*offending character.
+**/
+float ParseObjFloat(const char*& p, const char* end){
+	SkipSpaces(p, end);
+	const char* start = p;
+
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')){
+		negative = *p == '-';
+		p++;
+	}
+
+	unsigned long long mantissa = 0;
+	const char* digitsStart = p;
+	while (p < end && IsDigit(*p)){
+		mantissa = mantissa * 10 + (*p - '0');
+		p++;
+	}
+	int digits = (int)(p - digitsStart);
+	int exponent = 0;
+
+	if (p < end && *p == '.'){
+		p++;
+		const char* fractionStart = p;
+		while (p < end && IsDigit(*p)){
+			mantissa = mantissa * 10 + (*p - '0');
+			p++;
+		}
+		exponent = -(int)(p - fractionStart);
+		digits -= exponent;
+	}
+	if (digits > 19){
+		return ParseLongFloat(start, p, end);
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E')){
+		const char* mark = p;
+		p++;
+		bool negativeExponent = false;
+		if (p < end && (*p == '-' || *p == '+')){
+			negativeExponent = *p == '-';
+			p++;
+		}
+		if (p < end && IsDigit(*p)){
+			int value = 0;
+			while (p < end && IsDigit(*p)){
+				if (value < 10000){
+					value = value * 10 + (*p - '0');
+				}
+				p++;
+			}
+			exponent += negativeExponent ? -value : value;
+		}
+		else{
+			p = mark;
+		}
+	}
+
+	double result = (double)mantissa;
+	if (exponent < 0){
+		while (exponent < -22){
+			result *= 1e-22;
+			exponent += 22;
+		}
+		result *= NegativePowersOfTen[-exponent];
+	}
+	else if (exponent > 0){
+		while (exponent > 22){
+			result *= 1e22;
+			exponent -= 22;
+		}
+		result *= PowersOfTen[exponent];
+	}
+	return (float)(negative ? -result : result);
+}
+
+//Parses a possibly negative integer, returns 0 if there are no digits
+static inline int ParseIndex(const char*& p, const char* end){
+	bool negative = false;
+	if (p < end && *p == '-'){
+		negative = true;
+		p++;
+	}
+	int value = 0;
+	while (p < end && IsDigit(*p)){
+		value = value * 10 + (*p - '0');
+		p++;
+	}
+	return negative ? -value : value;
+}
+
+//Turns a file index into a 1-based index local to the chunk, flagging negative ones
+static inline int LocalIndex(int index, size_t count, unsigned char flag, unsigned char& relative){
+	if (index < 0){
+		relative |= flag;
+		return (int)count + index + 1;
+	}
+	return index;
+}
+
+/**
+*Face corner in any of the forms v, v/vt, v//vn and v/vt/vn
+**/
+static inline bool ParseCorner(const char*& p, const char* end, const ObjChunk& chunk, ObjCorner& corner, unsigned char& relative){
+	relative = 0;
+	corner.uv = 0;
+	corner.normal = 0;
+
+	if (p >= end || !(IsDigit(*p) || *p == '-')){
+		return false;
+	}
+	corner.position = LocalIndex(ParseIndex(p, end), chunk.positions.size(), OBJ_RELATIVE_POSITION, relative);
+
+	if (p < end && *p == '/'){
+		p++;
+		if (p < end && *p != '/'){
+			corner.uv = LocalIndex(ParseIndex(p, end), chunk.uvs.size(), OBJ_RELATIVE_UV, relative);
+		}
+		if (p < end && *p == '/'){
+			p++;
+			corner.normal = LocalIndex(ParseIndex(p, end), chunk.normals.size(), OBJ_RELATIVE_NORMAL, relative);
+		}
+	}
+
+	//skip anything unexpected up to the next separator
+	while (p < end && !IsSpace(*p) && *p != '\n'){
+		p++;
+	}
+	return true;
+}
+
+void ParseObjChunk(const char* begin, const char* end, ObjChunk& chunk){
+	const char* p = begin;
+	while (p < end){
+		SkipSpaces(p, end);
+		if (p >= end){
+			break;
+		}
+
+		const char* line = p;
+		if (line[0] == 'v' && line + 1 < end && IsSpace(line[1])){
+			p++;
+			XMFLOAT3 position;
+			position.x = ParseObjFloat(p, end);
+			position.y = ParseObjFloat(p, end);
+			position.z = ParseObjFloat(p, end);
+			chunk.positions.push_back(position);
+		}
+		else if (line[0] == 'v' && line + 2 < end && line[1] == 't' && IsSpace(line[2])){
+			p += 2;
+			XMFLOAT2 uv;
+			uv.x = ParseObjFloat(p, end);
+			uv.y = ParseObjFloat(p, end);
+			chunk.uvs.push_back(uv);
+		}
+		else if (line[0] == 'v' && line + 2 < end && line[1] == 'n' && IsSpace(line[2])){
+			p += 2;
+			XMFLOAT3 normal;
+			normal.x = ParseObjFloat(p, end);
+			normal.y = ParseObjFloat(p, end);
+			normal.z = ParseObjFloat(p, end);
+			chunk.normals.push_back(normal);
+		}
+		else if (line[0] == 'f' && line + 1 < end && IsSpace(line[1])){
+			p++;
+			//fan triangulation straight into the chunk as the corners are read, so a polygon can
+			//have any number of them; n-gons are assumed convex
+			size_t first = chunk.corners.size();
+			unsigned int count = 0;
+			ObjCorner firstCorner = { 0, 0, 0 };
+			ObjCorner lastCorner = { 0, 0, 0 };
+			unsigned char firstRelative = 0;
+			unsigned char lastRelative = 0;
+			for (;;){
+				SkipSpaces(p, end);
+				ObjCorner corner;
+				unsigned char relative;
+				if (!ParseCorner(p, end, chunk, corner, relative)){
+					break;
+				}
+				if (count == 0){
+					firstCorner = corner;
+					firstRelative = relative;
+				}
+				else if (count >= 3){
+					chunk.corners.push_back(firstCorner);
+					chunk.corners.push_back(lastCorner);
+					chunk.relative.push_back(firstRelative);
+					chunk.relative.push_back(lastRelative);
+				}
+				chunk.corners.push_back(corner);
+				chunk.relative.push_back(relative);
+				lastCorner = corner;
+				lastRelative = relative;
+				count++;
+			}
+			//fewer than 3 corners is a point or a line, not a face
+			if (count < 3){
+				chunk.corners.resize(first);
+				chunk.relative.resize(first);
+			}
+		}
+		//comments, groups, materials and smoothing groups are skipped
+
+		p = NextLine(p, end);
+	}
+}
+
+void ResolveObjChunk(ObjChunk& chunk, unsigned int positionOffset, unsigned int uvOffset, unsigned int normalOffset){
+	for (size_t i = 0; i < chunk.corners.size(); i++){
+		unsigned char relative = chunk.relative[i];
+		if (!relative){
+			continue;
+		}
+		if (relative & OBJ_RELATIVE_POSITION){
+			chunk.corners[i].position += positionOffset;
+		}
+		if (relative & OBJ_RELATIVE_UV){
+			chunk.corners[i].uv += uvOffset;
+		}
+		if (relative & OBJ_RELATIVE_NORMAL){
+			chunk.corners[i].normal += normalOffset;
+		}
+		chunk.relative[i] = 0;
+	}
+}
+
+struct ObjCornerHash{
+	size_t operator()(const ObjCorner& corner) const{
+		size_t hash = (size_t)corner.position;
+		hash = hash * 31 + (size_t)corner.uv;
+		hash = hash * 31 + (size_t)corner.normal;
+		return hash;
+	}
+};
+
+struct ObjCornerEqual{
+	bool operator()(const ObjCorner& a, const ObjCorner& b) const{
+		return a.position == b.position && a.uv == b.uv && a.normal == b.normal;
+	}
+};
+
+/**
+*Corners that reference the same position/uv/normal share one vertex, so the output is
+*O(corners) with a vertex buffer no larger than the number of unique corners.
+**/
+bool BuildObjMesh(const std::vector<ObjChunk>& chunks, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices){
+	std::vector<XMFLOAT3> positions;
+	std::vector<XMFLOAT2> uvs;
+	std::vector<XMFLOAT3> normals;
+	size_t cornerCount = 0;
+	for (size_t c = 0; c < chunks.size(); c++){
+		positions.insert(positions.end(), chunks[c].positions.begin(), chunks[c].positions.end());
+		uvs.insert(uvs.end(), chunks[c].uvs.begin(), chunks[c].uvs.end());
+		normals.insert(normals.end(), chunks[c].normals.begin(), chunks[c].normals.end());
+		cornerCount += chunks[c].corners.size();
+	}
+
+	vertices.clear();
+	indices.clear();
+	indices.reserve(cornerCount);
+
+	std::unordered_map<ObjCorner, unsigned int, ObjCornerHash, ObjCornerEqual> lookup;
+	lookup.reserve(cornerCount);
+
+	for (size_t c = 0; c < chunks.size(); c++){
+		const std::vector<ObjCorner>& corners = chunks[c].corners;
+		for (size_t i = 0; i < corners.size(); i++){
+			const ObjCorner& corner = corners[i];
+			auto found = lookup.find(corner);
+			if (found != lookup.end()){
+				indices.push_back(found->second);
+				continue;
+			}
+
+			if (corner.position < 1 || corner.position > (int)positions.size() ||
+				corner.uv < 0 || corner.uv > (int)uvs.size() ||
+				corner.normal < 0 || corner.normal > (int)normals.size()){
+				return false;
+			}
+
+			Vertex2 vertex;
+			vertex.Position = positions[corner.position - 1];
+			vertex.UVs = corner.uv ? uvs[corner.uv - 1] : XMFLOAT2(0.0f, 0.0f);
+			vertex.Normal = corner.normal ? normals[corner.normal - 1] : XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+			unsigned int index = vertices.size();
+			vertices.push_back(vertex);
+			lookup.insert(std::make_pair(corner, index));
+			indices.push_back(index);
+		}
+	}
+
+	if (!vertices.empty()){
+		GenerateTangents(&vertices[0], vertices.size(), &indices[0], indices.size());
+	}
+	return true;
+}
+
+bool ParseObj(const char* data, size_t size, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices){
+	std::vector<ObjChunk> chunks(1);
+	ParseObjChunk(data, data + size, chunks[0]);
+	return BuildObjMesh(chunks, vertices, indices);
+}
+
+bool LoadObj(const std::string& file, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices){
+	MappedFile mapped;
+	if (!mapped.open(file)){
+		return false;
+	}
+	return ParseObj(mapped.data(), mapped.size(), vertices, indices);
+}
+
+//Below this a chunk isn't worth a task
+#define OBJ_MIN_CHUNK_SIZE (1 << 20)
+
+/**
+*Chunks end just after a newline so no record is split. Each chunk is parsed into its own
+*arrays, then the attribute counts are prefix summed so every chunk knows how many positions,
+*uvs and normals came before it, which is all the negative indices need.
+*Dedup runs over the chunks in file order, so vertex numbering matches the serial path.
+**/
+bool ParseObjParallel(const char* data, size_t size, ThreadPool* pool, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices){
+	size_t threads = pool ? pool->getThreadCount() + 1 : 1;
+	//a few chunks per thread so one dense region doesn't hold everything up
+	size_t chunkCount = threads * 4;
+	if (size / OBJ_MIN_CHUNK_SIZE < chunkCount){
+		chunkCount = size / OBJ_MIN_CHUNK_SIZE;
+	}
+	//a pool without threads would never run the tasks
+	if (chunkCount < 2 || threads < 2){
+		return ParseObj(data, size, vertices, indices);
+	}
+
+	std::vector<const char*> bounds;
+	bounds.push_back(data);
+	const char* end = data + size;
+	for (size_t c = 1; c < chunkCount; c++){
+		const char* split = data + size * c / chunkCount;
+		if (split < bounds.back()){
+			split = bounds.back();
+		}
+		while (split < end && *(split - 1) != '\n'){
+			split++;
+		}
+		bounds.push_back(split);
+	}
+	bounds.push_back(end);
+
+	std::vector<ObjChunk> chunks(chunkCount);
+	std::vector<std::future<void>> parsed;
+	for (size_t c = 1; c < chunkCount; c++){
+		parsed.push_back(pool->submit([&bounds, &chunks, c](){ ParseObjChunk(bounds[c], bounds[c + 1], chunks[c]); }));
+	}
+	ParseObjChunk(bounds[0], bounds[1], chunks[0]);
+	for (size_t i = 0; i < parsed.size(); i++){
+		parsed[i].get();
+	}
+
+	//exclusive prefix sums of the attribute counts
+	unsigned int positionOffset = 0;
+	unsigned int uvOffset = 0;
+	unsigned int normalOffset = 0;
+	std::vector<std::future<void>> resolved;
+	for (size_t c = 0; c < chunkCount; c++){
+		if (c > 0){
+			resolved.push_back(pool->submit([&chunks, c, positionOffset, uvOffset, normalOffset](){ ResolveObjChunk(chunks[c], positionOffset, uvOffset, normalOffset); }));
+		}
+		positionOffset += chunks[c].positions.size();
+		uvOffset += chunks[c].uvs.size();
+		normalOffset += chunks[c].normals.size();
+	}
+	for (size_t i = 0; i < resolved.size(); i++){
+		resolved[i].get();
+	}
+
+	return BuildObjMesh(chunks, vertices, indices);
+}
+
+bool LoadObjParallel(const std::string& file, ThreadPool* pool, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices){
+	MappedFile mapped;
+	if (!mapped.open(file)){
+		return false;
+	}
+	return ParseObjParallel(mapped.data(), mapped.size(), pool, vertices, indices);
+}
@@ -0,0 +1,60 @@
+#ifndef _OBJPARSER_H
+#define _OBJPARSER_H
+
+#include "Global.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+class ThreadPool;
+
+//One face corner, 1-based attribute indices (0 when the corner has no uv or normal)
+struct ObjCorner{
+	int position;
+	int uv;
+	int normal;
+};
+
+//Bits of ObjChunk::relative, set when the index was negative in the file
+#define OBJ_RELATIVE_POSITION 1
+#define OBJ_RELATIVE_UV 2
+#define OBJ_RELATIVE_NORMAL 4
+
+/**
+*Everything parsed out of a run of whole lines.
+*Faces are already triangulated, 3 corners per triangle. Negative (relative) indices are
+*resolved against the attributes seen so far in this chunk only; ResolveObjChunk adds the
+*counts from the chunks before it.
+**/
+struct ObjChunk{
+	std::vector<XMFLOAT3> positions;
+	std::vector<XMFLOAT2> uvs;
+	std::vector<XMFLOAT3> normals;
+	std::vector<ObjCorner> corners;
+	std::vector<unsigned char> relative;
+};
+
+//Parses [begin, end), which must start at a line start and end at a line end (or the file end)
+void ParseObjChunk(const char* begin, const char* end, ObjChunk& chunk);
+
+//Shifts this chunk's relative indices by the attribute counts of all earlier chunks
+void ResolveObjChunk(ObjChunk& chunk, unsigned int positionOffset, unsigned int uvOffset, unsigned int normalOffset);
+
+//Concatenates resolved chunks and builds an indexed, deduplicated vertex list with tangents.
+//Returns false if a face references an attribute that doesn't exist.
+bool BuildObjMesh(const std::vector<ObjChunk>& chunks, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices);
+
+//Single threaded parse of a whole file image
+bool ParseObj(const char* data, size_t size, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices);
+//Memory maps and parses a file
+bool LoadObj(const std::string& file, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices);
+
+//Splits the image at line boundaries and parses the chunks on the pool (plus the calling thread).
+//The output is identical to ParseObj; small files are parsed serially.
+bool ParseObjParallel(const char* data, size_t size, ThreadPool* pool, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices);
+bool LoadObjParallel(const std::string& file, ThreadPool* pool, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices);
+
+//Decimal float parser (sign, digits, fraction, exponent); advances p past what it read
+float ParseObjFloat(const char*& p, const char* end);
+
+#endif
@@ -3,11 +3,10 @@
 #include "Mesh.h"
 #include "Global.h"
 #include <vector>
-#include <fstream>
-#include <iostream>
-#include <sstream>
 #include <string>
 
+class ThreadPool;
+
 using namespace DirectX;
 
 class ObjectLoader{
@@ -15,17 +14,10 @@ class ObjectLoader{
 public:
 	std::vector<Vertex2> vertices;
 	std::vector<UINT> indices;
-	std::vector<XMFLOAT3> Positions;
-	std::vector<XMFLOAT2> UVs;
-	std::vector<XMFLOAT3> Normals;
-	std::vector<UINT> splitString(std::string in);
 	ID3D11Device* m_device;
 	ObjectLoader(ID3D11Device* device);
 	~ObjectLoader();
-	bool CompareVertices(Vertex2 a, Vertex2 b);
-	UINT GetIndex(Vertex2 v);
-	Mesh* LoadModel(std::string file);
+	Mesh* LoadModel(std::string file, ThreadPool* pool = nullptr); // large files are parsed in chunks on the pool when one is given
+	Mesh* LoadCookedModel(std::string file); // nullptr if there is no current .mesh for the file
 	Vertex2* VecToArray();
-	XMFLOAT3* CalculateTangent(Triangle& triangle);
-	float XMFLOATDotProduct(XMFLOAT3 first, XMFLOAT3 second);
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef _PARALLELRENDERQUEUE_H
+#define _PARALLELRENDERQUEUE_H
+
+#include "CommandBackend.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <functional>
+#include <future>
+
+/**
+*Collects render jobs for a frame and records them across worker threads.
+*Jobs are split into contiguous slices, one per worker, and the slices are executed in worker
+*order, so the GPU sees exactly the submission order. Slice 0 is recorded on the calling
+*thread while the pool records the rest.
+*Jobs in different slices run at the same time and must not share mutable CPU state
+*(constant buffer staging structs included).
+**/
+template<typename TContext>
+class ParallelRenderQueue{
+public:
+	typedef std::function<void(TContext*)> RenderJob;
+
+	//pool may be null, then every slice is recorded on the calling thread
+	ParallelRenderQueue(CommandBackend<TContext>* commandBackend, ThreadPool* threadPool){
+		backend = commandBackend;
+		pool = threadPool;
+		lastSliceCount = 0;
+	}
+
+	void submit(RenderJob job){
+		jobs.push_back(job);
+	}
+
+	void flush(){
+		unsigned int jobCount = jobs.size();
+		unsigned int workers = backend->getWorkerCount();
+		lastSliceCount = workers < jobCount ? workers : jobCount;
+
+		if (lastSliceCount == 0){
+			TContext* context = backend->getImmediateContext();
+			for (unsigned int i = 0; i < jobCount; i++){
+				jobs[i](context);
+			}
+			jobs.clear();
+			return;
+		}
+
+		backend->beginFlush();
+
+		std::vector<std::future<void>> recordings;
+		for (unsigned int slice = 1; slice < lastSliceCount; slice++){
+			if (pool){
+				recordings.push_back(pool->submit([this, slice, jobCount](){ recordSlice(slice, jobCount); }));
+			}
+			else{
+				recordSlice(slice, jobCount);
+			}
+		}
+		recordSlice(0, jobCount);
+		for (size_t i = 0; i < recordings.size(); i++){
+			recordings[i].get();
+		}
+
+		for (unsigned int slice = 0; slice < lastSliceCount; slice++){
+			backend->executeRecording(slice);
+		}
+		backend->endFlush();
+
+		jobs.clear();
+	}
+
+	unsigned int getPendingCount(){
+		return jobs.size();
+	}
+
+	//Number of recordings the last flush was split into (0 when it ran on the immediate context)
+	unsigned int getLastSliceCount(){
+		return lastSliceCount;
+	}
+
+private:
+	//Slice k covers jobs [k * jobCount / slices, (k + 1) * jobCount / slices)
+	void recordSlice(unsigned int slice, unsigned int jobCount){
+		unsigned int first = slice * jobCount / lastSliceCount;
+		unsigned int last = (slice + 1) * jobCount / lastSliceCount;
+
+		TContext* context = backend->beginRecording(slice);
+		for (unsigned int i = first; i < last; i++){
+			jobs[i](context);
+		}
+		backend->endRecording(slice);
+	}
+
+	CommandBackend<TContext>* backend;
+	ThreadPool* pool;
+	std::vector<RenderJob> jobs;
+	unsigned int lastSliceCount;
+};
+
+#endif
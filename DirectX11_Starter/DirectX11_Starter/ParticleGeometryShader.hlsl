@@ -0,0 +1,56 @@
+struct VertexToGeometry
+{
+	float4 position		: POSITION;
+	float age			: TEXCOORD0;
+	uint alive			: TEXCOORD1;
+};
+
+struct GSOutput
+{
+	float4 position		: SV_POSITION;
+	float2 uv			: TEXCOORD2;
+};
+
+cbuffer perModel		: register(b0)
+{
+	matrix world;
+	matrix view;
+	matrix projection;
+	float4 uvTransform; // xy scale, zw offset of the texture in an atlas
+};
+
+// Expands each live pooled particle into a textured quad, dead slots emit nothing
+[maxvertexcount(4)]
+void main(
+	point VertexToGeometry dataIn[1],
+	inout TriangleStream< GSOutput > output
+	)
+{
+	if (dataIn[0].alive == 0)
+		return;
+
+	matrix worldViewProj = mul(mul(world, view), projection);
+
+	float4 v[4];
+	v[0] = dataIn[0].position + float4(0.05f, -0.05f, 0.0f, 0);
+	v[1] = dataIn[0].position + float4(-0.05f, -0.05f, 0.0f, 0);
+	v[2] = dataIn[0].position + float4(0.05f, 0.05f, 0.0f, 0);
+	v[3] = dataIn[0].position + float4(-0.05f, 0.05f, 0.0f, 0);
+
+	float2 quadUVs[4] = {
+		float2(1, 1),
+		float2(1, 0),
+		float2(0, 1),
+		float2(0, 0)
+	};
+
+	GSOutput element;
+	[unroll]
+	for (uint i = 0; i < 4; i++)
+	{
+		element.position = mul(v[i], worldViewProj);
+		element.uv = quadUVs[i] * uvTransform.xy + uvTransform.zw;
+		output.Append(element);
+	}
+	output.RestartStrip();
+}
@@ -0,0 +1,112 @@
+#include "ParticleSimulation.h"
+#include <cmath>
+
+void InitializeParticlePool(PooledParticle* particles, unsigned int emitterCount, unsigned int particlesPerEmitter){
+	for (unsigned int e = 0; e < emitterCount; e++){
+		for (unsigned int i = 0; i < particlesPerEmitter; i++){
+			PooledParticle& p = particles[e * particlesPerEmitter + i];
+			p.position = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			p.age = 0.0f;
+			p.velocity = XMFLOAT2(0.0f, 0.0f);
+			p.emitter = e;
+			p.alive = 0;
+		}
+	}
+}
+
+void SetEmitterPhases(ParticleEmitter* emitters, unsigned int emitterCount, double time){
+	for (unsigned int e = 0; e < emitterCount; e++){
+		float phase = (float)fmod(time, (double)emitters[e].lifetime);
+		//rounding to float can land on lifetime itself
+		if (phase >= emitters[e].lifetime){
+			phase = 0.0f;
+		}
+		emitters[e].previousPhase = emitters[e].phase;
+		emitters[e].phase = phase;
+	}
+}
+
+/**
+*Age, kill and integrate a live particle, then check whether the emitter fires into this slot.
+*Emission n happens at n * emitInterval into the emitter's lifetime and goes to slot
+*n % particlesPerEmitter, so with lifetime == particlesPerEmitter * emitInterval each slot is
+*recycled exactly as it dies and the pattern repeats every lifetime.
+*Emissions that land inside [previousPhase, phase) are found directly, so no emitter state is
+*needed beyond the two phases. Each bound goes through the same expression in consecutive frames,
+*so no emission falls between two windows or into both. When the phase wrapped during the frame
+*the window's start is in the previous lifetime, numbered from -particlesPerEmitter, which the slot
+*arithmetic handles the same way.
+**/
+void UpdatePooledParticle(const ParticleEmitter& emitter, PooledParticle& particle, unsigned int slot, unsigned int particlesPerEmitter, float deltaTime){
+	if (particle.alive){
+		particle.age += deltaTime;
+		if (particle.age >= emitter.lifetime){
+			particle.alive = 0;
+		}
+		else{
+			particle.velocity.x += emitter.acceleration.x * deltaTime;
+			particle.velocity.y += emitter.acceleration.y * deltaTime;
+			particle.position.x += particle.velocity.x * deltaTime;
+			particle.position.y += particle.velocity.y * deltaTime;
+		}
+	}
+
+	int firstEmission = (int)ceilf(emitter.previousPhase / emitter.emitInterval);
+	if (emitter.previousPhase > emitter.phase){
+		firstEmission -= (int)particlesPerEmitter;
+	}
+	int lastEmission = (int)ceilf(emitter.phase / emitter.emitInterval) - 1;
+	if (lastEmission < firstEmission){
+		return;
+	}
+
+	int offset = (lastEmission - (int)slot) % (int)particlesPerEmitter;
+	if (offset < 0){
+		offset += particlesPerEmitter;
+	}
+	int emission = lastEmission - offset;
+	if (emission < firstEmission){
+		return;
+	}
+
+	//spawn, advanced to the current time from the moment of emission
+	float age = emitter.phase - emission * emitter.emitInterval;
+	particle.age = age;
+	particle.alive = 1;
+	particle.velocity.x = emitter.velocity.x + emitter.acceleration.x * age;
+	particle.velocity.y = emitter.velocity.y + emitter.acceleration.y * age;
+	particle.position.x = emitter.position.x + emitter.velocity.x * age + 0.5f * emitter.acceleration.x * age * age;
+	particle.position.y = emitter.position.y + emitter.velocity.y * age + 0.5f * emitter.acceleration.y * age * age;
+	particle.position.z = emitter.position.z;
+}
+
+void SimulateParticles(const ParticleEmitter* emitters, PooledParticle* particles, unsigned int emitterCount, unsigned int particlesPerEmitter, float deltaTime){
+	unsigned int count = emitterCount * particlesPerEmitter;
+	for (unsigned int i = 0; i < count; i++){
+		const ParticleEmitter& emitter = emitters[particles[i].emitter];
+		UpdatePooledParticle(emitter, particles[i], i - emitter.firstParticle, particlesPerEmitter, deltaTime);
+	}
+}
+
+static bool Close(float a, float b, float tolerance){
+	float scale = fabsf(a) > 1.0f ? fabsf(a) : 1.0f;
+	return fabsf(a - b) <= tolerance * scale;
+}
+
+unsigned int CompareParticlePools(const PooledParticle* expected, const PooledParticle* actual, unsigned int count, float tolerance){
+	unsigned int mismatches = 0;
+	for (unsigned int i = 0; i < count; i++){
+		const PooledParticle& e = expected[i];
+		const PooledParticle& a = actual[i];
+		if (e.alive != a.alive || e.emitter != a.emitter){
+			mismatches++;
+		}
+		//a dead slot's contents are left over from its last life and never drawn
+		else if (e.alive && !(Close(e.age, a.age, tolerance) &&
+			Close(e.position.x, a.position.x, tolerance) && Close(e.position.y, a.position.y, tolerance) && Close(e.position.z, a.position.z, tolerance) &&
+			Close(e.velocity.x, a.velocity.x, tolerance) && Close(e.velocity.y, a.velocity.y, tolerance))){
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
@@ -0,0 +1,26 @@
+#ifndef _PARTICLESIMULATION_H
+#define _PARTICLESIMULATION_H
+
+#include "Global.h"
+
+//CPU reference for ParticleUpdateComputeShader.hlsl.
+//Kept free of D3D so it can run anywhere; any change to the kernel has to be mirrored here.
+
+//Marks every slot of the pool dead and assigns slots to emitters in blocks of particlesPerEmitter
+void InitializeParticlePool(PooledParticle* particles, unsigned int emitterCount, unsigned int particlesPerEmitter);
+
+//Moves every emitter's phase on to the frame ending at time, which the caller keeps in double:
+//a float clock loses the frame delta to rounding within hours, the phase stays in [0, lifetime).
+//The old phase becomes previousPhase so this frame's emission window starts where the last one ended
+void SetEmitterPhases(ParticleEmitter* emitters, unsigned int emitterCount, double time);
+
+//Advances one slot by deltaTime, from its emitter's previousPhase to its phase (the same work one compute shader thread does)
+void UpdatePooledParticle(const ParticleEmitter& emitter, PooledParticle& particle, unsigned int slot, unsigned int particlesPerEmitter, float deltaTime);
+
+//Advances the whole pool
+void SimulateParticles(const ParticleEmitter* emitters, PooledParticle* particles, unsigned int emitterCount, unsigned int particlesPerEmitter, float deltaTime);
+
+//Counts the slots that differ: liveness exactly, the rest relative to tolerance
+unsigned int CompareParticlePools(const PooledParticle* expected, const PooledParticle* actual, unsigned int count, float tolerance);
+
+#endif
@@ -0,0 +1,214 @@
+#include "ParticleSoA.h"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+//Arrays are padded to a whole number of AVX blocks so the kernels never need a scalar tail
+#define PARTICLE_SOA_BLOCK 8
+
+ParticleSoA::ParticleSoA(unsigned int max_particles)
+{
+	count = 0;
+	capacity = max_particles;
+
+	unsigned int padded = (max_particles + PARTICLE_SOA_BLOCK - 1) & ~(PARTICLE_SOA_BLOCK - 1);
+	posX.resize(padded, 0.0f);
+	posY.resize(padded, 0.0f);
+	posZ.resize(padded, 0.0f);
+	velX.resize(padded, 0.0f);
+	velY.resize(padded, 0.0f);
+	accX.resize(padded, 0.0f);
+	accY.resize(padded, 0.0f);
+	ages.resize(padded, 0.0f);
+	lifetimes.resize(padded, 0.0f);
+}
+
+/**
+*Add a continuous emitter
+*particles_per_lifetime: particles emitted over one lifetime, so this many are alive at once
+**/
+int ParticleSoA::addEmitter(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime, unsigned int particles_per_lifetime)
+{
+	ParticleSoAEmitter emitter;
+	emitter.position = position;
+	emitter.velocity = velocity;
+	emitter.acceleration = acceleration;
+	emitter.lifetime = lifetime;
+	emitter.emitInterval = lifetime / particles_per_lifetime;
+	emitter.timer = 0.0f;
+	emitters.push_back(emitter);
+	return emitters.size() - 1;
+}
+
+bool ParticleSoA::emit(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime)
+{
+	if (count >= capacity){
+		return false;
+	}
+
+	posX[count] = position.x;
+	posY[count] = position.y;
+	posZ[count] = position.z;
+	velX[count] = velocity.x;
+	velY[count] = velocity.y;
+	accX[count] = acceleration.x;
+	accY[count] = acceleration.y;
+	ages[count] = 0.0f;
+	lifetimes[count] = lifetime;
+	count++;
+	return true;
+}
+
+void ParticleSoA::update(float dt)
+{
+	integrate(dt);
+	compact();
+	emitFromEmitters(dt);
+}
+
+/**
+*Spawns the emissions that fell inside the last dt.
+*Each new particle is placed where it would be after living for the time since it was
+*emitted, the same closed form ParticleSimulation uses, so frame rate doesn't bunch them up.
+**/
+void ParticleSoA::emitFromEmitters(float dt)
+{
+	for (size_t e = 0; e < emitters.size(); e++){
+		ParticleSoAEmitter& emitter = emitters[e];
+		emitter.timer += dt;
+		while (emitter.timer >= emitter.emitInterval){
+			emitter.timer -= emitter.emitInterval;
+
+			float age = emitter.timer;
+			if (age >= emitter.lifetime || !emit(emitter.position, emitter.velocity, emitter.acceleration, emitter.lifetime)){
+				continue;
+			}
+
+			unsigned int i = count - 1;
+			ages[i] = age;
+			velX[i] = emitter.velocity.x + emitter.acceleration.x * age;
+			velY[i] = emitter.velocity.y + emitter.acceleration.y * age;
+			posX[i] = emitter.position.x + emitter.velocity.x * age + 0.5f * emitter.acceleration.x * age * age;
+			posY[i] = emitter.position.y + emitter.velocity.y * age + 0.5f * emitter.acceleration.y * age * age;
+		}
+	}
+}
+
+void ParticleSoA::integrate(float dt)
+{
+	unsigned int blocks = (count + PARTICLE_SOA_BLOCK - 1) / PARTICLE_SOA_BLOCK * PARTICLE_SOA_BLOCK;
+
+#if defined(__AVX2__)
+	__m256 delta = _mm256_set1_ps(dt);
+	for (unsigned int i = 0; i < blocks; i += 8){
+		__m256 vx = _mm256_add_ps(_mm256_loadu_ps(&velX[i]), _mm256_mul_ps(_mm256_loadu_ps(&accX[i]), delta));
+		__m256 vy = _mm256_add_ps(_mm256_loadu_ps(&velY[i]), _mm256_mul_ps(_mm256_loadu_ps(&accY[i]), delta));
+		_mm256_storeu_ps(&velX[i], vx);
+		_mm256_storeu_ps(&velY[i], vy);
+		_mm256_storeu_ps(&posX[i], _mm256_add_ps(_mm256_loadu_ps(&posX[i]), _mm256_mul_ps(vx, delta)));
+		_mm256_storeu_ps(&posY[i], _mm256_add_ps(_mm256_loadu_ps(&posY[i]), _mm256_mul_ps(vy, delta)));
+		_mm256_storeu_ps(&ages[i], _mm256_add_ps(_mm256_loadu_ps(&ages[i]), delta));
+	}
+#else
+	__m128 delta = _mm_set1_ps(dt);
+	for (unsigned int i = 0; i < blocks; i += 4){
+		__m128 vx = _mm_add_ps(_mm_loadu_ps(&velX[i]), _mm_mul_ps(_mm_loadu_ps(&accX[i]), delta));
+		__m128 vy = _mm_add_ps(_mm_loadu_ps(&velY[i]), _mm_mul_ps(_mm_loadu_ps(&accY[i]), delta));
+		_mm_storeu_ps(&velX[i], vx);
+		_mm_storeu_ps(&velY[i], vy);
+		_mm_storeu_ps(&posX[i], _mm_add_ps(_mm_loadu_ps(&posX[i]), _mm_mul_ps(vx, delta)));
+		_mm_storeu_ps(&posY[i], _mm_add_ps(_mm_loadu_ps(&posY[i]), _mm_mul_ps(vy, delta)));
+		_mm_storeu_ps(&ages[i], _mm_add_ps(_mm_loadu_ps(&ages[i]), delta));
+	}
+#endif
+}
+
+/**
+*Order preserving stream compaction.
+*The alive test is done 4 lanes at a time; a fully alive block with nothing removed before
+*it is skipped without touching memory, so the common case (no deaths this frame) is one
+*compare per 4 particles.
+**/
+unsigned int ParticleSoA::compact()
+{
+	unsigned int write = 0;
+	for (unsigned int read = 0; read < count; read += 4){
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(&ages[read]), _mm_loadu_ps(&lifetimes[read])));
+		unsigned int lanes = count - read < 4 ? count - read : 4;
+		mask &= (1 << lanes) - 1;
+
+		if (mask == 0xF && write == read){
+			write += 4;
+			continue;
+		}
+
+		for (unsigned int lane = 0; lane < lanes; lane++){
+			if (!(mask & (1 << lane))){
+				continue;
+			}
+			unsigned int i = read + lane;
+			if (write != i){
+				posX[write] = posX[i];
+				posY[write] = posY[i];
+				posZ[write] = posZ[i];
+				velX[write] = velX[i];
+				velY[write] = velY[i];
+				accX[write] = accX[i];
+				accY[write] = accY[i];
+				ages[write] = ages[i];
+				lifetimes[write] = lifetimes[i];
+			}
+			write++;
+		}
+	}
+
+	unsigned int removed = count - write;
+	count = write;
+	return removed;
+}
+
+unsigned int ParticleSoA::writeVertices(Particle* vertices, unsigned int maxVertices)
+{
+	unsigned int n = count < maxVertices ? count : maxVertices;
+	for (unsigned int i = 0; i < n; i++){
+		vertices[i].Position = XMFLOAT4(posX[i], posY[i], posZ[i], 1.0f);
+		vertices[i].velocity = XMFLOAT2(0.0f, 0.0f);
+		vertices[i].acceleration = XMFLOAT2(0.0f, 0.0f);
+	}
+	return n;
+}
+
+unsigned int ParticleSoA::getCount()
+{
+	return count;
+}
+
+unsigned int ParticleSoA::getCapacity()
+{
+	return capacity;
+}
+
+void ParticleSoA::clear()
+{
+	count = 0;
+	for (size_t e = 0; e < emitters.size(); e++){
+		emitters[e].timer = 0.0f;
+	}
+}
+
+const float* ParticleSoA::positionX()
+{
+	return &posX[0];
+}
+
+const float* ParticleSoA::positionY()
+{
+	return &posY[0];
+}
+
+const float* ParticleSoA::age()
+{
+	return &ages[0];
+}
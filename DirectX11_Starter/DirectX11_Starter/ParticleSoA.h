@@ -0,0 +1,72 @@
+#ifndef _PARTICLESOA_H
+#define _PARTICLESOA_H
+
+#include "Global.h"
+#include <vector>
+
+//Continuous emitter for the CPU backend, fires one particle every emitInterval seconds
+struct ParticleSoAEmitter{
+	XMFLOAT4 position;
+	XMFLOAT2 velocity;
+	XMFLOAT2 acceleration;
+	float lifetime;
+	float emitInterval;
+	float timer;
+};
+
+/**
+*CPU particle backend.
+*Particles are stored as structure of arrays so the integrate kernel can load 4 (SSE) or
+*8 (AVX2, when compiled with /arch:AVX2) particles per instruction. Dead particles are
+*removed by an order preserving stream compaction pass, so the live particles are always
+*the first getCount() entries. No D3D in here, CpuParticleSystem owns the upload.
+**/
+class ParticleSoA{
+public:
+	ParticleSoA(unsigned int max_particles);
+
+	//Returns the emitter index
+	int addEmitter(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime, unsigned int particles_per_lifetime);
+	//Appends one particle, returns false when the pool is full
+	bool emit(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 acceleration, float lifetime);
+
+	//Runs the emitters, integrates every particle and compacts out the dead ones
+	void update(float dt);
+	//Ages and integrates every particle (age, velocity, then position)
+	void integrate(float dt);
+	//Removes particles whose age reached their lifetime, returns how many were removed
+	unsigned int compact();
+
+	//Writes the live particles as Particle vertices (velocity and acceleration zeroed, the
+	//position is already integrated) and returns how many were written
+	unsigned int writeVertices(Particle* vertices, unsigned int maxVertices);
+
+	unsigned int getCount();
+	unsigned int getCapacity();
+	void clear();
+
+	//Direct access, valid for the first getCount() entries
+	const float* positionX();
+	const float* positionY();
+	const float* age();
+
+private:
+	void emitFromEmitters(float dt);
+
+	unsigned int count;
+	unsigned int capacity;
+
+	std::vector<float> posX;
+	std::vector<float> posY;
+	std::vector<float> posZ;
+	std::vector<float> velX;
+	std::vector<float> velY;
+	std::vector<float> accX;
+	std::vector<float> accY;
+	std::vector<float> ages;
+	std::vector<float> lifetimes;
+
+	std::vector<ParticleSoAEmitter> emitters;
+};
+
+#endif
@@ -13,15 +13,13 @@ ParticleSystem::ParticleSystem(XMFLOAT4 position, XMFLOAT2 velocity, XMFLOAT2 ac
 		velocity,
 		acceleration,
 	};
-	object = new GameEntity(new Mesh(point, 0, 1, device), mat);
-}
-
+	Mesh* pointMesh = new Mesh(point, 0, 1, device);
+	object = new GameEntity(pointMesh, mat);
+	pointMesh->Release();
 
-void ParticleSystem::drawParticleSystem(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, float time)
-{
-	
-	ID3D11BlendState* blendState = nullptr;
+	//alpha blending for the particles, created once and shared by every particle system on this device
 	D3D11_BLEND_DESC blendDesc;
+	ZeroMemory(&blendDesc, sizeof(blendDesc));
 	blendDesc.AlphaToCoverageEnable = 0;
 	blendDesc.IndependentBlendEnable = 0;
 	blendDesc.RenderTarget[0].BlendEnable = TRUE;
@@ -33,10 +31,14 @@ void ParticleSystem::drawParticleSystem(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projec
 	blendDesc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
 	blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
 
-	HRESULT hr_blend = device->CreateBlendState(&blendDesc, &blendState);
-
+	stateCache = PipelineStateCache::ForDevice(device);
+	blendState = stateCache->getBlendState(blendDesc);
+}
 
 
+void ParticleSystem::drawParticleSystem(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, float time)
+{
+	
 	UINT offset = 0;
 	UINT stride = object->g_mesh->sizeofvertex;
 
@@ -46,6 +48,7 @@ void ParticleSystem::drawParticleSystem(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projec
 	object->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = object->getWorld();
 	object->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
 	object->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+	object->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = object->g_mat->uvTransform;
 	object->g_mat->shaderProgram->ConstantBuffers[3]->dataToSendToGSBuffer.age = time;
 
 
@@ -76,9 +79,12 @@ void ParticleSystem::drawParticleSystem(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projec
 
 	
 
-	deviceContext->OMSetBlendState(blendState, NULL, 0xffffffff);
-	ID3D11DepthStencilState* depthState;
-	deviceContext->OMGetDepthStencilState(&depthState, 0);
+	stateCache->setBlendState(deviceContext, blendState);
+
+	//remember the bound depth state so it can be restored after the stream output pass
+	ID3D11DepthStencilState* depthState = nullptr;
+	UINT stencilRef = 0;
+	deviceContext->OMGetDepthStencilState(&depthState, &stencilRef);
 
 	
 
@@ -113,8 +119,9 @@ void ParticleSystem::drawParticleSystem(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projec
 	//swap vertex buffer and stream output buffer
 	std::swap(object->g_mesh->v_buffer, object->g_mesh->so_buffer);
 
-	//bind depth stencil state
-	deviceContext->OMSetDepthStencilState(depthState, 0);
+	//bind depth stencil state, OMGetDepthStencilState added a reference
+	deviceContext->OMSetDepthStencilState(depthState, stencilRef);
+	ReleaseMacro(depthState);
 	 
 	//bind geometry shader
 	deviceContext->GSSetShader(object->g_mat->shaderProgram->geometryShader, NULL, 0);
@@ -6,9 +6,11 @@
 #include "Material.h"
 #include "ConstantBuffer.h"
 #include "Mesh.h"
+#include "PipelineStateCache.h"
 #include <Windows.h>
 #include <d3d11.h>
 #include <vector>
+#include <memory>
 
 class ParticleSystem{
 public:
@@ -19,6 +21,8 @@ private:
 	ID3D11DeviceContext* deviceContext;
 	std::vector<GameEntity*> particles;
 	GameEntity* object;
+	std::shared_ptr<PipelineStateCache> stateCache;
+	BlendStateHandle blendState;
 	bool initialized;
 	bool firstPass;
 	int numParticles;
@@ -0,0 +1,86 @@
+// Advances every slot of the pooled particle buffer in one dispatch.
+// ParticleSimulation.cpp is the CPU reference for this kernel; keep the two in step.
+
+struct Emitter
+{
+	float4 position;
+	float2 velocity;
+	float2 acceleration;
+	float lifetime;
+	float emitInterval;
+	uint firstParticle;
+	float phase; // seconds into the current lifetime, wrapped on the CPU from a double clock
+	float previousPhase; // the last frame's
+	uint2 padding;
+};
+
+struct PooledParticle
+{
+	float3 position;
+	float age;
+	float2 velocity;
+	uint emitter;
+	uint alive;
+};
+
+cbuffer particleUpdate : register(b0)
+{
+	float deltaTime;
+	uint particlesPerEmitter;
+	uint particleCount;
+	uint padding;
+};
+
+StructuredBuffer<Emitter> emitters : register(t0);
+RWStructuredBuffer<PooledParticle> particles : register(u0);
+
+[numthreads(64, 1, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+	if (id.x >= particleCount)
+		return;
+
+	PooledParticle p = particles[id.x];
+	Emitter e = emitters[p.emitter];
+	int slot = (int)(id.x - e.firstParticle);
+
+	// age, kill and integrate
+	if (p.alive)
+	{
+		p.age += deltaTime;
+		if (p.age >= e.lifetime)
+		{
+			p.alive = 0;
+		}
+		else
+		{
+			p.velocity += e.acceleration * deltaTime;
+			p.position.xy += p.velocity * deltaTime;
+		}
+	}
+
+	// emission n fires n * emitInterval into the lifetime, into slot n % particlesPerEmitter;
+	// the window runs from the last frame's phase, which in the previous lifetime is at negative n
+	int firstEmission = (int)ceil(e.previousPhase / e.emitInterval);
+	if (e.previousPhase > e.phase)
+		firstEmission -= (int)particlesPerEmitter;
+	int lastEmission = (int)ceil(e.phase / e.emitInterval) - 1;
+	if (lastEmission >= firstEmission)
+	{
+		int offset = (lastEmission - slot) % (int)particlesPerEmitter;
+		if (offset < 0)
+			offset += particlesPerEmitter;
+		int emission = lastEmission - offset;
+		if (emission >= firstEmission)
+		{
+			float age = e.phase - emission * e.emitInterval;
+			p.age = age;
+			p.alive = 1;
+			p.velocity = e.velocity + e.acceleration * age;
+			p.position.xy = e.position.xy + e.velocity * age + 0.5f * e.acceleration * age * age;
+			p.position.z = e.position.z;
+		}
+	}
+
+	particles[id.x] = p;
+}
@@ -0,0 +1,30 @@
+// Reads the pooled particle buffer directly, no vertex buffer or input layout is bound.
+
+struct PooledParticle
+{
+	float3 position;
+	float age;
+	float2 velocity;
+	uint emitter;
+	uint alive;
+};
+
+StructuredBuffer<PooledParticle> particles : register(t0);
+
+struct VertexToGeometry
+{
+	float4 position		: POSITION;
+	float age			: TEXCOORD0;
+	uint alive			: TEXCOORD1;
+};
+
+VertexToGeometry main(uint id : SV_VertexID)
+{
+	PooledParticle p = particles[id];
+
+	VertexToGeometry output;
+	output.position = float4(p.position, 1.0f);
+	output.age = p.age;
+	output.alive = p.alive;
+	return output;
+}
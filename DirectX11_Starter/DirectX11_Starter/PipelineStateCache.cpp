@@ -0,0 +1,208 @@
+#include "PipelineStateCache.h"
+#include "Global.h"
+
+/**
+*Canonical copies of the state descriptors.
+*The descriptors contain UINT8 members and therefore padding bytes, and D3D ignores
+*RenderTarget[1..7] when IndependentBlendEnable is false, so keys are rebuilt member by
+*member into zeroed storage before they are hashed and compared.
+**/
+static D3D11_BLEND_DESC CanonicalBlendDesc(const D3D11_BLEND_DESC& in){
+	D3D11_BLEND_DESC out;
+	ZeroMemory(&out, sizeof(out));
+	out.AlphaToCoverageEnable = in.AlphaToCoverageEnable ? TRUE : FALSE;
+	out.IndependentBlendEnable = in.IndependentBlendEnable ? TRUE : FALSE;
+	UINT targets = out.IndependentBlendEnable ? 8 : 1;
+	for (UINT i = 0; i < targets; i++){
+		out.RenderTarget[i].BlendEnable = in.RenderTarget[i].BlendEnable ? TRUE : FALSE;
+		out.RenderTarget[i].SrcBlend = in.RenderTarget[i].SrcBlend;
+		out.RenderTarget[i].DestBlend = in.RenderTarget[i].DestBlend;
+		out.RenderTarget[i].BlendOp = in.RenderTarget[i].BlendOp;
+		out.RenderTarget[i].SrcBlendAlpha = in.RenderTarget[i].SrcBlendAlpha;
+		out.RenderTarget[i].DestBlendAlpha = in.RenderTarget[i].DestBlendAlpha;
+		out.RenderTarget[i].BlendOpAlpha = in.RenderTarget[i].BlendOpAlpha;
+		out.RenderTarget[i].RenderTargetWriteMask = in.RenderTarget[i].RenderTargetWriteMask;
+	}
+	return out;
+}
+
+static D3D11_DEPTH_STENCIL_DESC CanonicalDepthStencilDesc(const D3D11_DEPTH_STENCIL_DESC& in){
+	D3D11_DEPTH_STENCIL_DESC out;
+	ZeroMemory(&out, sizeof(out));
+	out.DepthEnable = in.DepthEnable ? TRUE : FALSE;
+	out.DepthWriteMask = in.DepthWriteMask;
+	out.DepthFunc = in.DepthFunc;
+	out.StencilEnable = in.StencilEnable ? TRUE : FALSE;
+	out.StencilReadMask = in.StencilReadMask;
+	out.StencilWriteMask = in.StencilWriteMask;
+	out.FrontFace = in.FrontFace;
+	out.BackFace = in.BackFace;
+	return out;
+}
+
+static D3D11_RASTERIZER_DESC CanonicalRasterizerDesc(const D3D11_RASTERIZER_DESC& in){
+	D3D11_RASTERIZER_DESC out;
+	ZeroMemory(&out, sizeof(out));
+	out.FillMode = in.FillMode;
+	out.CullMode = in.CullMode;
+	out.FrontCounterClockwise = in.FrontCounterClockwise ? TRUE : FALSE;
+	out.DepthBias = in.DepthBias;
+	out.DepthBiasClamp = in.DepthBiasClamp;
+	out.SlopeScaledDepthBias = in.SlopeScaledDepthBias;
+	out.DepthClipEnable = in.DepthClipEnable ? TRUE : FALSE;
+	out.ScissorEnable = in.ScissorEnable ? TRUE : FALSE;
+	out.MultisampleEnable = in.MultisampleEnable ? TRUE : FALSE;
+	out.AntialiasedLineEnable = in.AntialiasedLineEnable ? TRUE : FALSE;
+	return out;
+}
+
+//FNV-1a over the canonical descriptor bytes
+template<typename TDesc>
+size_t PipelineStateCache::DescKeyHash<TDesc>::operator()(const DescKey<TDesc>& key) const{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&key.desc);
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < sizeof(TDesc); i++){
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return static_cast<size_t>(hash);
+}
+
+PipelineStateCache::PipelineStateCache(ID3D11Device* dev){
+	device = dev;
+	device->AddRef();
+	hits = 0;
+	misses = 0;
+}
+
+PipelineStateCache::~PipelineStateCache(void){
+	releaseTable(blendStates);
+	releaseTable(depthStencilStates);
+	releaseTable(rasterizerStates);
+	ReleaseMacro(device);
+}
+
+/**
+*Returns the cache shared by everything using this device.
+*Same idea as DirectXTK's SharedResourcePool: the pool only holds weak references,
+*so the cache (and its state objects) go away with the last owner.
+**/
+std::shared_ptr<PipelineStateCache> PipelineStateCache::ForDevice(ID3D11Device* dev){
+	static std::mutex poolMutex;
+	static std::map<ID3D11Device*, std::weak_ptr<PipelineStateCache>> pool;
+
+	std::lock_guard<std::mutex> lock(poolMutex);
+
+	auto pos = pool.find(dev);
+	if (pos != pool.end()){
+		std::shared_ptr<PipelineStateCache> existing = pos->second.lock();
+		if (existing){
+			return existing;
+		}
+		pool.erase(pos);
+	}
+
+	std::shared_ptr<PipelineStateCache> cache = std::make_shared<PipelineStateCache>(dev);
+	pool.insert(std::make_pair(dev, cache));
+	return cache;
+}
+
+/**
+*Looks the key up in the table, creating the state object on a miss.
+*createFunc: called with the descriptor and an out pointer, returns an HRESULT
+**/
+template<typename TDesc, typename TState, typename TCreateFunc>
+UINT PipelineStateCache::demandCreate(StateTable<TDesc, TState>& table, const DescKey<TDesc>& key, TCreateFunc createFunc){
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto pos = table.lookup.find(key);
+	if (pos != table.lookup.end()){
+		hits++;
+		return pos->second;
+	}
+
+	misses++;
+	TState* state = nullptr;
+	if (FAILED(createFunc(&key.desc, &state))){
+		return INVALID_PIPELINE_STATE_INDEX;
+	}
+
+	UINT index = (UINT)table.states.size();
+	table.states.push_back(state);
+	table.lookup.insert(std::make_pair(key, index));
+	return index;
+}
+
+template<typename TDesc, typename TState>
+void PipelineStateCache::releaseTable(StateTable<TDesc, TState>& table){
+	for (size_t i = 0; i < table.states.size(); i++){
+		ReleaseMacro(table.states[i]);
+	}
+	table.states.clear();
+	table.lookup.clear();
+}
+
+BlendStateHandle PipelineStateCache::getBlendState(const D3D11_BLEND_DESC& desc){
+	DescKey<D3D11_BLEND_DESC> key = { CanonicalBlendDesc(desc) };
+	BlendStateHandle handle = { demandCreate(blendStates, key,
+		[&](const D3D11_BLEND_DESC* d, ID3D11BlendState** out){ return device->CreateBlendState(d, out); }) };
+	return handle;
+}
+
+DepthStencilStateHandle PipelineStateCache::getDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc){
+	DescKey<D3D11_DEPTH_STENCIL_DESC> key = { CanonicalDepthStencilDesc(desc) };
+	DepthStencilStateHandle handle = { demandCreate(depthStencilStates, key,
+		[&](const D3D11_DEPTH_STENCIL_DESC* d, ID3D11DepthStencilState** out){ return device->CreateDepthStencilState(d, out); }) };
+	return handle;
+}
+
+RasterizerStateHandle PipelineStateCache::getRasterizerState(const D3D11_RASTERIZER_DESC& desc){
+	DescKey<D3D11_RASTERIZER_DESC> key = { CanonicalRasterizerDesc(desc) };
+	RasterizerStateHandle handle = { demandCreate(rasterizerStates, key,
+		[&](const D3D11_RASTERIZER_DESC* d, ID3D11RasterizerState** out){ return device->CreateRasterizerState(d, out); }) };
+	return handle;
+}
+
+ID3D11BlendState* PipelineStateCache::blendState(BlendStateHandle handle){
+	std::lock_guard<std::mutex> lock(mutex);
+	return handle.index < blendStates.states.size() ? blendStates.states[handle.index] : nullptr;
+}
+
+ID3D11DepthStencilState* PipelineStateCache::depthStencilState(DepthStencilStateHandle handle){
+	std::lock_guard<std::mutex> lock(mutex);
+	return handle.index < depthStencilStates.states.size() ? depthStencilStates.states[handle.index] : nullptr;
+}
+
+ID3D11RasterizerState* PipelineStateCache::rasterizerState(RasterizerStateHandle handle){
+	std::lock_guard<std::mutex> lock(mutex);
+	return handle.index < rasterizerStates.states.size() ? rasterizerStates.states[handle.index] : nullptr;
+}
+
+void PipelineStateCache::setBlendState(ID3D11DeviceContext* devCtx, BlendStateHandle handle, const FLOAT blendFactor[4], UINT sampleMask){
+	devCtx->OMSetBlendState(blendState(handle), blendFactor, sampleMask);
+}
+
+void PipelineStateCache::setDepthStencilState(ID3D11DeviceContext* devCtx, DepthStencilStateHandle handle, UINT stencilRef){
+	devCtx->OMSetDepthStencilState(depthStencilState(handle), stencilRef);
+}
+
+void PipelineStateCache::setRasterizerState(ID3D11DeviceContext* devCtx, RasterizerStateHandle handle){
+	devCtx->RSSetState(rasterizerState(handle));
+}
+
+PipelineStateStats PipelineStateCache::getStats(){
+	std::lock_guard<std::mutex> lock(mutex);
+	PipelineStateStats stats;
+	stats.hits = hits;
+	stats.misses = misses;
+	stats.blendStates = (UINT)blendStates.states.size();
+	stats.depthStencilStates = (UINT)depthStencilStates.states.size();
+	stats.rasterizerStates = (UINT)rasterizerStates.states.size();
+	return stats;
+}
+
+void PipelineStateCache::resetStats(){
+	std::lock_guard<std::mutex> lock(mutex);
+	hits = 0;
+	misses = 0;
+}
@@ -0,0 +1,98 @@
+#ifndef _PIPELINESTATECACHE_H
+#define _PIPELINESTATECACHE_H
+
+#include <Windows.h>
+#include <d3d11.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <memory>
+#include <mutex>
+
+//Handles returned by the cache, index into the cache's state tables
+//Typed so a blend handle can't be passed where a depth stencil handle is expected
+struct BlendStateHandle{ UINT index; };
+struct DepthStencilStateHandle{ UINT index; };
+struct RasterizerStateHandle{ UINT index; };
+
+#define INVALID_PIPELINE_STATE_INDEX 0xffffffff
+
+//Cache hit/miss counters and the number of live state objects of each type
+struct PipelineStateStats{
+	UINT hits;
+	UINT misses;
+	UINT blendStates;
+	UINT depthStencilStates;
+	UINT rasterizerStates;
+};
+
+//Creates each unique blend, depth stencil and rasterizer state once and hands it out by handle.
+//States are keyed on the full descriptor; one cache is shared per device (see ForDevice).
+class PipelineStateCache{
+public:
+	PipelineStateCache(ID3D11Device* dev);
+	~PipelineStateCache(void);
+
+	//Returns the shared cache for a device, creating it on first use
+	static std::shared_ptr<PipelineStateCache> ForDevice(ID3D11Device* dev);
+
+	BlendStateHandle getBlendState(const D3D11_BLEND_DESC& desc);
+	DepthStencilStateHandle getDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc);
+	RasterizerStateHandle getRasterizerState(const D3D11_RASTERIZER_DESC& desc);
+
+	ID3D11BlendState* blendState(BlendStateHandle handle);
+	ID3D11DepthStencilState* depthStencilState(DepthStencilStateHandle handle);
+	ID3D11RasterizerState* rasterizerState(RasterizerStateHandle handle);
+
+	//Convenience binds
+	void setBlendState(ID3D11DeviceContext* devCtx, BlendStateHandle handle, const FLOAT blendFactor[4] = NULL, UINT sampleMask = 0xffffffff);
+	void setDepthStencilState(ID3D11DeviceContext* devCtx, DepthStencilStateHandle handle, UINT stencilRef = 0);
+	void setRasterizerState(ID3D11DeviceContext* devCtx, RasterizerStateHandle handle);
+
+	PipelineStateStats getStats();
+	void resetStats();
+
+private:
+	//Hash/equality over a canonical (zero padded) copy of a descriptor
+	template<typename TDesc>
+	struct DescKey{
+		TDesc desc;
+		bool operator==(const DescKey& other) const { return memcmp(&desc, &other.desc, sizeof(TDesc)) == 0; }
+	};
+
+	template<typename TDesc>
+	struct DescKeyHash{
+		size_t operator()(const DescKey<TDesc>& key) const;
+	};
+
+	//One table per state type: the live objects plus the descriptor -> index map
+	template<typename TDesc, typename TState>
+	struct StateTable{
+		std::vector<TState*> states;
+		std::unordered_map<DescKey<TDesc>, UINT, DescKeyHash<TDesc>> lookup;
+	};
+
+	template<typename TDesc, typename TState, typename TCreateFunc>
+	UINT demandCreate(StateTable<TDesc, TState>& table, const DescKey<TDesc>& key, TCreateFunc createFunc);
+
+	template<typename TDesc, typename TState>
+	void releaseTable(StateTable<TDesc, TState>& table);
+
+	ID3D11Device* device;
+	std::mutex mutex;
+
+	StateTable<D3D11_BLEND_DESC, ID3D11BlendState> blendStates;
+	StateTable<D3D11_DEPTH_STENCIL_DESC, ID3D11DepthStencilState> depthStencilStates;
+	StateTable<D3D11_RASTERIZER_DESC, ID3D11RasterizerState> rasterizerStates;
+
+	UINT hits;
+	UINT misses;
+
+	// Prevent copying.
+	PipelineStateCache(PipelineStateCache const&);
+	PipelineStateCache& operator= (PipelineStateCache const&);
+};
+
+#endif
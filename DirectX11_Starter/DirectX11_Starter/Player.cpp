@@ -2,7 +2,7 @@
 
 //Constructor for player object
 //Params(device, deviceContext, vector of constantbuffers, sampler state, mesh)
-Player::Player(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* mesh){
+Player::Player(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* mesh){
 	lighting.ambientColor = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
 	lighting.diffuseColor = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
 	lighting.lightDirection = XMFLOAT3(0.0f, 0.0f, 1.0f);
@@ -13,8 +13,8 @@ Player::Player(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBu
 	deviceContext = devCtx;
 	sampler = samplerState;
 	health = 10;
-	shaderProgram = new ShaderProgram(L"MultiTexVertexShader.cso", L"MultiTexPixelShader.cso", device, constantBufferList);
-	shipMaterial = new Material(device, deviceContext, sampler, L"spaceShipTexture.jpg", L"night.jpg", L"alpha_map.png", shaderProgram);
+	shaderProgram = assets->getMeshShaderProgram(MESH_SHADER_LIT | MESH_SHADER_MULTI_TEXTURE | MESH_SHADER_ALPHA_MAP | (mesh->quantized ? MESH_SHADER_PACKED : 0), constantBufferList);
+	shipMaterial = new Material(assets, sampler, L"spaceShipTexture.jpg", L"night.jpg", L"alpha_map.png", shaderProgram);
 
 	player = new GameEntity(mesh, shipMaterial);
 	player->translate(XMFLOAT3(0.0f, 0.0f, 0.0f));
@@ -36,10 +36,6 @@ Player::~Player(){
 		delete shipMaterial;
 		shipMaterial = nullptr;
 	}
-	if (shaderProgram){
-		delete shaderProgram;
-		shaderProgram = nullptr;
-	}
 }
 
 //Decrement Player's health
@@ -79,16 +75,17 @@ void Player::update(float dt){
 }
 
 //draw player game entity
-void Player::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos){
+void Player::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context){
 	UINT offset = 0;
 	UINT stride = player->g_mesh->sizeofvertex;
-	deviceContext->IASetInputLayout(player->g_mat->shaderProgram->vsInputLayout);
-	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	context->IASetInputLayout(player->g_mat->shaderProgram->vsInputLayout);
+	context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	//set values that get passed to matrix constant buffer
-	player->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = player->getWorld();
+	player->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = player->getDrawWorld();
 	player->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
 	player->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+	player->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = player->g_mat->uvTransform;
 
 	//set values that get passed to lighting constant buffer
 	player->g_mat->shaderProgram->ConstantBuffers[1]->dataToSendToLightBuffer.ambientColor = lighting.ambientColor;
@@ -101,7 +98,7 @@ void Player::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 c
 	player->g_mat->shaderProgram->ConstantBuffers[2]->dataToSendToCameraBuffer.padding = 1.0f;
 
 	//matrix constant buffer
-	deviceContext->UpdateSubresource(
+	context->UpdateSubresource(
 		player->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer,
 		0,
 		NULL,
@@ -110,7 +107,7 @@ void Player::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 c
 		0);
 
 	//camera constant buffer 
-	deviceContext->UpdateSubresource(
+	context->UpdateSubresource(
 		player->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer,
 		0,
 		NULL,
@@ -118,7 +115,7 @@ void Player::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 c
 		0,
 		0);
 	//light constant buffer
-	deviceContext->UpdateSubresource(
+	context->UpdateSubresource(
 		player->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer,
 		0,
 		NULL,
@@ -126,24 +123,24 @@ void Player::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 c
 		0,
 		0);
 
-	deviceContext->IASetVertexBuffers(0, 1, &player->g_mesh->v_buffer, &stride, &offset);
-	deviceContext->IASetIndexBuffer(player->g_mesh->i_buffer, DXGI_FORMAT_R32_UINT, 0);
+	context->IASetVertexBuffers(0, 1, &player->g_mesh->v_buffer, &stride, &offset);
+	context->IASetIndexBuffer(player->g_mesh->i_buffer, player->g_mesh->indexFormat, 0);
 
-	deviceContext->PSSetSamplers(0, 1, &player->g_mat->samplerState);
-	deviceContext->PSSetShaderResources(0, 1, &player->g_mat->resourceView);
-	deviceContext->PSSetShaderResources(1, 1, &player->g_mat->resourceView2);
-	deviceContext->PSSetShaderResources(2, 1, &player->g_mat->resourceView3);
+	context->PSSetSamplers(0, 1, &player->g_mat->samplerState);
+	context->PSSetShaderResources(0, 1, &player->g_mat->resourceView);
+	context->PSSetShaderResources(1, 1, &player->g_mat->resourceView2);
+	context->PSSetShaderResources(2, 1, &player->g_mat->resourceView3);
 
 
 	// Set the current vertex and pixel shaders, as well the constant buffer for the vert shader
-	deviceContext->VSSetShader(player->g_mat->shaderProgram->vertexShader, NULL, 0);
-	deviceContext->VSSetConstantBuffers(0, 1, &player->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
-	deviceContext->VSSetConstantBuffers(1, 1, &player->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
-	deviceContext->PSSetShader(player->g_mat->shaderProgram->pixelShader, NULL, 0);
-	deviceContext->PSSetConstantBuffers(0, 1, &player->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
+	context->VSSetShader(player->g_mat->shaderProgram->vertexShader, NULL, 0);
+	context->VSSetConstantBuffers(0, 1, &player->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
+	context->VSSetConstantBuffers(1, 1, &player->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
+	context->PSSetShader(player->g_mat->shaderProgram->pixelShader, NULL, 0);
+	context->PSSetConstantBuffers(0, 1, &player->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
 
 	// Finally do the actual drawing
-	deviceContext->DrawIndexed(
+	context->DrawIndexed(
 		player->g_mesh->m_size,	// The number of indices we're using in this draw
 		0,
 		0);
@@ -7,6 +7,7 @@
 #include "Mesh.h"
 #include "GameEntity.h"
 #include "Material.h"
+#include "AssetManager.h"
 #include "ShaderProgram.h"
 #include "SamplerState.h"
 #include "Global.h"
@@ -16,10 +17,10 @@
 
 class Player{
 public:
-	Player(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* mesh);
+	Player(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* mesh);
 	~Player(void);
 	void update(float dt);
-	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos);
+	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context);
 	void drawText(IFW1FontWrapper *pFontWrapper);
 	int returnHealth(void);
 	void setHealth(int new_health);
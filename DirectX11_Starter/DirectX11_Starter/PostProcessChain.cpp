@@ -0,0 +1,210 @@
+#include "PostProcessChain.h"
+#include "AssetManager.h"
+#include "Global.h"
+
+PostProcessChain::PostProcessChain(ID3D11Device* dev, AssetManager* assetManager){
+	device = dev;
+	assets = assetManager;
+	ID3D11SamplerState* linearClamp = nullptr;
+	sampler = new SamplerState(linearClamp);
+	sampler->createSamplerState(device, D3D11_TEXTURE_ADDRESS_CLAMP, D3D11_FILTER_MIN_MAG_MIP_LINEAR);
+	width = 0;
+	height = 0;
+	compiled = false;
+}
+
+PostProcessChain::~PostProcessChain(void){
+	for (size_t i = 0; i < pool.size(); i++){
+		releaseTexture(pool[i]);
+	}
+	delete sampler;
+}
+
+uint32_t PostProcessChain::addTarget(PostProcessFormat format, uint32_t divisor){
+	compiled = false;
+	return graph.addTarget(format, divisor);
+}
+
+void PostProcessChain::addScenePass(uint32_t output){
+	compiled = false;
+	graph.addPass(POST_PROCESS_PASS_EXTERNAL, 0, output, nullptr, 0);
+}
+
+void PostProcessChain::addEffectPass(PostProcessEffect effect, uint32_t output, uint32_t input){
+	compiled = false;
+	graph.addPass(POST_PROCESS_PASS_PIXEL, getPixelShader(effect), output, &input, 1);
+}
+
+uint32_t PostProcessChain::getPixelShader(PostProcessEffect effect){
+	std::vector<ConstantBuffer*> noConstantBuffers;
+	ShaderProgram* program = assets->getPostProcessShaderProgram(effect, noConstantBuffers);
+	for (size_t i = 0; i < shaders.size(); i++){
+		if (shaders[i] == program){
+			return (uint32_t)i;
+		}
+	}
+	shaders.push_back(program);
+	return (uint32_t)shaders.size() - 1;
+}
+
+bool PostProcessChain::createTexture(const PostProcessSlot& desc, PooledTexture& pooled){
+	static const DXGI_FORMAT formats[] = { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R11G11B10_FLOAT };
+	pooled.desc = desc;
+	pooled.texture = nullptr;
+	pooled.shaderResourceView = nullptr;
+	pooled.renderTargetView = nullptr;
+	pooled.unorderedAccessView = nullptr;
+
+	D3D11_TEXTURE2D_DESC textureDesc;
+	ZeroMemory(&textureDesc, sizeof(textureDesc));
+	textureDesc.Width = desc.width;
+	textureDesc.Height = desc.height;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = formats[desc.format];
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	if (desc.bindFlags & POST_PROCESS_BIND_RENDER_TARGET){
+		textureDesc.BindFlags |= D3D11_BIND_RENDER_TARGET;
+	}
+	if (desc.bindFlags & POST_PROCESS_BIND_UNORDERED_ACCESS){
+		textureDesc.BindFlags |= D3D11_BIND_UNORDERED_ACCESS;
+	}
+	if (FAILED(device->CreateTexture2D(&textureDesc, NULL, &pooled.texture)) ||
+		FAILED(device->CreateShaderResourceView(pooled.texture, NULL, &pooled.shaderResourceView))){
+		releaseTexture(pooled);
+		return false;
+	}
+	if ((desc.bindFlags & POST_PROCESS_BIND_RENDER_TARGET) && FAILED(device->CreateRenderTargetView(pooled.texture, NULL, &pooled.renderTargetView))){
+		releaseTexture(pooled);
+		return false;
+	}
+	if ((desc.bindFlags & POST_PROCESS_BIND_UNORDERED_ACCESS) && FAILED(device->CreateUnorderedAccessView(pooled.texture, NULL, &pooled.unorderedAccessView))){
+		releaseTexture(pooled);
+		return false;
+	}
+	return true;
+}
+
+void PostProcessChain::releaseTexture(PooledTexture& pooled){
+	ReleaseMacro(pooled.unorderedAccessView);
+	ReleaseMacro(pooled.renderTargetView);
+	ReleaseMacro(pooled.shaderResourceView);
+	ReleaseMacro(pooled.texture);
+}
+
+bool PostProcessChain::resize(uint32_t screenWidth, uint32_t screenHeight){
+	compiled = false;
+	if (!graph.compile(screenWidth, screenHeight)){
+		return false;
+	}
+	width = screenWidth;
+	height = screenHeight;
+
+	//textures the new slots can use are kept, the rest are released
+	std::vector<PooledTexture> previous;
+	previous.swap(pool);
+	bool created = true;
+	for (uint32_t i = 0; i < graph.getSlotCount() && created; i++){
+		const PostProcessSlot& slot = graph.getSlot(i);
+		PooledTexture pooled;
+		bool found = false;
+		for (size_t j = 0; j < previous.size() && !found; j++){
+			const PostProcessSlot& desc = previous[j].desc;
+			if (desc.format == slot.format && desc.width == slot.width && desc.height == slot.height && desc.bindFlags == slot.bindFlags){
+				pooled = previous[j];
+				previous.erase(previous.begin() + j);
+				found = true;
+			}
+		}
+		if (!found){
+			created = createTexture(slot, pooled);
+		}
+		if (created){
+			pool.push_back(pooled);
+		}
+	}
+	for (size_t i = 0; i < previous.size(); i++){
+		releaseTexture(previous[i]);
+	}
+	compiled = created;
+	return compiled;
+}
+
+void PostProcessChain::setViewport(ID3D11DeviceContext* context, uint32_t viewportWidth, uint32_t viewportHeight){
+	D3D11_VIEWPORT viewport;
+	viewport.TopLeftX = 0;
+	viewport.TopLeftY = 0;
+	viewport.Width = (float)viewportWidth;
+	viewport.Height = (float)viewportHeight;
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+	context->RSSetViewports(1, &viewport);
+}
+
+void PostProcessChain::beginScene(ID3D11DeviceContext* context, ID3D11DepthStencilView* depthStencilView){
+	if (!compiled){
+		return;
+	}
+	for (uint32_t p = 0; p < graph.getPassCount(); p++){
+		const PostProcessPass& pass = graph.getPass(p);
+		if (pass.kind == POST_PROCESS_PASS_EXTERNAL && pass.output != POST_PROCESS_BACK_BUFFER){
+			const PostProcessTarget& target = graph.getTarget(pass.output);
+			const float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			context->OMSetRenderTargets(1, &pool[target.slot].renderTargetView, depthStencilView);
+			context->ClearRenderTargetView(pool[target.slot].renderTargetView, color);
+			setViewport(context, target.width, target.height);
+			return;
+		}
+	}
+}
+
+void PostProcessChain::execute(ID3D11DeviceContext* context, ID3D11RenderTargetView* backBuffer, ID3D11DepthStencilView* depthStencilView){
+	if (!compiled){
+		return;
+	}
+	ID3D11SamplerState* linearClamp = sampler->getSamplerState();
+	ID3D11ShaderResourceView* nullViews[POST_PROCESS_MAX_INPUTS] = { 0 };
+	for (uint32_t p = 0; p < graph.getPassCount(); p++){
+		const PostProcessPass& pass = graph.getPass(p);
+		if (pass.kind == POST_PROCESS_PASS_EXTERNAL){
+			continue;
+		}
+		ID3D11ShaderResourceView* inputs[POST_PROCESS_MAX_INPUTS];
+		for (uint32_t i = 0; i < pass.inputCount; i++){
+			inputs[i] = pool[graph.getTarget(pass.inputs[i]).slot].shaderResourceView;
+		}
+		ShaderProgram* program = shaders[pass.shader];
+
+		if (pass.output == POST_PROCESS_BACK_BUFFER){
+			context->OMSetRenderTargets(1, &backBuffer, NULL);
+			setViewport(context, width, height);
+		}
+		else{
+			const PostProcessTarget& output = graph.getTarget(pass.output);
+			context->OMSetRenderTargets(1, &pool[output.slot].renderTargetView, NULL);
+			setViewport(context, output.width, output.height);
+		}
+		//the triangle comes from SV_VertexID, nothing to fetch
+		context->IASetInputLayout(NULL);
+		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context->VSSetShader(program->vertexShader, NULL, 0);
+		context->GSSetShader(NULL, NULL, 0);
+		context->PSSetShader(program->pixelShader, NULL, 0);
+		context->PSSetSamplers(0, 1, &linearClamp);
+		context->PSSetShaderResources(0, pass.inputCount, inputs);
+		context->Draw(3, 0);
+		context->PSSetShaderResources(0, pass.inputCount, nullViews);
+	}
+	context->OMSetRenderTargets(1, &backBuffer, depthStencilView);
+	setViewport(context, width, height);
+}
+
+uint64_t PostProcessChain::getTextureBytes(){
+	return graph.getSlotBytes();
+}
+
+uint64_t PostProcessChain::getTargetBytes(){
+	return graph.getTargetBytes();
+}
@@ -0,0 +1,76 @@
+#ifndef _POSTPROCESSCHAIN_H
+#define _POSTPROCESSCHAIN_H
+
+#include <d3d11.h>
+#include <vector>
+#include <cstdint>
+#include "PostProcessGraph.h"
+#include "ShaderPermutation.h"
+#include "SamplerState.h"
+
+class AssetManager;
+class ShaderProgram;
+
+/**
+*Runs a PostProcessGraph: creates its slots, binds them and draws each pass.
+*Declare the targets and passes, then resize with the screen size, which compiles the graph and
+*takes each slot's texture from a pool kept across resizes, so a texture of the same format and
+*size is reused rather than created again. Every frame beginScene binds the target the external
+*pass writes for the caller to draw into, execute runs the other passes in order.
+*Passes draw one triangle covering the target from SV_VertexID, no vertex or index buffer and
+*no input layout, into a viewport the size of their output. Inputs are sampled bilinearly with
+*clamped coordinates; a copy into a target of half the size is a 2x2 box downsample.
+**/
+class PostProcessChain{
+public:
+	PostProcessChain(ID3D11Device* dev, AssetManager* assetManager);
+	~PostProcessChain(void);
+
+	uint32_t addTarget(PostProcessFormat format, uint32_t divisor);
+	//The pass the caller draws, usually the scene; beginScene binds the first one's output
+	void addScenePass(uint32_t output);
+	//output may be POST_PROCESS_BACK_BUFFER, the render target execute is given
+	void addEffectPass(PostProcessEffect effect, uint32_t output, uint32_t input);
+
+	//Compiles the graph for a width x height back buffer, false if the graph is invalid or a texture can't be made
+	bool resize(uint32_t width, uint32_t height);
+
+	//Binds the scene pass's target with depthStencilView and clears it
+	void beginScene(ID3D11DeviceContext* context, ID3D11DepthStencilView* depthStencilView);
+	//Runs every other pass, then leaves backBuffer and depthStencilView bound with a full screen viewport
+	void execute(ID3D11DeviceContext* context, ID3D11RenderTargetView* backBuffer, ID3D11DepthStencilView* depthStencilView);
+
+	//Bytes of the textures the slots took, and what a texture per target would have taken
+	uint64_t getTextureBytes();
+	uint64_t getTargetBytes();
+
+private:
+	struct PooledTexture{
+		PostProcessSlot desc;
+		ID3D11Texture2D* texture;
+		ID3D11ShaderResourceView* shaderResourceView;
+		ID3D11RenderTargetView* renderTargetView;
+		ID3D11UnorderedAccessView* unorderedAccessView;
+	};
+
+	bool createTexture(const PostProcessSlot& desc, PooledTexture& pooled);
+	void releaseTexture(PooledTexture& pooled);
+	uint32_t getPixelShader(PostProcessEffect effect);
+	void setViewport(ID3D11DeviceContext* context, uint32_t viewportWidth, uint32_t viewportHeight);
+
+	ID3D11Device* device;
+	AssetManager* assets;
+	SamplerState* sampler; // linear, clamped
+	PostProcessGraph graph;
+	std::vector<ShaderProgram*> shaders; // what a pass's shader index refers to, owned by the asset manager's shader cache
+	std::vector<PooledTexture> pool; // one per slot once resized
+	uint32_t width;
+	uint32_t height;
+	bool compiled;
+
+	// Prevent copying.
+	PostProcessChain(PostProcessChain const&);
+	PostProcessChain& operator= (PostProcessChain const&);
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "PostProcessGraph.h"
+
+#define POST_PROCESS_UNUSED 0xFFFFFFFF
+
+PostProcessGraph::PostProcessGraph(void){
+}
+
+void PostProcessGraph::clear(){
+	targets.clear();
+	passes.clear();
+	slots.clear();
+}
+
+uint32_t PostProcessGraph::addTarget(PostProcessFormat format, uint32_t divisor){
+	PostProcessTarget target;
+	target.format = format;
+	target.divisor = divisor;
+	target.width = 0;
+	target.height = 0;
+	target.slot = POST_PROCESS_UNUSED;
+	target.firstPass = POST_PROCESS_UNUSED;
+	target.lastPass = POST_PROCESS_UNUSED;
+	targets.push_back(target);
+	return (uint32_t)targets.size() - 1;
+}
+
+uint32_t PostProcessGraph::addPass(PostProcessPassKind kind, uint32_t shader, uint32_t output, const uint32_t* inputs, uint32_t inputCount){
+	PostProcessPass pass;
+	pass.kind = kind;
+	pass.shader = shader;
+	pass.output = output;
+	pass.inputCount = inputCount < POST_PROCESS_MAX_INPUTS ? inputCount : POST_PROCESS_MAX_INPUTS;
+	for (uint32_t i = 0; i < POST_PROCESS_MAX_INPUTS; i++){
+		pass.inputs[i] = i < pass.inputCount ? inputs[i] : POST_PROCESS_UNUSED;
+	}
+	passes.push_back(pass);
+	return (uint32_t)passes.size() - 1;
+}
+
+bool PostProcessGraph::compile(uint32_t width, uint32_t height){
+	slots.clear();
+	for (size_t i = 0; i < targets.size(); i++){
+		PostProcessTarget& target = targets[i];
+		if (target.divisor != 1 && target.divisor != 2 && target.divisor != 4){
+			return false;
+		}
+		//rounded up so a quarter of an odd size still covers the screen
+		target.width = (width + target.divisor - 1) / target.divisor;
+		target.height = (height + target.divisor - 1) / target.divisor;
+		target.slot = POST_PROCESS_UNUSED;
+		target.firstPass = POST_PROCESS_UNUSED;
+		target.lastPass = POST_PROCESS_UNUSED;
+	}
+
+	//lifetimes, in pass order
+	for (uint32_t p = 0; p < passes.size(); p++){
+		const PostProcessPass& pass = passes[p];
+		for (uint32_t i = 0; i < pass.inputCount; i++){
+			if (pass.inputs[i] >= targets.size() || pass.inputs[i] == pass.output){
+				return false;
+			}
+			PostProcessTarget& input = targets[pass.inputs[i]];
+			if (input.firstPass == POST_PROCESS_UNUSED){
+				return false;
+			}
+			input.lastPass = p;
+		}
+		if (pass.output == POST_PROCESS_BACK_BUFFER){
+			//nothing can be read back out of the back buffer, or written to it from a compute shader
+			if (pass.kind == POST_PROCESS_PASS_COMPUTE){
+				return false;
+			}
+			continue;
+		}
+		if (pass.output >= targets.size() || targets[pass.output].firstPass != POST_PROCESS_UNUSED){
+			return false;
+		}
+		targets[pass.output].firstPass = p;
+	}
+	for (size_t i = 0; i < targets.size(); i++){
+		//declared and never written or never read, either way a texture for nothing
+		if (targets[i].lastPass == POST_PROCESS_UNUSED){
+			return false;
+		}
+	}
+
+	//slots, handed back once the pass after a target's last reader comes round
+	std::vector<uint32_t> freeSlots;
+	std::vector<bool> released(targets.size(), false); // a pass can read a target more than once
+	for (uint32_t p = 0; p < passes.size(); p++){
+		const PostProcessPass& pass = passes[p];
+		if (pass.output != POST_PROCESS_BACK_BUFFER){
+			PostProcessTarget& target = targets[pass.output];
+			uint32_t bindFlags = pass.kind == POST_PROCESS_PASS_COMPUTE ? POST_PROCESS_BIND_UNORDERED_ACCESS : POST_PROCESS_BIND_RENDER_TARGET;
+			for (size_t i = 0; i < freeSlots.size() && target.slot == POST_PROCESS_UNUSED; i++){
+				PostProcessSlot& slot = slots[freeSlots[i]];
+				if (slot.format == target.format && slot.width == target.width && slot.height == target.height){
+					target.slot = freeSlots[i];
+					slot.bindFlags |= bindFlags;
+					freeSlots.erase(freeSlots.begin() + i);
+				}
+			}
+			if (target.slot == POST_PROCESS_UNUSED){
+				PostProcessSlot slot;
+				slot.format = target.format;
+				slot.width = target.width;
+				slot.height = target.height;
+				slot.bindFlags = bindFlags;
+				slots.push_back(slot);
+				target.slot = (uint32_t)slots.size() - 1;
+			}
+		}
+		//only after the output has its slot, so it never lands on one of the pass's own inputs
+		for (uint32_t i = 0; i < pass.inputCount; i++){
+			uint32_t input = pass.inputs[i];
+			if (targets[input].lastPass == p && !released[input]){
+				freeSlots.push_back(targets[input].slot);
+				released[input] = true;
+			}
+		}
+	}
+	return true;
+}
+
+uint32_t PostProcessGraph::getTargetCount(){
+	return (uint32_t)targets.size();
+}
+
+const PostProcessTarget& PostProcessGraph::getTarget(uint32_t i){
+	return targets[i];
+}
+
+uint32_t PostProcessGraph::getPassCount(){
+	return (uint32_t)passes.size();
+}
+
+const PostProcessPass& PostProcessGraph::getPass(uint32_t i){
+	return passes[i];
+}
+
+uint32_t PostProcessGraph::getSlotCount(){
+	return (uint32_t)slots.size();
+}
+
+const PostProcessSlot& PostProcessGraph::getSlot(uint32_t i){
+	return slots[i];
+}
+
+uint64_t PostProcessGraph::getSlotBytes(){
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < slots.size(); i++){
+		bytes += (uint64_t)slots[i].width * slots[i].height * 4;
+	}
+	return bytes;
+}
+
+uint64_t PostProcessGraph::getTargetBytes(){
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < targets.size(); i++){
+		bytes += (uint64_t)targets[i].width * targets[i].height * 4;
+	}
+	return bytes;
+}
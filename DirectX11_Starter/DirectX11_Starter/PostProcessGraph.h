@@ -0,0 +1,91 @@
+#ifndef _POSTPROCESSGRAPH_H
+#define _POSTPROCESSGRAPH_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#define POST_PROCESS_MAX_INPUTS 4
+#define POST_PROCESS_BACK_BUFFER 0xFFFFFFFF // a pass output that is the chain's final target, not a graph target
+#define POST_PROCESS_BIND_RENDER_TARGET 1
+#define POST_PROCESS_BIND_UNORDERED_ACCESS 2
+
+//Every format is 4 bytes a pixel
+enum PostProcessFormat{
+	POST_PROCESS_FORMAT_RGBA8, // DXGI_FORMAT_R8G8B8A8_UNORM, colour that needs alpha
+	POST_PROCESS_FORMAT_R11G11B10 // DXGI_FORMAT_R11G11B10_FLOAT, lit colour past 1 without alpha
+};
+
+enum PostProcessPassKind{
+	POST_PROCESS_PASS_EXTERNAL, // the caller draws into the output, e.g. the scene
+	POST_PROCESS_PASS_PIXEL, // fullscreen triangle into the output as a render target
+	POST_PROCESS_PASS_COMPUTE // dispatch over the output as an unordered access view
+};
+
+//A texture the graph renders to, alive from the pass writing it to the last pass reading it
+struct PostProcessTarget{
+	uint32_t format; // PostProcessFormat
+	uint32_t divisor; // of the graph's size, 1, 2 or 4
+	uint32_t width; // the rest is filled in by compile
+	uint32_t height;
+	uint32_t slot; // the texture it lives in
+	uint32_t firstPass; // the one writing it
+	uint32_t lastPass; // the last one reading it
+};
+
+struct PostProcessPass{
+	uint32_t kind; // PostProcessPassKind
+	uint32_t shader; // the caller's, the graph only carries it
+	uint32_t output; // a target or POST_PROCESS_BACK_BUFFER
+	uint32_t inputs[POST_PROCESS_MAX_INPUTS];
+	uint32_t inputCount;
+};
+
+//One texture, shared by every target whose lifetime it holds
+struct PostProcessSlot{
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t bindFlags; // POST_PROCESS_BIND_*, of every target in it
+};
+
+/**
+*Plans the transient textures of a post-process chain.
+*Targets are declared with a format and a fraction of the screen, passes with the targets they
+*read and the one they write, in the order they run. compile checks every target is written once
+*before it is read and read at least once, then walks the passes keeping a free list: a target
+*takes a free slot of its format and size or a new one, and gives it back after its last reader,
+*so targets whose lifetimes don't overlap share one texture. A pass never writes a slot one of
+*its own inputs is in. No D3D in here, PostProcessChain creates and binds the slots.
+**/
+class PostProcessGraph{
+public:
+	PostProcessGraph(void);
+
+	void clear();
+	//Returns the target's index; divisor is 1 for full, 2 for half, 4 for quarter resolution
+	uint32_t addTarget(PostProcessFormat format, uint32_t divisor);
+	//Returns the pass's index
+	uint32_t addPass(PostProcessPassKind kind, uint32_t shader, uint32_t output, const uint32_t* inputs, uint32_t inputCount);
+
+	//Sizes the targets for a width x height screen and assigns their slots, false if the passes
+	//read a target before or without it being written, write one twice, or leave one unread
+	bool compile(uint32_t width, uint32_t height);
+
+	uint32_t getTargetCount();
+	const PostProcessTarget& getTarget(uint32_t i);
+	uint32_t getPassCount();
+	const PostProcessPass& getPass(uint32_t i);
+	uint32_t getSlotCount();
+	const PostProcessSlot& getSlot(uint32_t i);
+	//Bytes of every slot, and what the targets would take with a texture each
+	uint64_t getSlotBytes();
+	uint64_t getTargetBytes();
+
+private:
+	std::vector<PostProcessTarget> targets;
+	std::vector<PostProcessPass> passes;
+	std::vector<PostProcessSlot> slots;
+};
+
+#endif
@@ -0,0 +1,39 @@
+// Every post process pixel shader (see ShaderPermutation.h)
+// - Compiled once per effect; each PostProcessPixelShader_*.hlsl in Shaders\Permutations
+//   defines EFFECT and includes this, so a pass only computes the effect it shows
+#define EFFECT_COPY 0
+#define EFFECT_GRAYSCALE 1
+#define EFFECT_SEPIA 2
+#define EFFECT_INVERSE 3
+
+#ifndef EFFECT
+#define EFFECT EFFECT_COPY
+#endif
+
+Texture2D myTexture: register(t0);
+SamplerState mySampler: register(s0);
+
+// Defines the input to this pixel shader
+// - Should match the output of our corresponding vertex shader
+struct VertexToPixel
+{
+	float4 position		: SV_POSITION;
+	float2 uv			: TEXCOORD0;
+};
+
+// Entry point for this pixel shader
+float4 main(VertexToPixel input) : SV_TARGET
+{
+	float4 textureColor = myTexture.Sample(mySampler, input.uv);
+
+#if EFFECT == EFFECT_GRAYSCALE
+	float avg = (textureColor.r + textureColor.g + textureColor.b) / 3.0f;
+	return float4(avg, avg, avg, 1);
+#elif EFFECT == EFFECT_SEPIA
+	return float4((textureColor.r * 0.393) + (textureColor.g * 0.769) + (textureColor.b * 0.189), (textureColor.r * 0.349) + (textureColor.g * 0.686) + (textureColor.b * 0.168), (textureColor.r * 0.272) + (textureColor.g * 0.534) + (textureColor.b * 0.131), 1);
+#elif EFFECT == EFFECT_INVERSE
+	return 1.0f - textureColor;
+#else
+	return textureColor;
+#endif
+}
@@ -1,22 +1,18 @@
+// One triangle covering the screen for every post process pass (see PostProcessChain)
+// - Drawn with Draw(3, 0) and no vertex buffer or input layout; the vertex id gives
+//   (-1, 1), (3, 1) and (-1, -3), so the part inside the viewport has uvs 0 to 1
 struct VertexToPixel
 {
 	float4 position		: SV_POSITION;
 	float2 uv		    : TEXCOORD0;
 };
 
-struct VertexInput
-{
-	float3 position : POSITION;
-	float3 normal : NORMAL;
-	float2 uv : TEXCOORD0;
-};
-
-VertexToPixel main(VertexInput input)
+VertexToPixel main(uint id : SV_VertexID)
 {
 	VertexToPixel output;
 
-	output.position = float4(input.position, 1);
-	output.uv = input.uv;
+	output.uv = float2((id << 1) & 2, id & 2);
+	output.position = float4(output.uv * float2(2, -2) + float2(-1, 1), 0, 1);
 
 	return output;
-}
\ No newline at end of file
+}
@@ -1,7 +1,7 @@
 #include "Projectile.h"
 
 //Constructor for Projectile object
-Projectile::Projectile(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference){
+Projectile::Projectile(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference){
 	// set up the lighting
 	lighting.ambientColor = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
 	lighting.diffuseColor = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
@@ -12,8 +12,9 @@ Projectile::Projectile(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<Co
 	device = dev;
 	deviceContext = devCtx;
 	sampler = samplerState;
-	shaderProgram = new ShaderProgram(L"MultiTexVertexShader.cso", L"MultiTexPixelShader.cso", device, constantBufferList);
-	projectileMaterial = new Material(device, deviceContext, sampler, L"bullet.png", shaderProgram);
+	//the player's permutation, bullets have no reflection or mask texture but are lit the same way
+	shaderProgram = assets->getMeshShaderProgram(MESH_SHADER_LIT | MESH_SHADER_MULTI_TEXTURE | MESH_SHADER_ALPHA_MAP | (meshReference->quantized ? MESH_SHADER_PACKED : 0), constantBufferList);
+	projectileMaterial = new Material(assets, sampler, L"bullet.png", shaderProgram);
 	player = playerReference;
 	mesh = meshReference;
 }
@@ -29,10 +30,6 @@ Projectile::~Projectile(){
 		delete projectileMaterial;
 		projectileMaterial = nullptr;
 	}
-	if (shaderProgram){
-		delete shaderProgram;
-		shaderProgram = nullptr;
-	}
 }
 
 
@@ -77,21 +74,50 @@ void Projectile::fireProjectile()
 }
 
 //draw projectiles
-void Projectile::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos){
+void Projectile::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context){
+	//only submit what the camera can see
+	culler.setCamera(viewMatrix, projectionMatrix);
+	culler.clear();
 	for (unsigned int i = 0; i < projectiles.size(); i++){
+		XMFLOAT3 center;
+		float radius;
+		projectiles[i]->getBoundingSphere(center, radius);
+		culler.add(center, radius);
+	}
+	culler.cull();
+
+	//pick a level for each visible projectile from its size on screen, then draw them grouped by level
+	D3D11_VIEWPORT viewport;
+	UINT viewportCount = 1;
+	context->RSGetViewports(&viewportCount, &viewport);
+	lodSelector.setCamera(viewMatrix, projectionMatrix, viewportCount > 0 ? viewport.Height : 0.0f);
+	lodSelector.clear();
+	for (unsigned int v = 0; v < culler.getVisibleCount(); v++){
+		unsigned int i = culler.getVisible(v);
+		XMFLOAT3 center;
+		float radius;
+		projectiles[i]->getBoundingSphere(center, radius);
+		lodSelector.add(i, projectiles[i]->g_mesh, center, radius);
+	}
+	lodSelector.group();
+
+	for (unsigned int v = 0; v < lodSelector.getCount(); v++){
+		unsigned int i = lodSelector.getEntity(v);
+		const MeshLod& level = projectiles[i]->g_mesh->lods[lodSelector.getLod(v)];
 		// projectiles are scaled to 50% size so that they are not as large as the player ship
 		projectiles[i]->scale(XMFLOAT3(0.5f, 0.5f, 0.5f));
 		// The projectile is moved to compensate for the scaling operation (that would change its location)
 		projectiles[i]->setPosition(XMFLOAT3(projectiles[i]->getPosition()._41 * 2, projectiles[i]->getPosition()._42 * 2, 0.0f));
 		UINT offset = 0;
 		UINT stride = projectiles[i]->g_mesh->sizeofvertex;
-		deviceContext->IASetInputLayout(projectiles[i]->g_mat->shaderProgram->vsInputLayout);
-		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context->IASetInputLayout(projectiles[i]->g_mat->shaderProgram->vsInputLayout);
+		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 		//set values that get passed to matrix constant buffer
-		projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = projectiles[i]->getWorld();
+		projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = projectiles[i]->getDrawWorld();
 		projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
 		projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+		projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = projectiles[i]->g_mat->uvTransform;
 
 		//set values that get passed to lighting constant buffer
 		projectiles[i]->g_mat->shaderProgram->ConstantBuffers[1]->dataToSendToLightBuffer.ambientColor = lighting.ambientColor;
@@ -104,7 +130,7 @@ void Projectile::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOA
 		projectiles[i]->g_mat->shaderProgram->ConstantBuffers[2]->dataToSendToCameraBuffer.padding = 1.0f;
 
 		//matrix constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer,
 			0,
 			NULL,
@@ -113,7 +139,7 @@ void Projectile::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOA
 			0);
 
 		//camera constant buffer 
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			projectiles[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer,
 			0,
 			NULL,
@@ -121,7 +147,7 @@ void Projectile::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOA
 			0,
 			0);
 		//light constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			projectiles[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer,
 			0,
 			NULL,
@@ -129,25 +155,25 @@ void Projectile::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOA
 			0,
 			0);
 
-		deviceContext->IASetVertexBuffers(0, 1, &projectiles[i]->g_mesh->v_buffer, &stride, &offset);
-		deviceContext->IASetIndexBuffer(projectiles[i]->g_mesh->i_buffer, DXGI_FORMAT_R32_UINT, 0);
+		context->IASetVertexBuffers(0, 1, &projectiles[i]->g_mesh->v_buffer, &stride, &offset);
+		context->IASetIndexBuffer(projectiles[i]->g_mesh->i_buffer, projectiles[i]->g_mesh->indexFormat, 0);
 
-		deviceContext->PSSetSamplers(0, 1, &projectiles[i]->g_mat->samplerState);
-		deviceContext->PSSetShaderResources(1, 1, &projectiles[i]->g_mat->resourceView);
+		context->PSSetSamplers(0, 1, &projectiles[i]->g_mat->samplerState);
+		context->PSSetShaderResources(1, 1, &projectiles[i]->g_mat->resourceView);
 
 
 
 		// Set the current vertex and pixel shaders, as well the constant buffer for the vert shader
-		deviceContext->VSSetShader(projectiles[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
-		deviceContext->VSSetConstantBuffers(0, 1, &projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
-		deviceContext->VSSetConstantBuffers(1, 1, &projectiles[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
-		deviceContext->PSSetShader(projectiles[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
-		deviceContext->PSSetConstantBuffers(0, 1, &projectiles[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
+		context->VSSetShader(projectiles[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
+		context->VSSetConstantBuffers(0, 1, &projectiles[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
+		context->VSSetConstantBuffers(1, 1, &projectiles[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
+		context->PSSetShader(projectiles[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
+		context->PSSetConstantBuffers(0, 1, &projectiles[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
 
 		// Finally do the actual drawing
-		deviceContext->DrawIndexed(
-			projectiles[i]->g_mesh->m_size,	// The number of indices we're using in this draw
-			0,
+		context->DrawIndexed(
+			level.indexCount,	// The number of indices we're using in this draw
+			level.firstIndex,
 			0);
 		// Move the projectile back to the position it was at before we compensated for the scaling operation.
 		projectiles[i]->setPosition(XMFLOAT3(projectiles[i]->getPosition()._41 / 2, projectiles[i]->getPosition()._42 / 2, 0.0f));
@@ -155,3 +181,7 @@ void Projectile::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOA
 		projectiles[i]->scale(XMFLOAT3(2.0f, 2.0f, 2.0f));
 	}
 }
+
+CullStats Projectile::getCullStats(){
+	return culler.getStats();
+}
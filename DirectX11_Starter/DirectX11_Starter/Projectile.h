@@ -7,6 +7,7 @@
 #include "Mesh.h"
 #include "GameEntity.h"
 #include "Material.h"
+#include "AssetManager.h"
 #include "ShaderProgram.h"
 #include "SamplerState.h"
 #include "Global.h"
@@ -14,13 +15,16 @@
 #include "StateManager.h"
 #include "FW1FontWrapper.h"
 #include "Player.h"
+#include "FrustumCuller.h"
+#include "LodSelector.h"
 
 class Projectile{
 public:
-	Projectile(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference);
+	Projectile(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference);
 	~Projectile(void);
 	void update(float dt);
-	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos);
+	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context);
+	CullStats getCullStats(); // visible/culled counts from the last draw
 	GameEntity* getProjectile();
 
 	// list of projectiles present in the game
@@ -29,6 +33,8 @@ public:
 	// fires a projectile in response to user input (current the 'q' key)
 	void fireProjectile();
 private:
+	FrustumCuller culler;
+	LodSelector lodSelector;
 	Player* player;
 	Mesh* mesh;
 	ShaderProgram* shaderProgram;
@@ -20,6 +20,7 @@ SamplerState::~SamplerState(void){
 **/
 void SamplerState::createSamplerState(ID3D11Device* dev, D3D11_TEXTURE_ADDRESS_MODE mode, D3D11_FILTER filter, float MaxLOD, float MinLOD, float MipLODBias, UINT MaxAnisotropy){
 	D3D11_SAMPLER_DESC desc;
+	ZeroMemory(&desc, sizeof(desc));
 	desc.AddressU = mode;
 	desc.AddressV = mode;
 	desc.AddressW = mode;
@@ -28,15 +29,16 @@ void SamplerState::createSamplerState(ID3D11Device* dev, D3D11_TEXTURE_ADDRESS_M
 	desc.MinLOD = MinLOD;
 	desc.MipLODBias = MipLODBias;
 	desc.MaxAnisotropy = MaxAnisotropy;
+	desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
 	dev->CreateSamplerState(&desc, &sampler);
 }
 
 /**
 *Create a Sample State for textures
-*Overload with default float values
+*Overload with default float values, every mip is available
 **/
 void SamplerState::createSamplerState(ID3D11Device* dev, D3D11_TEXTURE_ADDRESS_MODE mode, D3D11_FILTER filter){
-	createSamplerState(dev, mode, filter, 0, 0, 0, 0);
+	createSamplerState(dev, mode, filter, D3D11_FLOAT32_MAX, 0, 0, SAMPLER_MAX_ANISOTROPY);
 }
 
 /**
@@ -44,7 +46,7 @@ void SamplerState::createSamplerState(ID3D11Device* dev, D3D11_TEXTURE_ADDRESS_M
 *Overload with default float values and default filter and texture mode settings
 **/
 void SamplerState::createSamplerState(ID3D11Device* dev){
-	createSamplerState(dev, D3D11_TEXTURE_ADDRESS_WRAP, D3D11_FILTER_ANISOTROPIC, 0, 0, 0, 0);
+	createSamplerState(dev, D3D11_TEXTURE_ADDRESS_WRAP, D3D11_FILTER_ANISOTROPIC, D3D11_FLOAT32_MAX, 0, 0, SAMPLER_MAX_ANISOTROPY);
 }
 
 ID3D11SamplerState* SamplerState::getSamplerState()
@@ -2,6 +2,8 @@
 #define _SAMPLERSTATE_H
 #include <d3d11.h>
 
+#define SAMPLER_MAX_ANISOTROPY 8 // the anisotropic filter needs 1 to 16, 0 is rejected
+
 class SamplerState{
 public:
 	ID3D11SamplerState* sampler;
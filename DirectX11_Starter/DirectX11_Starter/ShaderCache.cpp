@@ -0,0 +1,217 @@
+#include "ShaderCache.h"
+#include "AssetStamp.h"
+#include "Global.h"
+#include <cstring>
+
+ShaderCache::ShaderCache(ID3D11Device* dev){
+	device = dev;
+	packView.header = nullptr;
+	packView.entries = nullptr;
+	packView.elements = nullptr;
+	packView.data = nullptr;
+	fileReads = 0;
+}
+
+ShaderCache::~ShaderCache(void){
+	//programs first, they hold references to the objects below
+	for (std::map<std::vector<uint64_t>, ShaderProgram*>::iterator it = programs.begin(); it != programs.end(); ++it){
+		delete it->second;
+	}
+	for (std::unordered_map<uint64_t, ID3D11DeviceChild*>::iterator it = shaders.begin(); it != shaders.end(); ++it){
+		ReleaseMacro(it->second);
+	}
+	for (std::unordered_map<uint64_t, ID3D11InputLayout*>::iterator it = inputLayouts.begin(); it != inputLayouts.end(); ++it){
+		ReleaseMacro(it->second);
+	}
+}
+
+bool ShaderCache::loadPack(const std::string& manifestPath){
+	if (pack.isOpen()){
+		return false;
+	}
+	if (!OpenCookedShaderPack(manifestPath, pack, packView)){
+		return false;
+	}
+	for (uint32_t i = 0; i < packView.header->shaderCount; i++){
+		std::string path = GetManifestSourcePath(manifestPath, packView.entries[i].name);
+		packEntries[NormaliseAssetPath(path.c_str())] = i;
+	}
+	return true;
+}
+
+bool ShaderCache::findBytecode(const std::string& path, Bytecode& bytecode){
+	std::string normalised = NormaliseAssetPath(path.c_str());
+	std::unordered_map<std::string, uint32_t>::iterator packed = packEntries.find(normalised);
+	if (packed != packEntries.end()){
+		const ShaderPackEntry& entry = packView.entries[packed->second];
+		bytecode.data = packView.data + entry.offset;
+		bytecode.size = entry.size;
+		bytecode.hash = entry.hash;
+		bytecode.stage = entry.stage;
+		bytecode.inputs = packView.elements + entry.firstElement;
+		bytecode.inputCount = entry.elementCount;
+		return true;
+	}
+
+	//not cooked, the .cso is read and its signature read here, the way the cooker does
+	std::unordered_map<std::string, LooseShader>::iterator found = looseShaders.find(normalised);
+	if (found == looseShaders.end()){
+		MappedFile mapped;
+		if (!mapped.open(path) || mapped.size() == 0){
+			return false;
+		}
+		fileReads++;
+		LooseShader loose;
+		loose.bytecode.assign(mapped.data(), mapped.data() + mapped.size());
+		if (!ReadShaderBytecode(&loose.bytecode[0], loose.bytecode.size(), loose.stage, loose.inputs)){
+			return false;
+		}
+		loose.hash = HashAssetBytes(&loose.bytecode[0], loose.bytecode.size());
+		found = looseShaders.insert(std::make_pair(normalised, loose)).first;
+	}
+	const LooseShader& loose = found->second;
+	bytecode.data = &loose.bytecode[0];
+	bytecode.size = loose.bytecode.size();
+	bytecode.hash = loose.hash;
+	bytecode.stage = loose.stage;
+	bytecode.inputs = loose.inputs.empty() ? nullptr : &loose.inputs[0];
+	bytecode.inputCount = (uint32_t)loose.inputs.size();
+	return true;
+}
+
+ID3D11DeviceChild* ShaderCache::getShader(const std::string& path, ShaderKind kind, Bytecode& bytecode){
+	static const uint32_t stages[] = { SHADER_STAGE_VERTEX, SHADER_STAGE_PIXEL, SHADER_STAGE_GEOMETRY, SHADER_STAGE_GEOMETRY };
+	if (!findBytecode(path, bytecode) || bytecode.stage != stages[kind]){
+		return nullptr;
+	}
+	uint64_t key[] = { bytecode.hash, (uint64_t)kind };
+	uint64_t shaderKey = HashAssetBytes(key, sizeof(key));
+	std::unordered_map<uint64_t, ID3D11DeviceChild*>::iterator found = shaders.find(shaderKey);
+	if (found != shaders.end()){
+		return found->second;
+	}
+
+	ID3D11DeviceChild* shader = nullptr;
+	if (kind == SHADER_KIND_VERTEX){
+		ID3D11VertexShader* vs = nullptr;
+		device->CreateVertexShader(bytecode.data, bytecode.size, NULL, &vs);
+		shader = vs;
+	}
+	else if (kind == SHADER_KIND_PIXEL){
+		ID3D11PixelShader* ps = nullptr;
+		device->CreatePixelShader(bytecode.data, bytecode.size, NULL, &ps);
+		shader = ps;
+	}
+	else if (kind == SHADER_KIND_GEOMETRY){
+		ID3D11GeometryShader* gs = nullptr;
+		device->CreateGeometryShader(bytecode.data, bytecode.size, NULL, &gs);
+		shader = gs;
+	}
+	else{
+		D3D11_SO_DECLARATION_ENTRY desc[] =
+		{
+			{ 0, "SV_POSITION", 0, 0, 4, 0 },
+			{ 0, "TEXCOORD0", 0, 0, 2, 0 },
+			{ 0, "TEXCOORD1", 1, 0, 2, 0 }
+		};
+		ID3D11GeometryShader* so = nullptr;
+		device->CreateGeometryShaderWithStreamOutput(bytecode.data, bytecode.size, desc, 1, NULL, 0, 0, NULL, &so);
+		shader = so;
+	}
+	if (!shader){
+		return nullptr;
+	}
+	shaders[shaderKey] = shader;
+	return shader;
+}
+
+ID3D11InputLayout* ShaderCache::getInputLayout(const Bytecode& vs, const MeshFileElement* layout, uint32_t layoutCount){
+	if (layoutCount == 0){
+		return nullptr;
+	}
+	//the elements are plain bytes, zero padded names included
+	std::vector<uint64_t> key(1 + (layoutCount * sizeof(MeshFileElement) + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+	key[0] = vs.hash;
+	memcpy(&key[1], layout, layoutCount * sizeof(MeshFileElement));
+	uint64_t layoutKey = HashAssetBytes(&key[0], key.size() * sizeof(uint64_t));
+	std::unordered_map<uint64_t, ID3D11InputLayout*>::iterator found = inputLayouts.find(layoutKey);
+	if (found != inputLayouts.end()){
+		return found->second;
+	}
+
+	std::vector<D3D11_INPUT_ELEMENT_DESC> inputLayoutDesc(layoutCount);
+	for (uint32_t i = 0; i < layoutCount; i++){
+		inputLayoutDesc[i].SemanticName = layout[i].semantic;
+		inputLayoutDesc[i].SemanticIndex = layout[i].semanticIndex;
+		inputLayoutDesc[i].Format = (DXGI_FORMAT)layout[i].format;
+		inputLayoutDesc[i].InputSlot = 0;
+		inputLayoutDesc[i].AlignedByteOffset = layout[i].offset;
+		inputLayoutDesc[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		inputLayoutDesc[i].InstanceDataStepRate = 0;
+	}
+	ID3D11InputLayout* inputLayout = nullptr;
+	if (FAILED(device->CreateInputLayout(&inputLayoutDesc[0], layoutCount, vs.data, vs.size, &inputLayout))){
+		return nullptr;
+	}
+	inputLayouts[layoutKey] = inputLayout;
+	return inputLayout;
+}
+
+ShaderProgram* ShaderCache::getProgram(const std::string& vsPath, const std::string& psPath, const std::string* gsPath, const std::string* soPath,
+	const std::vector<ConstantBuffer*>& constantBufferList, const MeshFileElement* layout, uint32_t layoutCount){
+	Bytecode vsBytecode;
+	Bytecode bytecode;
+	ID3D11VertexShader* vs = static_cast<ID3D11VertexShader*>(getShader(vsPath, SHADER_KIND_VERTEX, vsBytecode));
+	ID3D11PixelShader* ps = static_cast<ID3D11PixelShader*>(getShader(psPath, SHADER_KIND_PIXEL, bytecode));
+	ID3D11GeometryShader* gs = gsPath ? static_cast<ID3D11GeometryShader*>(getShader(*gsPath, SHADER_KIND_GEOMETRY, bytecode)) : nullptr;
+	ID3D11GeometryShader* so = soPath ? static_cast<ID3D11GeometryShader*>(getShader(*soPath, SHADER_KIND_STREAM_OUTPUT, bytecode)) : nullptr;
+	ID3D11InputLayout* inputLayout = nullptr;
+	if (vs){
+		inputLayout = layout ? getInputLayout(vsBytecode, layout, layoutCount) : getInputLayout(vsBytecode, vsBytecode.inputs, vsBytecode.inputCount);
+	}
+
+	std::vector<uint64_t> key;
+	key.push_back((uint64_t)(uintptr_t)vs);
+	key.push_back((uint64_t)(uintptr_t)ps);
+	key.push_back((uint64_t)(uintptr_t)gs);
+	key.push_back((uint64_t)(uintptr_t)so);
+	key.push_back((uint64_t)(uintptr_t)inputLayout);
+	for (size_t i = 0; i < constantBufferList.size(); i++){
+		key.push_back((uint64_t)(uintptr_t)constantBufferList[i]);
+	}
+	std::map<std::vector<uint64_t>, ShaderProgram*>::iterator found = programs.find(key);
+	if (found != programs.end()){
+		return found->second;
+	}
+	ShaderProgram* program = new ShaderProgram(vs, ps, gs, so, inputLayout, constantBufferList);
+	programs[key] = program;
+	return program;
+}
+
+ShaderProgram* ShaderCache::getProgram(const std::string& vsPath, const std::string& psPath, const std::vector<ConstantBuffer*>& constantBufferList){
+	return getProgram(vsPath, psPath, nullptr, nullptr, constantBufferList, nullptr, 0);
+}
+
+ShaderProgram* ShaderCache::getProgram(const std::string& vsPath, const std::string& psPath, const std::vector<ConstantBuffer*>& constantBufferList, const MeshFileElement* layout, uint32_t layoutCount){
+	return getProgram(vsPath, psPath, nullptr, nullptr, constantBufferList, layout, layoutCount);
+}
+
+ShaderProgram* ShaderCache::getProgram(const std::string& vsPath, const std::string& psPath, const std::string& gsPath, const std::string& soPath, const std::vector<ConstantBuffer*>& constantBufferList){
+	return getProgram(vsPath, psPath, &gsPath, &soPath, constantBufferList, nullptr, 0);
+}
+
+unsigned int ShaderCache::getShaderCount(){
+	return (unsigned int)shaders.size();
+}
+
+unsigned int ShaderCache::getInputLayoutCount(){
+	return (unsigned int)inputLayouts.size();
+}
+
+unsigned int ShaderCache::getProgramCount(){
+	return (unsigned int)programs.size();
+}
+
+unsigned int ShaderCache::getFileReadCount(){
+	return fileReads;
+}
@@ -0,0 +1,91 @@
+#ifndef _SHADERCACHE_H
+#define _SHADERCACHE_H
+
+#include <d3d11.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <cstdint>
+#include "ShaderProgram.h"
+#include "ShaderPackFile.h"
+#include "MappedFile.h"
+
+/**
+*Creates each distinct shader and input layout once and builds ShaderPrograms out of them.
+*Bytecode comes from the cooked shader pack once loadPack has mapped it, with each vertex
+*shader's input layout already read from its signature; a shader the pack doesn't have is read
+*from its .cso and its signature read the same way, so nothing is reflected at runtime.
+*Shader objects are keyed by a hash of their bytecode, so names compiled to the same code share
+*one. Programs also carry their constant buffers, so each list of those gets its own program
+*over the shared objects. The cache owns every program it hands out.
+*Paths are normalised (see NormaliseAssetPath).
+**/
+class ShaderCache{
+public:
+	ShaderCache(ID3D11Device* dev);
+	~ShaderCache(void);
+
+	//Maps the cooked pack for a .pipeline manifest, false unless it is current. The pack stays
+	//mapped until the cache goes, shaders are only created from it as programs ask for them
+	bool loadPack(const std::string& manifestPath);
+
+	//Input layout from the vertex shader's signature
+	ShaderProgram* getProgram(const std::string& vsPath, const std::string& psPath, const std::vector<ConstantBuffer*>& constantBufferList);
+	//Input layout from a cooked vertex layout, for formats the signature can't describe, e.g. unorm positions read as float4
+	ShaderProgram* getProgram(const std::string& vsPath, const std::string& psPath, const std::vector<ConstantBuffer*>& constantBufferList, const MeshFileElement* layout, uint32_t layoutCount);
+	//Particles: gsPath draws, soPath is created with stream output
+	ShaderProgram* getProgram(const std::string& vsPath, const std::string& psPath, const std::string& gsPath, const std::string& soPath, const std::vector<ConstantBuffer*>& constantBufferList);
+
+	unsigned int getShaderCount(); // distinct shader objects
+	unsigned int getInputLayoutCount();
+	unsigned int getProgramCount();
+	unsigned int getFileReadCount(); // .cso files read because no pack had them
+
+private:
+	enum ShaderKind{
+		SHADER_KIND_VERTEX,
+		SHADER_KIND_PIXEL,
+		SHADER_KIND_GEOMETRY,
+		SHADER_KIND_STREAM_OUTPUT
+	};
+
+	//Bytecode and what was read from it, in the pack's mapping or a LooseShader
+	struct Bytecode{
+		const char* data;
+		size_t size;
+		uint64_t hash;
+		uint32_t stage;
+		const MeshFileElement* inputs;
+		uint32_t inputCount;
+	};
+
+	struct LooseShader{
+		std::vector<char> bytecode;
+		std::vector<MeshFileElement> inputs;
+		uint64_t hash;
+		uint32_t stage;
+	};
+
+	bool findBytecode(const std::string& path, Bytecode& bytecode);
+	ID3D11DeviceChild* getShader(const std::string& path, ShaderKind kind, Bytecode& bytecode);
+	ID3D11InputLayout* getInputLayout(const Bytecode& vs, const MeshFileElement* layout, uint32_t layoutCount);
+	ShaderProgram* getProgram(const std::string& vsPath, const std::string& psPath, const std::string* gsPath, const std::string* soPath,
+		const std::vector<ConstantBuffer*>& constantBufferList, const MeshFileElement* layout, uint32_t layoutCount);
+
+	ID3D11Device* device;
+	MappedFile pack;
+	ShaderPackView packView;
+	std::unordered_map<std::string, uint32_t> packEntries; // normalised path to entry
+	std::unordered_map<std::string, LooseShader> looseShaders; // by normalised path
+	std::unordered_map<uint64_t, ID3D11DeviceChild*> shaders; // by bytecode hash and kind
+	std::unordered_map<uint64_t, ID3D11InputLayout*> inputLayouts; // by vertex shader hash and elements
+	std::map<std::vector<uint64_t>, ShaderProgram*> programs; // by the objects and constant buffers they hold
+	unsigned int fileReads;
+
+	// Prevent copying.
+	ShaderCache(ShaderCache const&);
+	ShaderCache& operator= (ShaderCache const&);
+};
+
+#endif
@@ -0,0 +1,386 @@
+#include "ShaderPackFile.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+static_assert(sizeof(ShaderPackHeader) == 48, "ShaderPackHeader is read in place");
+static_assert(sizeof(ShaderPackEntry) == 120, "ShaderPackEntry is read in place");
+
+#define DXBC_MAGIC 0x43425844 // "DXBC"
+#define DXBC_HEADER_SIZE 32 // magic, 16 byte checksum, version, total size, chunk count
+#define DXBC_SHDR 0x52444853 // "SHDR", shader model 4 program
+#define DXBC_SHEX 0x58454853 // "SHEX", shader model 5 program
+#define DXBC_ISGN 0x4E475349 // "ISGN", input signature
+#define DXBC_ISG1 0x31475349 // "ISG1", input signature with stream and min precision
+#define DXBC_SIGNATURE_ELEMENT 24 // bytes per ISGN parameter
+#define DXBC_SIGNATURE_ELEMENT1 32 // bytes per ISG1 parameter
+#define DXBC_RDEF 0x46454452 // "RDEF", resource definitions
+#define RDEF_HEADER_SIZE 28 // shader model 5 adds a header of its own after this, found through the offsets
+#define RDEF_BINDING_SIZE 32
+#define RDEF_BUFFER_SIZE 24
+#define RDEF_VARIABLE_SIZE 24
+#define RDEF_VARIABLE_SIZE5 40 // shader model 5 adds texture and sampler ranges
+#define RDEF_TYPE_SIZE 16 // the part shader model 4 and 5 share
+#define RDEF_BINDING_CBUFFER 0 // D3D_SIT_CBUFFER
+#define RDEF_BUFFER_CBUFFER 0 // D3D_CT_CBUFFER, rather than a tbuffer
+
+//D3D_REGISTER_COMPONENT_TYPE
+#define SIGNATURE_UINT32 1
+#define SIGNATURE_SINT32 2
+#define SIGNATURE_FLOAT32 3
+
+struct DxbcChunk{
+	uint32_t fourCC;
+	uint32_t size;
+	const uint8_t* data;
+};
+
+static uint32_t ReadUint(const uint8_t* bytes){
+	uint32_t value;
+	memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+static uint16_t ReadShort(const uint8_t* bytes){
+	uint16_t value;
+	memcpy(&value, bytes, sizeof(value));
+	return value;
+}
+
+//The DXGI_FORMAT for components 32-bit values of type, as the input assembler reads them
+static uint32_t GetSignatureFormat(uint32_t type, unsigned int components){
+	//DXGI_FORMAT_R32G32B32A32_*, R32G32B32_*, R32G32_*, R32_*; uint, sint then float
+	static const uint32_t formats[4][3] = {
+		{ 42, 43, 41 },
+		{ 17, 18, 16 },
+		{ 7, 8, 6 },
+		{ 3, 4, 2 }
+	};
+	if (components < 1 || components > 4 || type < SIGNATURE_UINT32 || type > SIGNATURE_FLOAT32){
+		return 0;
+	}
+	return formats[components - 1][type - SIGNATURE_UINT32];
+}
+
+static bool ReadSignature(const uint8_t* chunk, uint32_t chunkSize, uint32_t elementSize, std::vector<MeshFileElement>& inputs){
+	if (chunkSize < 8){
+		return false;
+	}
+	uint32_t count = ReadUint(chunk);
+	if (8 + (uint64_t)count * elementSize > chunkSize){
+		return false;
+	}
+	for (uint32_t i = 0; i < count; i++){
+		//ISG1 puts the stream first and the min precision last, the rest is the same
+		const uint8_t* element = chunk + 8 + i * elementSize + (elementSize == DXBC_SIGNATURE_ELEMENT1 ? 4 : 0);
+		uint32_t nameOffset = ReadUint(element);
+		uint32_t semanticIndex = ReadUint(element + 4);
+		uint32_t systemValue = ReadUint(element + 8);
+		uint32_t type = ReadUint(element + 12);
+		uint8_t mask = element[20];
+		if (systemValue != 0){
+			continue; // SV_VertexID and the like come from the input assembler, not a buffer
+		}
+		if (nameOffset >= chunkSize){
+			return false;
+		}
+		const char* name = reinterpret_cast<const char*>(chunk + nameOffset);
+		size_t nameLength = strnlen(name, chunkSize - nameOffset);
+		unsigned int components = mask >= 8 ? 4 : mask >= 4 ? 3 : mask >= 2 ? 2 : 1;
+		MeshFileElement input;
+		memset(&input, 0, sizeof(input));
+		input.format = GetSignatureFormat(type, components);
+		if (nameLength == chunkSize - nameOffset || nameLength >= sizeof(input.semantic) || input.format == 0){
+			return false;
+		}
+		memcpy(input.semantic, name, nameLength);
+		input.semanticIndex = semanticIndex;
+		input.offset = SHADER_APPEND_ALIGNED;
+		inputs.push_back(input);
+	}
+	return true;
+}
+
+//Checks the container and that every chunk lies inside it
+static bool ReadChunks(const void* data, size_t size, std::vector<DxbcChunk>& chunks){
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	if (!bytes || size < DXBC_HEADER_SIZE || ReadUint(bytes) != DXBC_MAGIC || ReadUint(bytes + 24) != size){
+		return false;
+	}
+	uint32_t chunkCount = ReadUint(bytes + 28);
+	if (DXBC_HEADER_SIZE + (uint64_t)chunkCount * 4 > size){
+		return false;
+	}
+	for (uint32_t i = 0; i < chunkCount; i++){
+		uint32_t offset = ReadUint(bytes + DXBC_HEADER_SIZE + i * 4);
+		if ((uint64_t)offset + 8 > size){
+			return false;
+		}
+		DxbcChunk chunk;
+		chunk.fourCC = ReadUint(bytes + offset);
+		chunk.size = ReadUint(bytes + offset + 4);
+		chunk.data = bytes + offset + 8;
+		if ((uint64_t)offset + 8 + chunk.size > size){
+			return false;
+		}
+		chunks.push_back(chunk);
+	}
+	return true;
+}
+
+bool ReadShaderBytecode(const void* data, size_t size, uint32_t& stage, std::vector<MeshFileElement>& inputs){
+	inputs.clear();
+	std::vector<DxbcChunk> chunks;
+	if (!ReadChunks(data, size, chunks)){
+		return false;
+	}
+
+	const uint8_t* signature = nullptr;
+	uint32_t signatureSize = 0;
+	uint32_t elementSize = 0;
+	bool program = false;
+	for (size_t i = 0; i < chunks.size(); i++){
+		uint32_t fourCC = chunks[i].fourCC;
+		uint32_t chunkSize = chunks[i].size;
+		const uint8_t* chunk = chunks[i].data;
+		if ((fourCC == DXBC_SHDR || fourCC == DXBC_SHEX) && chunkSize >= 4){
+			//the version token's top half is the program type
+			stage = ReadUint(chunk) >> 16;
+			program = true;
+		}
+		else if (fourCC == DXBC_ISGN || fourCC == DXBC_ISG1){
+			signature = chunk;
+			signatureSize = chunkSize;
+			elementSize = fourCC == DXBC_ISGN ? DXBC_SIGNATURE_ELEMENT : DXBC_SIGNATURE_ELEMENT1;
+		}
+	}
+	if (!program || stage > SHADER_STAGE_COMPUTE){
+		return false;
+	}
+	if (stage == SHADER_STAGE_VERTEX && signature){
+		return ReadSignature(signature, signatureSize, elementSize, inputs);
+	}
+	return true;
+}
+
+//A zero terminated string at offset in chunk, false if it runs off the end
+static bool ReadChunkString(const uint8_t* chunk, uint32_t chunkSize, uint32_t offset, std::string& text){
+	if (offset >= chunkSize){
+		return false;
+	}
+	const char* name = reinterpret_cast<const char*>(chunk + offset);
+	size_t length = strnlen(name, chunkSize - offset);
+	if (length == chunkSize - offset){
+		return false;
+	}
+	text.assign(name, length);
+	return true;
+}
+
+static bool ReadResourceDefinitions(const uint8_t* chunk, uint32_t chunkSize, std::vector<ShaderConstantBuffer>& buffers){
+	if (chunkSize < RDEF_HEADER_SIZE){
+		return false;
+	}
+	uint32_t bufferCount = ReadUint(chunk);
+	uint32_t bufferOffset = ReadUint(chunk + 4);
+	uint32_t bindingCount = ReadUint(chunk + 8);
+	uint32_t bindingOffset = ReadUint(chunk + 12);
+	uint32_t variableSize = chunk[17] >= 5 ? RDEF_VARIABLE_SIZE5 : RDEF_VARIABLE_SIZE; // major version
+	if ((uint64_t)bufferOffset + (uint64_t)bufferCount * RDEF_BUFFER_SIZE > chunkSize ||
+		(uint64_t)bindingOffset + (uint64_t)bindingCount * RDEF_BINDING_SIZE > chunkSize){
+		return false;
+	}
+
+	for (uint32_t i = 0; i < bufferCount; i++){
+		const uint8_t* desc = chunk + bufferOffset + i * RDEF_BUFFER_SIZE;
+		if (ReadUint(desc + 20) != RDEF_BUFFER_CBUFFER){
+			continue;
+		}
+		ShaderConstantBuffer buffer;
+		uint32_t variableCount = ReadUint(desc + 4);
+		uint32_t variableOffset = ReadUint(desc + 8);
+		buffer.size = ReadUint(desc + 12);
+		buffer.slot = SHADER_SLOT_UNBOUND;
+		if (!ReadChunkString(chunk, chunkSize, ReadUint(desc), buffer.name) ||
+			(uint64_t)variableOffset + (uint64_t)variableCount * variableSize > chunkSize){
+			return false;
+		}
+		for (uint32_t j = 0; j < bindingCount; j++){
+			const uint8_t* binding = chunk + bindingOffset + j * RDEF_BINDING_SIZE;
+			std::string name;
+			if (ReadUint(binding + 4) == RDEF_BINDING_CBUFFER && ReadChunkString(chunk, chunkSize, ReadUint(binding), name) && name == buffer.name){
+				buffer.slot = ReadUint(binding + 20);
+			}
+		}
+		for (uint32_t j = 0; j < variableCount; j++){
+			const uint8_t* variableDesc = chunk + variableOffset + j * variableSize;
+			ShaderVariable variable;
+			variable.offset = ReadUint(variableDesc + 4);
+			variable.size = ReadUint(variableDesc + 8);
+			uint32_t typeOffset = ReadUint(variableDesc + 16);
+			if (!ReadChunkString(chunk, chunkSize, ReadUint(variableDesc), variable.name) || (uint64_t)typeOffset + RDEF_TYPE_SIZE > chunkSize ||
+				(uint64_t)variable.offset + variable.size > buffer.size){
+				return false;
+			}
+			const uint8_t* type = chunk + typeOffset;
+			variable.typeClass = ReadShort(type);
+			variable.type = ReadShort(type + 2);
+			variable.rows = ReadShort(type + 4);
+			variable.columns = ReadShort(type + 6);
+			variable.elements = ReadShort(type + 8);
+			buffer.variables.push_back(variable);
+		}
+		buffers.push_back(buffer);
+	}
+	return true;
+}
+
+bool ReadShaderConstantBuffers(const void* data, size_t size, std::vector<ShaderConstantBuffer>& buffers){
+	buffers.clear();
+	std::vector<DxbcChunk> chunks;
+	if (!ReadChunks(data, size, chunks)){
+		return false;
+	}
+	for (size_t i = 0; i < chunks.size(); i++){
+		if (chunks[i].fourCC == DXBC_RDEF){
+			return ReadResourceDefinitions(chunks[i].data, chunks[i].size, buffers);
+		}
+	}
+	return true; // stripped of reflection, or nothing to bind
+}
+
+static uint32_t AlignUp(uint32_t value){
+	return (value + SHADER_PACK_ALIGNMENT - 1) / SHADER_PACK_ALIGNMENT * SHADER_PACK_ALIGNMENT;
+}
+
+bool WriteShaderPackFile(const std::string& path, const std::vector<ShaderPackSource>& shaders, const AssetStamp& source, unsigned int& uniqueCount){
+	std::vector<ShaderPackEntry> entries(shaders.size());
+	std::vector<MeshFileElement> elements;
+	std::vector<size_t> blobs; // index into shaders of each distinct bytecode
+	std::unordered_map<uint64_t, size_t> blobByHash;
+	std::vector<size_t> entryBlob(shaders.size());
+	for (size_t i = 0; i < shaders.size(); i++){
+		const ShaderPackSource& shader = shaders[i];
+		ShaderPackEntry& entry = entries[i];
+		memset(&entry, 0, sizeof(entry));
+		std::vector<MeshFileElement> inputs;
+		if (shader.name.size() >= SHADER_NAME_SIZE || shader.bytecode.empty() ||
+			!ReadShaderBytecode(&shader.bytecode[0], shader.bytecode.size(), entry.stage, inputs)){
+			return false;
+		}
+		memcpy(entry.name, shader.name.c_str(), shader.name.size());
+		entry.hash = HashAssetBytes(&shader.bytecode[0], shader.bytecode.size());
+		entry.size = (uint32_t)shader.bytecode.size();
+		entry.firstElement = (uint32_t)elements.size();
+		entry.elementCount = (uint32_t)inputs.size();
+		entry.source = shader.source;
+		elements.insert(elements.end(), inputs.begin(), inputs.end());
+
+		//a hash match is only trusted once the bytes agree too
+		std::unordered_map<uint64_t, size_t>::iterator found = blobByHash.find(entry.hash);
+		if (found != blobByHash.end() && shaders[blobs[found->second]].bytecode == shader.bytecode){
+			entryBlob[i] = found->second;
+		}
+		else{
+			entryBlob[i] = blobs.size();
+			blobByHash[entry.hash] = blobs.size();
+			blobs.push_back(i);
+		}
+	}
+
+	uint32_t offset = AlignUp((uint32_t)(sizeof(ShaderPackHeader) + entries.size() * sizeof(ShaderPackEntry) + elements.size() * sizeof(MeshFileElement)));
+	std::vector<uint32_t> blobOffsets(blobs.size());
+	for (size_t i = 0; i < blobs.size(); i++){
+		blobOffsets[i] = offset;
+		offset = AlignUp(offset + (uint32_t)shaders[blobs[i]].bytecode.size());
+	}
+	for (size_t i = 0; i < entries.size(); i++){
+		entries[i].offset = blobOffsets[entryBlob[i]];
+	}
+
+	ShaderPackHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = SHADER_PACK_MAGIC;
+	header.version = SHADER_PACK_VERSION;
+	header.shaderCount = (uint32_t)entries.size();
+	header.elementCount = (uint32_t)elements.size();
+	header.blobCount = (uint32_t)blobs.size();
+	header.source = source;
+
+	std::vector<char> image(offset, 0);
+	char* out = &image[0];
+	memcpy(out, &header, sizeof(header));
+	out += sizeof(header);
+	if (!entries.empty()){
+		memcpy(out, &entries[0], entries.size() * sizeof(ShaderPackEntry));
+		out += entries.size() * sizeof(ShaderPackEntry);
+	}
+	if (!elements.empty()){
+		memcpy(out, &elements[0], elements.size() * sizeof(MeshFileElement));
+	}
+	for (size_t i = 0; i < blobs.size(); i++){
+		const std::vector<char>& bytecode = shaders[blobs[i]].bytecode;
+		memcpy(&image[blobOffsets[i]], &bytecode[0], bytecode.size());
+	}
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file){
+		return false;
+	}
+	bool written = fwrite(&image[0], 1, image.size(), file) == image.size();
+	uniqueCount = (unsigned int)blobs.size();
+	return fclose(file) == 0 && written;
+}
+
+bool ReadShaderPackFile(const char* data, size_t size, ShaderPackView& view){
+	if (!data || size < sizeof(ShaderPackHeader)){
+		return false;
+	}
+	const ShaderPackHeader* header = reinterpret_cast<const ShaderPackHeader*>(data);
+	if (header->magic != SHADER_PACK_MAGIC || header->version != SHADER_PACK_VERSION){
+		return false;
+	}
+	uint64_t tablesSize = sizeof(ShaderPackHeader) + (uint64_t)header->shaderCount * sizeof(ShaderPackEntry) + (uint64_t)header->elementCount * sizeof(MeshFileElement);
+	if (tablesSize > size){
+		return false;
+	}
+	const ShaderPackEntry* entries = reinterpret_cast<const ShaderPackEntry*>(data + sizeof(ShaderPackHeader));
+	for (uint32_t i = 0; i < header->shaderCount; i++){
+		const ShaderPackEntry& entry = entries[i];
+		if (memchr(entry.name, 0, SHADER_NAME_SIZE) == nullptr || entry.size == 0 || entry.offset < tablesSize || (uint64_t)entry.offset + entry.size > size ||
+			(uint64_t)entry.firstElement + entry.elementCount > header->elementCount){
+			return false;
+		}
+	}
+
+	view.header = header;
+	view.entries = entries;
+	view.elements = reinterpret_cast<const MeshFileElement*>(data + sizeof(ShaderPackHeader) + header->shaderCount * sizeof(ShaderPackEntry));
+	view.data = data;
+	return true;
+}
+
+std::string GetCookedShaderPackPath(const std::string& manifestPath){
+	return manifestPath + SHADER_PACK_EXTENSION;
+}
+
+bool OpenCookedShaderPack(const std::string& manifestPath, MappedFile& mapped, ShaderPackView& view){
+	std::string cookedPath = GetCookedShaderPackPath(manifestPath);
+	if (!mapped.open(cookedPath)){
+		return false;
+	}
+	if (!ReadShaderPackFile(mapped.data(), mapped.size(), view) ||
+		!IsCookedAssetCurrent(manifestPath, view.header->source, cookedPath, (const char*)&view.header->source - mapped.data())){
+		mapped.close();
+		return false;
+	}
+	for (uint32_t i = 0; i < view.header->shaderCount; i++){
+		const AssetStamp& source = view.entries[i].source;
+		if (!IsCookedAssetCurrent(GetManifestSourcePath(manifestPath, view.entries[i].name), source, cookedPath, (const char*)&source - mapped.data())){
+			mapped.close();
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,145 @@
+#ifndef _SHADERPACKFILE_H
+#define _SHADERPACKFILE_H
+
+#include "AssetStamp.h"
+#include "MeshFile.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile;
+
+/**
+*Every compiled shader the game uses, in one file read with one mapping.
+*A manifest (ReadAssetManifest) lists the .cso files; the cooker turns shaders.pipeline into
+*shaders.pipeline.pack:
+*	ShaderPackHeader
+*	ShaderPackEntry[shaderCount]		one per manifest line, in order
+*	MeshFileElement[elementCount]		vertex shaders' input layouts, read from their signatures
+*	bytecode blobs						16 byte aligned, stored once however many entries share them
+*Everything is little endian and read in place from a mapping, so the blobs go straight into
+*shader creation. Signatures and constant buffers are read here from the DXBC container rather
+*than through D3DReflect, so the cooker builds anywhere and the game reflects nothing at startup.
+**/
+#define SHADER_PACK_MAGIC 0x4B504853 // "SHPK"
+#define SHADER_PACK_VERSION 1
+#define SHADER_PACK_ALIGNMENT 16
+#define SHADER_PACK_EXTENSION ".pack"
+#define SHADER_NAME_SIZE 64
+#define SHADER_APPEND_ALIGNED 0xFFFFFFFF // D3D11_APPEND_ALIGNED_ELEMENT
+#define SHADER_SLOT_UNBOUND 0xFFFFFFFF
+
+//Program types of the shader model 4 and 5 version token
+enum ShaderStage{
+	SHADER_STAGE_PIXEL = 0,
+	SHADER_STAGE_VERTEX = 1,
+	SHADER_STAGE_GEOMETRY = 2,
+	SHADER_STAGE_HULL = 3,
+	SHADER_STAGE_DOMAIN = 4,
+	SHADER_STAGE_COMPUTE = 5
+};
+
+struct ShaderPackHeader{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t shaderCount;
+	uint32_t elementCount;
+	uint32_t blobCount; // distinct bytecode
+	uint32_t reserved;
+	AssetStamp source; // the manifest
+};
+
+struct ShaderPackEntry{
+	char name[SHADER_NAME_SIZE]; // as the manifest spells it, zero terminated
+	uint64_t hash; // HashAssetBytes of the bytecode, equal hashes share one blob and one shader object
+	uint32_t offset; // of the bytecode from the start of the file
+	uint32_t size;
+	uint32_t stage; // ShaderStage
+	uint32_t firstElement; // input layout, only vertex shaders have one
+	uint32_t elementCount;
+	uint32_t reserved;
+	AssetStamp source; // the .cso
+};
+
+//Pointers into a validated file image
+struct ShaderPackView{
+	const ShaderPackHeader* header;
+	const ShaderPackEntry* entries;
+	const MeshFileElement* elements;
+	const char* data; // the whole file, entries' offsets are from here
+};
+
+//D3D_SHADER_VARIABLE_CLASS
+enum ShaderVariableClass{
+	SHADER_VARIABLE_SCALAR = 0,
+	SHADER_VARIABLE_VECTOR = 1,
+	SHADER_VARIABLE_MATRIX_ROWS = 2,
+	SHADER_VARIABLE_MATRIX_COLUMNS = 3,
+	SHADER_VARIABLE_OBJECT = 4,
+	SHADER_VARIABLE_STRUCT = 5
+};
+
+//The D3D_SHADER_VARIABLE_TYPEs a constant buffer holds numbers as
+enum ShaderVariableType{
+	SHADER_VARIABLE_BOOL = 1,
+	SHADER_VARIABLE_INT = 2,
+	SHADER_VARIABLE_FLOAT = 3,
+	SHADER_VARIABLE_UINT = 19
+};
+
+//One member of a constant buffer, where the compiled shader reads it
+struct ShaderVariable{
+	std::string name;
+	uint32_t offset; // bytes from the start of the buffer
+	uint32_t size;
+	uint32_t typeClass; // ShaderVariableClass
+	uint32_t type; // ShaderVariableType, or another D3D_SHADER_VARIABLE_TYPE
+	uint32_t rows;
+	uint32_t columns;
+	uint32_t elements; // array length, 0 when it isn't one
+};
+
+struct ShaderConstantBuffer{
+	std::string name;
+	uint32_t slot; // register b#, SHADER_SLOT_UNBOUND if nothing binds it
+	uint32_t size; // whole registers
+	std::vector<ShaderVariable> variables;
+};
+
+//A compiled shader for WriteShaderPackFile
+struct ShaderPackSource{
+	std::string name;
+	std::vector<char> bytecode;
+	AssetStamp source;
+};
+
+/**
+*Reads a compiled shader's DXBC container: its stage and, for a vertex shader, the layout its
+*input signature asks for, one MeshFileElement a parameter with offsets SHADER_APPEND_ALIGNED,
+*system values left out. False if it isn't shader model 4 or 5 bytecode
+**/
+bool ReadShaderBytecode(const void* data, size_t size, uint32_t& stage, std::vector<MeshFileElement>& inputs);
+
+/**
+*Reads the constant buffers a compiled shader declares from its RDEF chunk, the layout D3DReflect
+*would give. Empty when the bytecode was stripped of reflection; false if it isn't shader model 4
+*or 5 bytecode or the chunk is malformed
+**/
+bool ReadShaderConstantBuffers(const void* data, size_t size, std::vector<ShaderConstantBuffer>& buffers);
+
+//Lays out and writes shaders, identical bytecode stored once; false if any isn't valid bytecode
+//or its name doesn't fit. uniqueCount gets how many blobs that left
+bool WriteShaderPackFile(const std::string& path, const std::vector<ShaderPackSource>& shaders, const AssetStamp& source, unsigned int& uniqueCount);
+
+//Checks the header, that every table and blob fits in the file and each entry's layout is in range
+bool ReadShaderPackFile(const char* data, size_t size, ShaderPackView& view);
+
+//shaders.pipeline -> shaders.pipeline.pack
+std::string GetCookedShaderPackPath(const std::string& manifestPath);
+
+//Maps the cooked pack for manifestPath, false unless it exists, is valid and neither the manifest
+//nor any shader in it changed since. The view points into mapped, which has to stay open while it is used
+bool OpenCookedShaderPack(const std::string& manifestPath, MappedFile& mapped, ShaderPackView& view);
+
+#endif
@@ -0,0 +1,28 @@
+#include "ShaderPermutation.h"
+
+static std::string GetPermutationName(const char* source, uint32_t features){
+	static const char letters[] = "LNMAP"; // bit by bit, as MeshShaderFeature orders them
+	std::string suffix;
+	for (unsigned int i = 0; letters[i] != 0; i++){
+		if (features & (1u << i)){
+			suffix += letters[i];
+		}
+	}
+	return std::string(source) + (suffix.empty() ? "" : "_" + suffix) + ".cso";
+}
+
+std::string GetMeshVertexShaderName(uint32_t features){
+	return GetPermutationName("MeshVertexShader", features & MESH_VERTEX_FEATURES);
+}
+
+std::string GetMeshPixelShaderName(uint32_t features){
+	return GetPermutationName("MeshPixelShader", features & MESH_PIXEL_FEATURES);
+}
+
+std::string GetPostProcessPixelShaderName(PostProcessEffect effect){
+	static const char* names[] = { "Copy", "Grayscale", "Sepia", "Inverse" };
+	if ((unsigned int)effect >= sizeof(names) / sizeof(names[0])){
+		return std::string();
+	}
+	return std::string("PostProcessPixelShader_") + names[effect] + ".cso";
+}
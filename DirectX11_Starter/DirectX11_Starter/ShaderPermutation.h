@@ -0,0 +1,44 @@
+#ifndef _SHADERPERMUTATION_H
+#define _SHADERPERMUTATION_H
+
+#include <string>
+#include <cstdint>
+
+/**
+*Which compiled permutation of an uber shader a material draws with.
+*Shaders\MeshVertexShader.hlsli and Shaders\MeshPixelShader.hlsli are every mesh shader, their
+*features switched by defines; PostProcessPixelShader.hlsli is every post process effect. Each
+*permutation the game uses is a file in Shaders\Permutations that defines its features and
+*includes the uber source, compiled by the build like any other shader and listed in
+*shaders.pipeline. The .cso name is the source's followed by a letter per feature, so a feature
+*mask is all it takes to find one; a combination nothing was compiled for isn't found.
+**/
+
+//Mesh shader features, in the order their letters are named
+enum MeshShaderFeature{
+	MESH_SHADER_LIT = 1 << 0, // L, lights from LightBuffer, specular needs CameraBuffer; otherwise the texture as is
+	MESH_SHADER_NORMAL_MAP = 1 << 1, // N, tangent space normals in the second texture; needs Vertex2's tangent
+	MESH_SHADER_MULTI_TEXTURE = 1 << 2, // M, a reflection texture in the next slot
+	MESH_SHADER_ALPHA_MAP = 1 << 3, // A, a mask in the next slot that blends towards cyan
+	MESH_SHADER_PACKED = 1 << 4 // P, PackedVertex2 input, the layout comes from GetPackedVertex2Layout
+};
+
+#define MESH_VERTEX_FEATURES (MESH_SHADER_LIT | MESH_SHADER_NORMAL_MAP | MESH_SHADER_PACKED) // the rest only change the pixel shader
+#define MESH_PIXEL_FEATURES (MESH_SHADER_LIT | MESH_SHADER_NORMAL_MAP | MESH_SHADER_MULTI_TEXTURE | MESH_SHADER_ALPHA_MAP)
+
+//EFFECT in PostProcessPixelShader.hlsli
+enum PostProcessEffect{
+	POST_PROCESS_COPY = 0,
+	POST_PROCESS_GRAYSCALE = 1,
+	POST_PROCESS_SEPIA = 2,
+	POST_PROCESS_INVERSE = 3
+};
+
+//MESH_SHADER_LIT | MESH_SHADER_NORMAL_MAP | MESH_SHADER_PACKED -> MeshVertexShader_LNP.cso
+std::string GetMeshVertexShaderName(uint32_t features);
+//MESH_SHADER_LIT | MESH_SHADER_NORMAL_MAP -> MeshPixelShader_LN.cso; no features is the unlit one
+std::string GetMeshPixelShaderName(uint32_t features);
+//POST_PROCESS_SEPIA -> PostProcessPixelShader_Sepia.cso
+std::string GetPostProcessPixelShaderName(PostProcessEffect effect);
+
+#endif
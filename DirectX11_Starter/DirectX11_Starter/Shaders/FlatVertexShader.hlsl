@@ -1,33 +0,0 @@
-cbuffer perModel : register(b0)
-{
-	matrix world;
-	matrix view;
-	matrix projection;
-};
-
-struct VertexShaderInput
-{
-	float3 position		: POSITION;
-	float3 normal		: NORMAL;
-	float2 uv		    : TEXCOORD1;
-};
-
-struct VertexToPixel
-{
-	float4 position		: SV_POSITION;
-	float3 normal		: TEXCOORD0;
-	float2 uv			: TEXCOORD1;
-};
-
-VertexToPixel main(VertexShaderInput input)
-{
-	VertexToPixel output;
-
-	// Calculate output position
-	matrix worldViewProj = mul(mul(world, view), projection);
-	output.position = mul(float4(input.position, 1.0f), worldViewProj);
-	output.uv = input.uv;
-	output.normal = input.normal;
-
-	return output;
-}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "MeshShader.hlsli"
+
+// Every mesh pixel shader, see MeshShader.hlsli for the features
+// - The optional textures take the slots after the diffuse one in feature order, the order
+//   Material holds them in
+Texture2D myTexture: register(t0);
+SamplerState mySampler: register(s0);
+
+#if NORMAL_MAP
+Texture2D normalMap: register(t1);
+#endif
+
+#if MULTI_TEXTURE && NORMAL_MAP
+Texture2D reflectionMap: register(t2);
+#elif MULTI_TEXTURE
+Texture2D reflectionMap: register(t1);
+#endif
+
+#if ALPHA_MAP && NORMAL_MAP && MULTI_TEXTURE
+Texture2D alphaMap: register(t3);
+#elif ALPHA_MAP && (NORMAL_MAP || MULTI_TEXTURE)
+Texture2D alphaMap: register(t2);
+#elif ALPHA_MAP
+Texture2D alphaMap: register(t1);
+#endif
+
+#if LIT
+cbuffer LightBuffer
+{
+	float4 ambientColor;
+	float4 diffuseColor;
+	float3 lightDirection;
+	float specularPower;
+	float4 specularColor;
+};
+#endif
+
+#if MULTI_TEXTURE
+#define DIFFUSE_SCALE 0.2f	// the reflection stands in for most of the diffuse light
+#else
+#define DIFFUSE_SCALE 0.8f
+#endif
+
+#if NORMAL_MAP
+float3 NormalSampleToWorldSpace(float2 normalMapSample, float3 unitNormalW, float4 tangentW)
+{
+	// Uncompress x and y from [0,1] to [-1,1]; z isn't stored in a BC5 normal map, it's the
+	// rest of the unit length and always faces out of the surface.
+	float3 normalT;
+	normalT.xy = 2.0f*normalMapSample - 1.0f;
+	normalT.z = sqrt(saturate(1.0f - dot(normalT.xy, normalT.xy)));
+	// Build orthonormal basis.
+	float3 N = unitNormalW;
+	float3 T = normalize(tangentW.xyz - dot(tangentW.xyz, N)*N);
+	float3 B = cross(N, T) * (tangentW.w < 0.0f ? -1.0f : 1.0f);
+	float3x3 TBN = float3x3(T, B, N);
+	// Transform from tangent space to world space.
+	return mul(normalT, TBN);
+}
+#endif
+
+float4 main(VertexToPixel input) : SV_TARGET
+{
+	float4 textureColor = myTexture.Sample(mySampler, input.uv);
+#if !LIT
+	return textureColor;
+#else
+	// Interpolating normal can unnormalize it, so normalize it.
+	float3 normal = normalize(input.normal);
+#if NORMAL_MAP
+	normal = NormalSampleToWorldSpace(normalMap.Sample(mySampler, input.uv).rg, normal, input.tangent);
+#endif
+
+	float3 reflection = reflect(-lightDirection, normal);
+	float4 specular = pow(saturate(dot(reflection, -input.viewDirection)), specularPower) * specularColor;
+	float4 diffuse = lerp(diffuseColor, textureColor, 0.85f) * saturate(dot(normal, -lightDirection)) * DIFFUSE_SCALE;
+	float4 color = saturate(diffuse + ambientColor + specular);
+
+#if MULTI_TEXTURE
+	color = reflectionMap.Sample(mySampler, reflection.xy) * 0.3f + color;
+#endif
+#if ALPHA_MAP
+	float4 cyan = float4(0, 1, 1, 1);
+	color = lerp(color, cyan, alphaMap.Sample(mySampler, input.uv));
+#endif
+	return color;
+#endif
+}
@@ -0,0 +1,39 @@
+// Features of the mesh shaders (see ShaderPermutation.h)
+// - MeshVertexShader.hlsli and MeshPixelShader.hlsli are compiled once per combination a
+//   material uses; each file in Permutations defines its features and includes one of them
+// - A feature left undefined is off, so a permutation only has the math it asks for
+#ifndef LIT
+#define LIT 0				// ambient, diffuse and specular from LightBuffer, otherwise just the texture
+#endif
+#ifndef NORMAL_MAP
+#define NORMAL_MAP 0		// BC5 tangent space normals in t1
+#endif
+#ifndef MULTI_TEXTURE
+#define MULTI_TEXTURE 0		// a reflection texture after the normal map
+#endif
+#ifndef ALPHA_MAP
+#define ALPHA_MAP 0			// a mask after that, blending towards cyan
+#endif
+#ifndef PACKED
+#define PACKED 0			// vertex shader only, PackedVertex2 input
+#endif
+
+#if (NORMAL_MAP || MULTI_TEXTURE || ALPHA_MAP) && !LIT
+#error The texture features only change lighting, they need LIT
+#endif
+
+// What the vertex shader passes on, each permutation pair agrees on it
+struct VertexToPixel
+{
+	float4 position		 : SV_POSITION;
+#if LIT
+	float3 normal		 : TEXCOORD0;
+#endif
+	float2 uv			 : TEXCOORD1;
+#if LIT
+	float3 viewDirection : TEXCOORD2;
+#endif
+#if NORMAL_MAP
+	float4 tangent		 : TANGENT;	// w is the handedness
+#endif
+};
@@ -0,0 +1,69 @@
+#include "MeshShader.hlsli"
+#include "VertexDecode.hlsli"
+
+// Every mesh vertex shader, see MeshShader.hlsli for the features
+cbuffer perModel : register(b0)
+{
+	matrix world;
+	matrix view;
+	matrix projection;
+	float4 uvTransform; // xy scale, zw offset of the texture in an atlas
+};
+
+#if LIT
+cbuffer CameraBuffer : register(b1)
+{
+	float3 cameraPosition;
+	float padding;
+};
+#endif
+
+struct VertexShaderInput
+{
+#if PACKED
+	// Matches the packed layout, the input layout comes from the mesh file rather than the signature
+	float4 position		: POSITION;	// unorm, 0..1 across the bounding cube, w set for a mirrored tangent frame
+	float2 normal		: NORMAL;	// octahedral
+	float2 uv			: TEXCOORD0;
+	float2 tangent		: TANGENT;	// octahedral, part of the vertex whether it's read or not
+#else
+	float3 position		: POSITION;
+	float3 normal		: NORMAL;
+	float2 uv		    : TEXCOORD1;
+#if NORMAL_MAP
+	float4 tangent		: TANGENT;	// w is the handedness
+#endif
+#endif
+};
+
+VertexToPixel main(VertexShaderInput input)
+{
+	VertexToPixel output;
+	float4 position = float4(input.position.xyz, 1.0f);
+
+	matrix worldViewProj = mul(mul(world, view), projection);
+	output.position = mul(position, worldViewProj);
+	output.uv = input.uv * uvTransform.xy + uvTransform.zw;
+
+#if LIT
+#if PACKED
+	float3 normal = DecodeOctahedral(input.normal);
+#else
+	float3 normal = input.normal;
+#endif
+	output.normal = normalize(mul(normal, (float3x3)world));
+
+	float4 worldPosition = mul(position, world);
+	output.viewDirection = normalize(cameraPosition - worldPosition.xyz);
+#endif
+
+#if NORMAL_MAP
+#if PACKED
+	output.tangent = float4(normalize(mul(DecodeOctahedral(input.tangent), (float3x3)world)), 1.0f - 2.0f * input.position.w);
+#else
+	output.tangent = float4(normalize(mul(input.tangent.xyz, (float3x3)world)), input.tangent.w);
+#endif
+#endif
+
+	return output;
+}
@@ -1,51 +0,0 @@
-cbuffer perModel : register(b0)
-{
-	matrix world;
-	matrix view;
-	matrix projection;
-};
-
-cbuffer CameraBuffer : register(b1)
-{
-	float3 cameraPosition;
-	float padding;
-};
-
-// Defines what kind of data to expect as input
-// - This should match our input layout!
-struct VertexShaderInput
-{
-	float3 position		: POSITION;
-	float3 normal		: NORMAL;
-	float2 uv		    : TEXCOORD1;
-};
-
-// Defines the output data of our vertex shader
-// - At a minimum, you'll need an SV_POSITION
-// - Should match the pixel shader's input
-struct VertexToPixel
-{
-	float4 position		: SV_POSITION;	// System Value Position - Has specific meaning to the pipeline!
-	float3 normal		: TEXCOORD0;
-	float2 uv		    : TEXCOORD1;
-	float3 viewDirection : TEXCOORD2;
-};
-
-// The entry point for our vertex shader
-VertexToPixel main(VertexShaderInput input)
-{
-	// Set up output
-	VertexToPixel output;
-	float4 worldPosition;
-
-	// Calculate output position
-	matrix worldViewProj = mul(mul(world, view), projection);
-	output.position = mul(float4(input.position, 1.0f), worldViewProj);
-	output.normal = normalize(mul(input.normal, (float3x3)world));
-	output.uv = input.uv;
-
-	worldPosition = mul(input.position, world);
-	output.viewDirection = normalize(cameraPosition.xyz - worldPosition.xyz);
-
-	return output;
-}
\ No newline at end of file
@@ -0,0 +1,3 @@
+// Lit, one texture: collectables and pickups
+#define LIT 1
+#include "../MeshPixelShader.hlsli"
@@ -0,0 +1,5 @@
+// Lit with a reflection and an alpha mapped highlight: the player and projectiles
+#define LIT 1
+#define MULTI_TEXTURE 1
+#define ALPHA_MAP 1
+#include "../MeshPixelShader.hlsli"
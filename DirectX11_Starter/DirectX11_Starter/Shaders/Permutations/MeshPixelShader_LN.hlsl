@@ -0,0 +1,4 @@
+// Lit and normal mapped: asteroids
+#define LIT 1
+#define NORMAL_MAP 1
+#include "../MeshPixelShader.hlsli"
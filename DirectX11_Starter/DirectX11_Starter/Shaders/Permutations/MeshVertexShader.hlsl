@@ -0,0 +1,2 @@
+// Unlit, the texture as is: backgrounds, sprites and the HUD
+#include "../MeshVertexShader.hlsli"
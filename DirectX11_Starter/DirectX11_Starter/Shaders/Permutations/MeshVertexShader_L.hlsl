@@ -0,0 +1,3 @@
+// Lit: collectables and pickups, the player and projectiles
+#define LIT 1
+#include "../MeshVertexShader.hlsli"
@@ -0,0 +1,4 @@
+// Lit with a tangent frame for normal mapping: asteroids
+#define LIT 1
+#define NORMAL_MAP 1
+#include "../MeshVertexShader.hlsli"
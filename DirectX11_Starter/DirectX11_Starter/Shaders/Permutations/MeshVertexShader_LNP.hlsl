@@ -0,0 +1,5 @@
+// Lit with a tangent frame, quantized vertices: asteroids
+#define LIT 1
+#define NORMAL_MAP 1
+#define PACKED 1
+#include "../MeshVertexShader.hlsli"
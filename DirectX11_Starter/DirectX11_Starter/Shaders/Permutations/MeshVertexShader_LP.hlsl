@@ -0,0 +1,4 @@
+// Lit, quantized vertices: the player and projectiles
+#define LIT 1
+#define PACKED 1
+#include "../MeshVertexShader.hlsli"
@@ -0,0 +1,3 @@
+// A straight copy, for passes that only resample
+#define EFFECT EFFECT_COPY
+#include "../../PostProcessPixelShader.hlsli"
@@ -0,0 +1,3 @@
+// Averaged to gray
+#define EFFECT EFFECT_GRAYSCALE
+#include "../../PostProcessPixelShader.hlsli"
@@ -0,0 +1,3 @@
+// Inverted colours
+#define EFFECT EFFECT_INVERSE
+#include "../../PostProcessPixelShader.hlsli"
@@ -0,0 +1,3 @@
+// Sepia toned, the game's screen pass
+#define EFFECT EFFECT_SEPIA
+#include "../../PostProcessPixelShader.hlsli"
@@ -0,0 +1,13 @@
+// Decoding for PackedVertex2 (see VertexCodec.h)
+// - Positions need nothing here, their decode is folded into the world matrix
+
+// Octahedral unit vector from its snorm pair
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 n = float3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+	if (n.z < 0.0f)
+	{
+		n.xy = (1.0f - abs(n.yx)) * (n.xy >= 0.0f ? 1.0f : -1.0f);
+	}
+	return normalize(n);
+}
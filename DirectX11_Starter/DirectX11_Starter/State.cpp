@@ -1,10 +1,10 @@
 #include "State.h"
 
-State::State(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sample, wchar_t* textureFile, Mesh* menuMesh, ShaderProgram* shaderProgram){
+State::State(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, ID3D11SamplerState* sample, wchar_t* textureFile, Mesh* menuMesh, ShaderProgram* shaderProgram){
 	device = dev;
 	deviceContext = devCtx;
 
-	Material* material = new Material(device, deviceContext, sample, textureFile, shaderProgram);
+	Material* material = new Material(assets, sample, textureFile, shaderProgram);
 	gameState = new GameEntity(menuMesh, material);
 
 	gameState->scale(XMFLOAT3(0.3f, 0.41f, 0.0f));
@@ -36,6 +36,7 @@ void State::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix){
 	gameState->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = gameState->getWorld();
 	gameState->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
 	gameState->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+	gameState->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = gameState->g_mat->uvTransform;
 
 
 	deviceContext->UpdateSubresource(
@@ -47,7 +48,7 @@ void State::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix){
 		0);
 
 	deviceContext->IASetVertexBuffers(0, 1, &gameState->g_mesh->v_buffer, &stride, &offset);
-	deviceContext->IASetIndexBuffer(gameState->g_mesh->i_buffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetIndexBuffer(gameState->g_mesh->i_buffer, gameState->g_mesh->indexFormat, 0);
 
 	deviceContext->PSSetSamplers(0, 1, &gameState->g_mat->samplerState);
 	deviceContext->PSSetShaderResources(0, 1, &gameState->g_mat->resourceView);
@@ -3,6 +3,7 @@
 
 #include "GameEntity.h"
 #include "Material.h"
+#include "AssetManager.h"
 #include "Mesh.h"
 #include "ShaderProgram.h"
 #include "ConstantBuffer.h"
@@ -11,7 +12,7 @@
 
 class State{
 public:
-	State(ID3D11Device* dev, ID3D11DeviceContext* devCtx, ID3D11SamplerState* sample, wchar_t* textureFile, Mesh* menuMesh, ShaderProgram* shaderProgram);
+	State(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, ID3D11SamplerState* sample, wchar_t* textureFile, Mesh* menuMesh, ShaderProgram* shaderProgram);
 	~State(void);
 	void update();
 	void draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix);
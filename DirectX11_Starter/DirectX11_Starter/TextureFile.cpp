@@ -0,0 +1,295 @@
+#include "TextureFile.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//DDS_HEADER flags the loader looks at
+#define DDS_HEADER_FLAGS_TEXTURE 0x00001007 // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT
+#define DDS_HEADER_FLAGS_MIPMAP 0x00020000 // DDSD_MIPMAPCOUNT
+#define DDS_HEADER_FLAGS_LINEARSIZE 0x00080000 // DDSD_LINEARSIZE
+#define DDS_HEADER_FLAGS_PITCH 0x00000008 // DDSD_PITCH
+#define DDS_FOURCC 0x00000004 // DDPF_FOURCC
+#define DDS_RGBA 0x00000041 // DDPF_RGB | DDPF_ALPHAPIXELS
+#define DDS_SURFACE_FLAGS_TEXTURE 0x00001000 // DDSCAPS_TEXTURE
+#define DDS_SURFACE_FLAGS_MIPMAP 0x00400008 // DDSCAPS_COMPLEX | DDSCAPS_MIPMAP
+#define DDS_HEADER_FLAGS_VOLUME 0x00800000 // DDSD_DEPTH
+#define DDS_CUBEMAP 0x00000200 // DDSCAPS2_CUBEMAP
+#define DDS_DIMENSION_TEXTURE2D 3 // D3D11_RESOURCE_DIMENSION_TEXTURE2D
+#define DDS_MISC_TEXTURECUBE 0x4 // D3D11_RESOURCE_MISC_TEXTURECUBE
+
+//Formats only ever read, the rest are in BlockCompress.h
+#define TEXTURE_FORMAT_BC1_SRGB 72 // DXGI_FORMAT_BC1_UNORM_SRGB
+#define TEXTURE_FORMAT_BC2 74 // DXGI_FORMAT_BC2_UNORM
+#define TEXTURE_FORMAT_BC2_SRGB 75 // DXGI_FORMAT_BC2_UNORM_SRGB
+#define TEXTURE_FORMAT_BC3_SRGB 78 // DXGI_FORMAT_BC3_UNORM_SRGB
+#define TEXTURE_FORMAT_BC7_SRGB 99 // DXGI_FORMAT_BC7_UNORM_SRGB
+
+//Typeless formats can't back a shader resource view, they are read as the UNORM one after them
+static const uint32_t typelessFormats[] = {
+	70, // DXGI_FORMAT_BC1_TYPELESS
+	73, // DXGI_FORMAT_BC2_TYPELESS
+	76, // DXGI_FORMAT_BC3_TYPELESS
+	79, // DXGI_FORMAT_BC4_TYPELESS
+	82, // DXGI_FORMAT_BC5_TYPELESS
+	97 // DXGI_FORMAT_BC7_TYPELESS
+};
+
+//Legacy four character codes and the formats they stand for
+static const uint32_t legacyFormats[][2] = {
+	{ 0x31545844, TEXTURE_FORMAT_BC1 }, // "DXT1"
+	{ 0x33545844, TEXTURE_FORMAT_BC2 }, // "DXT3"
+	{ 0x35545844, TEXTURE_FORMAT_BC3 }, // "DXT5"
+	{ 0x31495441, TEXTURE_FORMAT_BC4 }, // "ATI1"
+	{ 0x55344342, TEXTURE_FORMAT_BC4 }, // "BC4U"
+	{ 0x32495441, TEXTURE_FORMAT_BC5 }, // "ATI2"
+	{ 0x55354342, TEXTURE_FORMAT_BC5 } // "BC5U"
+};
+
+static_assert(sizeof(TextureFileHeader) == 124, "TextureFileHeader has to match DDS_HEADER");
+static_assert(sizeof(TextureFileHeaderDX10) == 20, "TextureFileHeaderDX10 has to match DDS_HEADER_DXT10");
+static_assert(sizeof(AssetStamp) == sizeof(((TextureFileHeader*)0)->stamp), "the stamp has to fit the reserved words");
+
+size_t GetTextureFileBlockBytes(uint32_t format){
+	switch (format){
+	case TEXTURE_FORMAT_BC1_SRGB:
+		return GetBlockBytes(TEXTURE_FORMAT_BC1);
+	case TEXTURE_FORMAT_BC2:
+	case TEXTURE_FORMAT_BC2_SRGB:
+		return 16;
+	case TEXTURE_FORMAT_BC3_SRGB:
+		return GetBlockBytes(TEXTURE_FORMAT_BC3);
+	case TEXTURE_FORMAT_BC7_SRGB:
+		return GetBlockBytes(TEXTURE_FORMAT_BC7);
+	default:
+		return GetBlockBytes(format);
+	}
+}
+
+size_t GetTextureDataSize(uint32_t format, uint32_t width, uint32_t height, uint32_t mipCount){
+	size_t size = 0;
+	for (uint32_t mip = 0; mip < mipCount; mip++){
+		size += (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetTextureFileBlockBytes(format);
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return size;
+}
+
+void GetTextureLevels(uint32_t format, uint32_t width, uint32_t height, uint32_t mipCount, const uint8_t* data, std::vector<TextureFileLevel>& levels){
+	size_t blockBytes = GetTextureFileBlockBytes(format);
+	levels.resize(mipCount);
+	for (uint32_t mip = 0; mip < mipCount; mip++){
+		TextureFileLevel& level = levels[mip];
+		level.data = data;
+		level.width = width;
+		level.height = height;
+		level.rowPitch = (uint32_t)(((width + 3) / 4) * blockBytes);
+		level.slicePitch = level.rowPitch * ((height + 3) / 4);
+		data += level.slicePitch;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+}
+
+void GetTextureFileLevels(const TextureFileView& view, std::vector<TextureFileLevel>& levels){
+	GetTextureLevels(view.format, view.header->width, view.header->height, view.mipCount, view.data, levels);
+}
+
+bool WriteTextureFile(const std::string& path, uint32_t format, uint32_t width, uint32_t height, uint32_t mipCount, const void* data, const AssetStamp& source){
+	if (GetBlockBytes(format) == 0 || width == 0 || height == 0 || mipCount == 0){
+		return false;
+	}
+
+	uint32_t magic = TEXTURE_FILE_MAGIC;
+	TextureFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.size = sizeof(TextureFileHeader);
+	header.flags = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_LINEARSIZE | (mipCount > 1 ? DDS_HEADER_FLAGS_MIPMAP : 0);
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = (uint32_t)GetCompressedSize(format, width, height);
+	header.depth = 1;
+	header.mipCount = mipCount;
+	header.stampTag = TEXTURE_FILE_STAMP_TAG;
+	memcpy(header.stamp, &source, sizeof(source));
+	header.format.size = sizeof(TextureFilePixelFormat);
+	header.format.flags = DDS_FOURCC;
+	header.format.fourCC = TEXTURE_FILE_DX10;
+	header.caps = DDS_SURFACE_FLAGS_TEXTURE | (mipCount > 1 ? DDS_SURFACE_FLAGS_MIPMAP : 0);
+
+	TextureFileHeaderDX10 header10;
+	memset(&header10, 0, sizeof(header10));
+	header10.format = format;
+	header10.dimension = DDS_DIMENSION_TEXTURE2D;
+	header10.arraySize = 1;
+
+	size_t dataSize = GetTextureDataSize(format, width, height, mipCount);
+	std::vector<char> image(sizeof(magic) + sizeof(header) + sizeof(header10) + dataSize);
+	char* out = &image[0];
+	memcpy(out, &magic, sizeof(magic));
+	memcpy(out + sizeof(magic), &header, sizeof(header));
+	memcpy(out + sizeof(magic) + sizeof(header), &header10, sizeof(header10));
+	memcpy(out + sizeof(magic) + sizeof(header) + sizeof(header10), data, dataSize);
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file){
+		return false;
+	}
+	bool written = fwrite(&image[0], 1, image.size(), file) == image.size();
+	return fclose(file) == 0 && written;
+}
+
+//Legacy channel masks rather than a DX10 header, so image viewers that predate DXGI open it too
+bool WriteImageTextureFile(const std::string& path, uint32_t width, uint32_t height, const uint8_t* pixels){
+	if (width == 0 || height == 0){
+		return false;
+	}
+	uint32_t magic = TEXTURE_FILE_MAGIC;
+	TextureFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.size = sizeof(TextureFileHeader);
+	header.flags = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_PITCH;
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = width * 4;
+	header.depth = 1;
+	header.mipCount = 1;
+	header.format.size = sizeof(TextureFilePixelFormat);
+	header.format.flags = DDS_RGBA;
+	header.format.rgbBitCount = 32;
+	header.format.rBitMask = 0x000000FF;
+	header.format.gBitMask = 0x0000FF00;
+	header.format.bBitMask = 0x00FF0000;
+	header.format.aBitMask = 0xFF000000;
+	header.caps = DDS_SURFACE_FLAGS_TEXTURE;
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file){
+		return false;
+	}
+	size_t dataSize = (size_t)width * height * 4;
+	bool written = fwrite(&magic, sizeof(magic), 1, file) == 1 && fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(pixels, 1, dataSize, file) == dataSize;
+	return fclose(file) == 0 && written;
+}
+
+bool ReadTextureFile(const char* data, size_t size, TextureFileView& view){
+	size_t headersSize = sizeof(uint32_t) + sizeof(TextureFileHeader);
+	if (!data || size < headersSize){
+		return false;
+	}
+	uint32_t magic;
+	memcpy(&magic, data, sizeof(magic));
+	const TextureFileHeader* header = reinterpret_cast<const TextureFileHeader*>(data + sizeof(uint32_t));
+	if (magic != TEXTURE_FILE_MAGIC || header->size != sizeof(TextureFileHeader) || header->format.size != sizeof(TextureFilePixelFormat)){
+		return false;
+	}
+	if (!(header->format.flags & DDS_FOURCC) || (header->flags & DDS_HEADER_FLAGS_VOLUME) || (header->caps2 & DDS_CUBEMAP)){
+		return false;
+	}
+
+	const TextureFileHeaderDX10* header10 = nullptr;
+	uint32_t format = 0;
+	if (header->format.fourCC == TEXTURE_FILE_DX10){
+		headersSize += sizeof(TextureFileHeaderDX10);
+		if (size < headersSize){
+			return false;
+		}
+		header10 = reinterpret_cast<const TextureFileHeaderDX10*>(data + sizeof(uint32_t) + sizeof(TextureFileHeader));
+		if (header10->dimension != DDS_DIMENSION_TEXTURE2D || header10->arraySize != 1 || (header10->miscFlag & DDS_MISC_TEXTURECUBE)){
+			return false;
+		}
+		format = header10->format;
+		for (size_t i = 0; i < sizeof(typelessFormats) / sizeof(typelessFormats[0]); i++){
+			format = format == typelessFormats[i] ? format + 1 : format;
+		}
+	}
+	else{
+		for (size_t i = 0; i < sizeof(legacyFormats) / sizeof(legacyFormats[0]); i++){
+			format = header->format.fourCC == legacyFormats[i][0] ? legacyFormats[i][1] : format;
+		}
+	}
+	if (GetTextureFileBlockBytes(format) == 0){
+		return false;
+	}
+
+	uint32_t mipCount = header->mipCount ? header->mipCount : 1;
+	if (header->width == 0 || header->height == 0 || mipCount > GetTextureMipCount(header->width, header->height)){
+		return false;
+	}
+	size_t dataSize = GetTextureDataSize(format, header->width, header->height, mipCount);
+	if (dataSize > size - headersSize){
+		return false;
+	}
+
+	view.header = header;
+	view.header10 = header10;
+	view.format = format;
+	view.mipCount = mipCount;
+	view.data = reinterpret_cast<const uint8_t*>(data + headersSize);
+	view.dataSize = dataSize;
+	return true;
+}
+
+bool OpenTextureFile(const std::string& path, MappedFile& mapped, TextureFileView& view){
+	if (!mapped.open(path)){
+		return false;
+	}
+	if (!ReadTextureFile(mapped.data(), mapped.size(), view)){
+		mapped.close();
+		return false;
+	}
+	return true;
+}
+
+bool GetTextureFileStamp(const TextureFileView& view, AssetStamp& stamp){
+	if (view.header->stampTag != TEXTURE_FILE_STAMP_TAG){
+		return false;
+	}
+	memcpy(&stamp, view.header->stamp, sizeof(stamp));
+	return true;
+}
+
+std::string GetCookedTexturePath(const std::string& sourcePath){
+	return sourcePath + TEXTURE_FILE_EXTENSION;
+}
+
+TextureEncoding ChooseTextureEncoding(const std::string& sourcePath){
+	size_t slash = sourcePath.find_last_of("/\\");
+	std::string name = sourcePath.substr(slash == std::string::npos ? 0 : slash + 1);
+	for (size_t i = 0; i < name.size(); i++){
+		if (name[i] >= 'A' && name[i] <= 'Z'){
+			name[i] = name[i] - 'A' + 'a';
+		}
+	}
+	if (name.find("_norm") != std::string::npos || name.find("_nrm") != std::string::npos){
+		return TEXTURE_NORMAL_MAP;
+	}
+	return name.find("_mask") != std::string::npos ? TEXTURE_LINEAR : TEXTURE_SRGB;
+}
+
+uint32_t ChooseTextureFormat(const std::string& sourcePath, bool hasAlpha, bool bc7){
+	switch (ChooseTextureEncoding(sourcePath)){
+	case TEXTURE_NORMAL_MAP:
+		return TEXTURE_FORMAT_BC5;
+	case TEXTURE_LINEAR:
+		return TEXTURE_FORMAT_BC4;
+	default:
+		return bc7 ? TEXTURE_FORMAT_BC7 : (hasAlpha ? TEXTURE_FORMAT_BC3 : TEXTURE_FORMAT_BC1);
+	}
+}
+
+bool OpenCookedTexture(const std::string& sourcePath, MappedFile& mapped, TextureFileView& view){
+	std::string cookedPath = GetCookedTexturePath(sourcePath);
+	if (!OpenTextureFile(cookedPath, mapped, view)){
+		return false;
+	}
+	AssetStamp stamp;
+	if (!GetTextureFileStamp(view, stamp) ||
+		!IsCookedAssetCurrent(sourcePath, stamp, cookedPath, (const char*)view.header->stamp - mapped.data())){
+		mapped.close();
+		return false;
+	}
+	return true;
+}
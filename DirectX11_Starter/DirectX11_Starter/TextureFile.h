@@ -0,0 +1,123 @@
+#ifndef _TEXTUREFILE_H
+#define _TEXTUREFILE_H
+
+#include "AssetStamp.h"
+#include "BlockCompress.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile;
+
+/**
+*Cooked textures are ordinary DDS files, so the DirectXTK loader reads them as they are:
+*	"DDS " magic
+*	TextureFileHeader		the DDS_HEADER, the source's stamp sits in its reserved words
+*	TextureFileHeaderDX10	the DXGI format
+*	every mip's blocks, largest first, tightly packed
+*Everything is little endian.
+*Reading takes any block compressed 2D DDS, from the cooker or not: legacy DXT1/3/5 and
+*ATI1/2 four character codes, or a DX10 header with a BC1-5 or BC7 format. Parsing and
+*the level layout are plain C++, so a mapped file goes to the GPU without a copy.
+**/
+#define TEXTURE_FILE_MAGIC 0x20534444 // "DDS "
+#define TEXTURE_FILE_DX10 0x30315844 // "DX10" four character code
+#define TEXTURE_FILE_STAMP_TAG 0x4B4F4F43 // "COOK", marks a stamp in the reserved words
+#define TEXTURE_FILE_EXTENSION ".dds"
+
+struct TextureFilePixelFormat{
+	uint32_t size;
+	uint32_t flags;
+	uint32_t fourCC;
+	uint32_t rgbBitCount;
+	uint32_t rBitMask;
+	uint32_t gBitMask;
+	uint32_t bBitMask;
+	uint32_t aBitMask;
+};
+
+struct TextureFileHeader{
+	uint32_t size;
+	uint32_t flags;
+	uint32_t height;
+	uint32_t width;
+	uint32_t pitchOrLinearSize;
+	uint32_t depth;
+	uint32_t mipCount;
+	uint32_t stampTag; // reserved1[11] in DDS_HEADER
+	uint32_t stamp[6]; // AssetStamp, unaligned
+	uint32_t reserved1[4];
+	TextureFilePixelFormat format;
+	uint32_t caps;
+	uint32_t caps2;
+	uint32_t caps3;
+	uint32_t caps4;
+	uint32_t reserved2;
+};
+
+struct TextureFileHeaderDX10{
+	uint32_t format;
+	uint32_t dimension;
+	uint32_t miscFlag;
+	uint32_t arraySize;
+	uint32_t miscFlags2;
+};
+
+//Pointers into a validated file image
+struct TextureFileView{
+	const TextureFileHeader* header;
+	const TextureFileHeaderDX10* header10; // nullptr for a legacy four character code
+	uint32_t format; // DXGI_FORMAT, sRGB variants kept, typeless read as UNORM
+	uint32_t mipCount;
+	const uint8_t* data; // mip 0 first
+	size_t dataSize;
+};
+
+//One mip level as D3D11_SUBRESOURCE_DATA wants it
+struct TextureFileLevel{
+	const uint8_t* data;
+	uint32_t width;
+	uint32_t height;
+	uint32_t rowPitch; // bytes per row of blocks
+	uint32_t slicePitch;
+};
+
+//Bytes per 4x4 block of any format a DDS can be read with, 0 otherwise
+size_t GetTextureFileBlockBytes(uint32_t format);
+
+//Every level of a full chain from width x height down
+size_t GetTextureDataSize(uint32_t format, uint32_t width, uint32_t height, uint32_t mipCount);
+
+//Where each of mipCount levels packed back to back from data sits, as FillInitData lays them out
+void GetTextureLevels(uint32_t format, uint32_t width, uint32_t height, uint32_t mipCount, const uint8_t* data, std::vector<TextureFileLevel>& levels);
+void GetTextureFileLevels(const TextureFileView& view, std::vector<TextureFileLevel>& levels);
+
+//data holds mipCount levels back to back, GetTextureDataSize bytes
+bool WriteTextureFile(const std::string& path, uint32_t format, uint32_t width, uint32_t height, uint32_t mipCount, const void* data, const AssetStamp& source);
+
+//Uncompressed RGBA8 DDS of one level, rows tightly packed; for captures, ReadTextureFile won't take it
+bool WriteImageTextureFile(const std::string& path, uint32_t width, uint32_t height, const uint8_t* pixels);
+
+//Checks the headers describe a single block compressed 2D texture and the levels fit in [data, data + size)
+bool ReadTextureFile(const char* data, size_t size, TextureFileView& view);
+
+//Maps any DDS ReadTextureFile takes; the view points into mapped
+bool OpenTextureFile(const std::string& path, MappedFile& mapped, TextureFileView& view);
+
+//False if the file wasn't cooked here
+bool GetTextureFileStamp(const TextureFileView& view, AssetStamp& stamp);
+
+//asteroid.jpg -> asteroid.jpg.dds, the source extension stays so bullet.jpg and bullet.png don't collide
+std::string GetCookedTexturePath(const std::string& sourcePath);
+
+//Normal maps are named *_norm or *_nrm, masks *_mask; everything else is sRGB colour
+TextureEncoding ChooseTextureEncoding(const std::string& sourcePath);
+//BC5 for normal maps, BC4 for masks, then BC7 when asked for, BC3 with alpha, BC1 without
+uint32_t ChooseTextureFormat(const std::string& sourcePath, bool hasAlpha, bool bc7);
+
+//Maps the cooked texture for sourcePath, false unless it exists, is valid and still current.
+//The view points into mapped, which has to stay open while it is used
+bool OpenCookedTexture(const std::string& sourcePath, MappedFile& mapped, TextureFileView& view);
+
+#endif
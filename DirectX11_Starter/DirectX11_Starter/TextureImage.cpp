@@ -0,0 +1,562 @@
+#include "TextureImage.h"
+#include "MappedFile.h"
+#include <emmintrin.h>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#ifdef _WIN32
+#include <Windows.h>
+#include <wincodec.h>
+#pragma comment(lib, "windowscodecs.lib")
+#else
+#include <csetjmp>
+#include <png.h>
+#include <jpeglib.h>
+#endif
+
+#define TEXTURE_MAX_DIMENSION 16384 // D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION
+#define SRGB_ENCODE_STEPS 4096 // linear to sRGB table entries, under half a step of error even in the darks
+
+//Both directions of the sRGB curve; built before main so worker threads can share them
+struct SrgbTables{
+	float toLinear[256];
+	uint8_t toSrgb[SRGB_ENCODE_STEPS];
+
+	SrgbTables(){
+		for (int i = 0; i < 256; i++){
+			float c = i / 255.0f;
+			toLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+		}
+		for (int i = 0; i < SRGB_ENCODE_STEPS; i++){
+			float c = i / (float)(SRGB_ENCODE_STEPS - 1);
+			float s = c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+			toSrgb[i] = (uint8_t)(s * 255.0f + 0.5f);
+		}
+	}
+};
+
+static const SrgbTables srgbTables;
+
+#ifdef _WIN32
+//Any image WIC can open, converted to RGBA8. Safe on a worker thread, it joins the MTA for the call
+bool LoadTextureImage(const std::string& path, TextureImage& image){
+	wchar_t widePath[MAX_PATH];
+	if (MultiByteToWideChar(CP_ACP, 0, path.c_str(), -1, widePath, MAX_PATH) == 0){
+		return false;
+	}
+
+	HRESULT init = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	IWICImagingFactory* factory = nullptr;
+	IWICBitmapDecoder* decoder = nullptr;
+	IWICBitmapFrameDecode* frame = nullptr;
+	IWICFormatConverter* converter = nullptr;
+
+	HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, __uuidof(IWICImagingFactory), reinterpret_cast<void**>(&factory));
+	if (SUCCEEDED(hr)){
+		hr = factory->CreateDecoderFromFilename(widePath, nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
+	}
+	if (SUCCEEDED(hr)){
+		hr = decoder->GetFrame(0, &frame);
+	}
+	if (SUCCEEDED(hr)){
+		hr = factory->CreateFormatConverter(&converter);
+	}
+	if (SUCCEEDED(hr)){
+		hr = converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom);
+	}
+	UINT width = 0;
+	UINT height = 0;
+	if (SUCCEEDED(hr)){
+		hr = converter->GetSize(&width, &height);
+	}
+	if (SUCCEEDED(hr) && (width == 0 || height == 0 || width > TEXTURE_MAX_DIMENSION || height > TEXTURE_MAX_DIMENSION)){
+		hr = E_FAIL;
+	}
+	if (SUCCEEDED(hr)){
+		image.width = width;
+		image.height = height;
+		image.pixels.resize((size_t)width * height * 4);
+		hr = converter->CopyPixels(nullptr, width * 4, (UINT)image.pixels.size(), &image.pixels[0]);
+	}
+
+	if (converter){
+		converter->Release();
+	}
+	if (frame){
+		frame->Release();
+	}
+	if (decoder){
+		decoder->Release();
+	}
+	if (factory){
+		factory->Release();
+	}
+	if (SUCCEEDED(init)){
+		CoUninitialize();
+	}
+	return SUCCEEDED(hr);
+}
+
+//WIC's PNG encoder takes BGRA, so the rows are swizzled into a copy first
+bool SaveTextureImage(const std::string& path, const TextureImage& image){
+	wchar_t widePath[MAX_PATH];
+	if (image.width == 0 || image.height == 0 || MultiByteToWideChar(CP_ACP, 0, path.c_str(), -1, widePath, MAX_PATH) == 0){
+		return false;
+	}
+	std::vector<uint8_t> bgra(image.pixels);
+	for (size_t i = 0; i < bgra.size(); i += 4){
+		uint8_t red = bgra[i];
+		bgra[i] = bgra[i + 2];
+		bgra[i + 2] = red;
+	}
+
+	HRESULT init = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	IWICImagingFactory* factory = nullptr;
+	IWICStream* stream = nullptr;
+	IWICBitmapEncoder* encoder = nullptr;
+	IWICBitmapFrameEncode* frame = nullptr;
+
+	HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, __uuidof(IWICImagingFactory), reinterpret_cast<void**>(&factory));
+	if (SUCCEEDED(hr)){
+		hr = factory->CreateStream(&stream);
+	}
+	if (SUCCEEDED(hr)){
+		hr = stream->InitializeFromFilename(widePath, GENERIC_WRITE);
+	}
+	if (SUCCEEDED(hr)){
+		hr = factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, &encoder);
+	}
+	if (SUCCEEDED(hr)){
+		hr = encoder->Initialize(stream, WICBitmapEncoderNoCache);
+	}
+	if (SUCCEEDED(hr)){
+		hr = encoder->CreateNewFrame(&frame, nullptr);
+	}
+	if (SUCCEEDED(hr)){
+		hr = frame->Initialize(nullptr);
+	}
+	if (SUCCEEDED(hr)){
+		hr = frame->SetSize(image.width, image.height);
+	}
+	WICPixelFormatGUID format = GUID_WICPixelFormat32bppBGRA;
+	if (SUCCEEDED(hr)){
+		hr = frame->SetPixelFormat(&format);
+	}
+	if (SUCCEEDED(hr) && format != GUID_WICPixelFormat32bppBGRA){
+		hr = E_FAIL;
+	}
+	if (SUCCEEDED(hr)){
+		hr = frame->WritePixels(image.height, image.width * 4, (UINT)bgra.size(), &bgra[0]);
+	}
+	if (SUCCEEDED(hr)){
+		hr = frame->Commit();
+	}
+	if (SUCCEEDED(hr)){
+		hr = encoder->Commit();
+	}
+
+	if (frame){
+		frame->Release();
+	}
+	if (encoder){
+		encoder->Release();
+	}
+	if (stream){
+		stream->Release();
+	}
+	if (factory){
+		factory->Release();
+	}
+	if (SUCCEEDED(init)){
+		CoUninitialize();
+	}
+	return SUCCEEDED(hr);
+}
+#else
+//libpng reads through this from the mapped file
+struct PngSource{
+	const unsigned char* data;
+	size_t size;
+	size_t offset;
+};
+
+static void ReadPngBytes(png_structp png, png_bytep out, png_size_t count){
+	PngSource* source = static_cast<PngSource*>(png_get_io_ptr(png));
+	if (count > source->size - source->offset){
+		png_error(png, "truncated");
+	}
+	memcpy(out, source->data + source->offset, count);
+	source->offset += count;
+}
+
+//Warnings such as a known bad colour profile don't stop the decode and aren't worth printing
+static void IgnorePngWarning(png_structp, png_const_charp){
+}
+
+static bool DecodePng(const unsigned char* data, size_t size, TextureImage& image){
+	png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, IgnorePngWarning);
+	if (!png){
+		return false;
+	}
+	png_infop info = png_create_info_struct(png);
+	if (!info){
+		png_destroy_read_struct(&png, nullptr, nullptr);
+		return false;
+	}
+	PngSource source = { data, size, 0 };
+	std::vector<png_bytep> rows;
+	//libpng reports errors by jumping back here
+	if (setjmp(png_jmpbuf(png))){
+		png_destroy_read_struct(&png, &info, nullptr);
+		return false;
+	}
+	png_set_read_fn(png, &source, ReadPngBytes);
+	png_read_info(png, info);
+
+	//whatever the file holds comes out as 8-bit RGBA
+	png_set_expand(png);
+	png_set_strip_16(png);
+	png_set_gray_to_rgb(png);
+	png_set_add_alpha(png, 0xFF, PNG_FILLER_AFTER);
+	png_set_interlace_handling(png);
+	png_read_update_info(png, info);
+
+	png_uint_32 width = png_get_image_width(png, info);
+	png_uint_32 height = png_get_image_height(png, info);
+	if (width == 0 || height == 0 || width > TEXTURE_MAX_DIMENSION || height > TEXTURE_MAX_DIMENSION || png_get_rowbytes(png, info) != width * 4){
+		png_destroy_read_struct(&png, &info, nullptr);
+		return false;
+	}
+	image.width = width;
+	image.height = height;
+	image.pixels.resize((size_t)width * height * 4);
+	rows.resize(height);
+	for (png_uint_32 y = 0; y < height; y++){
+		rows[y] = &image.pixels[(size_t)y * width * 4];
+	}
+	png_read_image(png, &rows[0]);
+	png_read_end(png, nullptr);
+	png_destroy_read_struct(&png, &info, nullptr);
+	return true;
+}
+
+//libjpeg would exit the process on an error, this jumps back to the decoder instead
+struct JpegErrors{
+	jpeg_error_mgr manager;
+	jmp_buf jump;
+};
+
+static void ExitJpeg(j_common_ptr decompressor){
+	longjmp(reinterpret_cast<JpegErrors*>(decompressor->err)->jump, 1);
+}
+
+static void IgnoreJpegMessage(j_common_ptr){
+}
+
+static bool DecodeJpeg(const unsigned char* data, size_t size, TextureImage& image){
+	jpeg_decompress_struct decompressor;
+	JpegErrors errors;
+	decompressor.err = jpeg_std_error(&errors.manager);
+	errors.manager.error_exit = ExitJpeg;
+	errors.manager.output_message = IgnoreJpegMessage;
+	std::vector<unsigned char> row;
+	if (setjmp(errors.jump)){
+		jpeg_destroy_decompress(&decompressor);
+		return false;
+	}
+	jpeg_create_decompress(&decompressor);
+	jpeg_mem_src(&decompressor, const_cast<unsigned char*>(data), (unsigned long)size);
+	jpeg_read_header(&decompressor, TRUE);
+	//grey stays grey and is spread over RGB below, anything else is converted to RGB
+	if (decompressor.jpeg_color_space != JCS_GRAYSCALE){
+		decompressor.out_color_space = JCS_RGB;
+	}
+	jpeg_start_decompress(&decompressor);
+
+	uint32_t width = decompressor.output_width;
+	uint32_t height = decompressor.output_height;
+	int components = decompressor.output_components;
+	if (width == 0 || height == 0 || width > TEXTURE_MAX_DIMENSION || height > TEXTURE_MAX_DIMENSION || (components != 1 && components != 3)){
+		jpeg_destroy_decompress(&decompressor);
+		return false;
+	}
+	image.width = width;
+	image.height = height;
+	image.pixels.resize((size_t)width * height * 4);
+	row.resize((size_t)width * components);
+	while (decompressor.output_scanline < height){
+		uint8_t* out = &image.pixels[(size_t)decompressor.output_scanline * width * 4];
+		JSAMPROW rows[1] = { &row[0] };
+		jpeg_read_scanlines(&decompressor, rows, 1);
+		for (uint32_t x = 0; x < width; x++){
+			const unsigned char* in = &row[x * components];
+			out[x * 4 + 0] = in[0];
+			out[x * 4 + 1] = in[components == 3 ? 1 : 0];
+			out[x * 4 + 2] = in[components == 3 ? 2 : 0];
+			out[x * 4 + 3] = 0xFF;
+		}
+	}
+	jpeg_finish_decompress(&decompressor);
+	jpeg_destroy_decompress(&decompressor);
+	return true;
+}
+
+bool LoadTextureImage(const std::string& path, TextureImage& image){
+	MappedFile mapped;
+	if (!mapped.open(path) || mapped.size() < 8){
+		return false;
+	}
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(mapped.data());
+	static const unsigned char pngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (memcmp(data, pngSignature, sizeof(pngSignature)) == 0){
+		return DecodePng(data, mapped.size(), image);
+	}
+	if (data[0] == 0xFF && data[1] == 0xD8){
+		return DecodeJpeg(data, mapped.size(), image);
+	}
+	return false;
+}
+
+//Fastest zlib level and only the Sub filter: frames are saved as fast as they are drawn
+bool SaveTextureImage(const std::string& path, const TextureImage& image){
+	if (image.width == 0 || image.height == 0){
+		return false;
+	}
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file){
+		return false;
+	}
+	png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, IgnorePngWarning);
+	png_infop info = png ? png_create_info_struct(png) : nullptr;
+	if (!info){
+		png_destroy_write_struct(&png, nullptr);
+		fclose(file);
+		return false;
+	}
+	std::vector<png_bytep> rows(image.height);
+	for (uint32_t y = 0; y < image.height; y++){
+		rows[y] = const_cast<png_bytep>(&image.pixels[(size_t)y * image.width * 4]);
+	}
+	//libpng reports errors by jumping back here
+	if (setjmp(png_jmpbuf(png))){
+		png_destroy_write_struct(&png, &info);
+		fclose(file);
+		return false;
+	}
+	png_init_io(png, file);
+	png_set_IHDR(png, info, image.width, image.height, 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_set_compression_level(png, 1);
+	png_set_filter(png, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+	png_write_info(png, info);
+	png_write_image(png, &rows[0]);
+	png_write_end(png, nullptr);
+	png_destroy_write_struct(&png, &info);
+	return fclose(file) == 0;
+}
+#endif
+
+bool HasTextureAlpha(const TextureImage& image){
+	for (size_t i = 3; i < image.pixels.size(); i += 4){
+		if (image.pixels[i] != 0xFF){
+			return true;
+		}
+	}
+	return false;
+}
+
+uint32_t GetTextureMipCount(uint32_t width, uint32_t height){
+	uint32_t count = 1;
+	while (width > 1 || height > 1){
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		count++;
+	}
+	return count;
+}
+
+//One source texel a target texel reads, and how much of it
+struct ResampleTap{
+	uint32_t source;
+	float weight;
+};
+
+/**
+*Taps along one axis. A target texel covers scale source texels (at least one, so upsizing
+*interpolates linearly) and reads each source texel by how much of it the footprint overlaps.
+*Off the edge reads clamp.
+**/
+static void BuildResampleTaps(uint32_t sourceSize, uint32_t targetSize, std::vector<uint32_t>& first, std::vector<ResampleTap>& taps){
+	float scale = (float)sourceSize / targetSize;
+	float footprint = scale > 1.0f ? scale : 1.0f;
+	first.resize(targetSize + 1);
+	taps.clear();
+	for (uint32_t t = 0; t < targetSize; t++){
+		first[t] = (uint32_t)taps.size();
+		float center = (t + 0.5f) * scale;
+		float low = center - footprint * 0.5f;
+		float high = center + footprint * 0.5f;
+		float total = 0.0f;
+		for (int s = (int)floorf(low); s < (int)ceilf(high); s++){
+			float overlap = (high < s + 1.0f ? high : s + 1.0f) - (low > (float)s ? low : (float)s);
+			if (overlap <= 1e-6f){
+				continue;
+			}
+			ResampleTap tap;
+			tap.source = s < 0 ? 0 : (s >= (int)sourceSize ? sourceSize - 1 : (uint32_t)s);
+			tap.weight = overlap;
+			taps.push_back(tap);
+			total += overlap;
+		}
+		for (size_t i = first[t]; i < taps.size(); i++){
+			taps[i].weight /= total;
+		}
+	}
+	first[targetSize] = (uint32_t)taps.size();
+}
+
+//Separable resample of float4 texels, rows first then columns
+static void ResampleLevel(const std::vector<float>& source, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t width, uint32_t height, std::vector<float>& target){
+	std::vector<uint32_t> first;
+	std::vector<ResampleTap> taps;
+
+	std::vector<float> rows((size_t)width * sourceHeight * 4);
+	BuildResampleTaps(sourceWidth, width, first, taps);
+	for (uint32_t y = 0; y < sourceHeight; y++){
+		const float* in = &source[(size_t)y * sourceWidth * 4];
+		float* out = &rows[(size_t)y * width * 4];
+		for (uint32_t x = 0; x < width; x++){
+			__m128 sum = _mm_setzero_ps();
+			for (uint32_t i = first[x]; i < first[x + 1]; i++){
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&in[taps[i].source * 4]), _mm_set1_ps(taps[i].weight)));
+			}
+			_mm_storeu_ps(&out[x * 4], sum);
+		}
+	}
+
+	target.assign((size_t)width * height * 4, 0.0f);
+	BuildResampleTaps(sourceHeight, height, first, taps);
+	for (uint32_t y = 0; y < height; y++){
+		float* out = &target[(size_t)y * width * 4];
+		for (uint32_t i = first[y]; i < first[y + 1]; i++){
+			const float* in = &rows[(size_t)taps[i].source * width * 4];
+			__m128 weight = _mm_set1_ps(taps[i].weight);
+			for (uint32_t x = 0; x < width; x++){
+				_mm_storeu_ps(&out[x * 4], _mm_add_ps(_mm_loadu_ps(&out[x * 4]), _mm_mul_ps(_mm_loadu_ps(&in[x * 4]), weight)));
+			}
+		}
+	}
+}
+
+//To the float4 texels filtering works on: linear light premultiplied by alpha, plain [0, 1], or [-1, 1] vectors
+static void DecodeLevel(const TextureImage& image, TextureEncoding encoding, std::vector<float>& texels){
+	size_t count = (size_t)image.width * image.height;
+	texels.resize(count * 4);
+	const uint8_t* in = &image.pixels[0];
+	const __m128 unit = _mm_set1_ps(1.0f / 255.0f);
+	for (size_t i = 0; i < count; i++, in += 4){
+		__m128 texel;
+		if (encoding == TEXTURE_SRGB){
+			float alpha = in[3] * (1.0f / 255.0f);
+			texel = _mm_mul_ps(_mm_setr_ps(srgbTables.toLinear[in[0]], srgbTables.toLinear[in[1]], srgbTables.toLinear[in[2]], 1.0f), _mm_set1_ps(alpha));
+		}
+		else{
+			texel = _mm_mul_ps(_mm_setr_ps(in[0], in[1], in[2], in[3]), unit);
+			if (encoding == TEXTURE_NORMAL_MAP){
+				texel = _mm_sub_ps(_mm_add_ps(texel, texel), _mm_setr_ps(1.0f, 1.0f, 1.0f, 0.0f));
+			}
+		}
+		_mm_storeu_ps(&texels[i * 4], texel);
+	}
+}
+
+static void EncodeLevel(const std::vector<float>& texels, uint32_t width, uint32_t height, TextureEncoding encoding, TextureImage& image){
+	size_t count = (size_t)width * height;
+	image.width = width;
+	image.height = height;
+	image.pixels.resize(count * 4);
+	uint8_t* out = &image.pixels[0];
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	for (size_t i = 0; i < count; i++, out += 4){
+		__m128 texel = _mm_loadu_ps(&texels[i * 4]);
+		float alpha = _mm_cvtss_f32(_mm_shuffle_ps(texel, texel, _MM_SHUFFLE(3, 3, 3, 3)));
+		__m128 scale;
+		if (encoding == TEXTURE_SRGB){
+			//back out of premultiplied, a fully clear texel has no colour left and goes black
+			float inverse = alpha > 1.0f / 1024.0f ? 1.0f / alpha : 0.0f;
+			scale = _mm_setr_ps(inverse, inverse, inverse, 1.0f);
+		}
+		else if (encoding == TEXTURE_NORMAL_MAP){
+			__m128 squared = _mm_mul_ps(texel, texel);
+			float length = sqrtf(_mm_cvtss_f32(squared) + _mm_cvtss_f32(_mm_shuffle_ps(squared, squared, _MM_SHUFFLE(1, 1, 1, 1))) +
+				_mm_cvtss_f32(_mm_shuffle_ps(squared, squared, _MM_SHUFFLE(2, 2, 2, 2))));
+			float inverse = length > 1e-6f ? 0.5f / length : 0.0f;
+			//[-1, 1] to [0, 1], alpha passes through
+			texel = _mm_add_ps(_mm_mul_ps(texel, _mm_setr_ps(inverse, inverse, inverse, 1.0f)), _mm_setr_ps(0.5f, 0.5f, 0.5f, 0.0f));
+			scale = one;
+		}
+		else{
+			scale = one;
+		}
+		texel = _mm_min_ps(_mm_max_ps(_mm_mul_ps(texel, scale), zero), one);
+
+		if (encoding == TEXTURE_SRGB){
+			__m128i steps = _mm_cvtps_epi32(_mm_mul_ps(texel, _mm_set1_ps(SRGB_ENCODE_STEPS - 1.0f)));
+			int32_t lanes[4];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), steps);
+			out[0] = srgbTables.toSrgb[lanes[0]];
+			out[1] = srgbTables.toSrgb[lanes[1]];
+			out[2] = srgbTables.toSrgb[lanes[2]];
+			out[3] = (uint8_t)(alpha <= 0.0f ? 0 : (alpha >= 1.0f ? 255 : (int)(alpha * 255.0f + 0.5f)));
+		}
+		else{
+			__m128i bytes = _mm_cvtps_epi32(_mm_mul_ps(texel, _mm_set1_ps(255.0f)));
+			bytes = _mm_packs_epi32(bytes, bytes);
+			bytes = _mm_packus_epi16(bytes, bytes);
+			int32_t packed = _mm_cvtsi128_si32(bytes);
+			memcpy(out, &packed, 4);
+		}
+	}
+}
+
+void BuildTextureMips(const TextureImage& image, uint32_t width, uint32_t height, TextureEncoding encoding, std::vector<TextureImage>& mips){
+	std::vector<float> level;
+	std::vector<float> next;
+	DecodeLevel(image, encoding, level);
+	if (width != image.width || height != image.height){
+		ResampleLevel(level, image.width, image.height, width, height, next);
+		level.swap(next);
+	}
+
+	uint32_t count = GetTextureMipCount(width, height);
+	mips.resize(count);
+	for (uint32_t mip = 0; mip < count; mip++){
+		EncodeLevel(level, width, height, encoding, mips[mip]);
+		if (mip + 1 < count){
+			uint32_t nextWidth = width > 1 ? width / 2 : 1;
+			uint32_t nextHeight = height > 1 ? height / 2 : 1;
+			ResampleLevel(level, width, height, nextWidth, nextHeight, next);
+			level.swap(next);
+			width = nextWidth;
+			height = nextHeight;
+		}
+	}
+}
+
+float ComputeImagePsnr(const TextureImage& reference, const TextureImage& test, unsigned int channels){
+	if (reference.width != test.width || reference.height != test.height || reference.pixels.empty()){
+		return 0.0f;
+	}
+	double squared = 0.0;
+	for (size_t i = 0; i < reference.pixels.size(); i += 4){
+		for (unsigned int c = 0; c < channels; c++){
+			double difference = (double)reference.pixels[i + c] - test.pixels[i + c];
+			squared += difference * difference;
+		}
+	}
+	double mean = squared / ((double)(reference.pixels.size() / 4) * channels);
+	if (mean <= 0.0){
+		return 999.0f;
+	}
+	return (float)(10.0 * log10(255.0 * 255.0 / mean));
+}
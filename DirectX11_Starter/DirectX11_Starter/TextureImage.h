@@ -0,0 +1,46 @@
+#ifndef _TEXTUREIMAGE_H
+#define _TEXTUREIMAGE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+//8-bit RGBA, rows tightly packed
+struct TextureImage{
+	uint32_t width;
+	uint32_t height;
+	std::vector<uint8_t> pixels;
+};
+
+//What the channels hold, which decides how mips are filtered
+enum TextureEncoding{
+	TEXTURE_SRGB, // colour, filtered in linear light with alpha weighting
+	TEXTURE_LINEAR, // data, filtered as stored
+	TEXTURE_NORMAL_MAP // xyz packed into [0, 1], renormalised after filtering
+};
+
+//Decodes a PNG or JPEG to RGBA8, the type is sniffed from the bytes rather than the extension.
+//WIC on Windows, libpng and libjpeg elsewhere
+bool LoadTextureImage(const std::string& path, TextureImage& image);
+
+//Writes image as a PNG, WIC on Windows and libpng elsewhere
+bool SaveTextureImage(const std::string& path, const TextureImage& image);
+
+//True if any pixel's alpha is under 255
+bool HasTextureAlpha(const TextureImage& image);
+
+//Levels down to 1x1, each half the one before rounded down
+uint32_t GetTextureMipCount(uint32_t width, uint32_t height);
+
+/**
+*Full mip chain of image, the first level resampled to width x height.
+*Every level is box filtered from the float copy of the level above it, so rounding only
+*happens once per level. Odd sizes get the exact box footprint, spread over three texels.
+**/
+void BuildTextureMips(const TextureImage& image, uint32_t width, uint32_t height, TextureEncoding encoding, std::vector<TextureImage>& mips);
+
+//Peak signal to noise ratio over the first channels of each pixel, in dB; 999 if identical
+float ComputeImagePsnr(const TextureImage& reference, const TextureImage& test, unsigned int channels);
+
+#endif
@@ -0,0 +1,204 @@
+#include "TextureResidency.h"
+#include <algorithm>
+#include <cmath>
+
+TextureResidency::TextureResidency(size_t budgetBytes, size_t uploadBytes){
+	budget = budgetBytes;
+	uploadBudget = uploadBytes;
+	residentBytes = 0;
+	frame = 1;
+}
+
+unsigned int TextureResidency::add(uint32_t width, uint32_t height, unsigned int mipCount, const size_t* levelBytes){
+	Entry entry;
+	entry.width = width;
+	entry.height = height;
+	entry.mipCount = mipCount > 0 ? mipCount : 1;
+	entry.levelBytes.assign(levelBytes, levelBytes + entry.mipCount);
+	entry.tailMip = 0;
+	while (entry.tailMip + 1 < entry.mipCount && ((width >> entry.tailMip) > TEXTURE_TAIL_SIZE || (height >> entry.tailMip) > TEXTURE_TAIL_SIZE)){
+		entry.tailMip++;
+	}
+	entry.residentMip = entry.tailMip;
+	entry.wantedMip = entry.tailMip;
+	entry.frameMip = entry.tailMip;
+	entry.lastUsed = 0;
+	entry.live = true;
+	for (unsigned int mip = entry.tailMip; mip < entry.mipCount; mip++){
+		residentBytes += entry.levelBytes[mip];
+	}
+	entries.push_back(entry);
+	return (unsigned int)entries.size() - 1;
+}
+
+void TextureResidency::remove(unsigned int texture){
+	Entry& entry = entries[texture];
+	if (!entry.live){
+		return;
+	}
+	for (unsigned int mip = entry.residentMip; mip < entry.mipCount; mip++){
+		residentBytes -= entry.levelBytes[mip];
+	}
+	entry.live = false;
+	entry.levelBytes.clear();
+}
+
+//The level with at least as many texels as the screen has pixels across it
+unsigned int TextureResidency::selectMip(const Entry& entry, float screenPixels){
+	if (screenPixels < 1.0f){
+		return entry.tailMip;
+	}
+	float texels = (float)(entry.width > entry.height ? entry.width : entry.height);
+	float ratio = texels / screenPixels;
+	unsigned int mip = ratio > 1.0f ? (unsigned int)floorf(log2f(ratio)) : 0;
+	return mip < entry.tailMip ? mip : entry.tailMip;
+}
+
+void TextureResidency::request(unsigned int texture, float screenPixels){
+	Entry& entry = entries[texture];
+	unsigned int mip = selectMip(entry, screenPixels);
+	if (entry.lastUsed != frame){
+		entry.lastUsed = frame;
+		entry.frameMip = mip;
+	}
+	else if (mip < entry.frameMip){
+		entry.frameMip = mip;
+	}
+}
+
+void TextureResidency::recordChange(unsigned int texture, unsigned int fromMip, unsigned int toMip, std::vector<TextureResidencyChange>& changes){
+	for (size_t i = 0; i < changes.size(); i++){
+		if (changes[i].texture == texture){
+			changes[i].toMip = toMip;
+			return;
+		}
+	}
+	TextureResidencyChange change;
+	change.texture = texture;
+	change.fromMip = fromMip;
+	change.toMip = toMip;
+	changes.push_back(change);
+}
+
+bool TextureResidency::evict(unsigned int texture, std::vector<TextureResidencyChange>& changes){
+	uint64_t protectedSince = texture < entries.size() ? entries[texture].lastUsed : frame + 1;
+	unsigned int victim = (unsigned int)entries.size();
+	for (unsigned int i = 0; i < entries.size(); i++){
+		const Entry& entry = entries[i];
+		if (i == texture || !entry.live || entry.residentMip >= entry.tailMip){
+			continue;
+		}
+		//levels it asked for stay unless something used more recently needs the room
+		if (entry.lastUsed >= protectedSince && entry.residentMip >= entry.wantedMip){
+			continue;
+		}
+		if (victim == entries.size() || entry.lastUsed < entries[victim].lastUsed){
+			victim = i;
+		}
+	}
+	if (victim == entries.size()){
+		return false;
+	}
+	Entry& entry = entries[victim];
+	residentBytes -= entry.levelBytes[entry.residentMip];
+	recordChange(victim, entry.residentMip, entry.residentMip + 1, changes);
+	entry.residentMip++;
+	return true;
+}
+
+/**
+*Over budget first (the budget may have dropped), evicting the least recently used levels.
+*Then every texture short of what it wants, latest used and furthest off first, takes
+*levels one at a time while the upload budget lasts, evicting older ones to make room.
+**/
+void TextureResidency::update(std::vector<TextureResidencyChange>& changes){
+	changes.clear();
+	for (unsigned int i = 0; i < entries.size(); i++){
+		if (entries[i].live && entries[i].lastUsed == frame){
+			entries[i].wantedMip = entries[i].frameMip;
+		}
+	}
+
+	while (residentBytes > budget && evict((unsigned int)entries.size(), changes)){
+	}
+
+	order.clear();
+	for (unsigned int i = 0; i < entries.size(); i++){
+		if (entries[i].live && entries[i].wantedMip < entries[i].residentMip){
+			order.push_back(i);
+		}
+	}
+	std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b){
+		const Entry& first = entries[a];
+		const Entry& second = entries[b];
+		if (first.lastUsed != second.lastUsed){
+			return first.lastUsed > second.lastUsed;
+		}
+		return first.residentMip - first.wantedMip > second.residentMip - second.wantedMip;
+	});
+
+	size_t uploaded = 0;
+	for (size_t i = 0; i < order.size(); i++){
+		Entry& entry = entries[order[i]];
+		unsigned int fromMip = entry.residentMip;
+		while (entry.residentMip > entry.wantedMip){
+			size_t cost = entry.levelBytes[entry.residentMip - 1];
+			if (uploaded > 0 && uploaded + cost > uploadBudget){
+				break;
+			}
+			while (residentBytes + cost > budget && evict(order[i], changes)){
+			}
+			if (residentBytes + cost > budget){
+				break;
+			}
+			entry.residentMip--;
+			residentBytes += cost;
+			uploaded += cost;
+		}
+		if (entry.residentMip != fromMip){
+			recordChange(order[i], fromMip, entry.residentMip, changes);
+		}
+		if (uploaded >= uploadBudget){
+			break;
+		}
+	}
+
+	//a texture that lost levels and got them back in the same update didn't move
+	for (size_t i = 0; i < changes.size();){
+		if (changes[i].fromMip == changes[i].toMip){
+			changes.erase(changes.begin() + i);
+		}
+		else{
+			i++;
+		}
+	}
+	frame++;
+}
+
+unsigned int TextureResidency::getResidentMip(unsigned int texture){
+	return entries[texture].residentMip;
+}
+
+unsigned int TextureResidency::getWantedMip(unsigned int texture){
+	return entries[texture].wantedMip;
+}
+
+unsigned int TextureResidency::getTailMip(unsigned int texture){
+	return entries[texture].tailMip;
+}
+
+size_t TextureResidency::getResidentBytes(){
+	return residentBytes;
+}
+
+size_t TextureResidency::getBudget(){
+	return budget;
+}
+
+void TextureResidency::setBudget(size_t bytes){
+	budget = bytes;
+}
+
+void TextureResidency::setUploadBudget(size_t bytes){
+	uploadBudget = bytes;
+}
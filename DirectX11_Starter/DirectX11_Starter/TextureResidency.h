@@ -0,0 +1,80 @@
+#ifndef _TEXTURERESIDENCY_H
+#define _TEXTURERESIDENCY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#define TEXTURE_TAIL_SIZE 64 // levels no larger than this on either side load up front and are never evicted
+
+//A texture whose finest resident level moved during an update
+struct TextureResidencyChange{
+	unsigned int texture;
+	unsigned int fromMip;
+	unsigned int toMip;
+};
+
+/**
+*Decides which mip levels of each streamed texture should be resident.
+*Every texture starts with just its tail, the levels up to TEXTURE_TAIL_SIZE. Draws report
+*how many pixels a texture covers on screen with request, and update, once a frame, promotes
+*textures towards the finest level those requests need, most recently used first.
+*Resident levels stay until the budget needs their memory: then the least recently used
+*texture loses its finest level, one level at a time, but only to make room for one used
+*more recently (or when a texture holds levels finer than it asked for).
+*A texture always holds a full chain from its finest resident level down to 1x1.
+*Only bookkeeping: update reports what moved and the caller creates the GPU textures. No D3D in here.
+**/
+class TextureResidency{
+public:
+	TextureResidency(size_t budgetBytes, size_t uploadBytes);
+
+	//levelBytes has mipCount entries, largest first. Returns the texture's id
+	unsigned int add(uint32_t width, uint32_t height, unsigned int mipCount, const size_t* levelBytes);
+	//Stops counting the texture's memory, the id isn't reused
+	void remove(unsigned int texture);
+
+	//screenPixels: the size on screen the whole texture is stretched over, along its larger side
+	void request(unsigned int texture, float screenPixels);
+	//Applies this frame's requests, fills changes with every texture whose resident levels moved
+	void update(std::vector<TextureResidencyChange>& changes);
+
+	unsigned int getResidentMip(unsigned int texture);
+	unsigned int getWantedMip(unsigned int texture);
+	unsigned int getTailMip(unsigned int texture);
+	size_t getResidentBytes(); // every texture's resident levels, tails included
+	size_t getBudget();
+	//A lower budget is met on the next update, by evicting
+	void setBudget(size_t bytes);
+	//Most bytes of new levels one update promotes, at least one texture always moves
+	void setUploadBudget(size_t bytes);
+
+private:
+	struct Entry{
+		uint32_t width;
+		uint32_t height;
+		unsigned int mipCount;
+		unsigned int tailMip; // coarsest levels from here on are always resident
+		unsigned int residentMip; // finest resident level
+		unsigned int wantedMip; // finest level the latest requests need
+		unsigned int frameMip; // finest requested this frame
+		uint64_t lastUsed; // frame of the latest request
+		bool live;
+		std::vector<size_t> levelBytes;
+	};
+
+	unsigned int selectMip(const Entry& entry, float screenPixels);
+	//Drops the finest level of the least recently used texture that may give one up to make
+	//room for texture; false if none can
+	bool evict(unsigned int texture, std::vector<TextureResidencyChange>& changes);
+	void recordChange(unsigned int texture, unsigned int fromMip, unsigned int toMip, std::vector<TextureResidencyChange>& changes);
+
+	std::vector<Entry> entries;
+	std::vector<unsigned int> order; // promotion order, rebuilt each update
+	size_t budget;
+	size_t uploadBudget;
+	size_t residentBytes;
+	uint64_t frame;
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "TextureStreamer.h"
+#include "Global.h"
+
+ID3D11ShaderResourceView* CreateLevelTexture(ID3D11Device* device, uint32_t format, const TextureFileLevel* levels, unsigned int count){
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = levels[0].width;
+	desc.Height = levels[0].height;
+	desc.MipLevels = count;
+	desc.ArraySize = 1;
+	desc.Format = (DXGI_FORMAT)format;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	std::vector<D3D11_SUBRESOURCE_DATA> initData(count);
+	for (unsigned int mip = 0; mip < count; mip++){
+		initData[mip].pSysMem = levels[mip].data;
+		initData[mip].SysMemPitch = levels[mip].rowPitch;
+		initData[mip].SysMemSlicePitch = levels[mip].slicePitch;
+	}
+
+	ID3D11Texture2D* texture = nullptr;
+	if (FAILED(device->CreateTexture2D(&desc, &initData[0], &texture))){
+		return nullptr;
+	}
+	ID3D11ShaderResourceView* view = nullptr;
+	HRESULT hr = device->CreateShaderResourceView(texture, nullptr, &view);
+	ReleaseMacro(texture);
+	return SUCCEEDED(hr) ? view : nullptr;
+}
+
+TextureStreamer::TextureStreamer(ID3D11Device* dev, size_t budgetBytes, size_t uploadBytes) : residency(budgetBytes, uploadBytes){
+	device = dev;
+}
+
+//Slots keep their own references, so views still in use outlive the streamer
+TextureStreamer::~TextureStreamer(void){
+	for (size_t i = 0; i < textures.size(); i++){
+		if (textures[i]){
+			ReleaseMacro(textures[i]->resourceView);
+			delete textures[i];
+			textures[i] = nullptr;
+		}
+	}
+}
+
+void TextureStreamer::setView(StreamedMips* texture, ID3D11ShaderResourceView* resourceView){
+	for (size_t i = 0; i < texture->slots.size(); i++){
+		ReleaseMacro((*texture->slots[i]));
+		*texture->slots[i] = resourceView;
+		resourceView->AddRef();
+	}
+	ReleaseMacro(texture->resourceView);
+	texture->resourceView = resourceView;
+}
+
+bool TextureStreamer::track(const std::string& sourcePath, ID3D11ShaderResourceView** slot){
+	if (bySlot.find(slot) != bySlot.end()){
+		untrack(slot);
+	}
+
+	StreamedMips* texture = nullptr;
+	std::unordered_map<std::string, unsigned int>::iterator found = byPath.find(sourcePath);
+	if (found != byPath.end()){
+		texture = textures[found->second];
+	}
+	else{
+		texture = new StreamedMips();
+		if (!OpenCookedTexture(sourcePath, texture->cooked, texture->view)){
+			delete texture;
+			return false;
+		}
+		GetTextureFileLevels(texture->view, texture->levels);
+		std::vector<size_t> levelBytes(texture->levels.size());
+		for (size_t mip = 0; mip < levelBytes.size(); mip++){
+			levelBytes[mip] = texture->levels[mip].slicePitch;
+		}
+		texture->residency = residency.add(texture->view.header->width, texture->view.header->height, (unsigned int)levelBytes.size(), &levelBytes[0]);
+
+		unsigned int first = residency.getResidentMip(texture->residency);
+		texture->resourceView = CreateLevelTexture(device, texture->view.format, &texture->levels[first], (unsigned int)texture->levels.size() - first);
+		if (!texture->resourceView){
+			residency.remove(texture->residency);
+			delete texture;
+			return false;
+		}
+		texture->path = sourcePath;
+		if (textures.size() <= texture->residency){
+			textures.resize(texture->residency + 1, nullptr);
+		}
+		textures[texture->residency] = texture;
+		byPath[sourcePath] = texture->residency;
+	}
+
+	ReleaseMacro((*slot));
+	*slot = texture->resourceView;
+	texture->resourceView->AddRef();
+	texture->slots.push_back(slot);
+	bySlot[slot] = texture->residency;
+	return true;
+}
+
+void TextureStreamer::untrack(ID3D11ShaderResourceView** slot){
+	std::unordered_map<ID3D11ShaderResourceView* const*, unsigned int>::iterator found = bySlot.find(slot);
+	if (found == bySlot.end()){
+		return;
+	}
+	StreamedMips* texture = textures[found->second];
+	bySlot.erase(found);
+	for (size_t i = 0; i < texture->slots.size(); i++){
+		if (texture->slots[i] == slot){
+			texture->slots.erase(texture->slots.begin() + i);
+			break;
+		}
+	}
+	if (!texture->slots.empty()){
+		return;
+	}
+
+	//nothing draws with it any more
+	residency.remove(texture->residency);
+	byPath.erase(texture->path);
+	textures[texture->residency] = nullptr;
+	ReleaseMacro(texture->resourceView);
+	delete texture;
+}
+
+void TextureStreamer::request(ID3D11ShaderResourceView* const* slot, float screenPixels){
+	std::unordered_map<ID3D11ShaderResourceView* const*, unsigned int>::iterator found = bySlot.find(slot);
+	if (found != bySlot.end()){
+		residency.request(found->second, screenPixels);
+	}
+}
+
+unsigned int TextureStreamer::update(){
+	residency.update(changes);
+	unsigned int moved = 0;
+	for (size_t i = 0; i < changes.size(); i++){
+		StreamedMips* texture = textures[changes[i].texture];
+		//recreated even when levels were only dropped, a clamped view would keep their memory
+		unsigned int first = changes[i].toMip;
+		ID3D11ShaderResourceView* resourceView = CreateLevelTexture(device, texture->view.format, &texture->levels[first], (unsigned int)texture->levels.size() - first);
+		//out of memory: draws keep the old levels, the budget already counts the new ones
+		if (!resourceView){
+			continue;
+		}
+		setView(texture, resourceView);
+		moved++;
+	}
+	return moved;
+}
+
+size_t TextureStreamer::getResidentBytes(){
+	return residency.getResidentBytes();
+}
+
+void TextureStreamer::setBudget(size_t bytes){
+	residency.setBudget(bytes);
+}
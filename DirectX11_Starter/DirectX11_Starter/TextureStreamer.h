@@ -0,0 +1,70 @@
+#ifndef _TEXTURESTREAMER_H
+#define _TEXTURESTREAMER_H
+
+#include <d3d11.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "MappedFile.h"
+#include "TextureFile.h"
+#include "TextureResidency.h"
+
+//Immutable texture of count levels from levels, which can point into a mapped DDS; nullptr if creation fails
+ID3D11ShaderResourceView* CreateLevelTexture(ID3D11Device* device, uint32_t format, const TextureFileLevel* levels, unsigned int count);
+
+/**
+*D3D11 side of TextureResidency.
+*Each streamed texture keeps its cooked DDS mapped and its GPU texture holds exactly the
+*resident levels, the view covering all of them. Narrowing the view (MostDetailedMip) or
+*SetResourceMinLOD would stop draws sampling the evicted levels, but their memory stays
+*allocated, and freeing it is the point of the budget. D3D11 can't release part of a texture,
+*so when the resident levels move a texture of the new size is created from the mapping and
+*swapped into every slot that tracks it; the old one goes once the last draw using it is done.
+*Slots are the ID3D11ShaderResourceView* members materials draw with. Each holds its own
+*reference, released and replaced on a swap. Main thread only.
+**/
+class TextureStreamer{
+public:
+	TextureStreamer(ID3D11Device* dev, size_t budgetBytes, size_t uploadBytes);
+	~TextureStreamer(void);
+
+	//Puts the tail of sourcePath's cooked texture in *slot and keeps it current. False, with
+	//*slot untouched, when there is no current cooked texture
+	bool track(const std::string& sourcePath, ID3D11ShaderResourceView** slot);
+	//The slot keeps the view it has
+	void untrack(ID3D11ShaderResourceView** slot);
+
+	//Screen size in pixels the slot's texture was drawn over this frame, ignored for untracked slots
+	void request(ID3D11ShaderResourceView* const* slot, float screenPixels);
+	//Once a frame: applies the requests and swaps in resized textures, returns how many moved
+	unsigned int update();
+
+	size_t getResidentBytes();
+	void setBudget(size_t bytes);
+
+private:
+	struct StreamedMips{
+		std::string path;
+		MappedFile cooked;
+		TextureFileView view;
+		std::vector<TextureFileLevel> levels;
+		unsigned int residency; // id in TextureResidency
+		ID3D11ShaderResourceView* resourceView; // the streamer's own reference
+		std::vector<ID3D11ShaderResourceView**> slots;
+	};
+
+	void setView(StreamedMips* texture, ID3D11ShaderResourceView* resourceView);
+
+	ID3D11Device* device;
+	TextureResidency residency;
+	std::vector<StreamedMips*> textures; // by residency id, nullptr once untracked by every slot
+	std::unordered_map<std::string, unsigned int> byPath;
+	std::unordered_map<ID3D11ShaderResourceView* const*, unsigned int> bySlot;
+	std::vector<TextureResidencyChange> changes;
+
+	// Prevent copying.
+	TextureStreamer(TextureStreamer const&);
+	TextureStreamer& operator= (TextureStreamer const&);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int threads){
+	stopping = false;
+	for (unsigned int i = 0; i < threads; i++){
+		workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+	}
+}
+
+ThreadPool::~ThreadPool(void){
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); i++){
+		workers[i].join();
+	}
+}
+
+void ThreadPool::workerLoop(){
+	for (;;){
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this](){ return stopping || !tasks.empty(); });
+			if (tasks.empty()){
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
+
+unsigned int ThreadPool::getThreadCount(){
+	return workers.size();
+}
+
+unsigned int ThreadPool::DefaultThreadCount(){
+	unsigned int hardware = std::thread::hardware_concurrency();
+	return hardware > 1 ? hardware - 1 : 1;
+}
@@ -0,0 +1,57 @@
+#ifndef _THREADPOOL_H
+#define _THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+//Fixed set of worker threads fed from one FIFO queue.
+//submit() returns a future for the task's result; the destructor finishes every queued task
+//before joining.
+class ThreadPool{
+public:
+	ThreadPool(unsigned int threads);
+	~ThreadPool(void);
+
+	template<typename TTask>
+	std::future<typename std::result_of<TTask()>::type> submit(TTask task);
+
+	unsigned int getThreadCount();
+
+	//hardware threads minus the calling one, at least 1
+	static unsigned int DefaultThreadCount();
+
+private:
+	void workerLoop();
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable wake;
+	bool stopping;
+
+	// Prevent copying.
+	ThreadPool(ThreadPool const&);
+	ThreadPool& operator= (ThreadPool const&);
+};
+
+//packaged_task is move only, so it is held by shared_ptr to fit in a std::function
+template<typename TTask>
+std::future<typename std::result_of<TTask()>::type> ThreadPool::submit(TTask task){
+	typedef typename std::result_of<TTask()>::type TResult;
+	std::shared_ptr<std::packaged_task<TResult()>> packaged = std::make_shared<std::packaged_task<TResult()>>(task);
+	std::future<TResult> result = packaged->get_future();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back([packaged](){ (*packaged)(); });
+	}
+	wake.notify_one();
+	return result;
+}
+
+#endif
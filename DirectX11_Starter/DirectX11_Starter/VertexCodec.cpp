@@ -0,0 +1,236 @@
+#include "VertexCodec.h"
+#include <cmath>
+#include <cstring>
+
+//Round to nearest even, out of range values saturate to the largest half rather than infinity
+uint16_t FloatToHalf(float value){
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = (bits >> 16) & 0x8000;
+	uint32_t magnitude = bits & 0x7FFFFFFF;
+
+	if (magnitude > 0x7F800000){
+		return (uint16_t)(sign | 0x7E00); // NaN
+	}
+	if (magnitude >= 0x477FF000){
+		return (uint16_t)(sign | 0x7BFF); // rounds past 65504
+	}
+	if (magnitude < 0x38800000){
+		//denormal half, shift the implicit one in and round on the dropped bits
+		if (magnitude < 0x33000000){
+			return (uint16_t)sign;
+		}
+		uint32_t exponent = magnitude >> 23;
+		uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+		uint32_t shift = 126 - exponent;
+		uint32_t half = mantissa >> shift;
+		uint32_t rest = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (rest > halfway || (rest == halfway && (half & 1))){
+			half++;
+		}
+		return (uint16_t)(sign | half);
+	}
+
+	uint32_t half = ((magnitude - 0x38000000) >> 13);
+	uint32_t rest = magnitude & 0x1FFF;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))){
+		half++;
+	}
+	return (uint16_t)(sign | half);
+}
+
+float HalfToFloat(uint16_t half){
+	uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+	uint32_t exponent = (half >> 10) & 0x1F;
+	uint32_t mantissa = half & 0x3FF;
+	uint32_t bits;
+	if (exponent == 0){
+		if (mantissa == 0){
+			bits = sign;
+		}
+		else{
+			//renormalise the denormal
+			exponent = 113;
+			while ((mantissa & 0x400) == 0){
+				mantissa <<= 1;
+				exponent--;
+			}
+			bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+		}
+	}
+	else if (exponent == 31){
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else{
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	}
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static float SignNotZero(float value){
+	return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+static int16_t ToSnorm16(float value){
+	if (value > 1.0f) value = 1.0f;
+	if (value < -1.0f) value = -1.0f;
+	return (int16_t)floorf(value * 32767.0f + 0.5f);
+}
+
+static float FromSnorm16(int16_t value){
+	float decoded = (float)value / 32767.0f;
+	return decoded < -1.0f ? -1.0f : decoded;
+}
+
+static XMFLOAT3 DecodeOctahedral(float x, float y){
+	XMFLOAT3 n(x, y, 1.0f - fabsf(x) - fabsf(y));
+	if (n.z < 0.0f){
+		float ox = (1.0f - fabsf(y)) * SignNotZero(x);
+		float oy = (1.0f - fabsf(x)) * SignNotZero(y);
+		n.x = ox;
+		n.y = oy;
+	}
+	float length = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+	n.x /= length;
+	n.y /= length;
+	n.z /= length;
+	return n;
+}
+
+XMFLOAT3 DecodeOctahedral(const int16_t encoded[2]){
+	return DecodeOctahedral(FromSnorm16(encoded[0]), FromSnorm16(encoded[1]));
+}
+
+//Projects onto the octahedron, then tries the four nearest grid points and keeps the closest
+void EncodeOctahedral(const XMFLOAT3& direction, int16_t encoded[2]){
+	float l1 = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+	if (l1 == 0.0f){
+		encoded[0] = 0;
+		encoded[1] = 0;
+		return;
+	}
+	float x = direction.x / l1;
+	float y = direction.y / l1;
+	if (direction.z < 0.0f){
+		float ox = (1.0f - fabsf(y)) * SignNotZero(x);
+		float oy = (1.0f - fabsf(x)) * SignNotZero(y);
+		x = ox;
+		y = oy;
+	}
+
+	float length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+	float baseX = floorf(x * 32767.0f);
+	float baseY = floorf(y * 32767.0f);
+	float bestDot = -2.0f;
+	for (int i = 0; i < 4; i++){
+		float cx = (baseX + (i & 1)) / 32767.0f;
+		float cy = (baseY + (i >> 1)) / 32767.0f;
+		int16_t candidate[2] = { ToSnorm16(cx), ToSnorm16(cy) };
+		XMFLOAT3 decoded = DecodeOctahedral(candidate);
+		float dot = (decoded.x * direction.x + decoded.y * direction.y + decoded.z * direction.z) / length;
+		if (dot > bestDot){
+			bestDot = dot;
+			encoded[0] = candidate[0];
+			encoded[1] = candidate[1];
+		}
+	}
+}
+
+static uint16_t QuantizePosition(float value, float minimum, float scale){
+	float q = (value - minimum) * scale;
+	if (q < 0.0f) q = 0.0f;
+	if (q > 65535.0f) q = 65535.0f;
+	return (uint16_t)floorf(q + 0.5f);
+}
+
+void PackVertices(const Vertex2* vertices, size_t count, const XMFLOAT3& center, float radius, PackedVertex2* packed){
+	float scale = radius > 0.0f ? 65535.0f / (2.0f * radius) : 0.0f;
+	for (size_t i = 0; i < count; i++){
+		const Vertex2& v = vertices[i];
+		PackedVertex2& p = packed[i];
+		p.position[0] = QuantizePosition(v.Position.x, center.x - radius, scale);
+		p.position[1] = QuantizePosition(v.Position.y, center.y - radius, scale);
+		p.position[2] = QuantizePosition(v.Position.z, center.z - radius, scale);
+		p.position[3] = v.Tangent.w < 0.0f ? 65535 : 0;
+		EncodeOctahedral(v.Normal, p.normal);
+		p.uv[0] = FloatToHalf(v.UVs.x);
+		p.uv[1] = FloatToHalf(v.UVs.y);
+		EncodeOctahedral(XMFLOAT3(v.Tangent.x, v.Tangent.y, v.Tangent.z), p.tangent);
+	}
+}
+
+void UnpackVertices(const PackedVertex2* packed, size_t count, const XMFLOAT3& center, float radius, Vertex2* vertices){
+	float step = 2.0f * radius / 65535.0f;
+	for (size_t i = 0; i < count; i++){
+		const PackedVertex2& p = packed[i];
+		Vertex2& v = vertices[i];
+		v.Position = XMFLOAT3(center.x - radius + p.position[0] * step, center.y - radius + p.position[1] * step, center.z - radius + p.position[2] * step);
+		v.Normal = DecodeOctahedral(p.normal);
+		v.UVs = XMFLOAT2(HalfToFloat(p.uv[0]), HalfToFloat(p.uv[1]));
+		XMFLOAT3 tangent = DecodeOctahedral(p.tangent);
+		v.Tangent = XMFLOAT4(tangent.x, tangent.y, tangent.z, p.position[3] ? -1.0f : 1.0f);
+	}
+}
+
+//Degrees between a direction and its decoded form, zero length inputs have no direction to lose.
+//Done in double, a float acos near 1 is off by more than the error being measured
+static float AngleError(const XMFLOAT3& direction, const XMFLOAT3& decoded){
+	double length = sqrt((double)direction.x * direction.x + (double)direction.y * direction.y + (double)direction.z * direction.z);
+	double decodedLength = sqrt((double)decoded.x * decoded.x + (double)decoded.y * decoded.y + (double)decoded.z * decoded.z);
+	if (length == 0.0 || decodedLength == 0.0){
+		return 0.0f;
+	}
+	double cosine = ((double)direction.x * decoded.x + (double)direction.y * decoded.y + (double)direction.z * decoded.z) / (length * decodedLength);
+	if (cosine > 1.0) cosine = 1.0;
+	if (cosine < -1.0) cosine = -1.0;
+	return (float)(acos(cosine) * 57.29577951308232);
+}
+
+static float UvError(float uv, float decoded){
+	float magnitude = fabsf(uv) > 1.0f ? fabsf(uv) : 1.0f;
+	return fabsf(decoded - uv) / magnitude;
+}
+
+VertexPackingError MeasurePackingError(const Vertex2* vertices, const PackedVertex2* packed, size_t count, const XMFLOAT3& center, float radius){
+	VertexPackingError error;
+	memset(&error, 0, sizeof(error));
+	for (size_t i = 0; i < count; i++){
+		Vertex2 decoded;
+		UnpackVertices(&packed[i], 1, center, radius, &decoded);
+		const Vertex2& v = vertices[i];
+
+		float dx = decoded.Position.x - v.Position.x;
+		float dy = decoded.Position.y - v.Position.y;
+		float dz = decoded.Position.z - v.Position.z;
+		float position = sqrtf(dx * dx + dy * dy + dz * dz);
+		float normal = AngleError(v.Normal, decoded.Normal);
+		float tangent = AngleError(XMFLOAT3(v.Tangent.x, v.Tangent.y, v.Tangent.z), XMFLOAT3(decoded.Tangent.x, decoded.Tangent.y, decoded.Tangent.z));
+		if ((v.Tangent.w < 0.0f) != (decoded.Tangent.w < 0.0f)){
+			tangent = 180.0f;
+		}
+		float uv = UvError(v.UVs.x, decoded.UVs.x);
+		float uvY = UvError(v.UVs.y, decoded.UVs.y);
+
+		if (position > error.position) error.position = position;
+		if (normal > error.normal) error.normal = normal;
+		if (tangent > error.tangent) error.tangent = tangent;
+		if (uv > error.uv) error.uv = uv;
+		if (uvY > error.uv) error.uv = uvY;
+	}
+	return error;
+}
+
+VertexPackingError GetPackingErrorBound(float radius){
+	VertexPackingError bound;
+	//half a step on each axis, with room for the float math in the decode
+	bound.position = sqrtf(3.0f) * radius / 65535.0f * 1.01f + radius * 1e-6f;
+	//16-bit octahedral with the nearest of four candidates stays under a hundredth of a degree
+	bound.normal = 0.01f;
+	bound.tangent = 0.01f;
+	//half an ulp of an 11-bit significand
+	bound.uv = 1.0f / 2048.0f;
+	return bound;
+}
@@ -0,0 +1,46 @@
+#ifndef _VERTEXCODEC_H
+#define _VERTEXCODEC_H
+
+#include "Global.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+*Compressed Vertex2, 20 bytes instead of 48.
+*	position	16-bit unorm inside the mesh's bounding cube, center +- radius
+*				w holds the tangent handedness, 0 for +1 and 1 for -1
+*	normal		octahedral, 16-bit snorm
+*	uv			half floats
+*	tangent		octahedral, 16-bit snorm
+*The packed vertex shaders decode normals and tangents; position decode is folded into the
+*world matrix (Mesh::decodeMatrix), so it costs nothing per vertex.
+**/
+struct PackedVertex2{
+	uint16_t position[4]; // w is the tangent handedness
+	int16_t normal[2];
+	uint16_t uv[2];
+	int16_t tangent[2];
+};
+
+//Largest error the reference codec found over a mesh
+struct VertexPackingError{
+	float position; // model units
+	float normal; // degrees
+	float tangent; // 180 if the handedness flipped
+	float uv; // relative to the uv's magnitude, at least 1
+};
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t half);
+
+void EncodeOctahedral(const XMFLOAT3& direction, int16_t encoded[2]);
+XMFLOAT3 DecodeOctahedral(const int16_t encoded[2]);
+
+void PackVertices(const Vertex2* vertices, size_t count, const XMFLOAT3& center, float radius, PackedVertex2* packed);
+void UnpackVertices(const PackedVertex2* packed, size_t count, const XMFLOAT3& center, float radius, Vertex2* vertices);
+
+VertexPackingError MeasurePackingError(const Vertex2* vertices, const PackedVertex2* packed, size_t count, const XMFLOAT3& center, float radius);
+//What the formats guarantee, MeasurePackingError must stay inside it
+VertexPackingError GetPackingErrorBound(float radius);
+
+#endif
@@ -2,7 +2,7 @@
 #include "Game.h"
 
 
-healthPickup::healthPickup(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed){
+healthPickup::healthPickup(ID3D11Device* dev, ID3D11DeviceContext* devCtx, AssetManager* assets, vector<ConstantBuffer*> constantBufferList, ID3D11SamplerState* samplerState, Mesh* meshReference, Player* playerReference, Game* gameReferencePassed){
 	// set up the lighting parameters
 	lighting.ambientColor = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
 	lighting.diffuseColor = XMFLOAT4(0.5f, 0.5f, 0.5f, 1.0f);
@@ -13,8 +13,8 @@ healthPickup::healthPickup(ID3D11Device* dev, ID3D11DeviceContext* devCtx, vecto
 	device = dev;
 	deviceContext = devCtx;
 	sampler = samplerState;
-	shaderProgram = new ShaderProgram(L"NormalVertexShader.cso", L"NormalPixelShader.cso", device, constantBufferList);
-	healthMaterial = new Material(device, deviceContext, sampler, L"energy.png", shaderProgram);
+	shaderProgram = assets->getMeshShaderProgram(MESH_SHADER_LIT, constantBufferList);
+	healthMaterial = new Material(assets, sampler, L"energy.png", shaderProgram);
 	player = playerReference;
 	mesh = meshReference;
 
@@ -42,10 +42,6 @@ healthPickup::~healthPickup()
 		delete healthMaterial;
 		healthMaterial = nullptr;
 	}
-	if (shaderProgram){
-		delete shaderProgram;
-		shaderProgram = nullptr;
-	}
 }
 
 //Update HPUp positions each frame
@@ -81,22 +77,35 @@ void healthPickup::update(float dt){
 
 
 //draw HPUp
-void healthPickup::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos){
+void healthPickup::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFLOAT3 camPos, ID3D11DeviceContext* context){
 	UINT offset = 0;
 	UINT stride = sizeof(Vertex);
 
+	//only submit what the camera can see
+	culler.setCamera(viewMatrix, projectionMatrix);
+	culler.clear();
 	for (unsigned int i = 0; i < HPUp.size(); i++){
+		XMFLOAT3 center;
+		float radius;
+		HPUp[i]->getBoundingSphere(center, radius);
+		culler.add(center, radius);
+	}
+	culler.cull();
+
+	for (unsigned int v = 0; v < culler.getVisibleCount(); v++){
+		unsigned int i = culler.getVisible(v);
 		//UINT offset = 0;
 		stride = HPUp[i]->g_mesh->sizeofvertex;
 		// Set up the input assembler
-		deviceContext->IASetInputLayout(HPUp[i]->g_mat->shaderProgram->vsInputLayout);
-		deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		context->IASetInputLayout(HPUp[i]->g_mat->shaderProgram->vsInputLayout);
+		context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 		//set values that get passed to matrix constant buffer
 
 		HPUp[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.world = HPUp[i]->getWorld();
 		HPUp[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.view = viewMatrix;
 		HPUp[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.projection = projectionMatrix;
+		HPUp[i]->g_mat->shaderProgram->ConstantBuffers[0]->dataToSendToConstantBuffer.uvTransform = HPUp[i]->g_mat->uvTransform;
 
 		//set values that get passed to lighting constant buffer
 		HPUp[i]->g_mat->shaderProgram->ConstantBuffers[1]->dataToSendToLightBuffer.ambientColor = lighting.ambientColor;
@@ -111,7 +120,7 @@ void healthPickup::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFL
 
 
 		//matrix constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			HPUp[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer,
 			0,
 			NULL,
@@ -120,7 +129,7 @@ void healthPickup::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFL
 			0);
 
 		//camera constant buffer 
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			HPUp[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer,
 			0,
 			NULL,
@@ -128,7 +137,7 @@ void healthPickup::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFL
 			0,
 			0);
 		//light constant buffer
-		deviceContext->UpdateSubresource(
+		context->UpdateSubresource(
 			HPUp[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer,
 			0,
 			NULL,
@@ -136,26 +145,29 @@ void healthPickup::draw(XMFLOAT4X4 viewMatrix, XMFLOAT4X4 projectionMatrix, XMFL
 			0,
 			0);
 
-		deviceContext->IASetVertexBuffers(0, 1, &HPUp[i]->g_mesh->v_buffer, &stride, &offset);
-		deviceContext->IASetIndexBuffer(HPUp[i]->g_mesh->i_buffer, DXGI_FORMAT_R32_UINT, 0);
+		context->IASetVertexBuffers(0, 1, &HPUp[i]->g_mesh->v_buffer, &stride, &offset);
+		context->IASetIndexBuffer(HPUp[i]->g_mesh->i_buffer, HPUp[i]->g_mesh->indexFormat, 0);
 
-		deviceContext->PSSetSamplers(0, 1, &HPUp[i]->g_mat->samplerState);
-		deviceContext->PSSetShaderResources(0, 1, &HPUp[i]->g_mat->resourceView);
+		context->PSSetSamplers(0, 1, &HPUp[i]->g_mat->samplerState);
+		context->PSSetShaderResources(0, 1, &HPUp[i]->g_mat->resourceView);
 
 
 
 		// Set the current vertex and pixel shaders, as well the constant buffer for the vert shader
-		deviceContext->VSSetShader(HPUp[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
-		deviceContext->VSSetConstantBuffers(0, 1, &HPUp[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
-		deviceContext->VSSetConstantBuffers(1, 1, &HPUp[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
-		deviceContext->PSSetShader(HPUp[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
-		deviceContext->PSSetConstantBuffers(0, 1, &HPUp[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
+		context->VSSetShader(HPUp[i]->g_mat->shaderProgram->vertexShader, NULL, 0);
+		context->VSSetConstantBuffers(0, 1, &HPUp[i]->g_mat->shaderProgram->ConstantBuffers[0]->constantBuffer); //set first constant vertex buffer-matrix
+		context->VSSetConstantBuffers(1, 1, &HPUp[i]->g_mat->shaderProgram->ConstantBuffers[2]->constantBuffer); //set second constant vertex buffer-camera
+		context->PSSetShader(HPUp[i]->g_mat->shaderProgram->pixelShader, NULL, 0);
+		context->PSSetConstantBuffers(0, 1, &HPUp[i]->g_mat->shaderProgram->ConstantBuffers[1]->constantBuffer); //set pixel constant buffer-light
 
 		// Finally do the actual drawing
-		deviceContext->DrawIndexed(
+		context->DrawIndexed(
 			HPUp.at(i)->g_mesh->m_size,	// The number of indices we're using in this draw
 			0,
 			0);
 	}
 }
 
+CullStats healthPickup::getCullStats(){
+	return culler.getStats();
+}
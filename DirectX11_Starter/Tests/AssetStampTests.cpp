@@ -0,0 +1,134 @@
+#include "Test.h"
+#include "AssetStamp.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#define STAMP_TEST_SOURCE "AssetStampTest.src"
+#define STAMP_TEST_COOKED "AssetStampTest.cooked"
+#define STAMP_TEST_OFFSET 12 // unaligned, like the stamp in a texture header
+
+static bool WriteFile(const char* path, const void* data, size_t size){
+	FILE* file = fopen(path, "wb");
+	if (!file){
+		return false;
+	}
+	bool written = fwrite(data, 1, size, file) == size;
+	return fclose(file) == 0 && written;
+}
+
+//A cooked file with a header before and a payload after the stamp
+static bool WriteCooked(const AssetStamp& stamp){
+	char bytes[STAMP_TEST_OFFSET + sizeof(AssetStamp) + 8];
+	memset(bytes, 0xCD, sizeof(bytes));
+	memcpy(bytes + STAMP_TEST_OFFSET, &stamp, sizeof(stamp));
+	return WriteFile(STAMP_TEST_COOKED, bytes, sizeof(bytes));
+}
+
+static bool ReadCooked(AssetStamp& stamp, bool& untouched){
+	char bytes[STAMP_TEST_OFFSET + sizeof(AssetStamp) + 8];
+	FILE* file = fopen(STAMP_TEST_COOKED, "rb");
+	if (!file){
+		return false;
+	}
+	bool read = fread(bytes, 1, sizeof(bytes), file) == sizeof(bytes);
+	fclose(file);
+	memcpy(&stamp, bytes + STAMP_TEST_OFFSET, sizeof(stamp));
+	untouched = true;
+	for (size_t i = 0; i < sizeof(bytes); i++){
+		if ((i < STAMP_TEST_OFFSET || i >= STAMP_TEST_OFFSET + sizeof(AssetStamp)) && bytes[i] != (char)0xCD){
+			untouched = false;
+		}
+	}
+	return read;
+}
+
+static bool SameStamp(const AssetStamp& a, const AssetStamp& b){
+	return a.size == b.size && a.time == b.time && a.hash == b.hash;
+}
+
+//Ticks since 1970 on every platform, so a stamp cooked on Windows matches on Linux and back
+TEST(AssetStampTimeIsUnixTicks){
+	const char source[] = "portable";
+	CHECK(WriteFile(STAMP_TEST_SOURCE, source, sizeof(source)));
+	uint64_t size = 0;
+	uint64_t ticks = 0;
+	CHECK(StatAsset(STAMP_TEST_SOURCE, size, ticks));
+	CHECK(size == sizeof(source));
+	uint64_t now = (uint64_t)time(NULL) * ASSET_TIME_TICKS_PER_SECOND;
+	uint64_t minute = 60 * ASSET_TIME_TICKS_PER_SECOND;
+	CHECK(ticks + minute > now && ticks < now + minute);
+	remove(STAMP_TEST_SOURCE);
+}
+
+//A touched but unchanged source is hashed once, then the rewritten stamp matches on time alone
+TEST(AssetStampRefreshedAfterHashMatch){
+	const char source[] = "touched but unchanged";
+	CHECK(WriteFile(STAMP_TEST_SOURCE, source, sizeof(source)));
+	AssetStamp stamp;
+	CHECK(StampAsset(STAMP_TEST_SOURCE, stamp));
+	AssetStamp stale = stamp;
+	stale.time -= 5 * ASSET_TIME_TICKS_PER_SECOND;
+	CHECK(WriteCooked(stale));
+
+	AssetStamp current;
+	CHECK(IsAssetCurrent(STAMP_TEST_SOURCE, stale, current));
+	CHECK(SameStamp(current, stamp));
+	CHECK(IsCookedAssetCurrent(STAMP_TEST_SOURCE, stale, STAMP_TEST_COOKED, STAMP_TEST_OFFSET));
+
+	AssetStamp rewritten;
+	bool untouched = false;
+	CHECK(ReadCooked(rewritten, untouched));
+	CHECK(untouched);
+	CHECK(SameStamp(rewritten, stamp));
+	//a wrong hash proves the second check stops at the time and never reads the source
+	rewritten.hash = ~stamp.hash;
+	CHECK(IsAssetCurrent(STAMP_TEST_SOURCE, rewritten, current));
+	CHECK(current.hash == rewritten.hash);
+	remove(STAMP_TEST_SOURCE);
+	remove(STAMP_TEST_COOKED);
+}
+
+//Same size, new time, different bytes: stale, and the stamp is left for the recook to replace
+TEST(AssetStampChangedSourceNotRefreshed){
+	const char before[] = "original bytes";
+	const char after[] = "modified bytes";
+	CHECK(WriteFile(STAMP_TEST_SOURCE, before, sizeof(before)));
+	AssetStamp stamp;
+	CHECK(StampAsset(STAMP_TEST_SOURCE, stamp));
+	stamp.time -= 5 * ASSET_TIME_TICKS_PER_SECOND;
+	CHECK(WriteFile(STAMP_TEST_SOURCE, after, sizeof(after)));
+	CHECK(WriteCooked(stamp));
+
+	CHECK(!IsCookedAssetCurrent(STAMP_TEST_SOURCE, stamp, STAMP_TEST_COOKED, STAMP_TEST_OFFSET));
+	AssetStamp kept;
+	bool untouched = false;
+	CHECK(ReadCooked(kept, untouched));
+	CHECK(untouched && SameStamp(kept, stamp));
+
+	stamp.size++;
+	AssetStamp current;
+	CHECK(!IsAssetCurrent(STAMP_TEST_SOURCE, stamp, current));
+	remove(STAMP_TEST_SOURCE);
+	remove(STAMP_TEST_COOKED);
+}
+
+//Shipping cooked files without their sources keeps them current and leaves them alone
+TEST(AssetStampMissingSource){
+	remove(STAMP_TEST_SOURCE);
+	AssetStamp stamp;
+	stamp.size = 10;
+	stamp.time = 20;
+	stamp.hash = 30;
+	CHECK(WriteCooked(stamp));
+	AssetStamp current;
+	CHECK(IsAssetCurrent(STAMP_TEST_SOURCE, stamp, current));
+	CHECK(SameStamp(current, stamp));
+	CHECK(IsCookedAssetCurrent(STAMP_TEST_SOURCE, stamp, STAMP_TEST_COOKED, STAMP_TEST_OFFSET));
+	AssetStamp kept;
+	bool untouched = false;
+	CHECK(ReadCooked(kept, untouched));
+	CHECK(untouched && SameStamp(kept, stamp));
+	remove(STAMP_TEST_COOKED);
+}
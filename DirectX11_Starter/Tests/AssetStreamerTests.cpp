@@ -0,0 +1,206 @@
+#include "Test.h"
+#include "AssetStreamer.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Holds a load on its worker until released, so a test can see it mid-flight
+class LoadGate{
+public:
+	LoadGate() : started(false), open(false){}
+
+	void enter(){
+		std::unique_lock<std::mutex> lock(mutex);
+		started = true;
+		changed.notify_all();
+		changed.wait(lock, [this](){ return open; });
+	}
+	void waitStarted(){
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [this](){ return started; });
+	}
+	void release(){
+		std::lock_guard<std::mutex> lock(mutex);
+		open = true;
+		changed.notify_all();
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool started;
+	bool open;
+};
+
+//What each request's callbacks did, in the order they did it
+struct StreamLog{
+	std::mutex mutex;
+	std::vector<int> loads;
+	std::vector<int> uploads; // main thread only
+};
+
+static StreamLoad LogLoad(StreamLog& log, int id, size_t bytes, LoadGate* gate){
+	return [&log, id, bytes, gate](size_t& uploadBytes){
+		if (gate){
+			gate->enter();
+		}
+		std::lock_guard<std::mutex> lock(log.mutex);
+		log.loads.push_back(id);
+		uploadBytes = bytes;
+		return true;
+	};
+}
+
+static StreamUpload LogUpload(StreamLog& log, int id){
+	return [&log, id](){
+		log.uploads.push_back(id);
+		return true;
+	};
+}
+
+//Every task submitted before it has run once this returns, the pool being one FIFO
+static void DrainPool(ThreadPool& pool){
+	pool.submit([](){}).wait();
+}
+
+static bool WaitForState(const StreamHandle& handle, StreamState state){
+	std::chrono::steady_clock::time_point giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (handle->getState() != state){
+		if (std::chrono::steady_clock::now() > giveUp){
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+//Cancelled before a worker picks it up: the load never runs
+TEST(AssetStreamerCancelQueued){
+	ThreadPool pool(1);
+	AssetStreamer streamer(&pool, 1024);
+	StreamLog log;
+	LoadGate gate;
+	StreamHandle blocker = streamer.request(LogLoad(log, 0, 16, &gate), LogUpload(log, 0));
+	gate.waitStarted();
+	StreamHandle queued = streamer.request(LogLoad(log, 1, 16, nullptr), LogUpload(log, 1));
+	CHECK(queued->getState() == STREAM_QUEUED);
+	CHECK(streamer.cancel(queued));
+	CHECK(queued->getState() == STREAM_CANCELLED);
+	CHECK(!streamer.cancel(queued));
+
+	gate.release();
+	DrainPool(pool);
+	CHECK(queued->getState() == STREAM_CANCELLED);
+	CHECK(log.loads.size() == 1 && log.loads[0] == 0);
+	CHECK(streamer.pump() == 1);
+	CHECK(log.uploads.size() == 1 && log.uploads[0] == 0);
+	CHECK(streamer.getPendingCount() == 0);
+}
+
+//Cancelled mid-load: the load finishes but is thrown away, nothing is uploaded
+TEST(AssetStreamerCancelLoading){
+	ThreadPool pool(1);
+	AssetStreamer streamer(&pool, 1024);
+	StreamLog log;
+	LoadGate gate;
+	StreamHandle loading = streamer.request(LogLoad(log, 0, 16, &gate), LogUpload(log, 0));
+	gate.waitStarted();
+	CHECK(loading->getState() == STREAM_LOADING);
+	CHECK(streamer.cancel(loading));
+
+	gate.release();
+	DrainPool(pool);
+	CHECK(log.loads.size() == 1);
+	CHECK(loading->getState() == STREAM_CANCELLED);
+	CHECK(streamer.pump() == 0);
+	CHECK(log.uploads.empty());
+	CHECK(streamer.getPendingCount() == 0);
+}
+
+//Cancelled while waiting for its turn to upload: it leaves the queue without uploading
+TEST(AssetStreamerCancelLoaded){
+	AssetStreamer streamer(nullptr, 1024);
+	StreamLog log;
+	StreamHandle first = streamer.request(LogLoad(log, 0, 16, nullptr), LogUpload(log, 0));
+	StreamHandle second = streamer.request(LogLoad(log, 1, 16, nullptr), LogUpload(log, 1));
+	CHECK(first->getState() == STREAM_LOADED);
+	CHECK(streamer.cancel(first));
+	CHECK(streamer.getPendingCount() == 1);
+	CHECK(streamer.pump() == 1);
+	CHECK(log.uploads.size() == 1 && log.uploads[0] == 1);
+	CHECK(first->getState() == STREAM_CANCELLED);
+	CHECK(second->getState() == STREAM_DONE);
+	CHECK(!streamer.cancel(second));
+}
+
+//A later request that loads first still waits for the earlier one's upload
+TEST(AssetStreamerUploadsInRequestOrder){
+	ThreadPool pool(2);
+	AssetStreamer streamer(&pool, 1024);
+	StreamLog log;
+	LoadGate gate;
+	StreamHandle slow = streamer.request(LogLoad(log, 0, 16, &gate), LogUpload(log, 0));
+	StreamHandle fast = streamer.request(LogLoad(log, 1, 16, nullptr), LogUpload(log, 1));
+	CHECK(WaitForState(fast, STREAM_LOADED));
+	CHECK(slow->getState() == STREAM_LOADING);
+	CHECK(streamer.pump() == 0);
+	CHECK(log.uploads.empty());
+	CHECK(fast->getState() == STREAM_LOADED);
+
+	gate.release();
+	CHECK(WaitForState(slow, STREAM_LOADED));
+	CHECK(streamer.pump() == 2);
+	CHECK(log.uploads.size() == 2 && log.uploads[0] == 0 && log.uploads[1] == 1);
+	CHECK(slow->getState() == STREAM_DONE && fast->getState() == STREAM_DONE);
+}
+
+//Failed loads and uploads drop out of the queue instead of holding up the ones behind them
+TEST(AssetStreamerFailuresDontBlock){
+	AssetStreamer streamer(nullptr, 1024);
+	StreamLog log;
+	StreamHandle badLoad = streamer.request([](size_t&){ return false; }, LogUpload(log, 0));
+	StreamHandle badUpload = streamer.request(LogLoad(log, 1, 16, nullptr), [](){ return false; });
+	StreamHandle good = streamer.request(LogLoad(log, 2, 16, nullptr), LogUpload(log, 2));
+	CHECK(badLoad->getState() == STREAM_FAILED);
+	CHECK(streamer.pump() == 2);
+	CHECK(badUpload->getState() == STREAM_FAILED);
+	CHECK(good->getState() == STREAM_DONE);
+	CHECK(log.uploads.size() == 1 && log.uploads[0] == 2);
+	CHECK(streamer.getPendingCount() == 0);
+}
+
+//Uploads stop once the budget is spent, but the first always goes through however big it is
+TEST(AssetStreamerUploadBudget){
+	AssetStreamer streamer(nullptr, 100);
+	StreamLog log;
+	const size_t sizes[] = { 250, 40, 40, 40, 30, 500, 10 };
+	const unsigned int count = sizeof(sizes) / sizeof(sizes[0]);
+	for (unsigned int i = 0; i < count; i++){
+		streamer.request(LogLoad(log, i, sizes[i], nullptr), LogUpload(log, i));
+	}
+
+	CHECK(streamer.pump() == 1);
+	CHECK(streamer.getLastPumpBytes() == 250);
+	CHECK(streamer.pump() == 2);
+	CHECK(streamer.getLastPumpBytes() == 80);
+	CHECK(streamer.pump() == 2);
+	CHECK(streamer.getLastPumpBytes() == 70);
+	//a zero budget still moves one request a pump
+	streamer.setUploadBudget(0);
+	CHECK(streamer.pump() == 1);
+	CHECK(streamer.getLastPumpBytes() == 500);
+	CHECK(streamer.pump() == 1);
+	CHECK(streamer.getLastPumpBytes() == 10);
+	CHECK(streamer.pump() == 0);
+	CHECK(streamer.getLastPumpBytes() == 0);
+
+	CHECK(log.uploads.size() == count);
+	bool ordered = log.uploads.size() == count;
+	for (unsigned int i = 0; ordered && i < count; i++){
+		ordered = log.uploads[i] == (int)i;
+	}
+	CHECK(ordered);
+}
@@ -0,0 +1,169 @@
+#include "Test.h"
+#include "AtlasPacker.h"
+#include <cstdlib>
+#include <vector>
+
+static bool Overlap(const AtlasRect& a, const AtlasRect& b){
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+//Padded sizes of count images between 1 and largest texels a side
+static void RandomSizes(unsigned int count, uint32_t largest, std::vector<AtlasRect>& sizes){
+	sizes.clear();
+	for (unsigned int i = 0; i < count; i++){
+		sizes.push_back(GetPaddedAtlasSize(1 + rand() % largest, 1 + rand() % largest));
+	}
+}
+
+//Everything placed where it was asked to be, inside the atlas, aligned and clear of the others
+static void CheckPacking(const std::vector<AtlasRect>& sizes, uint32_t maxSize, uint32_t width, uint32_t height, const std::vector<AtlasRect>& placed){
+	CHECK(width % ATLAS_SIZE_STEP == 0 && height % ATLAS_SIZE_STEP == 0);
+	CHECK(width <= maxSize && height <= maxSize);
+	CHECK(placed.size() == sizes.size());
+	bool sized = true;
+	bool inside = true;
+	bool aligned = true;
+	bool apart = true;
+	uint64_t area = 0;
+	for (size_t i = 0; i < placed.size(); i++){
+		const AtlasRect& rect = placed[i];
+		sized = sized && rect.width == sizes[i].width && rect.height == sizes[i].height;
+		inside = inside && rect.x + rect.width <= width && rect.y + rect.height <= height;
+		aligned = aligned && rect.x % ATLAS_ALIGNMENT == 0 && rect.y % ATLAS_ALIGNMENT == 0;
+		for (size_t j = i + 1; j < placed.size(); j++){
+			apart = apart && !Overlap(rect, placed[j]);
+		}
+		area += (uint64_t)rect.width * rect.height;
+	}
+	CHECK(sized);
+	CHECK(inside);
+	CHECK(aligned);
+	CHECK(apart);
+	CHECK(area <= (uint64_t)width * height);
+}
+
+TEST(AtlasPaddedSizes){
+	AtlasRect padded = GetPaddedAtlasSize(1, 30);
+	CHECK(padded.width == 24 && padded.height == 48);
+	padded = GetPaddedAtlasSize(48, 49);
+	CHECK(padded.width == 64 && padded.height == 72);
+	AtlasRect placed = { 128, 64, 64, 72 };
+	AtlasRect content = GetAtlasContentRect(placed, 48, 49);
+	CHECK(content.x == 128 + ATLAS_PADDING && content.y == 64 + ATLAS_PADDING && content.width == 48 && content.height == 49);
+}
+
+//Random sets from a few sprites to a few hundred, small and large
+TEST(AtlasPackingFuzz){
+	srand(45);
+	std::vector<AtlasRect> sizes;
+	std::vector<AtlasRect> placed;
+	for (int round = 0; round < 60; round++){
+		unsigned int count = 1 + rand() % (round < 40 ? 40 : 300);
+		uint32_t largest = round % 3 == 0 ? 400 : 60;
+		RandomSizes(count, largest, sizes);
+		uint32_t width = 0;
+		uint32_t height = 0;
+		CHECK(PackAtlas(sizes, ATLAS_MAX_SIZE, width, height, placed));
+		CheckPacking(sizes, ATLAS_MAX_SIZE, width, height, placed);
+	}
+
+	//a single image fills the smallest atlas that holds it
+	sizes.assign(1, GetPaddedAtlasSize(100, 20));
+	uint32_t width = 0;
+	uint32_t height = 0;
+	CHECK(PackAtlas(sizes, ATLAS_MAX_SIZE, width, height, placed));
+	CHECK(width == 128 && height == 64);
+	CHECK(placed[0].x == 0 && placed[0].y == 0);
+
+	//64 identical tiles pack with no waste
+	sizes.assign(64, GetPaddedAtlasSize(48, 48));
+	CHECK(PackAtlas(sizes, ATLAS_MAX_SIZE, width, height, placed));
+	CHECK(width == 512 && height == 512);
+	CheckPacking(sizes, ATLAS_MAX_SIZE, width, height, placed);
+}
+
+TEST(AtlasRefusesWhatDoesntFit){
+	std::vector<AtlasRect> sizes;
+	std::vector<AtlasRect> placed;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	//one side too long
+	sizes.assign(1, GetPaddedAtlasSize(250, 10));
+	CHECK(!PackAtlas(sizes, 256, width, height, placed));
+	//each fits, together they are more than the area
+	sizes.assign(5, GetPaddedAtlasSize(112, 112));
+	CHECK(!PackAtlas(sizes, 256, width, height, placed));
+	//the area is enough but the shapes aren't: no two 136 squares go side by side or stacked in 256
+	sizes.assign(3, GetPaddedAtlasSize(120, 120));
+	CHECK(!PackAtlas(sizes, 256, width, height, placed));
+	//the same three fit once the limit allows
+	CHECK(PackAtlas(sizes, 512, width, height, placed));
+	CheckPacking(sizes, 512, width, height, placed);
+	//an empty list gets the smallest atlas
+	sizes.clear();
+	CHECK(PackAtlas(sizes, 256, width, height, placed) && width == ATLAS_SIZE_STEP && height == ATLAS_SIZE_STEP);
+}
+
+static TextureImage MakeImage(uint32_t width, uint32_t height, uint8_t seed){
+	TextureImage image;
+	image.width = width;
+	image.height = height;
+	image.pixels.resize((size_t)width * height * 4);
+	for (uint32_t y = 0; y < height; y++){
+		for (uint32_t x = 0; x < width; x++){
+			uint8_t* texel = &image.pixels[((size_t)y * width + x) * 4];
+			texel[0] = (uint8_t)(x * 7 + seed);
+			texel[1] = (uint8_t)(y * 13 + seed);
+			texel[2] = seed;
+			texel[3] = (uint8_t)(255 - x - y);
+		}
+	}
+	return image;
+}
+
+//Every padding texel repeats the nearest border texel out to the padded edge; nothing else is written
+TEST(AtlasPaddingRepeatsBorder){
+	std::vector<TextureImage> images;
+	images.push_back(MakeImage(37, 5, 11));
+	images.push_back(MakeImage(1, 1, 90));
+	images.push_back(MakeImage(20, 64, 200));
+	std::vector<AtlasRect> sizes;
+	for (size_t i = 0; i < images.size(); i++){
+		sizes.push_back(GetPaddedAtlasSize(images[i].width, images[i].height));
+	}
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<AtlasRect> placed;
+	CHECK(PackAtlas(sizes, ATLAS_MAX_SIZE, width, height, placed));
+	TextureImage atlas;
+	BuildAtlasImage(images, placed, width, height, atlas);
+	CHECK(atlas.width == width && atlas.height == height && atlas.pixels.size() == (size_t)width * height * 4);
+
+	std::vector<int> owner((size_t)width * height, -1);
+	bool repeated = true;
+	for (size_t i = 0; i < images.size(); i++){
+		const TextureImage& image = images[i];
+		AtlasRect content = GetAtlasContentRect(placed[i], image.width, image.height);
+		for (uint32_t y = placed[i].y; y < placed[i].y + placed[i].height; y++){
+			for (uint32_t x = placed[i].x; x < placed[i].x + placed[i].width; x++){
+				int sx = (int)x - (int)content.x;
+				int sy = (int)y - (int)content.y;
+				sx = sx < 0 ? 0 : (sx >= (int)image.width ? image.width - 1 : sx);
+				sy = sy < 0 ? 0 : (sy >= (int)image.height ? image.height - 1 : sy);
+				const uint8_t* expected = &image.pixels[((size_t)sy * image.width + sx) * 4];
+				const uint8_t* actual = &atlas.pixels[((size_t)y * width + x) * 4];
+				repeated = repeated && expected[0] == actual[0] && expected[1] == actual[1] && expected[2] == actual[2] && expected[3] == actual[3];
+				owner[(size_t)y * width + x] = (int)i;
+			}
+		}
+	}
+	CHECK(repeated);
+
+	bool clear = true;
+	for (size_t t = 0; t < owner.size(); t++){
+		if (owner[t] < 0){
+			clear = clear && atlas.pixels[t * 4] == 0 && atlas.pixels[t * 4 + 1] == 0 && atlas.pixels[t * 4 + 2] == 0 && atlas.pixels[t * 4 + 3] == 0;
+		}
+	}
+	CHECK(clear);
+}
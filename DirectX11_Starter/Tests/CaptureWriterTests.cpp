@@ -0,0 +1,225 @@
+#include "Test.h"
+#include "CaptureWriter.h"
+#include "MappedFile.h"
+#include "TextureFile.h"
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define CAPTURE_TEST_PREFIX "CaptureWriterTest"
+
+#define CAPTURE_TEST_WIDTH 13 // odd, so no row is a power of two
+#define CAPTURE_TEST_HEIGHT 7
+#define CAPTURE_TEST_PITCH 64 // a staging texture's rows are padded past width * 4
+
+/**
+*A BGRA frame the way a mapped staging texture hands it over: every texel different, alpha not
+*opaque, and the bytes past width * 4 in each row filled with something that mustn't show up.
+**/
+static std::vector<uint8_t> MakeFrame(uint8_t seed){
+	std::vector<uint8_t> rows(CAPTURE_TEST_PITCH * CAPTURE_TEST_HEIGHT, 0xEE);
+	for (uint32_t y = 0; y < CAPTURE_TEST_HEIGHT; y++){
+		for (uint32_t x = 0; x < CAPTURE_TEST_WIDTH; x++){
+			uint8_t* texel = &rows[y * CAPTURE_TEST_PITCH + x * 4];
+			texel[0] = (uint8_t)(x * 17 + seed); // blue
+			texel[1] = (uint8_t)(y * 31 + seed); // green
+			texel[2] = (uint8_t)(x * 5 + y * 3); // red
+			texel[3] = (uint8_t)(x + y); // alpha the display ignores
+		}
+	}
+	return rows;
+}
+
+//What the writer should make of MakeFrame: tightly packed RGBA, opaque
+static bool MatchesFrame(const uint8_t* pixels, uint8_t seed){
+	std::vector<uint8_t> rows = MakeFrame(seed);
+	bool matches = true;
+	for (uint32_t y = 0; y < CAPTURE_TEST_HEIGHT; y++){
+		for (uint32_t x = 0; x < CAPTURE_TEST_WIDTH; x++){
+			const uint8_t* source = &rows[y * CAPTURE_TEST_PITCH + x * 4];
+			const uint8_t* texel = &pixels[(y * CAPTURE_TEST_WIDTH + x) * 4];
+			matches = matches && texel[0] == source[2] && texel[1] == source[1] && texel[2] == source[0] && texel[3] == 0xFF;
+		}
+	}
+	return matches;
+}
+
+//Holds a one thread pool's worker until released, so submitted frames stay queued
+static std::shared_future<void> BlockPool(ThreadPool& pool, std::promise<void>& release){
+	std::shared_future<void> released = release.get_future().share();
+	//shared, the worker may still be in set_value when this returns
+	std::shared_ptr<std::promise<void>> started = std::make_shared<std::promise<void>>();
+	std::future<void> running = started->get_future();
+	pool.submit([started, released](){
+		started->set_value();
+		released.wait();
+	});
+	running.wait();
+	return released;
+}
+
+TEST(CaptureFramePath){
+	CHECK(CaptureWriter::GetFramePath("shots/run", 42, CAPTURE_PNG) == "shots/run00042.png");
+	CHECK(CaptureWriter::GetFramePath("", 0, CAPTURE_DDS) == std::string("00000") + TEXTURE_FILE_EXTENSION);
+	//past five digits the number just gets longer
+	CHECK(CaptureWriter::GetFramePath("f", 123456, CAPTURE_PNG) == "f123456.png");
+}
+
+//Swapped to RGBA, opaque and without the row padding, read back by the same loader the cooker uses
+TEST(CaptureWritesPng){
+	ThreadPool pool(1);
+	std::string path = CaptureWriter::GetFramePath(CAPTURE_TEST_PREFIX, 1, CAPTURE_PNG);
+	{
+		CaptureWriter writer(&pool, CAPTURE_TEST_PREFIX, CAPTURE_PNG, CAPTURE_MAX_PENDING);
+		std::vector<uint8_t> rows = MakeFrame(3);
+		CHECK(writer.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 1, true, nullptr));
+		writer.finish();
+		CHECK(writer.getWrittenCount() == 1 && writer.getFailedCount() == 0 && writer.getPendingCount() == 0);
+	}
+	TextureImage image;
+	CHECK(LoadTextureImage(path, image));
+	CHECK(image.width == CAPTURE_TEST_WIDTH && image.height == CAPTURE_TEST_HEIGHT);
+	CHECK(image.pixels.size() == CAPTURE_TEST_WIDTH * CAPTURE_TEST_HEIGHT * 4 && MatchesFrame(&image.pixels[0], 3));
+	remove(path.c_str());
+}
+
+/**
+*A capture DDS is uncompressed, which OpenTextureFile turns down, so the headers are checked
+*here by hand: one level of tightly packed RGBA8 right after them.
+**/
+TEST(CaptureWritesDds){
+	ThreadPool pool(1);
+	std::string path = CaptureWriter::GetFramePath(CAPTURE_TEST_PREFIX, 2, CAPTURE_DDS);
+	{
+		CaptureWriter writer(&pool, CAPTURE_TEST_PREFIX, CAPTURE_DDS, CAPTURE_MAX_PENDING);
+		std::vector<uint8_t> rows = MakeFrame(9);
+		CHECK(writer.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 2, true, nullptr));
+		writer.finish();
+		CHECK(writer.getWrittenCount() == 1 && writer.getFailedCount() == 0);
+	}
+	MappedFile mapped;
+	TextureFileView view;
+	CHECK(!OpenTextureFile(path, mapped, view));
+	mapped.close();
+
+	size_t headersSize = sizeof(uint32_t) + sizeof(TextureFileHeader);
+	size_t dataSize = CAPTURE_TEST_WIDTH * CAPTURE_TEST_HEIGHT * 4;
+	CHECK(mapped.open(path));
+	CHECK(mapped.size() == headersSize + dataSize);
+	if (mapped.size() == headersSize + dataSize){
+		uint32_t magic;
+		memcpy(&magic, mapped.data(), sizeof(magic));
+		TextureFileHeader header;
+		memcpy(&header, mapped.data() + sizeof(magic), sizeof(header));
+		CHECK(magic == TEXTURE_FILE_MAGIC);
+		CHECK(header.width == CAPTURE_TEST_WIDTH && header.height == CAPTURE_TEST_HEIGHT && header.mipCount == 1);
+		CHECK(header.pitchOrLinearSize == CAPTURE_TEST_WIDTH * 4 && header.format.rgbBitCount == 32);
+		CHECK(header.format.rBitMask == 0x000000FF && header.format.aBitMask == 0xFF000000);
+		CHECK(MatchesFrame(reinterpret_cast<const uint8_t*>(mapped.data() + headersSize), 9));
+	}
+	mapped.close();
+	remove(path.c_str());
+}
+
+//Already RGBA goes through unswapped, still forced opaque
+TEST(CaptureKeepsRgba){
+	ThreadPool pool(1);
+	std::string path = CaptureWriter::GetFramePath(CAPTURE_TEST_PREFIX, 3, CAPTURE_PNG);
+	std::vector<uint8_t> rows = MakeFrame(5);
+	{
+		CaptureWriter writer(&pool, CAPTURE_TEST_PREFIX, CAPTURE_PNG, CAPTURE_MAX_PENDING);
+		CHECK(writer.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 3, false, nullptr));
+	}
+	TextureImage image;
+	CHECK(LoadTextureImage(path, image));
+	bool kept = image.pixels.size() == CAPTURE_TEST_WIDTH * CAPTURE_TEST_HEIGHT * 4;
+	for (uint32_t y = 0; kept && y < CAPTURE_TEST_HEIGHT; y++){
+		kept = kept && memcmp(&image.pixels[y * CAPTURE_TEST_WIDTH * 4], &rows[y * CAPTURE_TEST_PITCH], 3) == 0;
+		for (uint32_t x = 0; x < CAPTURE_TEST_WIDTH; x++){
+			kept = kept && image.pixels[(y * CAPTURE_TEST_WIDTH + x) * 4 + 3] == 0xFF;
+		}
+	}
+	CHECK(kept);
+	remove(path.c_str());
+}
+
+/**
+*The game unmaps the staging texture once copied is set, before the frame is encoded. The rows
+*are wiped and freed as soon as the flag goes up, and the file still has the frame.
+**/
+TEST(CaptureCopiedBeforeEncode){
+	ThreadPool pool(1);
+	std::string path = CaptureWriter::GetFramePath(CAPTURE_TEST_PREFIX, 4, CAPTURE_PNG);
+	CaptureWriter writer(&pool, CAPTURE_TEST_PREFIX, CAPTURE_PNG, CAPTURE_MAX_PENDING);
+	std::vector<uint8_t>* rows = new std::vector<uint8_t>(MakeFrame(21));
+	std::atomic<bool> copied(false);
+	std::promise<void> release;
+	std::shared_future<void> released = BlockPool(pool, release);
+	CHECK(writer.submit(&(*rows)[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 4, true, &copied));
+	//nothing runs while the worker is held
+	CHECK(!copied.load());
+	release.set_value();
+	while (!copied.load()){
+		std::this_thread::yield();
+	}
+	memset(&(*rows)[0], 0, rows->size());
+	delete rows;
+	writer.finish();
+	CHECK(writer.getWrittenCount() == 1);
+
+	TextureImage image;
+	CHECK(LoadTextureImage(path, image));
+	CHECK(image.pixels.size() == CAPTURE_TEST_WIDTH * CAPTURE_TEST_HEIGHT * 4 && MatchesFrame(&image.pixels[0], 21));
+	remove(path.c_str());
+}
+
+//Past maxPending frames are turned away with nothing queued, and taken again once the queue drains
+TEST(CaptureRefusesPastMaxPending){
+	ThreadPool pool(1);
+	std::vector<uint8_t> rows = MakeFrame(0);
+	CaptureWriter writer(&pool, CAPTURE_TEST_PREFIX, CAPTURE_DDS, 2);
+	std::promise<void> release;
+	std::shared_future<void> released = BlockPool(pool, release);
+	CHECK(writer.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 10, true, nullptr));
+	CHECK(writer.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 11, true, nullptr));
+	CHECK(!writer.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 12, true, nullptr));
+	CHECK(writer.getPendingCount() == 2 && writer.getWrittenCount() == 0);
+	release.set_value();
+	writer.finish();
+	CHECK(writer.getPendingCount() == 0 && writer.getWrittenCount() == 2 && writer.getFailedCount() == 0);
+
+	//the refused frame was never written
+	FILE* refused = fopen(CaptureWriter::GetFramePath(CAPTURE_TEST_PREFIX, 12, CAPTURE_DDS).c_str(), "rb");
+	CHECK(refused == nullptr);
+	if (refused){
+		fclose(refused);
+	}
+
+	CHECK(writer.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, 12, true, nullptr));
+	writer.finish();
+	CHECK(writer.getWrittenCount() == 3);
+	for (unsigned int frame = 10; frame <= 12; frame++){
+		remove(CaptureWriter::GetFramePath(CAPTURE_TEST_PREFIX, frame, CAPTURE_DDS).c_str());
+	}
+}
+
+//A file that can't be created counts as failed and still leaves the queue
+TEST(CaptureCountsFailures){
+	ThreadPool pool(2);
+	std::vector<uint8_t> rows = MakeFrame(0);
+	CaptureWriter png(&pool, "no_such_directory/" CAPTURE_TEST_PREFIX, CAPTURE_PNG, CAPTURE_MAX_PENDING);
+	CaptureWriter dds(&pool, "no_such_directory/" CAPTURE_TEST_PREFIX, CAPTURE_DDS, CAPTURE_MAX_PENDING);
+	for (unsigned int frame = 0; frame < 3; frame++){
+		CHECK(png.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, frame, true, nullptr));
+		CHECK(dds.submit(&rows[0], CAPTURE_TEST_PITCH, CAPTURE_TEST_WIDTH, CAPTURE_TEST_HEIGHT, frame, true, nullptr));
+	}
+	png.finish();
+	dds.finish();
+	CHECK(png.getFailedCount() == 3 && png.getWrittenCount() == 0 && png.getPendingCount() == 0);
+	CHECK(dds.getFailedCount() == 3 && dds.getWrittenCount() == 0 && dds.getPendingCount() == 0);
+	//finish() with nothing queued returns straight away
+	png.finish();
+}
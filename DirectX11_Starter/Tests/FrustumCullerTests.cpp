@@ -0,0 +1,127 @@
+#include "Test.h"
+#include "FrustumCuller.h"
+#include <cstdlib>
+#include <vector>
+
+//The game hands the culler transposed matrices, built here by hand so the test needs no DirectXMath functions
+static XMFLOAT4X4 Transposed(const float m[4][4]){
+	XMFLOAT4X4 t;
+	for (int i = 0; i < 4; i++){
+		for (int j = 0; j < 4; j++){
+			t.m[i][j] = m[j][i];
+		}
+	}
+	return t;
+}
+
+//Camera at (cameraX, 0, 0) looking down +z, 90 degree left handed perspective with near 1 and far 100
+static void SetTestCamera(FrustumCuller& culler, float cameraX){
+	const float nearZ = 1.0f;
+	const float farZ = 100.0f;
+	const float range = farZ / (farZ - nearZ);
+	const float view[4][4] = {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f },
+		{ -cameraX, 0.0f, 0.0f, 1.0f } };
+	const float projection[4][4] = {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, range, 1.0f },
+		{ 0.0f, 0.0f, -nearZ * range, 0.0f } };
+	culler.setCamera(Transposed(view), Transposed(projection));
+}
+
+TEST(FrustumNothingCulledWithoutCamera){
+	FrustumCuller culler;
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, 0.0f, -1000.0f), 1.0f));
+	CHECK(culler.isVisible(XMFLOAT3(1.0e6f, 5.0f, 3.0f), 0.0f));
+}
+
+TEST(FrustumSpheresInside){
+	FrustumCuller culler;
+	SetTestCamera(culler, 0.0f);
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, 0.0f, 10.0f), 1.0f));
+	CHECK(culler.isVisible(XMFLOAT3(8.0f, -8.0f, 10.0f), 0.5f));
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, 0.0f, 99.0f), 0.5f));
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, 0.0f, 1.5f), 0.1f));
+}
+
+TEST(FrustumSpheresOutsideEachSidePlane){
+	FrustumCuller culler;
+	SetTestCamera(culler, 0.0f);
+	//at depth 10 the sides are 10 away from the axis, the planes are at 45 degrees
+	CHECK(!culler.isVisible(XMFLOAT3(-13.0f, 0.0f, 10.0f), 1.0f)); // left
+	CHECK(!culler.isVisible(XMFLOAT3(13.0f, 0.0f, 10.0f), 1.0f)); // right
+	CHECK(!culler.isVisible(XMFLOAT3(0.0f, -13.0f, 10.0f), 1.0f)); // bottom
+	CHECK(!culler.isVisible(XMFLOAT3(0.0f, 13.0f, 10.0f), 1.0f)); // top
+	//the same centres with a radius reaching back over the plane stay
+	CHECK(culler.isVisible(XMFLOAT3(-13.0f, 0.0f, 10.0f), 3.0f));
+	CHECK(culler.isVisible(XMFLOAT3(13.0f, 0.0f, 10.0f), 3.0f));
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, -13.0f, 10.0f), 3.0f));
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, 13.0f, 10.0f), 3.0f));
+}
+
+TEST(FrustumSpheresBehindNearPlane){
+	FrustumCuller culler;
+	SetTestCamera(culler, 0.0f);
+	CHECK(!culler.isVisible(XMFLOAT3(0.0f, 0.0f, 0.5f), 0.25f));
+	CHECK(!culler.isVisible(XMFLOAT3(0.0f, 0.0f, -10.0f), 1.0f));
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, 0.0f, 0.5f), 0.75f));
+}
+
+TEST(FrustumSpheresPastFarPlane){
+	FrustumCuller culler;
+	SetTestCamera(culler, 0.0f);
+	CHECK(!culler.isVisible(XMFLOAT3(0.0f, 0.0f, 102.0f), 1.0f));
+	CHECK(culler.isVisible(XMFLOAT3(0.0f, 0.0f, 100.5f), 1.0f));
+}
+
+TEST(FrustumFollowsTheView){
+	FrustumCuller culler;
+	SetTestCamera(culler, 50.0f);
+	CHECK(!culler.isVisible(XMFLOAT3(0.0f, 0.0f, 10.0f), 1.0f));
+	CHECK(culler.isVisible(XMFLOAT3(50.0f, 0.0f, 10.0f), 1.0f));
+}
+
+//The SSE batch keeps the spheres the single test keeps, in the order they were added, for counts off a multiple of 4
+TEST(FrustumBatchMatchesSingleTest){
+	FrustumCuller culler;
+	SetTestCamera(culler, 0.0f);
+	srand(29);
+	for (int count = 0; count < 40; count += 13){
+		culler.clear();
+		std::vector<unsigned int> expected;
+		for (int i = 0; i < count; i++){
+			XMFLOAT3 center((rand() % 200 - 100) * 0.5f, (rand() % 200 - 100) * 0.5f, (rand() % 240 - 20) * 0.5f);
+			float radius = (rand() % 40) * 0.1f;
+			CHECK(culler.add(center, radius) == (unsigned int)i);
+			if (culler.isVisible(center, radius)){
+				expected.push_back(i);
+			}
+		}
+		culler.cull();
+		CHECK(culler.getVisibleCount() == expected.size());
+		bool same = culler.getVisibleCount() == expected.size();
+		for (unsigned int i = 0; same && i < expected.size(); i++){
+			same = culler.getVisible(i) == expected[i];
+		}
+		CHECK(same);
+		CullStats stats = culler.getStats();
+		CHECK(stats.visible == expected.size() && stats.visible + stats.culled == (unsigned int)count);
+	}
+}
+
+TEST(FrustumBoundingSphereTransform){
+	//scale (2, 3, 1) then move to (5, 6, 7), transposed like the game's world matrices
+	const float world[4][4] = {
+		{ 2.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 3.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f },
+		{ 5.0f, 6.0f, 7.0f, 1.0f } };
+	XMFLOAT3 center;
+	float radius;
+	FrustumCuller::TransformBoundingSphere(Transposed(world), XMFLOAT3(1.0f, 1.0f, 1.0f), 0.5f, center, radius);
+	CHECK(center.x == 7.0f && center.y == 9.0f && center.z == 8.0f);
+	CHECK(radius == 1.5f);
+}
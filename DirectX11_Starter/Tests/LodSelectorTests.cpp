@@ -0,0 +1,108 @@
+#include "Test.h"
+#include "LodSelector.h"
+
+//The game hands the selector transposed matrices, built here by hand so the test needs no DirectXMath functions
+static XMFLOAT4X4 Transposed(const float m[4][4]){
+	XMFLOAT4X4 t;
+	for (int i = 0; i < 4; i++){
+		for (int j = 0; j < 4; j++){
+			t.m[i][j] = m[j][i];
+		}
+	}
+	return t;
+}
+
+//Camera at (0, 0, cameraZ) looking down +z, 90 degree left handed perspective, 720 pixels high,
+//so one world unit at depth d covers 360 / d pixels
+static void SetTestCamera(LodSelector& selector, float cameraZ){
+	const float nearZ = 1.0f;
+	const float farZ = 1000.0f;
+	const float range = farZ / (farZ - nearZ);
+	const float view[4][4] = {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f },
+		{ 0.0f, 0.0f, -cameraZ, 1.0f } };
+	const float projection[4][4] = {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, range, 1.0f },
+		{ 0.0f, 0.0f, -nearZ * range, 0.0f } };
+	selector.setCamera(Transposed(view), Transposed(projection), 720.0f);
+}
+
+//A model of radius 1 with levels of 0.01, 0.05 and 0.2 units of error. Drawn at radius 2 one model
+//unit at depth d covers 720 / d pixels, so each level is good for one pixel from 720 times its error on
+static const MeshLod testLods[4] = { { 0, 3000, 0.0f }, { 3000, 1500, 0.01f }, { 4500, 600, 0.05f }, { 5100, 150, 0.2f } };
+
+TEST(LodSelectCoarsestWithinPixelError){
+	LodSelector selector;
+	SetTestCamera(selector, 0.0f);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 5.0f), 2.0f) == 0);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 7.0f), 2.0f) == 0);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 7.5f), 2.0f) == 1);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(3.0f, -2.0f, 35.0f), 2.0f) == 1);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 37.0f), 2.0f) == 2);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 143.0f), 2.0f) == 2);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 145.0f), 2.0f) == 3);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 900.0f), 2.0f) == 3);
+
+	//twice the size on screen needs twice the distance for the same level
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 10.0f), 4.0f) == 0);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 15.0f), 4.0f) == 1);
+	//only the chain's own levels
+	CHECK(selector.select(testLods, 2, 1.0f, XMFLOAT3(0.0f, 0.0f, 900.0f), 2.0f) == 1);
+
+	//moving the camera back moves every threshold with it
+	SetTestCamera(selector, -100.0f);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 5.0f), 2.0f) == 2);
+}
+
+TEST(LodSelectFullDetailWhenItCantTell){
+	LodSelector selector;
+	//no camera yet
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 500.0f), 2.0f) == 0);
+
+	SetTestCamera(selector, 0.0f);
+	//inside the bounds, behind the camera, a single level, or no bounds to scale by
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, 1.5f), 2.0f) == 0);
+	CHECK(selector.select(testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, -500.0f), 2.0f) == 0);
+	CHECK(selector.select(testLods, 1, 1.0f, XMFLOAT3(0.0f, 0.0f, 500.0f), 2.0f) == 0);
+	CHECK(selector.select(testLods, 4, 0.0f, XMFLOAT3(0.0f, 0.0f, 500.0f), 2.0f) == 0);
+}
+
+TEST(LodScreenSize){
+	LodSelector selector;
+	SetTestCamera(selector, 0.0f);
+	CHECK(selector.getScreenSize(XMFLOAT3(0.0f, 0.0f, 10.0f), 2.0f) == 144.0f);
+	CHECK(selector.getScreenSize(XMFLOAT3(5.0f, 5.0f, 100.0f), 1.0f) == 7.2f);
+	CHECK(selector.getScreenSize(XMFLOAT3(0.0f, 0.0f, 4.0f), 2.0f) == 360.0f);
+	//the whole viewport once the camera is against or inside the sphere
+	CHECK(selector.getScreenSize(XMFLOAT3(0.0f, 0.0f, 2.0f), 2.0f) == 720.0f);
+	CHECK(selector.getScreenSize(XMFLOAT3(0.0f, 0.0f, 1.0f), 2.0f) == 720.0f);
+}
+
+//group orders by level and keeps the order of adding within one
+TEST(LodGroupByLevel){
+	LodSelector selector;
+	SetTestCamera(selector, 0.0f);
+	const float depths[8] = { 200.0f, 5.0f, 50.0f, 10.0f, 300.0f, 6.0f, 60.0f, 1.0f };
+	const int expected[8] = { 3, 0, 2, 1, 3, 0, 2, 0 };
+	for (unsigned int i = 0; i < 8; i++){
+		selector.add(100 + i, testLods, 4, 1.0f, XMFLOAT3(0.0f, 0.0f, depths[i]), 2.0f);
+	}
+	selector.group();
+
+	const unsigned int order[8] = { 101, 105, 107, 103, 102, 106, 100, 104 };
+	CHECK(selector.getCount() == 8);
+	for (unsigned int i = 0; i < 8; i++){
+		CHECK(selector.getEntity(i) == order[i]);
+		CHECK(selector.getLod(i) == expected[order[i] - 100]);
+	}
+	CHECK(selector.getLodCount(0) == 3 && selector.getLodCount(1) == 1 && selector.getLodCount(2) == 2 && selector.getLodCount(3) == 2);
+
+	selector.clear();
+	selector.group();
+	CHECK(selector.getCount() == 0);
+	CHECK(selector.getLodCount(0) == 0 && selector.getLodCount(3) == 0);
+}
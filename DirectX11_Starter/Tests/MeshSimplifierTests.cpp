@@ -0,0 +1,231 @@
+#include "Test.h"
+#include "MeshSimplifier.h"
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+static Vertex2 MakeVertex(float x, float y, float z, float nx, float ny, float nz, float u, float v){
+	Vertex2 vertex;
+	vertex.Position = XMFLOAT3(x, y, z);
+	vertex.Normal = XMFLOAT3(nx, ny, nz);
+	vertex.UVs = XMFLOAT2(u, v);
+	vertex.Tangent = XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f);
+	return vertex;
+}
+
+static XMFLOAT3 TriangleNormal(const std::vector<Vertex2>& vertices, const unsigned int* triangle){
+	const XMFLOAT3& a = vertices[triangle[0]].Position;
+	const XMFLOAT3& b = vertices[triangle[1]].Position;
+	const XMFLOAT3& c = vertices[triangle[2]].Position;
+	float e1[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+	float e2[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+	return XMFLOAT3(e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]);
+}
+
+static bool SamePosition(const XMFLOAT3& a, const XMFLOAT3& b){
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+//Adds the triangle unless two of its corners share a position, the way the poles and seams of a lat-long sphere would
+static void AddTriangle(const std::vector<Vertex2>& vertices, unsigned int a, unsigned int b, unsigned int c, std::vector<unsigned int>& indices){
+	if (SamePosition(vertices[a].Position, vertices[b].Position) || SamePosition(vertices[b].Position, vertices[c].Position) ||
+		SamePosition(vertices[a].Position, vertices[c].Position)){
+		return;
+	}
+	indices.push_back(a);
+	indices.push_back(b);
+	indices.push_back(c);
+}
+
+/**
+*A lat-long sphere of radius 1 at the origin, facing out. The u = 0 and u = 1 columns and the
+*rows at the poles are separate vertices at the same positions, a uv seam the simplifier welds,
+*so the surface is closed.
+**/
+static void BuildSphere(unsigned int rings, unsigned int segments, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices){
+	const double pi = 3.14159265358979323846;
+	for (unsigned int r = 0; r <= rings; r++){
+		for (unsigned int s = 0; s <= segments; s++){
+			double theta = pi * r / rings;
+			double phi = 2.0 * pi * (s % segments) / segments;
+			float x = (float)(sin(theta) * cos(phi));
+			float y = (float)cos(theta);
+			float z = (float)(sin(theta) * sin(phi));
+			//exact poles, so every vertex of a pole row welds
+			if (r == 0 || r == rings){
+				x = 0.0f;
+				z = 0.0f;
+			}
+			vertices.push_back(MakeVertex(x, y, z, x, y, z, (float)s / segments, (float)r / rings));
+		}
+	}
+	for (unsigned int r = 0; r < rings; r++){
+		for (unsigned int s = 0; s < segments; s++){
+			unsigned int a = r * (segments + 1) + s;
+			unsigned int b = a + segments + 1;
+			AddTriangle(vertices, a, a + 1, b, indices);
+			AddTriangle(vertices, a + 1, b + 1, b, indices);
+		}
+	}
+	XMFLOAT3 normal = TriangleNormal(vertices, &indices[0]);
+	const XMFLOAT3& corner = vertices[indices[0]].Position;
+	if (normal.x * corner.x + normal.y * corner.y + normal.z * corner.z < 0.0f){
+		for (size_t i = 0; i < indices.size(); i += 3){
+			std::swap(indices[i + 1], indices[i + 2]);
+		}
+	}
+}
+
+//A size x size heightfield in x and y facing +z, open on all four sides
+static void BuildGrid(unsigned int size, std::vector<Vertex2>& vertices, std::vector<unsigned int>& indices){
+	for (unsigned int y = 0; y <= size; y++){
+		for (unsigned int x = 0; x <= size; x++){
+			float height = 0.3f * sinf(x * 0.4f) * cosf(y * 0.3f);
+			vertices.push_back(MakeVertex((float)x, (float)y, height, 0.0f, 0.0f, 1.0f, (float)x / size, (float)y / size));
+		}
+	}
+	for (unsigned int y = 0; y < size; y++){
+		for (unsigned int x = 0; x < size; x++){
+			unsigned int a = y * (size + 1) + x;
+			unsigned int b = a + size + 1;
+			indices.push_back(a);
+			indices.push_back(a + 1);
+			indices.push_back(b);
+			indices.push_back(a + 1);
+			indices.push_back(b + 1);
+			indices.push_back(b);
+		}
+	}
+}
+
+//Edges between positions, each as often as a triangle runs along it in that direction
+typedef std::map<std::pair<unsigned int, unsigned int>, int> PositionEdges;
+
+static unsigned int PositionIndex(const std::vector<Vertex2>& vertices, unsigned int v){
+	//the first vertex at the same position stands for all of them
+	for (unsigned int i = 0; i < v; i++){
+		if (SamePosition(vertices[i].Position, vertices[v].Position)){
+			return i;
+		}
+	}
+	return v;
+}
+
+//Open edges of an index list, as pairs of position indices
+static void FindOpenEdges(const std::vector<Vertex2>& vertices, const std::vector<unsigned int>& indices, std::vector<std::pair<unsigned int, unsigned int>>& open){
+	std::vector<unsigned int> positionOf(vertices.size());
+	for (unsigned int v = 0; v < vertices.size(); v++){
+		positionOf[v] = PositionIndex(vertices, v);
+	}
+	PositionEdges edges;
+	for (size_t i = 0; i < indices.size(); i += 3){
+		for (int k = 0; k < 3; k++){
+			edges[std::make_pair(positionOf[indices[i + k]], positionOf[indices[i + (k + 1) % 3]])]++;
+		}
+	}
+	open.clear();
+	for (PositionEdges::const_iterator e = edges.begin(); e != edges.end(); e++){
+		if (edges.find(std::make_pair(e->first.second, e->first.first)) == edges.end()){
+			open.push_back(e->first);
+		}
+	}
+}
+
+//Indices in range, no triangle degenerate or facing away from outward(triangle centroid)
+template<typename TOutward>
+static void CheckLevel(const std::vector<Vertex2>& vertices, const std::vector<unsigned int>& level, TOutward outward){
+	CHECK(!level.empty() && level.size() % 3 == 0);
+	bool inRange = true;
+	bool nondegenerate = true;
+	bool facesOut = true;
+	for (size_t i = 0; i + 2 < level.size(); i += 3){
+		inRange = inRange && level[i] < vertices.size() && level[i + 1] < vertices.size() && level[i + 2] < vertices.size();
+		if (!inRange){
+			break;
+		}
+		XMFLOAT3 normal = TriangleNormal(vertices, &level[i]);
+		float area = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		nondegenerate = nondegenerate && area > 1e-6f;
+		const XMFLOAT3& a = vertices[level[i]].Position;
+		const XMFLOAT3& b = vertices[level[i + 1]].Position;
+		const XMFLOAT3& c = vertices[level[i + 2]].Position;
+		XMFLOAT3 out = outward(XMFLOAT3((a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f));
+		facesOut = facesOut && normal.x * out.x + normal.y * out.y + normal.z * out.z > 0.0f;
+	}
+	CHECK(inRange);
+	CHECK(nondegenerate);
+	CHECK(facesOut);
+}
+
+static XMFLOAT3 AwayFromOrigin(const XMFLOAT3& p){
+	return p;
+}
+
+static XMFLOAT3 Up(const XMFLOAT3&){
+	return XMFLOAT3(0.0f, 0.0f, 1.0f);
+}
+
+//Halving the triangle count level after level, the way the cooker builds a chain
+TEST(SimplifyClosedSphere){
+	std::vector<Vertex2> vertices;
+	std::vector<unsigned int> indices;
+	BuildSphere(24, 48, vertices, indices);
+	std::vector<std::pair<unsigned int, unsigned int>> open;
+	FindOpenEdges(vertices, indices, open);
+	CHECK(open.empty());
+
+	size_t previous = indices.size();
+	for (int lod = 1; lod <= 4; lod++){
+		std::vector<unsigned int> level;
+		size_t target = previous / 6 * 3;
+		float error = SimplifyMesh(vertices, indices, target, 0.1f, level);
+		CHECK(error <= 0.1f);
+		CHECK(level.size() <= previous);
+		CheckLevel(vertices, level, AwayFromOrigin);
+		//welded across the seam and the poles, so still closed
+		FindOpenEdges(vertices, level, open);
+		CHECK(open.empty());
+		previous = level.size();
+	}
+
+	//a limit of zero allows nothing that changes the shape
+	std::vector<unsigned int> level;
+	CHECK(SimplifyMesh(vertices, indices, indices.size() / 2, 0.0f, level) == 0.0f);
+	CHECK(level.size() == indices.size());
+}
+
+//The grid can collapse a long way, but its outline has to stay where it was
+TEST(SimplifyOpenGridKeepsBorder){
+	const unsigned int size = 32;
+	std::vector<Vertex2> vertices;
+	std::vector<unsigned int> indices;
+	BuildGrid(size, vertices, indices);
+
+	size_t previous = indices.size();
+	for (int lod = 1; lod <= 4; lod++){
+		std::vector<unsigned int> level;
+		size_t target = previous / 6 * 3;
+		float error = SimplifyMesh(vertices, indices, target, 0.25f, level);
+		CHECK(error <= 0.25f);
+		CHECK(level.size() < previous);
+		CheckLevel(vertices, level, Up);
+
+		//every open edge runs along one side of the square, and together they cover all four
+		std::vector<std::pair<unsigned int, unsigned int>> open;
+		FindOpenEdges(vertices, level, open);
+		bool onBorder = true;
+		double perimeter = 0.0;
+		for (size_t e = 0; e < open.size(); e++){
+			const XMFLOAT3& a = vertices[open[e].first].Position;
+			const XMFLOAT3& b = vertices[open[e].second].Position;
+			bool alongX = a.y == b.y && (a.y == 0.0f || a.y == size);
+			bool alongY = a.x == b.x && (a.x == 0.0f || a.x == size);
+			onBorder = onBorder && (alongX || alongY);
+			perimeter += sqrt((double)(b.x - a.x) * (b.x - a.x) + (double)(b.y - a.y) * (b.y - a.y));
+		}
+		CHECK(onBorder);
+		CHECK(fabs(perimeter - 4.0 * size) < 1e-3);
+		previous = level.size();
+	}
+}
@@ -0,0 +1,212 @@
+#include "Test.h"
+#include "MeshTangents.h"
+#include <cmath>
+#include <vector>
+
+//The frame GenerateTangents should produce, worked out in double
+struct ReferenceTangent{
+	double tangent[3];
+	double handedness;
+};
+
+static void Cross(const double a[3], const double b[3], double out[3]){
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static double Dot(const double a[3], const double b[3]){
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/**
+*Lengyel's method written out the long way: each triangle's dP/du and dP/dv divided by the uv
+*determinant, weighted by the uv area |det|, summed per vertex, then Gram-Schmidt against the
+*normal. The meshes below have no degenerate uvs, so the fallbacks aren't modelled.
+**/
+static void ReferenceTangents(const std::vector<Vertex2>& vertices, const std::vector<unsigned int>& indices, std::vector<ReferenceTangent>& frames){
+	std::vector<double> tangents(vertices.size() * 3, 0.0);
+	std::vector<double> bitangents(vertices.size() * 3, 0.0);
+	for (size_t i = 0; i + 2 < indices.size(); i += 3){
+		const Vertex2& v0 = vertices[indices[i]];
+		const Vertex2& v1 = vertices[indices[i + 1]];
+		const Vertex2& v2 = vertices[indices[i + 2]];
+		double e1[3] = { (double)v1.Position.x - v0.Position.x, (double)v1.Position.y - v0.Position.y, (double)v1.Position.z - v0.Position.z };
+		double e2[3] = { (double)v2.Position.x - v0.Position.x, (double)v2.Position.y - v0.Position.y, (double)v2.Position.z - v0.Position.z };
+		double s1 = (double)v1.UVs.x - v0.UVs.x;
+		double t1 = (double)v1.UVs.y - v0.UVs.y;
+		double s2 = (double)v2.UVs.x - v0.UVs.x;
+		double t2 = (double)v2.UVs.y - v0.UVs.y;
+		double det = s1 * t2 - s2 * t1;
+		double weight = fabs(det);
+		for (int k = 0; k < 3; k++){
+			size_t corner = indices[i + k];
+			for (int j = 0; j < 3; j++){
+				tangents[corner * 3 + j] += (e1[j] * t2 - e2[j] * t1) / det * weight;
+				bitangents[corner * 3 + j] += (e2[j] * s1 - e1[j] * s2) / det * weight;
+			}
+		}
+	}
+
+	frames.resize(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++){
+		double n[3] = { vertices[i].Normal.x, vertices[i].Normal.y, vertices[i].Normal.z };
+		double length = sqrt(Dot(n, n));
+		for (int j = 0; j < 3; j++){
+			n[j] /= length;
+		}
+		double* t = &tangents[i * 3];
+		double along = Dot(n, t);
+		for (int j = 0; j < 3; j++){
+			t[j] -= n[j] * along;
+		}
+		length = sqrt(Dot(t, t));
+		double nxt[3];
+		Cross(n, t, nxt);
+		for (int j = 0; j < 3; j++){
+			frames[i].tangent[j] = t[j] / length;
+		}
+		frames[i].handedness = Dot(nxt, &bitangents[i * 3]) < 0.0 ? -1.0 : 1.0;
+	}
+}
+
+//Repeatable jitter in [-1, 1)
+static double Jitter(unsigned int& seed){
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) / (double)(1 << 23) - 1.0;
+}
+
+static Vertex2 MakeVertex(double x, double y, double z, double nx, double ny, double nz, double u, double v){
+	Vertex2 vertex;
+	vertex.Position = XMFLOAT3((float)x, (float)y, (float)z);
+	vertex.Normal = XMFLOAT3((float)nx, (float)ny, (float)nz);
+	vertex.UVs = XMFLOAT2((float)u, (float)v);
+	vertex.Tangent = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+	return vertex;
+}
+
+//rows x columns quads, two triangles each
+static void GridIndices(unsigned int rows, unsigned int columns, unsigned int first, std::vector<unsigned int>& indices){
+	for (unsigned int r = 0; r < rows; r++){
+		for (unsigned int c = 0; c < columns; c++){
+			unsigned int corner = first + r * (columns + 1) + c;
+			unsigned int quad[6] = { corner, corner + columns + 1, corner + 1, corner + 1, corner + columns + 1, corner + columns + 2 };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+}
+
+//Compares every vertex with the reference, tolerances sized for float against double
+static void CheckAgainstReference(std::vector<Vertex2>& vertices, const std::vector<unsigned int>& indices){
+	std::vector<ReferenceTangent> reference;
+	ReferenceTangents(vertices, indices, reference);
+	GenerateTangents(&vertices[0], vertices.size(), &indices[0], indices.size());
+
+	double worstDirection = 1.0;
+	double worstLength = 0.0;
+	double worstOrthogonal = 0.0;
+	unsigned int handednessMismatches = 0;
+	for (size_t i = 0; i < vertices.size(); i++){
+		const XMFLOAT4& tangent = vertices[i].Tangent;
+		double t[3] = { tangent.x, tangent.y, tangent.z };
+		double n[3] = { vertices[i].Normal.x, vertices[i].Normal.y, vertices[i].Normal.z };
+		double length = sqrt(Dot(t, t));
+		worstDirection = fmin(worstDirection, Dot(t, reference[i].tangent) / length);
+		worstLength = fmax(worstLength, fabs(length - 1.0));
+		worstOrthogonal = fmax(worstOrthogonal, fabs(Dot(t, n)) / sqrt(Dot(n, n)));
+		if (tangent.w != (float)reference[i].handedness){
+			handednessMismatches++;
+		}
+	}
+	CHECK(worstDirection > 1.0 - 1e-6);
+	CHECK(worstLength < 1e-5);
+	CHECK(worstOrthogonal < 1e-5);
+	CHECK(handednessMismatches == 0);
+}
+
+//A flat quad whose right half has its u mirrored, split at the seam the way a cooked mesh would be
+TEST(TangentsMirroredHandedness){
+	std::vector<Vertex2> vertices;
+	for (int side = 0; side < 2; side++){
+		for (int r = 0; r <= 1; r++){
+			for (int c = 0; c <= 1; c++){
+				double x = side + c;
+				double u = side == 0 ? x : 2.0 - x;
+				vertices.push_back(MakeVertex(x, r, 0.0, 0.0, 0.0, 1.0, u, r));
+			}
+		}
+	}
+	std::vector<unsigned int> indices;
+	GridIndices(1, 1, 0, indices);
+	GridIndices(1, 1, 4, indices);
+	std::vector<Vertex2> checked = vertices;
+	CheckAgainstReference(checked, indices);
+
+	for (size_t i = 0; i < checked.size(); i++){
+		const XMFLOAT4& tangent = checked[i].Tangent;
+		float expectedX = i < 4 ? 1.0f : -1.0f;
+		CHECK(fabsf(tangent.x - expectedX) < 1e-6f && fabsf(tangent.y) < 1e-6f && fabsf(tangent.z) < 1e-6f);
+		//u runs against +x on the mirrored side, v still runs along +y, so the frame is left handed
+		CHECK(tangent.w == (i < 4 ? 1.0f : -1.0f));
+	}
+}
+
+//A lat-long sphere, rotated off the axes so no component is trivially zero
+TEST(TangentsSphereMatchesReference){
+	const unsigned int rings = 16;
+	const unsigned int segments = 32;
+	const double pi = 3.14159265358979323846;
+	const double tilt = 0.4;
+	std::vector<Vertex2> vertices;
+	//the poles are left out, every triangle there has a corner with no tangent direction
+	for (unsigned int r = 1; r < rings; r++){
+		for (unsigned int s = 0; s <= segments; s++){
+			double theta = pi * r / rings;
+			double phi = 2.0 * pi * s / segments;
+			double x = sin(theta) * cos(phi);
+			double y = cos(theta);
+			double z = sin(theta) * sin(phi);
+			double ry = y * cos(tilt) - z * sin(tilt);
+			double rz = y * sin(tilt) + z * cos(tilt);
+			vertices.push_back(MakeVertex(x * 3.0, ry * 3.0, rz * 3.0, x, ry, rz, (double)s / segments, (double)r / rings));
+		}
+	}
+	std::vector<unsigned int> indices;
+	GridIndices(rings - 2, segments, 0, indices);
+	CheckAgainstReference(vertices, indices);
+}
+
+//A bumpy grid with jittered positions, normals and uvs, and the v axis flipped on every other
+//column band so both handedness signs come out of the sums rather than the layout
+TEST(TangentsJitteredGridMatchesReference){
+	const unsigned int size = 24;
+	unsigned int seed = 12345;
+	std::vector<Vertex2> vertices;
+	for (int band = 0; band < 2; band++){
+		double flip = band == 0 ? 1.0 : -1.0;
+		for (unsigned int r = 0; r <= size; r++){
+			for (unsigned int c = 0; c <= size; c++){
+				double x = c + Jitter(seed) * 0.2;
+				double y = r + Jitter(seed) * 0.2;
+				double z = sin(x * 0.5) * cos(y * 0.3);
+				double nx = -0.5 * cos(x * 0.5) * cos(y * 0.3) + Jitter(seed) * 0.05;
+				double ny = 0.3 * sin(x * 0.5) * sin(y * 0.3) + Jitter(seed) * 0.05;
+				double u = c / (double)size + Jitter(seed) * 0.005;
+				double v = flip * r / (double)size + Jitter(seed) * 0.005;
+				vertices.push_back(MakeVertex(x, y, z, nx, ny, 1.0, u, v));
+			}
+		}
+	}
+	std::vector<unsigned int> indices;
+	GridIndices(size, size, 0, indices);
+	GridIndices(size, size, (size + 1) * (size + 1), indices);
+	CheckAgainstReference(vertices, indices);
+
+	unsigned int leftHanded = 0;
+	for (size_t i = 0; i < vertices.size(); i++){
+		if (vertices[i].Tangent.w < 0.0f){
+			leftHanded++;
+		}
+	}
+	CHECK(leftHanded == vertices.size() / 2);
+}
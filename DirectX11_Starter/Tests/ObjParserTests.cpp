@@ -0,0 +1,152 @@
+#include "Test.h"
+#include "ObjParser.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static void Parse(const std::string& text, ObjChunk& chunk){
+	ParseObjChunk(text.data(), text.data() + text.size(), chunk);
+}
+
+static bool SameCorner(const ObjCorner& corner, int position, int uv, int normal){
+	return corner.position == position && corner.uv == uv && corner.normal == normal;
+}
+
+//Well past the 64 corners the parser used to keep, every one has to make it into the fan
+TEST(ObjPolygonWithManyCorners){
+	const int sides = 200;
+	std::string text;
+	char line[64];
+	for (int i = 0; i < sides; i++){
+		sprintf(line, "v %d 0 %d\n", i % 7, i / 7);
+		text += line;
+	}
+	text += "f";
+	for (int i = 1; i <= sides; i++){
+		sprintf(line, " %d", i);
+		text += line;
+	}
+	text += "\n";
+
+	ObjChunk chunk;
+	Parse(text, chunk);
+	CHECK(chunk.positions.size() == (size_t)sides);
+	CHECK(chunk.corners.size() == (size_t)(sides - 2) * 3);
+	CHECK(chunk.relative.size() == chunk.corners.size());
+	bool fan = chunk.corners.size() == (size_t)(sides - 2) * 3;
+	for (int t = 0; fan && t < sides - 2; t++){
+		fan = SameCorner(chunk.corners[t * 3], 1, 0, 0) && SameCorner(chunk.corners[t * 3 + 1], t + 2, 0, 0) && SameCorner(chunk.corners[t * 3 + 2], t + 3, 0, 0);
+	}
+	CHECK(fan);
+}
+
+TEST(ObjCornerForms){
+	ObjChunk chunk;
+	Parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvn 0 0 1\n"
+		"f 1 2 3\n"
+		"f 1/1 2/2 3/3\n"
+		"f 1//1 2//1 3//1\n"
+		"f 1/3/1 2/2/1 3/1/1\n", chunk);
+	CHECK(chunk.corners.size() == 12);
+	if (chunk.corners.size() == 12){
+		CHECK(SameCorner(chunk.corners[2], 3, 0, 0));
+		CHECK(SameCorner(chunk.corners[4], 2, 2, 0));
+		CHECK(SameCorner(chunk.corners[8], 3, 0, 1));
+		CHECK(SameCorner(chunk.corners[9], 1, 3, 1));
+	}
+}
+
+TEST(ObjQuadsAndNegativeIndices){
+	ObjChunk chunk;
+	Parse("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvn 0 0 1\n"
+		"f -4/-1/-1 -3/-1/-1 -2/-1/-1 -1/-1/-1\n", chunk);
+	CHECK(chunk.corners.size() == 6);
+	if (chunk.corners.size() == 6){
+		CHECK(SameCorner(chunk.corners[0], 1, 1, 1) && SameCorner(chunk.corners[1], 2, 1, 1) && SameCorner(chunk.corners[2], 3, 1, 1));
+		CHECK(SameCorner(chunk.corners[3], 1, 1, 1) && SameCorner(chunk.corners[4], 3, 1, 1) && SameCorner(chunk.corners[5], 4, 1, 1));
+		CHECK(chunk.relative[0] == (OBJ_RELATIVE_POSITION | OBJ_RELATIVE_UV | OBJ_RELATIVE_NORMAL));
+	}
+
+	//resolving shifts them by what earlier chunks held
+	ResolveObjChunk(chunk, 10, 20, 30);
+	CHECK(SameCorner(chunk.corners[0], 11, 21, 31));
+	CHECK(chunk.relative[0] == 0);
+}
+
+TEST(ObjDegenerateFacesDropped){
+	ObjChunk chunk;
+	Parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\nf 1\nf\nf 1 2 3\n", chunk);
+	CHECK(chunk.corners.size() == 3);
+	CHECK(chunk.relative.size() == 3);
+}
+
+TEST(ObjMeshDeduplicatesCorners){
+	std::vector<Vertex2> vertices;
+	std::vector<unsigned int> indices;
+	std::string text = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvn 0 0 1\n"
+		"f 1/1/1 2/2/1 3/3/1 4/4/1\n";
+	CHECK(ParseObj(text.data(), text.size(), vertices, indices));
+	CHECK(vertices.size() == 4);
+	CHECK(indices.size() == 6);
+
+	//a face past the attributes there are fails the load
+	std::string broken = "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+	CHECK(!ParseObj(broken.data(), broken.size(), vertices, indices));
+}
+
+/**
+*A few MB of OBJ, enough for the parallel loader to split it into many chunks: groups of
+*attributes followed by faces using them, alternating absolute and negative indices so the
+*relative ones cross chunk boundaries, with quads, pentagons, comments and every corner form.
+**/
+static void GenerateMixedObj(std::string& text){
+	char line[256];
+	int positions = 0;
+	for (int group = 0; group < 16000; group++){
+		sprintf(line, "# group %d\ng g%d\n", group, group);
+		text += line;
+		for (int i = 0; i < 6; i++){
+			sprintf(line, "v %d.%03d %d.5 -%d.25e-1\nvt 0.%d 0.%d\nvn 0 %d 1\n", group, i * 111, i, group % 97, i, group % 10, i % 2);
+			text += line;
+		}
+		positions += 6;
+		if (group % 2){
+			text += "f -6/-6/-6 -5/-5/-5 -4/-4/-4 -3/-3/-3\nf -3//-3 -2//-2 -1//-1\nf -6/-1 -4/-2 -2/-3 -1/-4 -5/-5\n";
+		}
+		else{
+			int a = positions - 5;
+			sprintf(line, "f %d/%d/%d %d/%d/%d %d/%d/%d\nf %d %d %d %d\nf %d/%d %d/%d %d/%d %d/%d %d/%d\n",
+				a, a, a, a + 1, a + 1, a + 1, a + 2, a + 2, a + 2,
+				a + 2, a + 3, a + 4, a + 5,
+				a, a + 5, a + 1, a + 4, a + 2, a + 3, a + 3, a + 2, a + 4, a + 1);
+			text += line;
+		}
+	}
+}
+
+//Same vertices, bit for bit, and the same indices as the serial path, whatever the thread count
+TEST(ObjParallelMatchesSerial){
+	std::string text;
+	GenerateMixedObj(text);
+	CHECK(text.size() > (4 << 20));
+
+	std::vector<Vertex2> vertices;
+	std::vector<unsigned int> indices;
+	CHECK(ParseObj(text.data(), text.size(), vertices, indices));
+	CHECK(!indices.empty() && vertices.size() < indices.size());
+	if (indices.empty()){
+		return;
+	}
+
+	for (unsigned int threads = 1; threads <= 8; threads++){
+		ThreadPool pool(threads - 1);
+		std::vector<Vertex2> parallelVertices;
+		std::vector<unsigned int> parallelIndices;
+		CHECK(ParseObjParallel(text.data(), text.size(), &pool, parallelVertices, parallelIndices));
+		CHECK(parallelIndices == indices);
+		CHECK(parallelVertices.size() == vertices.size() &&
+			memcmp(&parallelVertices[0], &vertices[0], sizeof(Vertex2) * vertices.size()) == 0);
+	}
+}
@@ -0,0 +1,195 @@
+#include "Test.h"
+#include "ParallelRenderQueue.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//What a render job draws with: the jobs that ran on it, in order
+struct RecordingContext{
+	std::vector<unsigned int> jobs;
+};
+
+enum BackendCall{
+	BEGIN_FLUSH,
+	BEGIN_RECORDING,
+	END_RECORDING,
+	EXECUTE_RECORDING,
+	END_FLUSH
+};
+
+struct BackendEvent{
+	BackendCall call;
+	unsigned int worker;
+	std::thread::id thread;
+};
+
+//Stands in for D3D11CommandBackend: a recording is the list of jobs run on a worker's context,
+//executing it appends that list to what the "GPU" has seen
+class RecordingBackend : public CommandBackend<RecordingContext>{
+public:
+	RecordingBackend(unsigned int workerCount) : workers(workerCount), recordings(workerCount){}
+
+	unsigned int getWorkerCount(){
+		return workers;
+	}
+	RecordingContext* getImmediateContext(){
+		return &immediate;
+	}
+	void beginFlush(){
+		log(BEGIN_FLUSH, 0);
+	}
+	RecordingContext* beginRecording(unsigned int worker){
+		log(BEGIN_RECORDING, worker);
+		recordings[worker].jobs.clear();
+		return &recordings[worker];
+	}
+	void endRecording(unsigned int worker){
+		log(END_RECORDING, worker);
+	}
+	void executeRecording(unsigned int worker){
+		log(EXECUTE_RECORDING, worker);
+		immediate.jobs.insert(immediate.jobs.end(), recordings[worker].jobs.begin(), recordings[worker].jobs.end());
+	}
+	void endFlush(){
+		log(END_FLUSH, 0);
+	}
+
+	unsigned int workers;
+	RecordingContext immediate;
+	std::vector<RecordingContext> recordings;
+	std::vector<BackendEvent> events;
+
+private:
+	void log(BackendCall call, unsigned int worker){
+		BackendEvent event;
+		event.call = call;
+		event.worker = worker;
+		event.thread = std::this_thread::get_id();
+		std::lock_guard<std::mutex> lock(mutex);
+		events.push_back(event);
+	}
+
+	std::mutex mutex;
+};
+
+//Flushes jobCount jobs through workers recordings and checks the backend saw a well formed flush
+//that played every job back in submission order
+static void CheckFlush(unsigned int workers, unsigned int jobCount, ThreadPool* pool){
+	RecordingBackend backend(workers);
+	ParallelRenderQueue<RecordingContext> queue(&backend, pool);
+	for (unsigned int i = 0; i < jobCount; i++){
+		queue.submit([i](RecordingContext* context){ context->jobs.push_back(i); });
+	}
+	CHECK(queue.getPendingCount() == jobCount);
+	queue.flush();
+	CHECK(queue.getPendingCount() == 0);
+
+	bool inOrder = backend.immediate.jobs.size() == jobCount;
+	for (unsigned int i = 0; inOrder && i < jobCount; i++){
+		inOrder = backend.immediate.jobs[i] == i;
+	}
+	CHECK(inOrder);
+
+	unsigned int slices = workers < jobCount ? workers : jobCount;
+	CHECK(queue.getLastSliceCount() == slices);
+	if (slices == 0){
+		//straight onto the immediate context, no recording at all
+		CHECK(backend.events.empty());
+		return;
+	}
+
+	//beginFlush, a begin and end per slice in any order between threads, executes in slice order, endFlush
+	const std::vector<BackendEvent>& events = backend.events;
+	CHECK(events.size() == 3 * slices + 2);
+	if (events.size() != 3 * slices + 2){
+		return;
+	}
+	CHECK(events.front().call == BEGIN_FLUSH);
+	CHECK(events.back().call == END_FLUSH);
+	std::vector<int> begun(slices, 0);
+	std::vector<int> ended(slices, 0);
+	bool recordingsWellFormed = true;
+	for (unsigned int i = 1; i <= 2 * slices; i++){
+		const BackendEvent& event = events[i];
+		recordingsWellFormed = recordingsWellFormed && event.worker < slices;
+		if (!recordingsWellFormed){
+			break;
+		}
+		if (event.call == BEGIN_RECORDING){
+			recordingsWellFormed = begun[event.worker]++ == 0;
+		}
+		else{
+			recordingsWellFormed = event.call == END_RECORDING && begun[event.worker] == 1 && ended[event.worker]++ == 0;
+		}
+	}
+	CHECK(recordingsWellFormed);
+	bool executedInOrder = true;
+	for (unsigned int k = 0; k < slices; k++){
+		const BackendEvent& event = events[2 * slices + 1 + k];
+		executedInOrder = executedInOrder && event.call == EXECUTE_RECORDING && event.worker == k;
+	}
+	CHECK(executedInOrder);
+
+	//contiguous slices within one job of each other, so every worker gets a share
+	unsigned int smallest = jobCount;
+	unsigned int largest = 0;
+	for (unsigned int k = 0; k < slices; k++){
+		unsigned int size = backend.recordings[k].jobs.size();
+		smallest = size < smallest ? size : smallest;
+		largest = size > largest ? size : largest;
+	}
+	CHECK(smallest >= 1 && largest - smallest <= 1);
+
+	//slice 0 is always recorded by the thread calling flush
+	bool sliceZeroOnCaller = false;
+	for (size_t i = 0; i < events.size(); i++){
+		if (events[i].call == BEGIN_RECORDING && events[i].worker == 0){
+			sliceZeroOnCaller = events[i].thread == std::this_thread::get_id();
+		}
+	}
+	CHECK(sliceZeroOnCaller);
+}
+
+static const unsigned int jobCounts[] = { 0, 1, 2, 3, 7, 8, 9, 100 };
+
+TEST(RenderQueueWithoutPool){
+	for (unsigned int workers = 0; workers <= 8; workers++){
+		for (unsigned int j = 0; j < sizeof(jobCounts) / sizeof(jobCounts[0]); j++){
+			CheckFlush(workers, jobCounts[j], nullptr);
+		}
+	}
+}
+
+//Pool sized like Game does, one thread fewer than the slices
+TEST(RenderQueueWithPool){
+	for (unsigned int workers = 0; workers <= 8; workers++){
+		ThreadPool pool(workers > 1 ? workers - 1 : 0);
+		for (int repeat = 0; repeat < 20; repeat++){
+			for (unsigned int j = 0; j < sizeof(jobCounts) / sizeof(jobCounts[0]); j++){
+				CheckFlush(workers, jobCounts[j], &pool);
+			}
+		}
+	}
+}
+
+//Later flushes start from an empty queue and slice again
+TEST(RenderQueueReusedAcrossFlushes){
+	RecordingBackend backend(4);
+	ThreadPool pool(3);
+	ParallelRenderQueue<RecordingContext> queue(&backend, &pool);
+	unsigned int next = 0;
+	for (unsigned int frame = 0; frame < 10; frame++){
+		unsigned int count = frame * 3;
+		for (unsigned int i = 0; i < count; i++){
+			unsigned int id = next++;
+			queue.submit([id](RecordingContext* context){ context->jobs.push_back(id); });
+		}
+		queue.flush();
+		CHECK(queue.getLastSliceCount() == (count < 4 ? count : 4));
+	}
+	bool inOrder = backend.immediate.jobs.size() == next;
+	for (unsigned int i = 0; inOrder && i < next; i++){
+		inOrder = backend.immediate.jobs[i] == i;
+	}
+	CHECK(inOrder);
+}
@@ -0,0 +1,123 @@
+#include "Test.h"
+#include "ParticleSimulation.h"
+#include <cmath>
+#include <vector>
+
+static ParticleEmitter MakeEmitter(float lifetime, unsigned int particlesPerEmitter, unsigned int firstParticle){
+	ParticleEmitter emitter;
+	emitter.position = XMFLOAT4(1.0f, 2.0f, 3.0f, 1.0f);
+	emitter.velocity = XMFLOAT2(0.5f, -0.25f);
+	emitter.acceleration = XMFLOAT2(0.0f, 0.0f);
+	emitter.lifetime = lifetime;
+	emitter.emitInterval = lifetime / particlesPerEmitter;
+	emitter.firstParticle = firstParticle;
+	emitter.phase = 0.0f;
+	emitter.previousPhase = 0.0f;
+	emitter.padding[0] = 0;
+	emitter.padding[1] = 0;
+	return emitter;
+}
+
+//Distance between two ages on a circle of one lifetime, a slot about to be recycled may sit either side of it
+static double LifetimeDistance(double a, double b, double lifetime){
+	double d = fabs(a - b);
+	return d < lifetime - d ? d : lifetime - d;
+}
+
+//Steps a pool of two emitters from start for seconds of 60Hz frames and checks every slot against
+//the closed form in double once the first lifetime has filled the pool. A slot whose lifetime ends
+//right on a frame is dead for that frame and re-emitted in the next, so those are left out
+static void CheckCadence(double start, double seconds){
+	const unsigned int particlesPerEmitter = 20;
+	const float dt = 1.0f / 60.0f;
+	ParticleEmitter emitters[2] = { MakeEmitter(2.0f, particlesPerEmitter, 0), MakeEmitter(1.5f, particlesPerEmitter, particlesPerEmitter) };
+	std::vector<PooledParticle> pool(2 * particlesPerEmitter);
+	InitializeParticlePool(&pool[0], 2, particlesPerEmitter);
+	SetEmitterPhases(emitters, 2, start);
+
+	double time = start;
+	bool allAlive = true;
+	bool agesMatch = true;
+	bool positionsMatch = true;
+	for (int frame = 1; frame <= (int)(seconds * 60.0); frame++){
+		time = start + frame * (double)dt;
+		SetEmitterPhases(emitters, 2, time);
+		SimulateParticles(emitters, &pool[0], 2, particlesPerEmitter, dt);
+		if (time - start < 2.0 + dt){
+			continue;
+		}
+		for (unsigned int i = 0; i < pool.size(); i++){
+			const PooledParticle& p = pool[i];
+			const ParticleEmitter& e = emitters[p.emitter];
+			unsigned int slot = i - e.firstParticle;
+			double expected = fmod(time - slot * (double)e.emitInterval, (double)e.lifetime);
+			if (LifetimeDistance(expected, 0.0, e.lifetime) < 1e-3){
+				continue;
+			}
+			allAlive = allAlive && p.alive == 1;
+			agesMatch = agesMatch && LifetimeDistance(p.age, expected, e.lifetime) < 1e-3;
+			positionsMatch = positionsMatch && fabsf(p.position.x - (e.position.x + e.velocity.x * p.age)) < 1e-3f &&
+				fabsf(p.position.y - (e.position.y + e.velocity.y * p.age)) < 1e-3f && p.position.z == e.position.z;
+		}
+	}
+	CHECK(allAlive);
+	CHECK(agesMatch);
+	CHECK(positionsMatch);
+}
+
+TEST(EmitterPhaseStaysInsideLifetime){
+	ParticleEmitter emitter = MakeEmitter(2.0f, 20, 0);
+	double times[] = { 0.0, 0.5, 2.0, 3599.75, 864000.3, 1.0e7 + 1.25 };
+	for (int i = 0; i < 6; i++){
+		SetEmitterPhases(&emitter, 1, times[i]);
+		CHECK(emitter.phase >= 0.0f && emitter.phase < emitter.lifetime);
+		CHECK(fabs(emitter.phase - fmod(times[i], 2.0)) < 1e-6);
+	}
+}
+
+TEST(ParticleCadenceFromStartup){
+	CheckCadence(0.0, 8.0);
+}
+
+//Ten days in a float clock has a 1/16s step, so a 60Hz delta would vanish; the phase keeps full precision
+TEST(ParticleCadenceAfterTenDays){
+	CheckCadence(864000.0, 8.0);
+}
+
+TEST(ParticleWindowAcrossWrapEmitsPreviousLifetime){
+	//emissions every 0.25s into slots 0-3, the window from 0.7 round to 0.05 holds 3 of the previous
+	//lifetime, numbered -1 (slot 3), and 0 (slot 0)
+	ParticleEmitter emitter = MakeEmitter(1.0f, 4, 0);
+	emitter.previousPhase = 0.7f;
+	emitter.phase = 0.05f;
+	PooledParticle pool[4];
+	InitializeParticlePool(pool, 1, 4);
+	SimulateParticles(&emitter, pool, 1, 4, 0.35f);
+	CHECK(pool[0].alive == 1 && fabsf(pool[0].age - 0.05f) < 1e-6f);
+	CHECK(pool[1].alive == 0);
+	CHECK(pool[2].alive == 0);
+	CHECK(pool[3].alive == 1 && fabsf(pool[3].age - 0.3f) < 1e-6f);
+}
+
+TEST(CompareParticlePoolsCountsDifferingSlots){
+	PooledParticle expected[4];
+	InitializeParticlePool(expected, 1, 4);
+	for (int i = 0; i < 4; i++){
+		expected[i].alive = i < 3;
+		expected[i].age = 0.5f;
+		expected[i].position = XMFLOAT3(100.0f, 1.0f, 0.0f);
+	}
+	PooledParticle actual[4];
+	for (int i = 0; i < 4; i++){
+		actual[i] = expected[i];
+	}
+	CHECK(CompareParticlePools(expected, actual, 4, 1e-3f) == 0);
+
+	actual[0].position.x = 100.05f; // relative to 100, inside the tolerance
+	actual[3].age = 7.0f; // dead, not compared
+	CHECK(CompareParticlePools(expected, actual, 4, 1e-3f) == 0);
+
+	actual[1].age = 0.52f;
+	actual[2].alive = 0;
+	CHECK(CompareParticlePools(expected, actual, 4, 1e-3f) == 2);
+}
@@ -0,0 +1,162 @@
+#include "Test.h"
+#include "ParticleSoA.h"
+#include <cmath>
+#include <vector>
+
+//One particle integrated the plain way, the order ParticleSoA::integrate documents
+struct ReferenceParticle{
+	float x, y, z;
+	float vx, vy;
+	float ax, ay;
+	float age;
+	float lifetime;
+};
+
+static void IntegrateReference(std::vector<ReferenceParticle>& particles, float dt){
+	for (size_t i = 0; i < particles.size(); i++){
+		ReferenceParticle& p = particles[i];
+		p.age += dt;
+		p.vx += p.ax * dt;
+		p.vy += p.ay * dt;
+		p.x += p.vx * dt;
+		p.y += p.vy * dt;
+	}
+}
+
+static bool Close(float a, float b){
+	return fabsf(a - b) <= 1e-6f * (1.0f + fabsf(b));
+}
+
+//Every particle gets different values, z numbers them so they can be followed through compaction
+static ReferenceParticle MakeParticle(unsigned int i, float lifetime){
+	ReferenceParticle p;
+	p.x = i * 0.5f - 3.0f;
+	p.y = 2.0f - i * 0.25f;
+	p.z = (float)i;
+	p.vx = sinf(i * 1.3f);
+	p.vy = cosf(i * 0.7f);
+	p.ax = (i % 5) * 0.1f - 0.2f;
+	p.ay = -1.0f + (i % 3) * 0.05f;
+	p.age = 0.0f;
+	p.lifetime = lifetime;
+	return p;
+}
+
+static void Emit(ParticleSoA& soa, const ReferenceParticle& p){
+	soa.emit(XMFLOAT4(p.x, p.y, p.z, 1.0f), XMFLOAT2(p.vx, p.vy), XMFLOAT2(p.ax, p.ay), p.lifetime);
+}
+
+/**
+*Counts that aren't a multiple of 8 leave part of the last block padding, which the SSE and AVX
+*loops run over anyway. Builds with /arch:AVX2 (-mavx2) take the 8 wide path, the others 4 wide.
+**/
+TEST(ParticleSoAIntegrateMatchesScalar){
+	const unsigned int counts[] = { 1, 3, 4, 7, 8, 13, 64, 101 };
+	const float dt = 1.0f / 60.0f;
+	for (unsigned int c = 0; c < sizeof(counts) / sizeof(counts[0]); c++){
+		//the pool is sized to the count so the padding is all the slack there is
+		ParticleSoA soa(counts[c]);
+		std::vector<ReferenceParticle> reference;
+		for (unsigned int i = 0; i < counts[c]; i++){
+			reference.push_back(MakeParticle(i, 100.0f));
+			Emit(soa, reference.back());
+		}
+		CHECK(!soa.emit(XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f), XMFLOAT2(0.0f, 0.0f), XMFLOAT2(0.0f, 0.0f), 1.0f));
+
+		bool matches = true;
+		for (int frame = 0; frame < 30; frame++){
+			soa.integrate(dt);
+			IntegrateReference(reference, dt);
+			for (unsigned int i = 0; i < counts[c]; i++){
+				matches = matches && Close(soa.positionX()[i], reference[i].x) && Close(soa.positionY()[i], reference[i].y) &&
+					Close(soa.age()[i], reference[i].age);
+			}
+		}
+		CHECK(matches);
+		CHECK(soa.getCount() == counts[c]);
+	}
+}
+
+/**
+*Blocks of 4 that are all alive, all dead, mixed, and a partial block at the end, so compact takes
+*the skip, the copy and the tail paths. Survivors keep their order and every array moves with them.
+**/
+TEST(ParticleSoACompactKeepsOrder){
+	//1 lives, 0 dies this frame
+	const char* pattern = "1111" "0000" "1010" "0111" "1111" "0001" "101";
+	unsigned int total = 0;
+	while (pattern[total]){
+		total++;
+	}
+	ParticleSoA soa(64);
+	std::vector<ReferenceParticle> reference;
+	for (unsigned int i = 0; i < total; i++){
+		reference.push_back(MakeParticle(i, pattern[i] == '1' ? 10.0f : 0.5f));
+		Emit(soa, reference.back());
+	}
+
+	soa.integrate(1.0f);
+	IntegrateReference(reference, 1.0f);
+	std::vector<ReferenceParticle> survivors;
+	for (unsigned int i = 0; i < total; i++){
+		if (pattern[i] == '1'){
+			survivors.push_back(reference[i]);
+		}
+	}
+	CHECK(soa.compact() == total - survivors.size());
+	CHECK(soa.getCount() == survivors.size());
+
+	std::vector<Particle> vertices(64);
+	CHECK(soa.writeVertices(&vertices[0], 64) == survivors.size());
+	bool ordered = true;
+	for (size_t i = 0; i < survivors.size(); i++){
+		ordered = ordered && vertices[i].Position.z == survivors[i].z && soa.positionX()[i] == survivors[i].x &&
+			soa.positionY()[i] == survivors[i].y && soa.age()[i] == survivors[i].age;
+	}
+	CHECK(ordered);
+
+	//velocity and acceleration came along too: the next step still matches
+	soa.integrate(0.25f);
+	IntegrateReference(survivors, 0.25f);
+	bool moved = true;
+	for (size_t i = 0; i < survivors.size(); i++){
+		moved = moved && Close(soa.positionX()[i], survivors[i].x) && Close(soa.positionY()[i], survivors[i].y);
+	}
+	CHECK(moved);
+
+	//nothing dies, nothing changes
+	CHECK(soa.compact() == 0);
+	CHECK(soa.getCount() == survivors.size());
+	//everything dies
+	soa.integrate(20.0f);
+	CHECK(soa.compact() == survivors.size());
+	CHECK(soa.getCount() == 0);
+}
+
+TEST(ParticleSoAWriteVertices){
+	ParticleSoA soa(16);
+	for (unsigned int i = 0; i < 10; i++){
+		Emit(soa, MakeParticle(i, 5.0f));
+	}
+	soa.integrate(0.5f);
+
+	Particle vertices[16];
+	CHECK(soa.writeVertices(vertices, 16) == 10);
+	bool written = true;
+	for (unsigned int i = 0; i < 10; i++){
+		written = written && vertices[i].Position.x == soa.positionX()[i] && vertices[i].Position.y == soa.positionY()[i] &&
+			vertices[i].Position.z == (float)i && vertices[i].Position.w == 1.0f &&
+			vertices[i].velocity.x == 0.0f && vertices[i].velocity.y == 0.0f &&
+			vertices[i].acceleration.x == 0.0f && vertices[i].acceleration.y == 0.0f;
+	}
+	CHECK(written);
+
+	//a short buffer takes the first particles and no more
+	vertices[4].Position.z = -1.0f;
+	CHECK(soa.writeVertices(vertices, 4) == 4);
+	CHECK(vertices[3].Position.z == 3.0f && vertices[4].Position.z == -1.0f);
+
+	soa.clear();
+	CHECK(soa.getCount() == 0);
+	CHECK(soa.writeVertices(vertices, 16) == 0);
+}
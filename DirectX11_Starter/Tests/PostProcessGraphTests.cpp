@@ -0,0 +1,129 @@
+#include "Test.h"
+#include "PostProcessGraph.h"
+
+//Blur at reduced size: scene -> half -> quarter -> half -> back buffer
+TEST(PostProcessGraphAliasesDisjointTargets){
+	PostProcessGraph graph;
+	uint32_t scene = graph.addTarget(POST_PROCESS_FORMAT_R11G11B10, 1);
+	uint32_t half = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 2);
+	uint32_t quarter = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 4);
+	uint32_t blurred = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 2);
+	graph.addPass(POST_PROCESS_PASS_EXTERNAL, 0, scene, nullptr, 0);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, half, &scene, 1);
+	graph.addPass(POST_PROCESS_PASS_COMPUTE, 1, quarter, &half, 1);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, blurred, &quarter, 1);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 2, POST_PROCESS_BACK_BUFFER, &blurred, 1);
+	CHECK(graph.compile(1279, 719));
+
+	//odd sizes round up so the smaller targets still cover the screen
+	CHECK(graph.getTarget(scene).width == 1279 && graph.getTarget(scene).height == 719);
+	CHECK(graph.getTarget(half).width == 640 && graph.getTarget(half).height == 360);
+	CHECK(graph.getTarget(quarter).width == 320 && graph.getTarget(quarter).height == 180);
+	CHECK(graph.getTarget(half).firstPass == 1 && graph.getTarget(half).lastPass == 2);
+
+	//half is done with once quarter is written, so blurred takes its texture
+	CHECK(graph.getSlotCount() == 3);
+	CHECK(graph.getTarget(half).slot == graph.getTarget(blurred).slot);
+	CHECK(graph.getTarget(scene).slot != graph.getTarget(half).slot);
+	CHECK(graph.getSlot(graph.getTarget(half).slot).bindFlags == POST_PROCESS_BIND_RENDER_TARGET);
+	CHECK(graph.getSlot(graph.getTarget(quarter).slot).bindFlags == POST_PROCESS_BIND_UNORDERED_ACCESS);
+	CHECK(graph.getTargetBytes() - graph.getSlotBytes() == 640ULL * 360 * 4);
+}
+
+//Same size targets bouncing between passes share two textures, and a pass never writes the
+//texture it reads from
+TEST(PostProcessGraphPingPong){
+	PostProcessGraph graph;
+	uint32_t a = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	uint32_t b = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	uint32_t c = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	uint32_t d = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	graph.addPass(POST_PROCESS_PASS_EXTERNAL, 0, a, nullptr, 0);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, b, &a, 1);
+	graph.addPass(POST_PROCESS_PASS_COMPUTE, 0, c, &b, 1);
+	uint32_t twice[] = { c, c };
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, d, twice, 2);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, POST_PROCESS_BACK_BUFFER, &d, 1);
+	CHECK(graph.compile(64, 64));
+
+	CHECK(graph.getSlotCount() == 2);
+	CHECK(graph.getTarget(a).slot == graph.getTarget(c).slot);
+	CHECK(graph.getTarget(b).slot == graph.getTarget(d).slot);
+	CHECK(graph.getTarget(a).slot != graph.getTarget(b).slot);
+	//written by a pixel pass and a compute pass
+	CHECK(graph.getSlot(graph.getTarget(a).slot).bindFlags == (POST_PROCESS_BIND_RENDER_TARGET | POST_PROCESS_BIND_UNORDERED_ACCESS));
+	for (uint32_t p = 0; p < graph.getPassCount(); p++){
+		const PostProcessPass& pass = graph.getPass(p);
+		for (uint32_t i = 0; i < pass.inputCount && pass.output != POST_PROCESS_BACK_BUFFER; i++){
+			CHECK(graph.getTarget(pass.inputs[i]).slot != graph.getTarget(pass.output).slot);
+		}
+	}
+}
+
+//Textures are only shared between targets of one format and size
+TEST(PostProcessGraphKeepsFormatsApart){
+	PostProcessGraph graph;
+	uint32_t scene = graph.addTarget(POST_PROCESS_FORMAT_R11G11B10, 1);
+	uint32_t first = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	uint32_t second = graph.addTarget(POST_PROCESS_FORMAT_R11G11B10, 2);
+	uint32_t third = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	graph.addPass(POST_PROCESS_PASS_EXTERNAL, 0, scene, nullptr, 0);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, first, &scene, 1);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, second, &first, 1);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, third, &second, 1);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, POST_PROCESS_BACK_BUFFER, &third, 1);
+	CHECK(graph.compile(100, 100));
+	//second can't take scene's texture, it is half the size; third takes first's
+	CHECK(graph.getSlotCount() == 3);
+	CHECK(graph.getTarget(third).slot == graph.getTarget(first).slot);
+	CHECK(graph.getTarget(second).slot != graph.getTarget(scene).slot);
+
+	//compiling again for a new size keeps the plan and resizes every slot
+	CHECK(graph.compile(50, 30));
+	CHECK(graph.getSlotCount() == 3);
+	CHECK(graph.getTarget(third).slot == graph.getTarget(first).slot);
+	CHECK(graph.getSlot(graph.getTarget(second).slot).width == 25 && graph.getSlot(graph.getTarget(second).slot).height == 15);
+}
+
+//scene -> target -> back buffer, with the target's divisor and the last pass's kind and output
+//given, and optionally a second write of the target
+static bool CompilesSimpleChain(uint32_t divisor, PostProcessPassKind kind, bool toBackBuffer, bool writeTwice){
+	PostProcessGraph graph;
+	uint32_t scene = graph.addTarget(POST_PROCESS_FORMAT_R11G11B10, 1);
+	uint32_t target = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, divisor);
+	graph.addPass(POST_PROCESS_PASS_EXTERNAL, 0, scene, nullptr, 0);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, target, &scene, 1);
+	if (writeTwice){
+		graph.addPass(POST_PROCESS_PASS_PIXEL, 0, target, &scene, 1);
+	}
+	graph.addPass(kind, 0, toBackBuffer ? POST_PROCESS_BACK_BUFFER : target, &target, 1);
+	return graph.compile(8, 8);
+}
+
+TEST(PostProcessGraphRejectsInvalidGraphs){
+	//the well formed chain each case breaks
+	CHECK(CompilesSimpleChain(4, POST_PROCESS_PASS_PIXEL, true, false));
+	//a quarter is as small as targets go, and sizes are powers of two
+	CHECK(!CompilesSimpleChain(3, POST_PROCESS_PASS_PIXEL, true, false));
+	CHECK(!CompilesSimpleChain(8, POST_PROCESS_PASS_PIXEL, true, false));
+	//compute passes can't write the back buffer
+	CHECK(!CompilesSimpleChain(1, POST_PROCESS_PASS_COMPUTE, true, false));
+	//a target written twice
+	CHECK(!CompilesSimpleChain(1, POST_PROCESS_PASS_PIXEL, true, true));
+	//a pass reading its own output
+	CHECK(!CompilesSimpleChain(1, POST_PROCESS_PASS_PIXEL, false, false));
+
+	PostProcessGraph graph;
+	uint32_t unwritten = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	uint32_t written = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	//read before anything wrote it
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, written, &unwritten, 1);
+	graph.addPass(POST_PROCESS_PASS_PIXEL, 0, POST_PROCESS_BACK_BUFFER, &written, 1);
+	CHECK(!graph.compile(8, 8));
+
+	//written and never read
+	graph.clear();
+	uint32_t unread = graph.addTarget(POST_PROCESS_FORMAT_RGBA8, 1);
+	graph.addPass(POST_PROCESS_PASS_EXTERNAL, 0, unread, nullptr, 0);
+	CHECK(!graph.compile(8, 8));
+}
@@ -0,0 +1,117 @@
+#include "Test.h"
+#include "ShaderPackFile.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+*fxc output checked in under Debug, read from the Tests directory the way the cooker reads the
+*shaders.pipeline ones. They are older builds than the HLSL next to the sources, so what is
+*expected here is what these binaries declare: perModel before uvTransform was added, and the
+*post-process vertex shader from when it still took a vertex buffer.
+**/
+#define GEOMETRY_SHADER_PATH "../Debug/GeometryShader.cso"
+#define POST_PROCESS_VERTEX_SHADER_PATH "../Debug/PostProcessVertexShader.cso"
+
+#define FORMAT_R32G32B32_FLOAT 6 // DXGI_FORMAT
+#define FORMAT_R32G32_FLOAT 16
+
+static bool ReadBytecode(const char* path, std::vector<char>& bytecode){
+	FILE* file = fopen(path, "rb");
+	if (!file){
+		return false;
+	}
+	bytecode.clear();
+	char buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0){
+		bytecode.insert(bytecode.end(), buffer, buffer + read);
+	}
+	fclose(file);
+	return !bytecode.empty();
+}
+
+static bool IsMatrix(const ShaderVariable& variable, const char* name, uint32_t offset){
+	return variable.name == name && variable.offset == offset && variable.size == 64 && variable.typeClass == SHADER_VARIABLE_MATRIX_COLUMNS &&
+		variable.type == SHADER_VARIABLE_FLOAT && variable.rows == 4 && variable.columns == 4 && variable.elements == 0;
+}
+
+static bool IsElement(const MeshFileElement& element, const char* semantic, uint32_t index, uint32_t format){
+	return strcmp(element.semantic, semantic) == 0 && element.semanticIndex == index && element.format == format && element.offset == SHADER_APPEND_ALIGNED;
+}
+
+//A geometry shader: no input layout, one constant buffer of three column major matrices
+TEST(ShaderReflectGeometryShader){
+	std::vector<char> bytecode;
+	CHECK(ReadBytecode(GEOMETRY_SHADER_PATH, bytecode));
+	if (bytecode.empty()){
+		return;
+	}
+	uint32_t stage = SHADER_STAGE_PIXEL;
+	std::vector<MeshFileElement> inputs;
+	CHECK(ReadShaderBytecode(&bytecode[0], bytecode.size(), stage, inputs));
+	CHECK(stage == SHADER_STAGE_GEOMETRY && inputs.empty());
+
+	std::vector<ShaderConstantBuffer> buffers;
+	CHECK(ReadShaderConstantBuffers(&bytecode[0], bytecode.size(), buffers));
+	CHECK(buffers.size() == 1);
+	if (buffers.size() == 1){
+		const ShaderConstantBuffer& perModel = buffers[0];
+		CHECK(perModel.name == "perModel" && perModel.slot == 0 && perModel.size == 192);
+		CHECK(perModel.variables.size() == 3);
+		if (perModel.variables.size() == 3){
+			CHECK(IsMatrix(perModel.variables[0], "world", 0));
+			CHECK(IsMatrix(perModel.variables[1], "view", 64));
+			CHECK(IsMatrix(perModel.variables[2], "projection", 128));
+		}
+	}
+}
+
+//A vertex shader: its input signature as a layout, system values left out, and no constant buffers
+TEST(ShaderReflectVertexShader){
+	std::vector<char> bytecode;
+	CHECK(ReadBytecode(POST_PROCESS_VERTEX_SHADER_PATH, bytecode));
+	if (bytecode.empty()){
+		return;
+	}
+	uint32_t stage = SHADER_STAGE_PIXEL;
+	std::vector<MeshFileElement> inputs;
+	CHECK(ReadShaderBytecode(&bytecode[0], bytecode.size(), stage, inputs));
+	CHECK(stage == SHADER_STAGE_VERTEX);
+	CHECK(inputs.size() == 3);
+	if (inputs.size() == 3){
+		CHECK(IsElement(inputs[0], "POSITION", 0, FORMAT_R32G32B32_FLOAT));
+		CHECK(IsElement(inputs[1], "NORMAL", 0, FORMAT_R32G32B32_FLOAT));
+		CHECK(IsElement(inputs[2], "TEXCOORD", 0, FORMAT_R32G32_FLOAT));
+	}
+
+	std::vector<ShaderConstantBuffer> buffers(1);
+	CHECK(ReadShaderConstantBuffers(&bytecode[0], bytecode.size(), buffers));
+	CHECK(buffers.empty());
+}
+
+//Cut short or with its magic broken the container is refused, not read past its end
+TEST(ShaderReflectRefusesDamagedBytecode){
+	std::vector<char> bytecode;
+	CHECK(ReadBytecode(GEOMETRY_SHADER_PATH, bytecode));
+	if (bytecode.empty()){
+		return;
+	}
+	uint32_t stage;
+	std::vector<MeshFileElement> inputs;
+	std::vector<ShaderConstantBuffer> buffers;
+	bool refused = true;
+	const size_t lengths[] = { 0, 4, 31, 32, 100, bytecode.size() / 2, bytecode.size() - 1 };
+	for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++){
+		//copied so a read past the shorter length lands outside the allocation
+		std::vector<char> truncated(bytecode.begin(), bytecode.begin() + lengths[i]);
+		const char* data = truncated.empty() ? nullptr : &truncated[0];
+		refused = refused && !ReadShaderBytecode(data, truncated.size(), stage, inputs) && !ReadShaderConstantBuffers(data, truncated.size(), buffers);
+	}
+	CHECK(refused);
+
+	bytecode[0] = 'X';
+	CHECK(!ReadShaderBytecode(&bytecode[0], bytecode.size(), stage, inputs));
+	CHECK(!ReadShaderConstantBuffers(&bytecode[0], bytecode.size(), buffers));
+}
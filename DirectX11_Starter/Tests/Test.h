@@ -0,0 +1,30 @@
+#ifndef _TEST_H
+#define _TEST_H
+
+/**
+*Just enough of a test framework for the engine's D3D-free modules.
+*TEST(name) defines a test and registers it with the runner in TestMain.cpp, CHECK records a
+*failure with its file and line and carries on, so one run reports every broken expectation.
+**/
+
+typedef void(*TestFunction)();
+
+struct TestRegistration{
+	TestRegistration(const char* name, TestFunction function);
+};
+
+void TestFailed(const char* file, int line, const char* expression);
+
+#define TEST(name) \
+	static void name(); \
+	static TestRegistration name##Registration(#name, name); \
+	static void name()
+
+#define CHECK(expression) \
+	do{ \
+		if (!(expression)){ \
+			TestFailed(__FILE__, __LINE__, #expression); \
+		} \
+	} while (0)
+
+#endif
@@ -0,0 +1,72 @@
+/**
+*Runs every registered test, or only those whose names contain one of the arguments.
+*Returns the number of failed tests, so 0 when everything passes.
+*Tests.vcxproj builds it on Windows. Elsewhere compile the .cpp files here with the engine sources
+*the project lists, e.g. from this directory with DirectXMath on the include path:
+*	g++ -std=c++11 -O2 -pthread -I../DirectX11_Starter *.cpp ../DirectX11_Starter/ParticleSimulation.cpp ... -lpng -ljpeg -o tests
+*TextureImage.cpp decodes with libpng and libjpeg there, WIC on Windows.
+**/
+#include "Test.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct RegisteredTest{
+	const char* name;
+	TestFunction function;
+};
+
+//function local so registrations from other files' static initializers find it constructed
+static std::vector<RegisteredTest>& GetTests(){
+	static std::vector<RegisteredTest> tests;
+	return tests;
+}
+
+static int failures = 0;
+
+TestRegistration::TestRegistration(const char* name, TestFunction function){
+	RegisteredTest test;
+	test.name = name;
+	test.function = function;
+	GetTests().push_back(test);
+}
+
+void TestFailed(const char* file, int line, const char* expression){
+	printf("  %s(%d): CHECK(%s) failed\n", file, line, expression);
+	failures++;
+}
+
+static bool Selected(const char* name, int argc, char** argv){
+	if (argc < 2){
+		return true;
+	}
+	for (int i = 1; i < argc; i++){
+		if (strstr(name, argv[i])){
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char** argv){
+	std::vector<RegisteredTest>& tests = GetTests();
+	int run = 0;
+	int failed = 0;
+	for (size_t i = 0; i < tests.size(); i++){
+		if (!Selected(tests[i].name, argc, argv)){
+			continue;
+		}
+		int before = failures;
+		tests[i].function();
+		run++;
+		if (failures != before){
+			failed++;
+			printf("FAILED %s\n", tests[i].name);
+		}
+		else{
+			printf("ok     %s\n", tests[i].name);
+		}
+	}
+	printf("%d of %d tests passed\n", run - failed, run);
+	return failed;
+}
@@ -0,0 +1,212 @@
+#include "Test.h"
+#include "TextureFile.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define DDS_TEST_PATH "TextureFileTest.dds"
+
+//DDS_HEADER bits, as TextureFile.cpp and DDS.h spell them
+#define DDS_TEST_FLAGS 0x00021007 // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT
+#define DDS_TEST_DEPTH 0x00800000 // DDSD_DEPTH
+#define DDS_TEST_FOURCC 0x00000004 // DDPF_FOURCC
+#define DDS_TEST_CUBEMAP 0x0000FE00 // DDSCAPS2_CUBEMAP and all six faces
+#define DDS_TEST_VOLUME 0x00200000 // DDSCAPS2_VOLUME
+#define DDS_TEST_TEXTURE2D 3 // D3D11_RESOURCE_DIMENSION_TEXTURE2D
+#define DDS_TEST_TEXTURE3D 4 // D3D11_RESOURCE_DIMENSION_TEXTURE3D
+#define DDS_TEST_MISC_CUBE 0x4 // D3D11_RESOURCE_MISC_TEXTURECUBE
+
+static uint32_t FourCC(const char* code){
+	return (uint32_t)code[0] | ((uint32_t)code[1] << 8) | ((uint32_t)code[2] << 16) | ((uint32_t)code[3] << 24);
+}
+
+//What goes into one generated file; everything not set here is what a plain 2D texture has
+struct DdsDescription{
+	const char* name;
+	uint32_t fourCC; // "DX10" for a DXGI format header
+	uint32_t dxgiFormat;
+	uint32_t blockBytes; // of the data generated after the headers
+	uint32_t width;
+	uint32_t height;
+	uint32_t mipCount; // as stored, 0 means one level
+	uint32_t dataMipCount; // levels of data actually written
+	uint32_t flags; // added to DDS_TEST_FLAGS
+	uint32_t caps2;
+	uint32_t dimension;
+	uint32_t miscFlag;
+	uint32_t arraySize;
+	int truncate; // bytes cut off the end
+	uint32_t expectedFormat; // 0 if ReadTextureFile has to refuse it
+};
+
+static std::vector<char> GenerateDds(const DdsDescription& dds){
+	TextureFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.size = sizeof(TextureFileHeader);
+	header.flags = DDS_TEST_FLAGS | dds.flags;
+	header.height = dds.height;
+	header.width = dds.width;
+	header.depth = 1;
+	header.mipCount = dds.mipCount;
+	header.format.size = sizeof(TextureFilePixelFormat);
+	header.format.flags = DDS_TEST_FOURCC;
+	header.format.fourCC = dds.fourCC;
+	header.caps2 = dds.caps2;
+
+	TextureFileHeaderDX10 header10;
+	memset(&header10, 0, sizeof(header10));
+	header10.format = dds.dxgiFormat;
+	header10.dimension = dds.dimension;
+	header10.miscFlag = dds.miscFlag;
+	header10.arraySize = dds.arraySize;
+
+	uint32_t magic = TEXTURE_FILE_MAGIC;
+	std::vector<char> file((char*)&magic, (char*)&magic + sizeof(magic));
+	file.insert(file.end(), (char*)&header, (char*)&header + sizeof(header));
+	if (dds.fourCC == FourCC("DX10")){
+		file.insert(file.end(), (char*)&header10, (char*)&header10 + sizeof(header10));
+	}
+	uint32_t width = dds.width;
+	uint32_t height = dds.height;
+	for (uint32_t mip = 0; mip < dds.dataMipCount; mip++){
+		file.resize(file.size() + ((width + 3) / 4) * ((height + 3) / 4) * dds.blockBytes, (char)(0x40 + mip));
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	file.resize(file.size() - dds.truncate);
+	return file;
+}
+
+//One generated file per case, each a single difference away from one ReadTextureFile takes
+TEST(TextureFileGeneratedHeaders){
+	const uint32_t dx10 = FourCC("DX10");
+	const DdsDescription cases[] = {
+		//name, fourCC, dxgi, block bytes, width, height, mips, data mips, flags, caps2, dimension, misc, array, truncate, expected
+		{ "BC1 full chain", dx10, 71, 8, 256, 128, 9, 9, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 71 },
+		{ "BC7 sRGB", dx10, 99, 16, 64, 64, 7, 7, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 99 },
+		{ "BC3 odd size", dx10, 77, 16, 5, 3, 3, 3, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 77 },
+		{ "BC2 DXGI", dx10, 74, 16, 16, 16, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 74 },
+		{ "no mip count", dx10, 71, 8, 32, 32, 0, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 71 },
+		//typeless reads as the UNORM format after it
+		{ "BC1 typeless", dx10, 70, 8, 32, 32, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 71 },
+		{ "BC2 typeless", dx10, 73, 16, 32, 32, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 74 },
+		{ "BC3 typeless", dx10, 76, 16, 32, 32, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 77 },
+		{ "BC4 typeless", dx10, 79, 8, 32, 32, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 80 },
+		{ "BC5 typeless", dx10, 82, 16, 32, 32, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 83 },
+		{ "BC7 typeless", dx10, 97, 16, 32, 32, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 98 },
+		//legacy four character codes
+		{ "DXT1", FourCC("DXT1"), 0, 8, 64, 32, 7, 7, 0, 0, 0, 0, 0, 0, 71 },
+		{ "DXT3", FourCC("DXT3"), 0, 16, 64, 32, 7, 7, 0, 0, 0, 0, 0, 0, 74 },
+		{ "DXT5", FourCC("DXT5"), 0, 16, 64, 32, 7, 7, 0, 0, 0, 0, 0, 0, 77 },
+		{ "ATI1", FourCC("ATI1"), 0, 8, 64, 32, 1, 1, 0, 0, 0, 0, 0, 0, 80 },
+		{ "BC4U", FourCC("BC4U"), 0, 8, 64, 32, 1, 1, 0, 0, 0, 0, 0, 0, 80 },
+		{ "ATI2", FourCC("ATI2"), 0, 16, 64, 32, 1, 1, 0, 0, 0, 0, 0, 0, 83 },
+		{ "BC5U", FourCC("BC5U"), 0, 16, 64, 32, 1, 1, 0, 0, 0, 0, 0, 0, 83 },
+		{ "DXT2 premultiplied", FourCC("DXT2"), 0, 16, 64, 32, 1, 1, 0, 0, 0, 0, 0, 0, 0 },
+		{ "BC4S signed", FourCC("BC4S"), 0, 8, 64, 32, 1, 1, 0, 0, 0, 0, 0, 0, 0 },
+		//truncated: a byte short of the last mip, in the DX10 header, in the DDS header
+		{ "data one byte short", dx10, 71, 8, 256, 128, 9, 9, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 1, 0 },
+		{ "legacy data short", FourCC("DXT5"), 0, 16, 64, 32, 7, 7, 0, 0, 0, 0, 0, 1, 0 },
+		{ "DX10 header cut", dx10, 71, 8, 4, 4, 1, 0, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 4, 0 },
+		{ "DDS header cut", FourCC("DXT1"), 0, 8, 4, 4, 1, 0, 0, 0, 0, 0, 0, 40, 0 },
+		{ "mip count past 1x1", dx10, 71, 8, 16, 16, 6, 6, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 0 },
+		//cube maps, volumes and arrays aren't 2D textures
+		{ "cube caps2", FourCC("DXT1"), 0, 8, 32, 32, 1, 6, 0, DDS_TEST_CUBEMAP, 0, 0, 0, 0, 0 },
+		{ "cube DX10", dx10, 71, 8, 32, 32, 1, 6, 0, 0, DDS_TEST_TEXTURE2D, DDS_TEST_MISC_CUBE, 1, 0, 0 },
+		{ "volume depth flag", FourCC("DXT1"), 0, 8, 32, 32, 1, 4, DDS_TEST_DEPTH, DDS_TEST_VOLUME, 0, 0, 0, 0, 0 },
+		{ "volume DX10", dx10, 71, 8, 32, 32, 1, 4, 0, 0, DDS_TEST_TEXTURE3D, 0, 1, 0, 0 },
+		{ "array of two", dx10, 71, 8, 32, 32, 1, 2, 0, 0, DDS_TEST_TEXTURE2D, 0, 2, 0, 0 },
+		{ "uncompressed DXGI", dx10, 28, 4, 32, 32, 1, 1, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 0 },
+		{ "zero width", dx10, 71, 8, 0, 32, 1, 0, 0, 0, DDS_TEST_TEXTURE2D, 0, 1, 0, 0 }
+	};
+
+	for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+		const DdsDescription& dds = cases[i];
+		std::vector<char> file = GenerateDds(dds);
+		TextureFileView view;
+		bool read = ReadTextureFile(&file[0], file.size(), view);
+		bool expected = dds.expectedFormat != 0;
+		if (read != expected){
+			printf("       %s: %s\n", dds.name, read ? "read" : "refused");
+		}
+		CHECK(read == expected);
+		if (!read || !expected){
+			continue;
+		}
+		uint32_t mipCount = dds.mipCount ? dds.mipCount : 1;
+		size_t headers = sizeof(uint32_t) + sizeof(TextureFileHeader) + (dds.fourCC == dx10 ? sizeof(TextureFileHeaderDX10) : 0);
+		CHECK(view.format == dds.expectedFormat);
+		CHECK(view.mipCount == mipCount);
+		CHECK((view.header10 != nullptr) == (dds.fourCC == dx10));
+		CHECK((const char*)view.data == &file[0] + headers);
+		CHECK(view.dataSize == file.size() - headers);
+
+		//each level starts where the bytes generated for it do
+		std::vector<TextureFileLevel> levels;
+		GetTextureFileLevels(view, levels);
+		CHECK(levels.size() == mipCount);
+		bool laidOut = levels.size() == mipCount && levels[0].data == view.data;
+		for (uint32_t mip = 0; laidOut && mip < mipCount; mip++){
+			laidOut = levels[mip].data[0] == 0x40 + mip && levels[mip].data[levels[mip].slicePitch - 1] == 0x40 + mip &&
+				levels[mip].rowPitch == ((levels[mip].width + 3) / 4) * dds.blockBytes;
+		}
+		CHECK(laidOut);
+	}
+}
+
+//Headers alone, shorter than a DDS_HEADER, and an empty view
+TEST(TextureFileShortInputs){
+	TextureFileView view;
+	uint32_t magic = TEXTURE_FILE_MAGIC;
+	CHECK(!ReadTextureFile(nullptr, 0, view));
+	CHECK(!ReadTextureFile((const char*)&magic, sizeof(magic), view));
+	std::vector<char> headerOnly(sizeof(uint32_t) + sizeof(TextureFileHeader) - 1, 0);
+	memcpy(&headerOnly[0], &magic, sizeof(magic));
+	CHECK(!ReadTextureFile(&headerOnly[0], headerOnly.size(), view));
+}
+
+//A capture is a DDS, but not one the block compressed loader takes
+TEST(TextureFileRefusesImageCapture){
+	std::vector<uint8_t> pixels(8 * 8 * 4, 0x80);
+	CHECK(WriteImageTextureFile(DDS_TEST_PATH, 8, 8, &pixels[0]));
+	MappedFile mapped;
+	TextureFileView view;
+	CHECK(!OpenTextureFile(DDS_TEST_PATH, mapped, view));
+	remove(DDS_TEST_PATH);
+}
+
+//What the cooker writes reads back with its stamp and every level in place
+TEST(TextureFileCookedRoundTrip){
+	const uint32_t width = 40;
+	const uint32_t height = 24;
+	const uint32_t mipCount = 6;
+	size_t dataSize = GetTextureDataSize(TEXTURE_FORMAT_BC3, width, height, mipCount);
+	std::vector<uint8_t> data(dataSize);
+	for (size_t i = 0; i < dataSize; i++){
+		data[i] = (uint8_t)(i * 7);
+	}
+	AssetStamp source;
+	source.size = 1234;
+	source.time = 5678;
+	source.hash = 0x0123456789ABCDEFULL;
+	CHECK(WriteTextureFile(DDS_TEST_PATH, TEXTURE_FORMAT_BC3, width, height, mipCount, &data[0], source));
+
+	MappedFile mapped;
+	TextureFileView view;
+	CHECK(OpenTextureFile(DDS_TEST_PATH, mapped, view));
+	if (mapped.isOpen()){
+		AssetStamp stamp;
+		CHECK(GetTextureFileStamp(view, stamp));
+		CHECK(stamp.size == source.size && stamp.time == source.time && stamp.hash == source.hash);
+		CHECK(view.format == TEXTURE_FORMAT_BC3 && view.mipCount == mipCount && view.header10 != nullptr);
+		CHECK(view.dataSize == dataSize && memcmp(view.data, &data[0], dataSize) == 0);
+		std::vector<TextureFileLevel> levels;
+		GetTextureFileLevels(view, levels);
+		CHECK(levels.size() == mipCount);
+		CHECK(levels[mipCount - 1].width == 1 && levels[mipCount - 1].height == 1);
+		CHECK(levels[mipCount - 1].data + levels[mipCount - 1].slicePitch == view.data + dataSize);
+	}
+	mapped.close();
+	remove(DDS_TEST_PATH);
+}
@@ -0,0 +1,232 @@
+#include "Test.h"
+#include "TextureResidency.h"
+#include <cstdlib>
+#include <vector>
+
+//BC3 bytes of every level of a square size x size chain, finest first
+static unsigned int AddSquare(TextureResidency& residency, uint32_t size){
+	size_t levelBytes[16];
+	unsigned int count = 0;
+	for (uint32_t side = size; ; side /= 2){
+		size_t blocks = (side + 3) / 4;
+		levelBytes[count++] = blocks * blocks * 16;
+		if (side == 1){
+			break;
+		}
+	}
+	return residency.add(size, size, count, levelBytes);
+}
+
+//Bytes of the chain from level first down to 1x1
+static size_t ChainBytes(uint32_t size, unsigned int first){
+	size_t total = 0;
+	unsigned int mip = 0;
+	for (uint32_t side = size; ; side /= 2, mip++){
+		size_t blocks = (side + 3) / 4;
+		total += mip >= first ? blocks * blocks * 16 : 0;
+		if (side == 1){
+			break;
+		}
+	}
+	return total;
+}
+
+static const TextureResidencyChange* FindChange(const std::vector<TextureResidencyChange>& changes, unsigned int texture){
+	for (size_t i = 0; i < changes.size(); i++){
+		if (changes[i].texture == texture){
+			return &changes[i];
+		}
+	}
+	return nullptr;
+}
+
+//Only levels of TEXTURE_TAIL_SIZE and below are resident to begin with
+TEST(ResidencyStartsWithTails){
+	TextureResidency residency(4 << 20, 64 << 20);
+	unsigned int large = AddSquare(residency, 1024);
+	unsigned int medium = AddSquare(residency, 512);
+	unsigned int small = AddSquare(residency, 32);
+	CHECK(residency.getTailMip(large) == 4);
+	CHECK(residency.getTailMip(medium) == 3);
+	CHECK(residency.getTailMip(small) == 0);
+	CHECK(residency.getResidentMip(large) == 4 && residency.getWantedMip(large) == 4);
+	CHECK(residency.getResidentBytes() == ChainBytes(1024, 4) + ChainBytes(512, 3) + ChainBytes(32, 0));
+}
+
+//The largest request of the frame wins, and the move is one change from tail to that level
+TEST(ResidencyPromotesToFinestRequest){
+	TextureResidency residency(4 << 20, 64 << 20);
+	unsigned int texture = AddSquare(residency, 1024);
+	std::vector<TextureResidencyChange> changes;
+	residency.request(texture, 2048.0f);
+	residency.request(texture, 10.0f);
+	residency.update(changes);
+	CHECK(residency.getResidentMip(texture) == 0);
+	CHECK(changes.size() == 1 && changes[0].texture == texture && changes[0].fromMip == 4 && changes[0].toMip == 0);
+	CHECK(residency.getResidentBytes() == ChainBytes(1024, 0));
+
+	//about 300 pixels across needs the 512 level, not the 256 one
+	unsigned int other = AddSquare(residency, 1024);
+	residency.request(other, 300.0f);
+	residency.update(changes);
+	CHECK(residency.getWantedMip(other) == 1 && residency.getResidentMip(other) == 1);
+}
+
+//Room for a texture in use comes out of the one used longest ago
+TEST(ResidencyEvictsLeastRecentlyUsed){
+	TextureResidency residency(64 << 20, 64 << 20);
+	unsigned int old = AddSquare(residency, 1024);
+	unsigned int recent = AddSquare(residency, 1024);
+	unsigned int incoming = AddSquare(residency, 512);
+	std::vector<TextureResidencyChange> changes;
+	residency.request(old, 2048.0f);
+	residency.update(changes);
+	residency.request(recent, 2048.0f);
+	residency.update(changes);
+	CHECK(residency.getResidentMip(old) == 0 && residency.getResidentMip(recent) == 0);
+
+	residency.setBudget(3000000);
+	for (int frame = 0; frame < 3; frame++){
+		residency.request(recent, 2048.0f);
+		residency.request(incoming, 1024.0f);
+		residency.update(changes);
+		CHECK(residency.getResidentBytes() <= residency.getBudget());
+	}
+	CHECK(residency.getResidentMip(incoming) == 0);
+	CHECK(residency.getResidentMip(recent) == 0);
+	CHECK(residency.getResidentMip(old) > 0);
+}
+
+//Finer levels than a texture now asks for stay until the budget needs them
+TEST(ResidencyKeepsLevelsUntilPressure){
+	TextureResidency residency(64 << 20, 64 << 20);
+	unsigned int texture = AddSquare(residency, 1024);
+	std::vector<TextureResidencyChange> changes;
+	residency.request(texture, 2048.0f);
+	residency.update(changes);
+	residency.request(texture, 100.0f);
+	residency.update(changes);
+	CHECK(residency.getWantedMip(texture) == 3);
+	CHECK(residency.getResidentMip(texture) == 0);
+	CHECK(changes.empty());
+
+	//pressure takes the unwanted levels first, even from the texture used this frame
+	residency.setBudget(ChainBytes(1024, 2));
+	residency.request(texture, 100.0f);
+	residency.update(changes);
+	CHECK(residency.getResidentMip(texture) == 2);
+	CHECK(changes.size() == 1 && changes[0].fromMip == 0 && changes[0].toMip == 2);
+}
+
+//Cutting the budget evicts down to the tails, which are never given up
+TEST(ResidencyBudgetDropStopsAtTails){
+	TextureResidency residency(64 << 20, 64 << 20);
+	unsigned int a = AddSquare(residency, 1024);
+	unsigned int b = AddSquare(residency, 512);
+	std::vector<TextureResidencyChange> changes;
+	residency.request(a, 2048.0f);
+	residency.request(b, 2048.0f);
+	residency.update(changes);
+	CHECK(residency.getResidentMip(a) == 0 && residency.getResidentMip(b) == 0);
+
+	residency.setBudget(0);
+	residency.update(changes);
+	CHECK(residency.getResidentMip(a) == 4 && residency.getResidentMip(b) == 3);
+	CHECK(residency.getResidentBytes() == ChainBytes(1024, 4) + ChainBytes(512, 3));
+	const TextureResidencyChange* change = FindChange(changes, a);
+	CHECK(change && change->fromMip == 0 && change->toMip == 4);
+	change = FindChange(changes, b);
+	CHECK(change && change->fromMip == 0 && change->toMip == 3);
+}
+
+//The upload budget caps a frame's new levels, but one texture always moves
+TEST(ResidencyUploadBudget){
+	TextureResidency residency(64 << 20, 1);
+	unsigned int a = AddSquare(residency, 1024);
+	unsigned int b = AddSquare(residency, 1024);
+	std::vector<TextureResidencyChange> changes;
+	residency.request(a, 2048.0f);
+	residency.request(b, 2048.0f);
+	residency.update(changes);
+	CHECK(changes.size() == 1 && changes[0].fromMip == 4 && changes[0].toMip == 3);
+
+	//a level at a time, most recently used first, until both are complete
+	for (int frame = 0; frame < 16; frame++){
+		residency.request(a, 2048.0f);
+		residency.request(b, 2048.0f);
+		residency.update(changes);
+		CHECK(changes.size() <= 1);
+	}
+	CHECK(residency.getResidentMip(a) == 0 && residency.getResidentMip(b) == 0);
+}
+
+TEST(ResidencyRemoveFreesLevels){
+	TextureResidency residency(64 << 20, 64 << 20);
+	unsigned int a = AddSquare(residency, 1024);
+	unsigned int b = AddSquare(residency, 256);
+	std::vector<TextureResidencyChange> changes;
+	residency.request(a, 2048.0f);
+	residency.update(changes);
+	residency.remove(a);
+	CHECK(residency.getResidentBytes() == ChainBytes(256, 2));
+	residency.remove(a);
+	CHECK(residency.getResidentBytes() == ChainBytes(256, 2));
+	//a removed texture is never promoted or picked to evict
+	residency.request(b, 512.0f);
+	residency.update(changes);
+	CHECK(changes.size() == 1 && changes[0].texture == b);
+}
+
+//Random requests over many frames: the resident bytes always add up to the resident chains,
+//stay in budget unless only tails are left, and every change really moves
+TEST(ResidencyRandomChurn){
+	TextureResidency residency(3 << 20, 2 << 20);
+	std::vector<unsigned int> textures;
+	std::vector<uint32_t> sizes;
+	for (int i = 0; i < 20; i++){
+		sizes.push_back(256 << (i % 3));
+		textures.push_back(AddSquare(residency, sizes.back()));
+	}
+	std::vector<TextureResidencyChange> changes;
+	std::vector<unsigned int> previous(textures.size());
+	for (size_t i = 0; i < textures.size(); i++){
+		previous[i] = residency.getResidentMip(textures[i]);
+	}
+
+	srand(1);
+	bool consistent = true;
+	bool inBudget = true;
+	bool changesMove = true;
+	bool changesReported = true;
+	for (int frame = 0; frame < 500; frame++){
+		for (int k = 0; k < 5; k++){
+			residency.request(textures[rand() % textures.size()], (float)(rand() % 1500));
+		}
+		residency.update(changes);
+
+		size_t resident = 0;
+		size_t tails = 0;
+		for (size_t i = 0; i < textures.size(); i++){
+			unsigned int mip = residency.getResidentMip(textures[i]);
+			resident += ChainBytes(sizes[i], mip);
+			tails += ChainBytes(sizes[i], residency.getTailMip(textures[i]));
+			const TextureResidencyChange* change = FindChange(changes, textures[i]);
+			if (mip != previous[i]){
+				changesReported = changesReported && change && change->fromMip == previous[i] && change->toMip == mip;
+			}
+			else{
+				changesReported = changesReported && !change;
+			}
+			previous[i] = mip;
+		}
+		consistent = consistent && resident == residency.getResidentBytes();
+		inBudget = inBudget && (resident <= residency.getBudget() || resident == tails);
+		for (size_t i = 0; i < changes.size(); i++){
+			changesMove = changesMove && changes[i].fromMip != changes[i].toMip;
+		}
+	}
+	CHECK(consistent);
+	CHECK(inBudget);
+	CHECK(changesMove);
+	CHECK(changesReported);
+}
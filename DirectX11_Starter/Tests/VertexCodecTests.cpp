@@ -0,0 +1,211 @@
+#include "Test.h"
+#include "VertexCodec.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+static uint32_t FloatBits(float value){
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static float BitsToFloat(uint32_t bits){
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+//Every finite half, denormals included, comes back bit for bit
+TEST(HalfRoundTripsEveryValue){
+	bool roundTrips = true;
+	for (uint32_t half = 0; half < 0x10000; half++){
+		if ((half & 0x7C00) == 0x7C00){
+			continue;
+		}
+		roundTrips = roundTrips && FloatToHalf(HalfToFloat((uint16_t)half)) == half;
+	}
+	CHECK(roundTrips);
+	CHECK(HalfToFloat(0x0001) == ldexpf(1.0f, -24));
+	CHECK(HalfToFloat(0x03FF) == ldexpf(1023.0f, -24));
+	CHECK(HalfToFloat(0x0400) == ldexpf(1.0f, -14));
+	CHECK(HalfToFloat(0x7BFF) == 65504.0f);
+	CHECK(FloatBits(HalfToFloat(0x8000)) == 0x80000000);
+}
+
+//A float between two neighbouring halves goes to the nearer one, ties to the even one
+TEST(HalfRoundsToNearestEven){
+	bool nearest = true;
+	for (uint32_t half = 0; half < 0x7BFF; half++){
+		double low = HalfToFloat((uint16_t)half);
+		double high = HalfToFloat((uint16_t)(half + 1));
+		float middle = (float)((low + high) * 0.5);
+		uint32_t tie = (half & 1) ? half + 1 : half;
+		nearest = nearest && FloatToHalf(middle) == tie && FloatToHalf(-middle) == (tie | 0x8000);
+		nearest = nearest && FloatToHalf(nextafterf(middle, 0.0f)) == half && FloatToHalf(nextafterf(middle, 1e9f)) == half + 1;
+	}
+	CHECK(nearest);
+
+	//under half the smallest denormal is zero, over it the smallest denormal
+	CHECK(FloatToHalf(ldexpf(1.0f, -25)) == 0x0000);
+	CHECK(FloatToHalf(ldexpf(1.5f, -25)) == 0x0001);
+	CHECK(FloatToHalf(ldexpf(1.0f, -40)) == 0x0000);
+	CHECK(FloatToHalf(-ldexpf(1.0f, -40)) == 0x8000);
+}
+
+//Past 65504 saturates instead of going to infinity, NaN stays NaN
+TEST(HalfSaturatesAndKeepsNaN){
+	CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+	CHECK(FloatToHalf(65519.0f) == 0x7BFF);
+	CHECK(FloatToHalf(65520.0f) == 0x7BFF);
+	CHECK(FloatToHalf(1.0e9f) == 0x7BFF);
+	CHECK(FloatToHalf(-1.0e9f) == 0xFBFF);
+	CHECK(FloatToHalf(BitsToFloat(0x7F800000)) == 0x7BFF);
+	CHECK(FloatToHalf(BitsToFloat(0xFF800000)) == 0xFBFF);
+
+	uint16_t nan = FloatToHalf(BitsToFloat(0x7FC00000));
+	CHECK((nan & 0x7C00) == 0x7C00 && (nan & 0x3FF) != 0);
+	CHECK(HalfToFloat(nan) != HalfToFloat(nan));
+	//a NaN whose payload is all in the bits the half drops is still a NaN
+	nan = FloatToHalf(BitsToFloat(0x7F800001));
+	CHECK((nan & 0x7C00) == 0x7C00 && (nan & 0x3FF) != 0);
+}
+
+//Degrees between two directions, in double
+static double Angle(const XMFLOAT3& a, const XMFLOAT3& b){
+	double dot = (double)a.x * b.x + (double)a.y * b.y + (double)a.z * b.z;
+	double lengths = sqrt(((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z) * ((double)b.x * b.x + (double)b.y * b.y + (double)b.z * b.z));
+	double cosine = dot / lengths;
+	cosine = cosine > 1.0 ? 1.0 : (cosine < -1.0 ? -1.0 : cosine);
+	return acos(cosine) * 57.29577951308232;
+}
+
+static double WorstOctahedralError(const std::vector<XMFLOAT3>& directions){
+	double worst = 0.0;
+	for (size_t i = 0; i < directions.size(); i++){
+		int16_t encoded[2];
+		EncodeOctahedral(directions[i], encoded);
+		double angle = Angle(directions[i], DecodeOctahedral(encoded));
+		worst = angle > worst ? angle : worst;
+	}
+	return worst;
+}
+
+/**
+*A Fibonacci sphere for the general case, then the places the octahedral map is awkward: the
+*poles, the equator where the lower half folds over, and the x = 0 and y = 0 great circles whose
+*lower halves land on the edges of the encoded square.
+**/
+TEST(OctahedralErrorWithinBound){
+	const float bound = GetPackingErrorBound(1.0f).normal;
+	const double pi = 3.14159265358979323846;
+
+	std::vector<XMFLOAT3> sphere;
+	const unsigned int points = 200000;
+	for (unsigned int i = 0; i < points; i++){
+		double z = 1.0 - (2.0 * i + 1.0) / points;
+		double r = sqrt(1.0 - z * z);
+		double phi = i * pi * (3.0 - sqrt(5.0));
+		sphere.push_back(XMFLOAT3((float)(r * cos(phi)), (float)(r * sin(phi)), (float)z));
+	}
+	CHECK(WorstOctahedralError(sphere) < bound);
+
+	std::vector<XMFLOAT3> edges;
+	const float axes[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+	for (int i = 0; i < 6; i++){
+		edges.push_back(XMFLOAT3(axes[i][0], axes[i][1], axes[i][2]));
+	}
+	//the poles and just off them
+	edges.push_back(XMFLOAT3(1e-6f, -1e-6f, 1.0f));
+	edges.push_back(XMFLOAT3(-1e-6f, 1e-6f, -1.0f));
+	for (unsigned int i = 0; i < 4096; i++){
+		double angle = 2.0 * pi * i / 4096;
+		float c = (float)cos(angle);
+		float s = (float)sin(angle);
+		edges.push_back(XMFLOAT3(c, s, 0.0f));
+		edges.push_back(XMFLOAT3(c, s, -1e-4f));
+		edges.push_back(XMFLOAT3(0.0f, c, s));
+		edges.push_back(XMFLOAT3(c, 0.0f, s));
+	}
+	CHECK(WorstOctahedralError(edges) < bound);
+
+	//length doesn't matter, only direction
+	std::vector<XMFLOAT3> scaled;
+	for (size_t i = 0; i < sphere.size(); i += 97){
+		float scale = 0.01f + (i % 7) * 3.0f;
+		scaled.push_back(XMFLOAT3(sphere[i].x * scale, sphere[i].y * scale, sphere[i].z * scale));
+	}
+	CHECK(WorstOctahedralError(scaled) < bound);
+
+	//the poles decode exactly
+	int16_t encoded[2];
+	EncodeOctahedral(XMFLOAT3(0.0f, 0.0f, -1.0f), encoded);
+	XMFLOAT3 pole = DecodeOctahedral(encoded);
+	CHECK(pole.x == 0.0f && pole.y == 0.0f && pole.z == -1.0f);
+}
+
+static Vertex2 MakeVertex(float x, float y, float z, float handedness){
+	Vertex2 vertex;
+	vertex.Position = XMFLOAT3(x, y, z);
+	vertex.Normal = XMFLOAT3(0.0f, 0.6f, 0.8f);
+	vertex.UVs = XMFLOAT2(x * 0.1f, 1.0f - y * 0.1f);
+	vertex.Tangent = XMFLOAT4(0.8f, 0.0f, -0.6f, handedness);
+	return vertex;
+}
+
+//The corners of the bounding cube are the extremes of the 16-bit range and decode within the bound
+TEST(PackedPositionsAtCubeCorners){
+	const XMFLOAT3 center(12.5f, -3.0f, 100.0f);
+	const float radius = 37.25f;
+	std::vector<Vertex2> vertices;
+	for (int corner = 0; corner < 8; corner++){
+		float x = center.x + ((corner & 1) ? radius : -radius);
+		float y = center.y + ((corner & 2) ? radius : -radius);
+		float z = center.z + ((corner & 4) ? radius : -radius);
+		vertices.push_back(MakeVertex(x, y, z, 1.0f));
+		//a hair inside, where rounding decides the last step
+		float inset = radius * 0.7f / 65535.0f;
+		vertices.push_back(MakeVertex(x + ((corner & 1) ? -inset : inset), y + ((corner & 2) ? -inset : inset), z + ((corner & 4) ? -inset : inset), 1.0f));
+	}
+	vertices.push_back(MakeVertex(center.x, center.y, center.z, 1.0f));
+
+	std::vector<PackedVertex2> packed(vertices.size());
+	PackVertices(&vertices[0], vertices.size(), center, radius, &packed[0]);
+	for (int corner = 0; corner < 8; corner++){
+		const PackedVertex2& p = packed[corner * 2];
+		CHECK(p.position[0] == ((corner & 1) ? 65535 : 0));
+		CHECK(p.position[1] == ((corner & 2) ? 65535 : 0));
+		CHECK(p.position[2] == ((corner & 4) ? 65535 : 0));
+	}
+
+	VertexPackingError error = MeasurePackingError(&vertices[0], &packed[0], vertices.size(), center, radius);
+	VertexPackingError bound = GetPackingErrorBound(radius);
+	CHECK(error.position <= bound.position);
+	CHECK(error.normal < bound.normal);
+	CHECK(error.tangent < bound.tangent);
+	CHECK(error.uv <= bound.uv);
+}
+
+//The handedness rides in position.w: 0 for right handed, 65535 for left handed
+TEST(PackedTangentKeepsHandedness){
+	const XMFLOAT3 center(0.0f, 0.0f, 0.0f);
+	std::vector<Vertex2> vertices;
+	vertices.push_back(MakeVertex(0.5f, 0.5f, 0.5f, 1.0f));
+	vertices.push_back(MakeVertex(-0.5f, 0.25f, 0.0f, -1.0f));
+	vertices.push_back(MakeVertex(0.0f, 0.0f, 0.0f, -1.0f));
+	vertices.push_back(MakeVertex(0.75f, -0.75f, 0.1f, 1.0f));
+
+	std::vector<PackedVertex2> packed(vertices.size());
+	PackVertices(&vertices[0], vertices.size(), center, 1.0f, &packed[0]);
+	std::vector<Vertex2> unpacked(vertices.size());
+	UnpackVertices(&packed[0], packed.size(), center, 1.0f, &unpacked[0]);
+	for (size_t i = 0; i < vertices.size(); i++){
+		CHECK(packed[i].position[3] == (vertices[i].Tangent.w < 0.0f ? 65535 : 0));
+		CHECK(unpacked[i].Tangent.w == vertices[i].Tangent.w);
+	}
+	CHECK(MeasurePackingError(&vertices[0], &packed[0], vertices.size(), center, 1.0f).tangent < GetPackingErrorBound(1.0f).tangent);
+
+	//a flipped sign is reported as the worst a tangent can be
+	packed[1].position[3] = 0;
+	CHECK(MeasurePackingError(&vertices[0], &packed[0], vertices.size(), center, 1.0f).tangent == 180.0f);
+}